@@ -407,6 +407,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/rdb/backend/detail/impl/Shard.cpp
   src/ripple/app/rdb/backend/impl/PostgresDatabase.cpp
   src/ripple/app/rdb/backend/impl/SQLiteDatabase.cpp
+  src/ripple/app/rdb/impl/AccountTxIndex.cpp
   src/ripple/app/rdb/impl/Download.cpp
   src/ripple/app/rdb/impl/PeerFinder.cpp
   src/ripple/app/rdb/impl/RelationalDatabase.cpp
@@ -444,6 +445,8 @@ target_sources (rippled PRIVATE
   src/ripple/app/tx/impl/Taker.cpp
   src/ripple/app/tx/impl/Transactor.cpp
   src/ripple/app/tx/impl/apply.cpp
+  src/ripple/app/tx/impl/applyParallel.cpp
+  src/ripple/app/tx/impl/applyPrefetch.cpp
   src/ripple/app/tx/impl/applySteps.cpp
   src/ripple/app/tx/impl/details/NFTokenUtils.cpp
   #[===============================[
@@ -452,8 +455,11 @@ target_sources (rippled PRIVATE
   #]===============================]
   src/ripple/basics/impl/Archive.cpp
   src/ripple/basics/impl/BasicConfig.cpp
+  src/ripple/basics/impl/CacheSweeper.cpp
   src/ripple/basics/impl/ResolverAsio.cpp
+  src/ripple/basics/impl/SlabAllocator.cpp
   src/ripple/basics/impl/UptimeClock.cpp
+  src/ripple/basics/impl/WorkerPool.cpp
   src/ripple/basics/impl/make_SSLContext.cpp
   src/ripple/basics/impl/mulDiv.cpp
   src/ripple/basics/impl/partitioned_unordered_map.cpp
@@ -523,6 +529,7 @@ target_sources (rippled PRIVATE
   src/ripple/nodestore/backend/NullFactory.cpp
   src/ripple/nodestore/backend/RocksDBFactory.cpp
   src/ripple/nodestore/impl/BatchWriter.cpp
+  src/ripple/nodestore/impl/CompressionDictionary.cpp
   src/ripple/nodestore/impl/Database.cpp
   src/ripple/nodestore/impl/DatabaseNodeImp.cpp
   src/ripple/nodestore/impl/DatabaseRotatingImp.cpp
@@ -551,6 +558,7 @@ target_sources (rippled PRIVATE
   src/ripple/overlay/impl/ProtocolVersion.cpp
   src/ripple/overlay/impl/TrafficCount.cpp
   src/ripple/overlay/impl/TxMetrics.cpp
+  src/ripple/overlay/impl/ZstdDictionary.cpp
   #[===============================[
      main sources:
        subdir: peerfinder
@@ -682,6 +690,7 @@ target_sources (rippled PRIVATE
 if (tests)
   target_sources (rippled PRIVATE
     src/test/app/AccountDelete_test.cpp
+    src/test/app/AccountTxIndex_test.cpp
     src/test/app/AccountTxPaging_test.cpp
     src/test/app/AmendmentTable_test.cpp
     src/test/app/Check_test.cpp
@@ -706,7 +715,10 @@ if (tests)
     src/test/app/NFTokenDir_test.cpp
     src/test/app/OfferStream_test.cpp
     src/test/app/Offer_test.cpp
+    src/test/app/OpenLedger_test.cpp
+    src/test/app/OrderBookDB_test.cpp
     src/test/app/OversizeMeta_test.cpp
+    src/test/app/ParallelApply_test.cpp
     src/test/app/Path_test.cpp
     src/test/app/PayChan_test.cpp
     src/test/app/PayStrand_test.cpp
@@ -739,11 +751,14 @@ if (tests)
     src/test/basics/IOUAmount_test.cpp
     src/test/basics/KeyCache_test.cpp
     src/test/basics/PerfLog_test.cpp
+    src/test/basics/PersistentMap_test.cpp
     src/test/basics/RangeSet_test.cpp
     src/test/basics/scope_test.cpp
+    src/test/basics/SlabAllocator_test.cpp
     src/test/basics/Slice_test.cpp
     src/test/basics/StringUtilities_test.cpp
     src/test/basics/TaggedCache_test.cpp
+    src/test/basics/WorkerPool_test.cpp
     src/test/basics/XRPAmount_test.cpp
     src/test/basics/base64_test.cpp
     src/test/basics/base_uint_test.cpp
@@ -880,6 +895,7 @@ if (tests)
     #]===============================]
     src/test/nodestore/Backend_test.cpp
     src/test/nodestore/Basics_test.cpp
+    src/test/nodestore/CompressionDictionary_test.cpp
     src/test/nodestore/DatabaseShard_test.cpp
     src/test/nodestore/Database_test.cpp
     src/test/nodestore/Timing_test.cpp
@@ -894,6 +910,7 @@ if (tests)
     src/test/overlay/short_read_test.cpp
     src/test/overlay/compression_test.cpp
     src/test/overlay/reduce_relay_test.cpp
+    src/test/overlay/send_batch_test.cpp
     src/test/overlay/handshake_test.cpp
     src/test/overlay/tx_reduce_relay_test.cpp
     #[===============================[
@@ -987,6 +1004,8 @@ if (tests)
          subdir: shamap
     #]===============================]
     src/test/shamap/FetchPack_test.cpp
+    src/test/shamap/SHAMapFlush_test.cpp
+    src/test/shamap/SHAMapItem_test.cpp
     src/test/shamap/SHAMapSync_test.cpp
     src/test/shamap/SHAMap_test.cpp
     #[===============================[
@@ -0,0 +1,24 @@
+find_package (PkgConfig)
+if (PKG_CONFIG_FOUND)
+  pkg_search_module (zstd_PC QUIET libzstd>=1.4.0)
+endif ()
+
+if(static)
+  set(ZSTD_LIB libzstd.a)
+else()
+  set(ZSTD_LIB libzstd.so)
+endif()
+
+find_library (zstd
+  NAMES ${ZSTD_LIB}
+  HINTS
+    ${zstd_PC_LIBDIR}
+    ${zstd_PC_LIBRARY_DIRS}
+  NO_DEFAULT_PATH)
+
+find_path (ZSTD_INCLUDE_DIR
+  NAMES zstd.h
+  HINTS
+    ${zstd_PC_INCLUDEDIR}
+    ${zstd_PC_INCLUDEDIRS}
+  NO_DEFAULT_PATH)
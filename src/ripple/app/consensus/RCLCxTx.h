@@ -42,7 +42,16 @@ public:
 
         @param txn The transaction to wrap
     */
-    RCLCxTx(SHAMapItem const& txn) : tx_{txn}
+    RCLCxTx(boost::intrusive_ptr<SHAMapItem const> txn) : tx_{std::move(txn)}
+    {
+    }
+
+    /** Constructor
+
+        @param txn The transaction to wrap. Items count their own
+                   references, so this shares the item rather than copying.
+    */
+    RCLCxTx(SHAMapItem const& txn) : tx_{&txn}
     {
     }
 
@@ -50,11 +59,11 @@ public:
     ID const&
     id() const
     {
-        return tx_.key();
+        return tx_->key();
     }
 
     //! The SHAMapItem that represents the transaction.
-    SHAMapItem const tx_;
+    boost::intrusive_ptr<SHAMapItem const> const tx_;
 };
 
 /** Represents a set of transactions in RCLConsensus.
@@ -90,8 +99,7 @@ public:
         bool
         insert(Tx const& t)
         {
-            return map_->addItem(
-                SHAMapNodeType::tnTRANSACTION_NM, SHAMapItem{t.tx_});
+            return map_->addItem(SHAMapNodeType::tnTRANSACTION_NM, t.tx_);
         }
 
         /** Remove a transaction from the set.
@@ -137,15 +145,15 @@ public:
     /** Lookup a transaction.
 
         @param entry The ID of the transaction to find.
-        @return A shared pointer to the SHAMapItem.
+        @return A pointer to the SHAMapItem.
 
         @note Since find may not succeed, this returns a
-              `std::shared_ptr<const SHAMapItem>` rather than a Tx, which
+              `boost::intrusive_ptr<SHAMapItem const>` rather than a Tx, which
               cannot refer to a missing transaction.  The generic consensus
-              code uses the shared_ptr semantics to know whether the find
+              code uses the pointer semantics to know whether the find
               was successful and properly creates a Tx as needed.
     */
-    std::shared_ptr<const SHAMapItem> const&
+    boost::intrusive_ptr<SHAMapItem const> const&
     find(Tx::ID const& entry) const
     {
         return map_->peekItem(entry);
@@ -66,6 +66,9 @@ struct LedgerFill
 void
 addJson(Json::Value&, LedgerFill const&);
 
+void
+addJson(Json::Object&, LedgerFill const&);
+
 /** Return a new Json::Value representing the ledger with given options.*/
 Json::Value
 getJson(LedgerFill const&);
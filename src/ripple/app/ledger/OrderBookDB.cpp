@@ -28,6 +28,28 @@
 
 namespace ripple {
 
+// Returns the book a directory belongs to if it is the first page of one of
+// the book's qualities. Fields holding zero may be missing from metadata.
+static std::optional<Book>
+bookFromDirectory(STObject const& dir, uint256 const& key)
+{
+    if (!dir.isFieldPresent(sfExchangeRate) ||
+        !dir.isFieldPresent(sfRootIndex) ||
+        dir.getFieldH256(sfRootIndex) != key)
+        return std::nullopt;
+
+    auto field = [&dir](SField const& f) {
+        return dir.isFieldPresent(f) ? dir.getFieldH160(f) : uint160{};
+    };
+
+    Book book;
+    book.in.currency = field(sfTakerPaysCurrency);
+    book.in.account = field(sfTakerPaysIssuer);
+    book.out.currency = field(sfTakerGetsCurrency);
+    book.out.account = field(sfTakerGetsIssuer);
+    return book;
+}
+
 OrderBookDB::OrderBookDB(Application& app)
     : app_(app), seq_(0), j_(app.journal("OrderBookDB"))
 {
@@ -87,9 +109,21 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
 
     decltype(allBooks_) allBooks;
     decltype(xrpBooks_) xrpBooks;
+    decltype(bookDirs_) bookDirs;
 
     allBooks.reserve(allBooks_.size());
     xrpBooks.reserve(xrpBooks_.size());
+    bookDirs.reserve(bookDirs_.size());
+
+    // Changes deferred for this update are of no use if it does not finish
+    auto abandon = [this]() {
+        {
+            std::lock_guard sl(mLock);
+            deferred_.clear();
+            deferredSeq_ = 0;
+        }
+        seq_.store(0);
+    };
 
     JLOG(j_.debug()) << "Beginning update (" << ledger->seq() << ")";
 
@@ -104,25 +138,22 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
             {
                 JLOG(j_.info())
                     << "Update halted because the process is stopping";
-                seq_.store(0);
+                abandon();
                 return;
             }
 
-            if (sle->getType() == ltDIR_NODE &&
-                sle->isFieldPresent(sfExchangeRate) &&
-                sle->getFieldH256(sfRootIndex) == sle->key())
-            {
-                Book book;
-
-                book.in.currency = sle->getFieldH160(sfTakerPaysCurrency);
-                book.in.account = sle->getFieldH160(sfTakerPaysIssuer);
-                book.out.currency = sle->getFieldH160(sfTakerGetsCurrency);
-                book.out.account = sle->getFieldH160(sfTakerGetsIssuer);
+            if (sle->getType() != ltDIR_NODE)
+                continue;
 
-                allBooks[book.in].insert(book.out);
+            if (auto const book = bookFromDirectory(*sle, sle->key()))
+            {
+                if (bookDirs[*book]++ == 0)
+                {
+                    allBooks[book->in].insert(book->out);
 
-                if (isXRP(book.out))
-                    xrpBooks.insert(book.in);
+                    if (isXRP(book->out))
+                        xrpBooks.insert(book->in);
+                }
 
                 ++cnt;
             }
@@ -132,7 +163,7 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
     {
         JLOG(j_.info()) << "Missing node in " << ledger->seq()
                         << " during update: " << mn.what();
-        seq_.store(0);
+        abandon();
         return;
     }
 
@@ -143,11 +174,154 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
         std::lock_guard sl(mLock);
         allBooks_.swap(allBooks);
         xrpBooks_.swap(xrpBooks);
+        bookDirs_.swap(bookDirs);
+        booksSeq_ = builtSeq_ = ledger->seq();
+
+        // Catch up with the ledgers published during the walk
+        for (auto const& c : deferred_)
+        {
+            if (c.seq > builtSeq_)
+                applyChange(c.book, c.created);
+        }
+
+        if (deferredSeq_ > builtSeq_)
+            booksSeq_ = deferredSeq_;
+
+        // A later full update, if one is pending, still needs the changes
+        // that follow its own ledger.
+        if (auto const target = seq_.load(); target > builtSeq_)
+        {
+            deferred_.erase(
+                std::remove_if(
+                    deferred_.begin(),
+                    deferred_.end(),
+                    [target](BookChange const& c) { return c.seq <= target; }),
+                deferred_.end());
+        }
+        else
+        {
+            deferred_.clear();
+            deferredSeq_ = 0;
+        }
     }
 
     app_.getLedgerMaster().newOrderBookDB();
 }
 
+void
+OrderBookDB::processLedger(
+    std::shared_ptr<ReadView const> const& ledger,
+    AcceptedLedger const& accepted)
+{
+    if (app_.config().PATH_SEARCH_MAX == 0)
+        return;  // pathfinding has been disabled
+
+    auto const seq = ledger->seq();
+
+    std::vector<BookChange> changes;
+
+    for (auto const& tx : accepted)
+    {
+        for (auto const& node : tx->getMeta().getNodes())
+        {
+            try
+            {
+                if (node.getFieldU16(sfLedgerEntryType) != ltDIR_NODE)
+                    continue;
+
+                bool const created = node.getFName() == sfCreatedNode;
+
+                if (!created && node.getFName() != sfDeletedNode)
+                    continue;
+
+                auto const fields = dynamic_cast<STObject const*>(
+                    node.peekAtPField(created ? sfNewFields : sfFinalFields));
+
+                if (!fields)
+                    continue;
+
+                if (auto const book = bookFromDirectory(
+                        *fields, node.getFieldH256(sfLedgerIndex)))
+                    changes.push_back({seq, *book, created});
+            }
+            catch (std::exception const& ex)
+            {
+                JLOG(j_.info())
+                    << "processLedger: field not found (" << ex.what() << ")";
+            }
+        }
+    }
+
+    {
+        std::lock_guard sl(mLock);
+
+        // While a full update runs, keep what follows its ledger to apply
+        // once it is done.
+        if (auto const target = seq_.load();
+            target != 0 && target != builtSeq_)
+        {
+            if (seq > target)
+            {
+                deferred_.insert(
+                    deferred_.end(), changes.begin(), changes.end());
+                deferredSeq_ = std::max(deferredSeq_, seq);
+            }
+            return;
+        }
+
+        if (booksSeq_ != 0 && seq <= booksSeq_)
+            return;
+
+        if (booksSeq_ != 0 && seq == booksSeq_ + 1)
+        {
+            for (auto const& c : changes)
+                applyChange(c.book, c.created);
+
+            booksSeq_ = seq;
+            return;
+        }
+
+        JLOG(j_.info()) << "Order books track ledger " << booksSeq_
+                        << ", not " << seq - 1;
+    }
+
+    setup(ledger);
+}
+
+void
+OrderBookDB::applyChange(Book const& book, bool created)
+{
+    if (created)
+    {
+        if (bookDirs_[book]++ == 0)
+        {
+            allBooks_[book.in].insert(book.out);
+
+            if (isXRP(book.out))
+                xrpBooks_.insert(book.in);
+        }
+        return;
+    }
+
+    auto const it = bookDirs_.find(book);
+
+    if (it == bookDirs_.end() || --it->second != 0)
+        return;
+
+    bookDirs_.erase(it);
+
+    if (auto books = allBooks_.find(book.in); books != allBooks_.end())
+    {
+        books->second.erase(book.out);
+
+        if (books->second.empty())
+            allBooks_.erase(books);
+    }
+
+    if (isXRP(book.out))
+        xrpBooks_.erase(book.in);
+}
+
 void
 OrderBookDB::addOrderBook(Book const& book)
 {
@@ -234,7 +408,7 @@ void
 OrderBookDB::processTxn(
     std::shared_ptr<ReadView const> const& ledger,
     const AcceptedLedgerTx& alTx,
-    Json::Value const& jvObj)
+    PubMessage const& msg)
 {
     std::lock_guard sl(mLock);
 
@@ -261,7 +435,7 @@ OrderBookDB::processTxn(
                             {data->getFieldAmount(sfTakerGets).issue(),
                              data->getFieldAmount(sfTakerPays).issue()});
                         if (listeners)
-                            listeners->publish(jvObj, havePublished);
+                            listeners->publish(msg, havePublished);
                     }
                 };
 
@@ -20,6 +20,7 @@
 #ifndef RIPPLE_APP_LEDGER_ORDERBOOKDB_H_INCLUDED
 #define RIPPLE_APP_LEDGER_ORDERBOOKDB_H_INCLUDED
 
+#include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/AcceptedLedgerTx.h>
 #include <ripple/app/ledger/BookListeners.h>
 #include <ripple/app/main/Application.h>
@@ -37,6 +38,17 @@ public:
     void
     update(std::shared_ptr<ReadView const> const& ledger);
 
+    /** Track the order book directories a validated ledger created and
+        deleted.
+
+        Ledgers are expected in sequence. If this one does not follow the
+        last ledger the books reflect, a full update is scheduled instead.
+    */
+    void
+    processLedger(
+        std::shared_ptr<ReadView const> const& ledger,
+        AcceptedLedger const& accepted);
+
     void
     addOrderBook(Book const&);
 
@@ -63,9 +75,20 @@ public:
     processTxn(
         std::shared_ptr<ReadView const> const& ledger,
         const AcceptedLedgerTx& alTx,
-        Json::Value const& jvObj);
+        PubMessage const& msg);
 
 private:
+    struct BookChange
+    {
+        std::uint32_t seq;
+        Book book;
+        bool created;
+    };
+
+    // Add or remove one directory of a book. mLock must be held.
+    void
+    applyChange(Book const& book, bool created);
+
     Application& app_;
 
     // Maps order books by "issue in" to "issue out":
@@ -74,6 +97,20 @@ private:
     // does an order book to XRP exist
     hash_set<Issue> xrpBooks_;
 
+    // The number of directories (one per quality) in each known book
+    hash_map<Book, std::uint32_t> bookDirs_;
+
+    // The ledger the books reflect, or 0 if they are not being tracked
+    std::uint32_t booksSeq_ = 0;
+
+    // The ledger of the last completed full update
+    std::uint32_t builtSeq_ = 0;
+
+    // Changes from ledgers published while a full update is running, and
+    // the last such ledger
+    std::vector<BookChange> deferred_;
+    std::uint32_t deferredSeq_ = 0;
+
     std::recursive_mutex mLock;
 
     using BookToListenersMap = hash_map<Book, BookListeners::pointer>;
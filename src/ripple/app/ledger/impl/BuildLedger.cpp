@@ -81,6 +81,79 @@ buildLedgerImpl(
     return built;
 }
 
+/** Make one pass over a set of consensus transactions, executing them
+    speculatively in parallel.
+
+    @return number of transactions applied; the ones applied or failed are
+            removed from txns
+*/
+static int
+applyPassParallel(
+    Application& app,
+    std::shared_ptr<Ledger const> const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    int pass,
+    bool certainRetry,
+    beast::Journal j)
+{
+    std::vector<std::shared_ptr<STTx const>> pending;
+    pending.reserve(txns.size());
+
+    for (auto it = txns.begin(); it != txns.end();)
+    {
+        auto const txid = it->first.getTXID();
+
+        try
+        {
+            if (pass == 0 && built->txExists(txid))
+            {
+                it = txns.erase(it);
+                continue;
+            }
+        }
+        catch (std::exception const&)
+        {
+            JLOG(j.warn()) << "Transaction " << txid << " throws";
+            failed.insert(txid);
+            it = txns.erase(it);
+            continue;
+        }
+
+        pending.push_back(it->second);
+        ++it;
+    }
+
+    auto const results =
+        applyTransactions(app, view, pending, certainRetry, tapNONE, j);
+    assert(results.size() == txns.size());
+
+    int changes = 0;
+    auto it = txns.begin();
+
+    for (auto const result : results)
+    {
+        switch (result)
+        {
+            case ApplyResult::Success:
+                it = txns.erase(it);
+                ++changes;
+                break;
+
+            case ApplyResult::Fail:
+                failed.insert(it->first.getTXID());
+                it = txns.erase(it);
+                break;
+
+            case ApplyResult::Retry:
+                ++it;
+        }
+    }
+
+    return changes;
+}
+
 /** Apply a set of consensus transactions to a ledger.
 
   @param app Handle to application
@@ -103,6 +176,10 @@ applyTransactions(
     bool certainRetry = true;
     std::size_t count = 0;
 
+    // Start reading the state the transactions need while they are applied
+    for (auto const& it : txns)
+        prefetchTransaction(*built, *it.second);
+
     // Attempt to apply all of the retriable transactions
     for (int pass = 0; pass < LEDGER_TOTAL_PASSES; ++pass)
     {
@@ -110,42 +187,50 @@ applyTransactions(
                         << " begins (" << txns.size() << " transactions)";
         int changes = 0;
 
-        auto it = txns.begin();
-
-        while (it != txns.end())
+        if (app.config().PARALLEL_APPLY)
+        {
+            changes = applyPassParallel(
+                app, built, txns, failed, view, pass, certainRetry, j);
+        }
+        else
         {
-            auto const txid = it->first.getTXID();
+            auto it = txns.begin();
 
-            try
+            while (it != txns.end())
             {
-                if (pass == 0 && built->txExists(txid))
-                {
-                    it = txns.erase(it);
-                    continue;
-                }
+                auto const txid = it->first.getTXID();
 
-                switch (applyTransaction(
-                    app, view, *it->second, certainRetry, tapNONE, j))
+                try
                 {
-                    case ApplyResult::Success:
+                    if (pass == 0 && built->txExists(txid))
+                    {
                         it = txns.erase(it);
-                        ++changes;
-                        break;
-
-                    case ApplyResult::Fail:
-                        failed.insert(txid);
-                        it = txns.erase(it);
-                        break;
-
-                    case ApplyResult::Retry:
-                        ++it;
+                        continue;
+                    }
+
+                    switch (applyTransaction(
+                        app, view, *it->second, certainRetry, tapNONE, j))
+                    {
+                        case ApplyResult::Success:
+                            it = txns.erase(it);
+                            ++changes;
+                            break;
+
+                        case ApplyResult::Fail:
+                            failed.insert(txid);
+                            it = txns.erase(it);
+                            break;
+
+                        case ApplyResult::Retry:
+                            ++it;
+                    }
+                }
+                catch (std::exception const&)
+                {
+                    JLOG(j.warn()) << "Transaction " << txid << " throws";
+                    failed.insert(txid);
+                    it = txns.erase(it);
                 }
-            }
-            catch (std::exception const&)
-            {
-                JLOG(j.warn()) << "Transaction " << txid << " throws";
-                failed.insert(txid);
-                it = txns.erase(it);
             }
         }
 
@@ -229,6 +314,19 @@ buildLedger(
         app,
         j,
         [&](OpenView& accum, std::shared_ptr<Ledger> const& built) {
+            for (auto& tx : replayData.orderedTxns())
+                prefetchTransaction(*built, *tx.second);
+
+            if (app.config().PARALLEL_APPLY)
+            {
+                std::vector<std::shared_ptr<STTx const>> txns;
+                txns.reserve(replayData.orderedTxns().size());
+                for (auto& tx : replayData.orderedTxns())
+                    txns.push_back(tx.second);
+                applyTransactions(app, accum, txns, false, applyFlags, j);
+                return;
+            }
+
             for (auto& tx : replayData.orderedTxns())
                 applyTransaction(app, accum, *tx.second, false, applyFlags, j);
         });
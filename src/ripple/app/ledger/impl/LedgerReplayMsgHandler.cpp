@@ -206,9 +206,10 @@ LedgerReplayMsgHandler::processReplayDeltaRequest(
     reply.set_ledgerheader(nData.getDataPtr(), nData.getLength());
     // pack transactions
     auto const& txMap = ledger->txMap();
-    txMap.visitLeaves([&](std::shared_ptr<SHAMapItem const> const& txNode) {
-        reply.add_transaction(txNode->data(), txNode->size());
-    });
+    txMap.visitLeaves(
+        [&](boost::intrusive_ptr<SHAMapItem const> const& txNode) {
+            reply.add_transaction(txNode->data(), txNode->size());
+        });
 
     JLOG(journal_.debug()) << "getReplayDelta for ledger " << ledgerHash
                            << " txMap hash " << txMap.getHash().as_uint256();
@@ -265,7 +266,7 @@ LedgerReplayMsgHandler::processReplayDeltaResponse(
             orderedTxns.emplace(meta[sfTransactionIndex], std::move(tx));
 
             auto item =
-                std::make_shared<SHAMapItem const>(tid, shaMapItemData.slice());
+                make_shamapitem(tid, shaMapItemData.slice());
             if (!item ||
                 !txMap.addGiveItem(SHAMapNodeType::tnTRANSACTION_MD, item))
             {
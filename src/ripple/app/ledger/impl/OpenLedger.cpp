@@ -81,6 +81,10 @@ OpenLedger::accept(
 {
     JLOG(j_.trace()) << "accept ledger " << ledger->seq() << " " << suffix;
     auto next = create(rules, ledger);
+    // Start reading the state the transactions will need,
+    // while the ones ahead of them are being applied
+    for (auto const& item : retries)
+        prefetchTransaction(*ledger, *item.second);
     if (retriesFirst)
     {
         // Handle disputed tx, outside lock
@@ -91,6 +95,10 @@ OpenLedger::accept(
     // new tx going into the open ledger
     // would get lost.
     std::lock_guard lock1(modify_mutex_);
+    for (auto const& item : current_->txs)
+        prefetchTransaction(*ledger, *item.first);
+    for (auto const& item : locals)
+        prefetchTransaction(*ledger, *item.second);
     // Apply tx from the current open view
     if (!current_->txs.empty())
     {
@@ -50,6 +50,7 @@
 #include <ripple/app/reporting/ReportingETL.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/basics/ByteUtilities.h>
+#include <ripple/basics/CacheSweeper.h>
 #include <ripple/basics/PerfLog.h>
 #include <ripple/basics/ResolverAsio.h>
 #include <ripple/basics/random.h>
@@ -103,6 +104,7 @@ private:
     private:
         beast::insight::Event m_event;
         beast::Journal m_journal;
+        std::string const name_;
         beast::io_latency_probe<std::chrono::steady_clock> m_probe;
         std::atomic<std::chrono::milliseconds> lastSample_;
 
@@ -111,9 +113,11 @@ private:
             beast::insight::Event ev,
             beast::Journal journal,
             std::chrono::milliseconds interval,
-            boost::asio::io_service& ios)
+            boost::asio::io_service& ios,
+            std::string name = "io_service")
             : m_event(ev)
             , m_journal(journal)
+            , name_(std::move(name))
             , m_probe(interval, ios)
             , lastSample_{}
         {
@@ -139,7 +143,7 @@ private:
             if (lastSample >= 500ms)
             {
                 JLOG(m_journal.warn())
-                    << "io_service latency = " << lastSample.count();
+                    << name_ << " latency = " << lastSample.count();
             }
         }
 
@@ -240,6 +244,9 @@ public:
 
     io_latency_sampler m_io_latency_sampler;
 
+    // One for each io_service the connections are spread over
+    std::vector<std::unique_ptr<io_latency_sampler>> m_io_shard_samplers;
+
     std::unique_ptr<GRPCServer> grpcServer_;
     std::unique_ptr<ReportingETL> reportingETL_;
 
@@ -273,7 +280,7 @@ public:
         std::unique_ptr<Config> config,
         std::unique_ptr<Logs> logs,
         std::unique_ptr<TimeKeeper> timeKeeper)
-        : BasicApp(numberOfThreads(*config))
+        : BasicApp(numberOfThreads(*config), config->IO_CONTEXTS)
         , config_(std::move(config))
         , logs_(std::move(logs))
         , timeKeeper_(std::move(timeKeeper))
@@ -495,6 +502,18 @@ public:
 
         add(m_resourceManager.get());
 
+        m_io_shard_samplers.reserve(io_shard_count());
+        for (std::size_t i = 0; i < io_shard_count(); ++i)
+        {
+            m_io_shard_samplers.push_back(std::make_unique<io_latency_sampler>(
+                m_collectorManager->collector()->make_event(
+                    "ios_latency_" + std::to_string(i)),
+                logs_->journal("Application"),
+                std::chrono::milliseconds(100),
+                get_io_shard(i),
+                "io_service #" + std::to_string(i)));
+        }
+
         //
         // VFALCO - READ THIS!
         //
@@ -608,10 +627,29 @@ public:
         return get_io_service();
     }
 
+    boost::asio::io_service&
+    getConnectionIOService() override
+    {
+        return next_io_service();
+    }
+
     std::chrono::milliseconds
     getIOLatency() override
     {
-        return m_io_latency_sampler.get();
+        auto latency = m_io_latency_sampler.get();
+        for (auto const& sampler : m_io_shard_samplers)
+            latency = std::max(latency, sampler->get());
+        return latency;
+    }
+
+    std::vector<std::chrono::milliseconds>
+    getIOContextLatencies() override
+    {
+        std::vector<std::chrono::milliseconds> latencies;
+        latencies.reserve(m_io_shard_samplers.size());
+        for (auto const& sampler : m_io_shard_samplers)
+            latencies.push_back(sampler->get());
+        return latencies;
     }
 
     LedgerMaster&
@@ -1168,6 +1206,10 @@ ApplicationImp::setup(boost::program_options::variables_map const& cmdline)
     // Optionally turn off logging to console.
     logs_->silent(config_->silent());
 
+    if (config_->SWEEP_BUDGET)
+        CacheSweeper::instance().setBudget(
+            std::chrono::milliseconds{*config_->SWEEP_BUDGET});
+
     if (!config_->standalone())
         timeKeeper_->run(config_->SNTP_SERVERS);
 
@@ -1523,6 +1565,8 @@ ApplicationImp::start(bool withTimers)
     }
 
     m_io_latency_sampler.start();
+    for (auto& sampler : m_io_shard_samplers)
+        sampler->start();
     m_resolver->start();
     m_loadManager->start();
     m_shaMapStore->start();
@@ -1553,6 +1597,8 @@ ApplicationImp::run()
     JLOG(m_journal.debug()) << "Application stopping";
 
     m_io_latency_sampler.cancel_async();
+    for (auto& sampler : m_io_shard_samplers)
+        sampler->cancel_async();
 
     // VFALCO Enormous hack, we have to force the probe to cancel
     //        before we stop the io_service queue or else it never
@@ -1561,6 +1607,8 @@ ApplicationImp::run()
     //        naturally return from io_service::run() instead of
     //        forcing a call to io_service::stop()
     m_io_latency_sampler.cancel();
+    for (auto& sampler : m_io_shard_samplers)
+        sampler->cancel();
 
     m_resolver->stop_async();
 
@@ -31,6 +31,7 @@
 #include <boost/program_options.hpp>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -60,7 +61,8 @@ template <
     bool IsKeyCache,
     class Hash,
     class KeyEqual,
-    class Mutex>
+    class Mutex,
+    bool IsPartitionLocked>
 class TaggedCache;
 class STLedgerEntry;
 using SLE = STLedgerEntry;
@@ -167,6 +169,15 @@ public:
     virtual boost::asio::io_service&
     getIOService() = 0;
 
+    /** Return the io_service a new peer or client connection runs on.
+
+        When [io_contexts] is set, connections take turns over that many
+        io_services, each run by a thread of its own. Otherwise this is
+        getIOService().
+    */
+    virtual boost::asio::io_service&
+    getConnectionIOService() = 0;
+
     virtual CollectorManager&
     getCollectorManager() = 0;
     virtual Family&
@@ -257,9 +268,14 @@ public:
     virtual RelationalDatabase&
     getRelationalDatabase() = 0;
 
+    /** The highest latency last sampled on any of the io_services. */
     virtual std::chrono::milliseconds
     getIOLatency() = 0;
 
+    /** The latency last sampled on each of the connection io_services. */
+    virtual std::vector<std::chrono::milliseconds>
+    getIOContextLatencies() = 0;
+
     virtual ReportingETL&
     getReportingETL() = 0;
 
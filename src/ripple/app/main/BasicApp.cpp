@@ -19,8 +19,34 @@
 
 #include <ripple/app/main/BasicApp.h>
 #include <ripple/beast/core/CurrentThreadName.h>
+#include <boost/predef.h>
 
-BasicApp::BasicApp(std::size_t numberOfThreads)
+#if BOOST_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Keep the thread on one core, so the sockets of its connections stay in
+// that core's cache.
+void
+pinToCore(std::thread& thread, std::size_t core)
+{
+#if BOOST_OS_LINUX
+    auto const cores = std::thread::hardware_concurrency();
+    if (cores == 0)
+        return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % cores, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#endif
+}
+
+}  // namespace
+
+BasicApp::BasicApp(std::size_t numberOfThreads, std::size_t numberOfShards)
 {
     work_.emplace(io_service_);
     threads_.reserve(numberOfThreads);
@@ -33,12 +59,36 @@ BasicApp::BasicApp(std::size_t numberOfThreads)
             this->io_service_.run();
         });
     }
+
+    shards_.reserve(numberOfShards);
+    for (std::size_t i = 0; i < numberOfShards; ++i)
+    {
+        auto& shard = *shards_.emplace_back(std::make_unique<Shard>());
+        shard.work.emplace(shard.io_service);
+        shard.thread = std::thread([&shard, i]() {
+            beast::setCurrentThreadName("io shard #" + std::to_string(i));
+            shard.io_service.run();
+        });
+        pinToCore(shard.thread, i);
+    }
 }
 
 BasicApp::~BasicApp()
 {
     work_.reset();
+    for (auto& shard : shards_)
+        shard->work.reset();
 
     for (auto& t : threads_)
         t.join();
+    for (auto& shard : shards_)
+        shard->thread.join();
+}
+
+boost::asio::io_service&
+BasicApp::next_io_service()
+{
+    if (shards_.empty())
+        return io_service_;
+    return shards_[nextShard_++ % shards_.size()]->io_service;
 }
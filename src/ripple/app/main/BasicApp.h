@@ -21,6 +21,8 @@
 #define RIPPLE_APP_BASICAPP_H_INCLUDED
 
 #include <boost/asio/io_service.hpp>
+#include <atomic>
+#include <memory>
 #include <optional>
 #include <thread>
 #include <vector>
@@ -29,12 +31,31 @@
 class BasicApp
 {
 private:
+    // An io_service run by a thread of its own
+    struct Shard
+    {
+        boost::asio::io_service io_service;
+        std::optional<boost::asio::io_service::work> work;
+        std::thread thread;
+    };
+
     std::optional<boost::asio::io_service::work> work_;
     std::vector<std::thread> threads_;
     boost::asio::io_service io_service_;
 
+    // Connections are spread over these when there are any
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<std::size_t> nextShard_{0};
+
 public:
-    BasicApp(std::size_t numberOfThreads);
+    /** Create the io_services.
+
+        @param numberOfThreads The threads which run the shared io_service.
+        @param numberOfShards The io_services for connections, each run by
+                              one thread pinned to a core. Zero runs the
+                              connections on the shared io_service.
+    */
+    BasicApp(std::size_t numberOfThreads, std::size_t numberOfShards = 0);
     ~BasicApp();
 
     boost::asio::io_service&
@@ -42,6 +63,25 @@ public:
     {
         return io_service_;
     }
+
+    /** Return the io_service a new connection runs on for its lifetime.
+
+        Successive connections take the shards in turn.
+    */
+    boost::asio::io_service&
+    next_io_service();
+
+    std::size_t
+    io_shard_count() const
+    {
+        return shards_.size();
+    }
+
+    boost::asio::io_service&
+    get_io_shard(std::size_t index)
+    {
+        return shards_[index]->io_service;
+    }
 };
 
 #endif
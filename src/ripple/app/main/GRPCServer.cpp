@@ -20,10 +20,14 @@
 #include <ripple/app/main/GRPCServer.h>
 #include <ripple/app/reporting/P2pProxy.h>
 #include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/beast/core/LexicalCast.h>
 #include <ripple/resource/Fees.h>
 
 #include <ripple/beast/net/IPAddressConversion.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace ripple {
 
 namespace {
@@ -453,6 +457,32 @@ GRPCServerImpl::GRPCServerImpl(Application& app)
             Throw<std::runtime_error>("Error setting grpc server address");
         }
 
+        if (auto const optThreads = section.get("threads"))
+        {
+            // Each queue polls on a thread of its own, so beyond a few per
+            // core more of them only contend with each other.
+            std::size_t const maxThreads =
+                4 * std::max(1u, std::thread::hardware_concurrency());
+            try
+            {
+                queueCount_ =
+                    beast::lexicalCastThrow<std::size_t>(*optThreads);
+            }
+            catch (std::exception const&)
+            {
+                queueCount_ = 0;
+            }
+
+            if (queueCount_ == 0 || queueCount_ > maxThreads)
+            {
+                JLOG(journal_.error())
+                    << "Invalid threads for grpc server: " << *optThreads
+                    << ", must be between 1 and " << maxThreads;
+                Throw<std::runtime_error>(
+                    "Invalid threads in port_grpc section");
+            }
+        }
+
         auto const optSecureGateway = section.get("secure_gateway");
         if (optSecureGateway)
         {
@@ -498,25 +528,29 @@ GRPCServerImpl::shutdown()
     // requests being processed are completed. CallData objects in the midst of
     // processing requests need to actually send data back to the client, via
     // responder_.Finish(...) or responder_.FinishWithError(...), for this call
-    // to unblock. Each cancelled listener is returned via cq_.Next(...) with ok
+    // to unblock. Each cancelled listener is returned via cq.Next(...) with ok
     // set to false
     server_->Shutdown();
     JLOG(journal_.debug()) << "Server has been shutdown";
 
-    // Always shutdown the completion queue after the server. This call allows
-    // cq_.Next() to return false, once all events posted to the completion
+    // Always shutdown the completion queues after the server. This call allows
+    // cq.Next() to return false, once all events posted to the completion
     // queue have been processed. See handleRpcs() for more details.
-    cq_->Shutdown();
-    JLOG(journal_.debug()) << "Completion Queue has been shutdown";
+    for (auto& cq : cqs_)
+        cq->Shutdown();
+    JLOG(journal_.debug()) << "Completion Queues have been shutdown";
 }
 
 void
-GRPCServerImpl::handleRpcs()
+GRPCServerImpl::handleRpcs(std::size_t queue)
 {
+    auto& cq = *cqs_[queue];
+
     // This collection should really be an unordered_set. However, to delete
-    // from the unordered_set, we need a shared_ptr, but cq_.Next() (see below
-    // while loop) sets the tag to a raw pointer.
-    std::vector<std::shared_ptr<Processor>> requests = setupListeners();
+    // from the unordered_set, we need a shared_ptr, but cq.Next() (see below
+    // while loop) sets the tag to a raw pointer. Only this thread uses it: the
+    // CallData objects listening on a queue are always returned by that queue.
+    std::vector<std::shared_ptr<Processor>> requests = setupListeners(cq);
 
     auto erase = [&requests](Processor* ptr) {
         auto it = std::find_if(
@@ -536,17 +570,17 @@ GRPCServerImpl::handleRpcs()
     // event is uniquely identified by its tag, which in this case is the
     // memory address of a CallData instance.
     // The return value of Next should always be checked. This return value
-    // tells us whether there is any kind of event or cq_ is shutting down.
-    // When cq_.Next(...) returns false, all work has been completed and the
+    // tells us whether there is any kind of event or cq is shutting down.
+    // When cq.Next(...) returns false, all work has been completed and the
     // loop can exit. When the server is shutdown, each CallData object that is
     // listening for a request is forceably cancelled, and is returned by
-    // cq_->Next() with ok set to false. Then, each CallData object processing
+    // cq.Next() with ok set to false. Then, each CallData object processing
     // a request must complete (by sending data to the client), each of which
-    // will be returned from cq_->Next() with ok set to true. After all
+    // will be returned from cq.Next() with ok set to true. After all
     // cancelled listeners and all CallData objects processing requests are
-    // returned via cq_->Next(), cq_->Next() will return false, causing the
+    // returned via cq.Next(), cq.Next() will return false, causing the
     // loop to exit.
-    while (cq_->Next(&tag, &ok))
+    while (cq.Next(&tag, &ok))
     {
         auto ptr = static_cast<Processor*>(tag);
         JLOG(journal_.trace()) << "Processing CallData object."
@@ -577,12 +611,12 @@ GRPCServerImpl::handleRpcs()
             }
         }
     }
-    JLOG(journal_.debug()) << "Completion Queue drained";
+    JLOG(journal_.debug()) << "Completion Queue " << queue << " drained";
 }
 
 // create a CallData instance for each RPC
 std::vector<std::shared_ptr<Processor>>
-GRPCServerImpl::setupListeners()
+GRPCServerImpl::setupListeners(grpc::ServerCompletionQueue& cq)
 {
     std::vector<std::shared_ptr<Processor>> requests;
 
@@ -597,7 +631,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetFee,
@@ -614,7 +648,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetAccountInfo,
@@ -631,7 +665,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetTransaction,
@@ -648,7 +682,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestSubmitTransaction,
@@ -666,7 +700,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetAccountTransactionHistory,
@@ -685,7 +719,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetLedger,
@@ -702,7 +736,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetLedgerData,
@@ -719,7 +753,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetLedgerDiff,
@@ -736,7 +770,7 @@ GRPCServerImpl::setupListeners()
 
         addToRequests(std::make_shared<cd>(
             service_,
-            *cq_,
+            cq,
             app_,
             &org::xrpl::rpc::v1::XRPLedgerAPIService::AsyncService::
                 RequestGetLedgerEntry,
@@ -764,9 +798,10 @@ GRPCServerImpl::start()
     // Register "service_" as the instance through which we'll communicate with
     // clients. In this case it corresponds to an *asynchronous* service.
     builder.RegisterService(&service_);
-    // Get hold of the completion queue used for the asynchronous communication
-    // with the gRPC runtime.
-    cq_ = builder.AddCompletionQueue();
+    // Get hold of the completion queues used for the asynchronous
+    // communication with the gRPC runtime.
+    for (std::size_t i = 0; i < queueCount_; ++i)
+        cqs_.push_back(builder.AddCompletionQueue());
     // Finally assemble the server.
     server_ = builder.BuildAndStart();
 
@@ -779,12 +814,15 @@ GRPCServer::start()
     // Start the server and setup listeners
     if (running_ = impl_.start(); running_)
     {
-        thread_ = std::thread([this]() {
-            beast::setCurrentThreadName("rippled : GRPCServer");
-            // Start the event loop and begin handling requests
-            beast::setCurrentThreadName("rippled: grpc");
-            this->impl_.handleRpcs();
-        });
+        for (std::size_t i = 0; i < impl_.queueCount(); ++i)
+        {
+            threads_.emplace_back([this, i]() {
+                // Start the event loop and begin handling requests
+                beast::setCurrentThreadName(
+                    "rippled: grpc " + std::to_string(i));
+                this->impl_.handleRpcs(i);
+            });
+        }
     }
 }
 
@@ -794,7 +832,9 @@ GRPCServer::stop()
     if (running_)
     {
         impl_.shutdown();
-        thread_.join();
+        for (auto& thread : threads_)
+            thread.join();
+        threads_.clear();
         running_ = false;
     }
 }
@@ -70,9 +70,13 @@ public:
 class GRPCServerImpl final
 {
 private:
-    // CompletionQueue returns events that have occurred, or events that have
-    // been cancelled
-    std::unique_ptr<grpc::ServerCompletionQueue> cq_;
+    // CompletionQueues return events that have occurred, or events that have
+    // been cancelled. Each is polled by a thread of its own, and has its own
+    // listeners for every RPC.
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> cqs_;
+
+    // Number of completion queues to create
+    std::size_t queueCount_ = 1;
 
     std::vector<std::shared_ptr<Processor>> requests_;
 
@@ -133,13 +137,22 @@ public:
     bool
     start();
 
-    // the main event loop
+    // the number of completion queues, each needing a thread to call
+    // handleRpcs for it
+    std::size_t
+    queueCount() const
+    {
+        return cqs_.size();
+    }
+
+    // the main event loop of one completion queue
     void
-    handleRpcs();
+    handleRpcs(std::size_t queue);
 
-    // Create a CallData object for each RPC. Return created objects in vector
+    // Create a CallData object for each RPC, listening on the given completion
+    // queue. Return created objects in vector
     std::vector<std::shared_ptr<Processor>>
-    setupListeners();
+    setupListeners(grpc::ServerCompletionQueue& cq);
 
 private:
     // Class encompasing the state and logic needed to serve a request.
@@ -315,7 +328,7 @@ public:
 
 private:
     GRPCServerImpl impl_;
-    std::thread thread_;
+    std::vector<std::thread> threads_;
     bool running_ = false;
 };
 }  // namespace ripple
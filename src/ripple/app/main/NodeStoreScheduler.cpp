@@ -26,11 +26,11 @@ NodeStoreScheduler::NodeStoreScheduler(JobQueue& jobQueue) : jobQueue_(jobQueue)
 {
 }
 
-void
+bool
 NodeStoreScheduler::scheduleTask(NodeStore::Task& task)
 {
     if (jobQueue_.isStopped())
-        return;
+        return false;
 
     if (!jobQueue_.addJob(jtWRITE, "NodeObject::store", [&task]() {
             task.performScheduledTask();
@@ -40,6 +40,7 @@ NodeStoreScheduler::scheduleTask(NodeStore::Task& task)
         // Recover by executing the task synchronously.
         task.performScheduledTask();
     }
+    return true;
 }
 
 void
@@ -51,7 +52,7 @@ NodeStoreScheduler::onFetch(NodeStore::FetchReport const& report)
     jobQueue_.addLoadEvents(
         report.fetchType == NodeStore::FetchType::async ? jtNS_ASYNC_READ
                                                         : jtNS_SYNC_READ,
-        1,
+        report.count,
         report.elapsed);
 }
 
@@ -32,7 +32,7 @@ class NodeStoreScheduler : public NodeStore::Scheduler
 public:
     explicit NodeStoreScheduler(JobQueue& jobQueue);
 
-    void
+    bool
     scheduleTask(NodeStore::Task& task) override;
     void
     onFetch(NodeStore::FetchReport const& report) override;
@@ -26,7 +26,14 @@
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/container/aged_unordered_map.h>
 
+#include <boost/container/flat_set.hpp>
+#include <boost/container/small_vector.hpp>
+
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
+#include <vector>
 
 namespace ripple {
 
@@ -49,6 +56,11 @@ namespace ripple {
     This table keeps track of which hashes have been received by which peers.
     It is used to manage the routing and broadcasting of messages in the peer
     to peer overlay.
+
+    The table is split into shards by the leading bytes of the hash, each with
+    its own lock, so that peers handling different messages do not contend.
+    Each shard ages its own entries: those which have not been touched for the
+    hold time are expired when a new entry is added to the same shard.
 */
 class HashRouter
 {
@@ -89,7 +101,10 @@ private:
         std::set<PeerShortID>
         releasePeerSet()
         {
-            return std::move(peers_);
+            std::set<PeerShortID> peers(peers_.begin(), peers_.end());
+            peers_.clear();
+            peers_.shrink_to_fit();
+            return peers;
         }
 
         /** Return seated relay time point if the message has been relayed */
@@ -127,7 +142,13 @@ private:
 
     private:
         int flags_ = 0;
-        std::set<PeerShortID> peers_;
+        // Most messages reach us from only a few peers, so their IDs are
+        // kept sorted in place rather than in a node based set.
+        boost::container::flat_set<
+            PeerShortID,
+            std::less<PeerShortID>,
+            boost::container::small_vector<PeerShortID, 4>>
+            peers_;
         // This could be generalized to a map, if more
         // than one flag needs to expire independently.
         std::optional<Stopwatch::time_point> relayed_;
@@ -143,11 +164,17 @@ public:
         return 300s;
     }
 
-    HashRouter(Stopwatch& clock, std::chrono::seconds entryHoldTimeInSeconds)
-        : suppressionMap_(clock), holdTime_(entryHoldTimeInSeconds)
+    static inline std::size_t
+    getDefaultShards()
     {
+        return 32;
     }
 
+    HashRouter(
+        Stopwatch& clock,
+        std::chrono::seconds entryHoldTimeInSeconds,
+        std::size_t shards = getDefaultShards());
+
     HashRouter&
     operator=(HashRouter const&) = delete;
 
@@ -206,19 +233,33 @@ public:
     shouldRelay(uint256 const& key);
 
 private:
-    // pair.second indicates whether the entry was created
-    std::pair<Entry&, bool>
-    emplace(uint256 const&);
-
-    std::mutex mutable mutex_;
-
-    // Stores all suppressed hashes and their expiration time
-    beast::aged_unordered_map<
+    using map_type = beast::aged_unordered_map<
         uint256,
         Entry,
         Stopwatch::clock_type,
-        hardened_hash<strong_hash>>
-        suppressionMap_;
+        hardened_hash<strong_hash>>;
+
+    struct alignas(64) Shard
+    {
+        explicit Shard(Stopwatch& clock) : suppressionMap(clock)
+        {
+        }
+
+        std::mutex mutex;
+
+        // Stores the suppressed hashes of this shard and their expiration
+        // time
+        map_type suppressionMap;
+    };
+
+    Shard&
+    shardOf(uint256 const& key) const;
+
+    // pair.second indicates whether the entry was created
+    std::pair<Entry&, bool>
+    emplace(Shard& shard, uint256 const&);
+
+    std::vector<std::unique_ptr<Shard>> shards_;
 
     std::chrono::seconds const holdTime_;
 };
@@ -32,6 +32,7 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/SHAMapStore.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/misc/ValidatorKeys.h>
@@ -599,6 +600,9 @@ public:
     void
     stateAccounting(Json::Value& obj) override;
 
+    void
+    streamCounts(Json::Value& obj) override;
+
 private:
     void
     setTimer(
@@ -756,6 +760,26 @@ private:
     };
     std::array<SubMapType, SubTypes::sLastEntry + 1> mStreamMaps;
 
+    // How much each stream has published, and how much serialization
+    // sharing each message between its subscribers has avoided.
+    struct StreamCounts
+    {
+        std::uint64_t messages = 0;
+        std::uint64_t deliveries = 0;
+        std::uint64_t serializations = 0;
+        std::chrono::nanoseconds serializeTime{0};
+    };
+    std::array<StreamCounts, SubTypes::sLastEntry + 1> mStreamCounts;
+
+    /** Send a message to every subscriber of a stream.
+
+        Subscribers that have gone away are removed.
+
+        @note called while holding mSubLock
+    */
+    void
+    pubStream(SubTypes stream, PubMessage const& msg);
+
     ServerFeeSummary mLastFeeSummary;
 
     JobQueue& m_job_queue;
@@ -1967,19 +1991,7 @@ NetworkOPsImp::pubManifest(Manifest const& mo)
             jvObj[jss::domain] = mo.domain;
         jvObj[jss::manifest] = strHex(mo.serialized);
 
-        for (auto i = mStreamMaps[sManifests].begin();
-             i != mStreamMaps[sManifests].end();)
-        {
-            if (auto p = i->second.lock())
-            {
-                p->send(jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sManifests].erase(i);
-            }
-        }
+        pubStream(sManifests, PubMessage(jvObj));
     }
 }
 
@@ -2070,24 +2082,10 @@ NetworkOPsImp::pubServer()
 
         mLastFeeSummary = f;
 
-        for (auto i = mStreamMaps[sServer].begin();
-             i != mStreamMaps[sServer].end();)
-        {
-            InfoSub::pointer p = i->second.lock();
-
-            // VFALCO TODO research the possibility of using thread queues and
-            //             linearizing the deletion of subscribers with the
-            //             sending of JSON data.
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sServer].erase(i);
-            }
-        }
+        // VFALCO TODO research the possibility of using thread queues and
+        //             linearizing the deletion of subscribers with the
+        //             sending of JSON data.
+        pubStream(sServer, PubMessage(jvObj));
     }
 }
 
@@ -2096,25 +2094,13 @@ NetworkOPsImp::pubConsensus(ConsensusPhase phase)
 {
     std::lock_guard sl(mSubLock);
 
-    auto& streamMap = mStreamMaps[sConsensusPhase];
-    if (!streamMap.empty())
+    if (!mStreamMaps[sConsensusPhase].empty())
     {
         Json::Value jvObj(Json::objectValue);
         jvObj[jss::type] = "consensusPhase";
         jvObj[jss::consensus] = to_string(phase);
 
-        for (auto i = streamMap.begin(); i != streamMap.end();)
-        {
-            if (auto p = i->second.lock())
-            {
-                p->send(jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = streamMap.erase(i);
-            }
-        }
+        pubStream(sConsensusPhase, PubMessage(jvObj));
     }
 }
 
@@ -2180,19 +2166,7 @@ NetworkOPsImp::pubValidation(std::shared_ptr<STValidation> const& val)
         if (auto const reserveInc = (*val)[~sfReserveIncrement])
             jvObj[jss::reserve_inc] = *reserveInc;
 
-        for (auto i = mStreamMaps[sValidations].begin();
-             i != mStreamMaps[sValidations].end();)
-        {
-            if (auto p = i->second.lock())
-            {
-                p->send(jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sValidations].erase(i);
-            }
-        }
+        pubStream(sValidations, PubMessage(jvObj));
     }
 }
 
@@ -2207,21 +2181,7 @@ NetworkOPsImp::pubPeerStatus(std::function<Json::Value(void)> const& func)
 
         jvObj[jss::type] = "peerStatusChange";
 
-        for (auto i = mStreamMaps[sPeerStatus].begin();
-             i != mStreamMaps[sPeerStatus].end();)
-        {
-            InfoSub::pointer p = i->second.lock();
-
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sPeerStatus].erase(i);
-            }
-        }
+        pubStream(sPeerStatus, PubMessage(jvObj));
     }
 }
 
@@ -2407,6 +2367,13 @@ NetworkOPsImp::getServerInfo(bool human, bool admin, bool counters)
     }
     info[jss::io_latency_ms] =
         static_cast<Json::UInt>(app_.getIOLatency().count());
+    if (auto const latencies = app_.getIOContextLatencies();
+        !latencies.empty())
+    {
+        auto& l = (info[jss::io_context_latency_ms] = Json::arrayValue);
+        for (auto const& latency : latencies)
+            l.append(static_cast<Json::UInt>(latency.count()));
+    }
 
     if (admin)
     {
@@ -2431,6 +2398,12 @@ NetworkOPsImp::getServerInfo(bool human, bool admin, bool counters)
         else
             app_.getNodeStore().getCountsJson(nodestore);
         info[jss::counters][jss::nodestore] = nodestore;
+
+        Json::Value onlineDelete(Json::objectValue);
+        app_.getSHAMapStore().getCountsJson(onlineDelete);
+        if (onlineDelete.size())
+            info[jss::counters][jss::online_delete] = onlineDelete;
+
         info[jss::current_activities] = app_.getPerfLog().currentJson();
     }
 
@@ -2671,22 +2644,7 @@ NetworkOPsImp::pubProposedTransaction(
 
     {
         std::lock_guard sl(mSubLock);
-
-        auto it = mStreamMaps[sRTTransactions].begin();
-        while (it != mStreamMaps[sRTTransactions].end())
-        {
-            InfoSub::pointer p = it->second.lock();
-
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++it;
-            }
-            else
-            {
-                it = mStreamMaps[sRTTransactions].erase(it);
-            }
-        }
+        pubStream(sRTTransactions, PubMessage(jvObj));
     }
 
     pubProposedAccountTransaction(ledger, transaction, result);
@@ -2702,22 +2660,7 @@ NetworkOPsImp::forwardProposedTransaction(Json::Value const& jvObj)
         return;
     {
         std::lock_guard sl(mSubLock);
-
-        auto it = mStreamMaps[sRTTransactions].begin();
-        while (it != mStreamMaps[sRTTransactions].end())
-        {
-            InfoSub::pointer p = it->second.lock();
-
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++it;
-            }
-            else
-            {
-                it = mStreamMaps[sRTTransactions].erase(it);
-            }
-        }
+        pubStream(sRTTransactions, PubMessage(jvObj));
     }
 
     forwardProposedAccountTransaction(jvObj);
@@ -2727,40 +2670,14 @@ void
 NetworkOPsImp::forwardValidation(Json::Value const& jvObj)
 {
     std::lock_guard sl(mSubLock);
-
-    for (auto i = mStreamMaps[sValidations].begin();
-         i != mStreamMaps[sValidations].end();)
-    {
-        if (auto p = i->second.lock())
-        {
-            p->send(jvObj, true);
-            ++i;
-        }
-        else
-        {
-            i = mStreamMaps[sValidations].erase(i);
-        }
-    }
+    pubStream(sValidations, PubMessage(jvObj));
 }
 
 void
 NetworkOPsImp::forwardManifest(Json::Value const& jvObj)
 {
     std::lock_guard sl(mSubLock);
-
-    for (auto i = mStreamMaps[sManifests].begin();
-         i != mStreamMaps[sManifests].end();)
-    {
-        if (auto p = i->second.lock())
-        {
-            p->send(jvObj, true);
-            ++i;
-        }
-        else
-        {
-            i = mStreamMaps[sManifests].erase(i);
-        }
-    }
+    pubStream(sManifests, PubMessage(jvObj));
 }
 
 static void
@@ -2844,8 +2761,9 @@ NetworkOPsImp::forwardProposedAccountTransaction(Json::Value const& jvObj)
 
     if (!notify.empty())
     {
+        PubMessage const msg(jvObj);
         for (InfoSub::ref isrListener : notify)
-            isrListener->send(jvObj, true);
+            isrListener->send(msg, true);
     }
 }
 
@@ -2866,6 +2784,8 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
 
     assert(alpAccepted->getLedger().get() == lpAccepted.get());
 
+    app_.getOrderBookDB().processLedger(lpAccepted, *alpAccepted);
+
     {
         JLOG(m_journal.debug())
             << "Publishing ledger " << lpAccepted->info().seq << " "
@@ -2898,36 +2818,14 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
                     app_.getLedgerMaster().getCompleteLedgers();
             }
 
-            auto it = mStreamMaps[sLedger].begin();
-            while (it != mStreamMaps[sLedger].end())
-            {
-                InfoSub::pointer p = it->second.lock();
-                if (p)
-                {
-                    p->send(jvObj, true);
-                    ++it;
-                }
-                else
-                    it = mStreamMaps[sLedger].erase(it);
-            }
+            pubStream(sLedger, PubMessage(jvObj));
         }
 
         if (!mStreamMaps[sBookChanges].empty())
         {
             Json::Value jvObj = ripple::RPC::computeBookChanges(lpAccepted);
 
-            auto it = mStreamMaps[sBookChanges].begin();
-            while (it != mStreamMaps[sBookChanges].end())
-            {
-                InfoSub::pointer p = it->second.lock();
-                if (p)
-                {
-                    p->send(jvObj, true);
-                    ++it;
-                }
-                else
-                    it = mStreamMaps[sBookChanges].erase(it);
-            }
+            pubStream(sBookChanges, PubMessage(jvObj));
         }
 
         {
@@ -3076,41 +2974,18 @@ NetworkOPsImp::pubValidatedTransaction(
         RPC::insertDeliveredAmount(jvObj[jss::meta], *ledger, stTxn, meta);
     }
 
+    // Both transaction streams and the order book subscribers receive the
+    // same text, so it is serialized at most once.
+    PubMessage const msg(jvObj);
+
     {
         std::lock_guard sl(mSubLock);
-
-        auto it = mStreamMaps[sTransactions].begin();
-        while (it != mStreamMaps[sTransactions].end())
-        {
-            InfoSub::pointer p = it->second.lock();
-
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++it;
-            }
-            else
-                it = mStreamMaps[sTransactions].erase(it);
-        }
-
-        it = mStreamMaps[sRTTransactions].begin();
-
-        while (it != mStreamMaps[sRTTransactions].end())
-        {
-            InfoSub::pointer p = it->second.lock();
-
-            if (p)
-            {
-                p->send(jvObj, true);
-                ++it;
-            }
-            else
-                it = mStreamMaps[sRTTransactions].erase(it);
-        }
+        pubStream(sTransactions, msg);
+        pubStream(sRTTransactions, msg);
     }
 
     if (transaction.getResult() == tesSUCCESS)
-        app_.getOrderBookDB().processTxn(ledger, transaction, jvObj);
+        app_.getOrderBookDB().processTxn(ledger, transaction, msg);
 
     pubAccountTransaction(ledger, transaction);
 }
@@ -3223,8 +3098,11 @@ NetworkOPsImp::pubAccountTransaction(
             RPC::insertDeliveredAmount(jvObj[jss::meta], *ledger, stTxn, meta);
         }
 
-        for (InfoSub::ref isrListener : notify)
-            isrListener->send(jvObj, true);
+        {
+            PubMessage const msg(jvObj);
+            for (InfoSub::ref isrListener : notify)
+                isrListener->send(msg, true);
+        }
 
         assert(!jvObj.isMember(jss::account_history_tx_stream));
         for (auto& info : accountHistoryNotify)
@@ -3289,8 +3167,11 @@ NetworkOPsImp::pubProposedAccountTransaction(
     {
         Json::Value jvObj = transJson(*tx, result, false, ledger);
 
-        for (InfoSub::ref isrListener : notify)
-            isrListener->send(jvObj, true);
+        {
+            PubMessage const msg(jvObj);
+            for (InfoSub::ref isrListener : notify)
+                isrListener->send(msg, true);
+        }
 
         assert(!jvObj.isMember(jss::account_history_tx_stream));
         for (auto& info : accountHistoryNotify)
@@ -4042,6 +3923,78 @@ NetworkOPsImp::stateAccounting(Json::Value& obj)
     accounting_.json(obj);
 }
 
+void
+NetworkOPsImp::pubStream(SubTypes stream, PubMessage const& msg)
+{
+    auto const shares = msg.shares();
+
+    auto& streamMap = mStreamMaps[stream];
+    for (auto i = streamMap.begin(); i != streamMap.end();)
+    {
+        if (auto p = i->second.lock())
+        {
+            p->send(msg, true);
+            ++i;
+        }
+        else
+        {
+            i = streamMap.erase(i);
+        }
+    }
+
+    auto& counts = mStreamCounts[stream];
+    ++counts.messages;
+    counts.deliveries += msg.shares() - shares;
+    if (shares == 0 && msg.shares() != 0)
+    {
+        ++counts.serializations;
+        counts.serializeTime += msg.serializeTime();
+    }
+}
+
+void
+NetworkOPsImp::streamCounts(Json::Value& obj)
+{
+    using namespace std::chrono;
+
+    static constexpr std::array<char const*, SubTypes::sLastEntry + 1>
+        names{
+            "ledger",
+            "manifests",
+            "server",
+            "transactions",
+            "transactions_proposed",
+            "validations",
+            "peer_status",
+            "consensus",
+            "book_changes"};
+
+    std::lock_guard sl(mSubLock);
+
+    Json::Value& streams = (obj[jss::streams] = Json::objectValue);
+    for (std::size_t i = 0; i < mStreamCounts.size(); ++i)
+    {
+        auto const& counts = mStreamCounts[i];
+        if (counts.messages == 0)
+            continue;
+
+        // Every delivery past the first of a message reused its text
+        // rather than serializing it again.
+        auto const serializeUs =
+            duration_cast<microseconds>(counts.serializeTime).count();
+        auto const savedUs = counts.serializations == 0
+            ? 0
+            : serializeUs * (counts.deliveries - counts.serializations) /
+                counts.serializations;
+
+        Json::Value& jv = (streams[names[i]] = Json::objectValue);
+        jv[jss::messages] = std::to_string(counts.messages);
+        jv[jss::deliveries] = std::to_string(counts.deliveries);
+        jv[jss::serialize_us] = std::to_string(serializeUs);
+        jv[jss::serialize_saved_us] = std::to_string(savedUs);
+    }
+}
+
 // <-- bool: true=erased, false=was not there
 bool
 NetworkOPsImp::unsubValidations(std::uint64_t uSeq)
@@ -272,6 +272,10 @@ public:
 
     virtual void
     stateAccounting(Json::Value& obj) = 0;
+
+    /** Add per-stream publishing statistics to a get_counts report. */
+    virtual void
+    streamCounts(Json::Value& obj) = 0;
 };
 
 //------------------------------------------------------------------------------
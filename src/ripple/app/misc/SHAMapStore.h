@@ -97,6 +97,13 @@ public:
     */
     virtual std::optional<LedgerIndex>
     minimumOnline() const = 0;
+
+    /** Add the progress of online_delete's state copy to obj.
+
+        Nothing is added unless online_delete is enabled.
+    */
+    virtual void
+    getCountsJson(Json::Value& obj) const = 0;
 };
 
 //------------------------------------------------------------------------------
@@ -23,6 +23,7 @@
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/rdb/State.h>
 #include <ripple/app/rdb/backend/SQLiteDatabase.h>
+#include <ripple/basics/scope.h>
 #include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/core/Pg.h>
@@ -140,6 +141,10 @@ SHAMapStoreImp::SHAMapStoreImp(
             ageThreshold_ = std::chrono::seconds{temp};
         if (get_if_exists(section, "recovery_wait_seconds", temp))
             recoveryWaitTime_ = std::chrono::seconds{temp};
+        if (get_if_exists(section, "copy_threads", temp))
+            copyThreads_ = std::max<std::size_t>(temp, 1);
+        if (get_if_exists(section, "copy_batch", temp))
+            copyBatch_ = std::max<std::size_t>(temp, 1);
 
         get_if_exists(section, "advisory_delete", advisoryDelete_);
 
@@ -258,22 +263,52 @@ SHAMapStoreImp::fdRequired() const
     return fdRequired_;
 }
 
-bool
-SHAMapStoreImp::copyNode(std::uint64_t& nodeCount, SHAMapTreeNode const& node)
+void
+SHAMapStoreImp::copyState(Ledger const& ledger)
 {
-    // Copy a single record from node to dbRotating_
-    dbRotating_->fetchNodeObject(
-        node.getHash().as_uint256(),
-        0,
-        NodeStore::FetchType::synchronous,
-        true);
-    if (!(++nodeCount % checkHealthInterval_))
+    copyLedger_ = ledger.info().seq;
+    copyVisited_ = 0;
+    copyCopied_ = 0;
+    copyStart_ = std::chrono::steady_clock::now();
+    copying_ = true;
+
+    scope_exit finished([this]() {
+        copyDuration_ = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - copyStart_.load());
+        copying_ = false;
+    });
+
+    // Copy a batch of records to dbRotating_, checking health every
+    // checkHealthInterval_ records across all the threads
+    std::atomic<bool> stopped{false};
+    auto copy = [&](std::vector<uint256>& batch) {
+        copyCopied_ += dbRotating_->copyToWritable(batch);
+        auto const before = copyVisited_.fetch_add(batch.size());
+        auto const after = before + batch.size();
+        batch.clear();
+        if (after / checkHealthInterval_ != before / checkHealthInterval_ &&
+            stopping())
+            stopped = true;
+        return !stopped;
+    };
+
+    std::vector<std::vector<uint256>> batches(copyThreads_);
+    for (auto& batch : batches)
+        batch.reserve(copyBatch_);
+
+    auto const map = ledger.stateMap().snapShot(false);
+    map->visitNodesParallel(
+        copyThreads_, [&](std::size_t worker, SHAMapTreeNode& node) {
+            auto& batch = batches[worker];
+            batch.push_back(node.getHash().as_uint256());
+            return batch.size() < copyBatch_ || copy(batch);
+        });
+
+    for (auto& batch : batches)
     {
-        if (stopping())
-            return false;
+        if (!stopped && !batch.empty())
+            copy(batch);
     }
-
-    return true;
 }
 
 void
@@ -363,16 +398,10 @@ SHAMapStoreImp::run()
                 return;
 
             JLOG(journal_.debug()) << "copying ledger " << validatedSeq;
-            std::uint64_t nodeCount = 0;
 
             try
             {
-                validatedLedger->stateMap().snapShot(false)->visitNodes(
-                    std::bind(
-                        &SHAMapStoreImp::copyNode,
-                        this,
-                        std::ref(nodeCount),
-                        std::placeholders::_1));
+                copyState(*validatedLedger);
             }
             catch (SHAMapMissingNode const& e)
             {
@@ -385,8 +414,10 @@ SHAMapStoreImp::run()
             if (stopping())
                 return;
             // Only log if we completed without a "health" abort
-            JLOG(journal_.debug()) << "copied ledger " << validatedSeq
-                                   << " nodecount " << nodeCount;
+            JLOG(journal_.debug())
+                << "copied ledger " << validatedSeq << " nodecount "
+                << copyVisited_.load() << " copied " << copyCopied_.load()
+                << " in " << copyDuration_.load().count() << "us";
 
             JLOG(journal_.debug()) << "freshening caches";
             freshenCaches();
@@ -722,6 +753,34 @@ SHAMapStoreImp::minimumOnline() const
     return app_.getLedgerMaster().minSqlSeq();
 }
 
+void
+SHAMapStoreImp::getCountsJson(Json::Value& obj) const
+{
+    assert(obj.isObject());
+
+    if (!deleteInterval_)
+        return;
+
+    using namespace std::chrono;
+    auto const duration = copying_
+        ? duration_cast<microseconds>(steady_clock::now() - copyStart_.load())
+        : copyDuration_.load();
+    auto const visited = copyVisited_.load();
+
+    obj["copy_running"] = copying_.load();
+    obj["copy_ledger"] = copyLedger_.load();
+    obj["copy_threads"] = static_cast<Json::UInt>(copyThreads_);
+    obj["copy_batch"] = static_cast<Json::UInt>(copyBatch_);
+    obj["copy_nodes_visited"] = std::to_string(visited);
+    obj["copy_nodes_copied"] = std::to_string(copyCopied_.load());
+    obj["copy_duration_us"] = std::to_string(duration.count());
+    if (duration.count() > 0)
+    {
+        obj["copy_nodes_per_second"] =
+            std::to_string(visited * 1000000 / duration.count());
+    }
+}
+
 //------------------------------------------------------------------------------
 
 std::unique_ptr<SHAMapStore>
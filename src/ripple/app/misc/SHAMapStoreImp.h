@@ -77,6 +77,9 @@ private:
     std::string const dbPrefix_ = "rippledb";
     // check health/stop status as records are copied
     std::uint64_t const checkHealthInterval_ = 1000;
+    // threads copying the validated state, and nodes each copies at a time
+    std::size_t copyThreads_ = 4;
+    std::size_t copyBatch_ = 256;
     // minimum # of ledgers to maintain for health of network
     static std::uint32_t const minimumDeletionInterval_ = 256;
     // minimum # of ledgers required for standalone mode.
@@ -111,6 +114,15 @@ private:
     /// See also: "recovery_wait_seconds" in rippled-example.cfg
     std::chrono::seconds recoveryWaitTime_{5};
 
+    // Progress of the current, or else the last, copy of the validated
+    // state into the writable backend
+    std::atomic<bool> copying_{false};
+    std::atomic<LedgerIndex> copyLedger_{0};
+    std::atomic<std::uint64_t> copyVisited_{0};
+    std::atomic<std::uint64_t> copyCopied_{0};
+    std::atomic<std::chrono::steady_clock::time_point> copyStart_{};
+    std::atomic<std::chrono::microseconds> copyDuration_{};
+
     // these do not exist upon SHAMapStore creation, but do exist
     // as of run() or before
     NetworkOPs* netOPs_ = nullptr;
@@ -177,10 +189,18 @@ public:
     std::optional<LedgerIndex>
     minimumOnline() const override;
 
+    void
+    getCountsJson(Json::Value& obj) const override;
+
 private:
-    // callback for visitNodes
-    bool
-    copyNode(std::uint64_t& nodeCount, SHAMapTreeNode const& node);
+    /** Copy every node of the ledger's state map into the writable backend.
+
+        The state map is walked by copyThreads_ threads, each reading and
+        writing copyBatch_ nodes at a time. Returns early, without copying
+        the rest, if stopping() returns true.
+    */
+    void
+    copyState(Ledger const& ledger);
     void
     run();
     void
@@ -53,17 +53,61 @@ PathRequests::getLineCache(
          ((lgrSeq + 8) < lineSeq)) ||  // we jumped way back for some reason
         (lgrSeq > (lineSeq + 8)))      // we jumped way forward for some reason
     {
-        JLOG(mJournal.debug())
-            << "getLineCache creating new cache for " << lgrSeq;
+        // A newer authoritative ledger not far ahead gets the cache carried
+        // forward to it, rather than one read again from nothing.
+        std::shared_ptr<RippleLineCache> next;
+        if (lineCache && authoritative && (lgrSeq > lineSeq) &&
+            (lgrSeq <= (lineSeq + 8)))
+            next = advanceLineCache(lineCache, ledger);
+
+        if (!next)
+        {
+            JLOG(mJournal.debug())
+                << "getLineCache creating new cache for " << lgrSeq;
+            next = std::make_shared<RippleLineCache>(
+                ledger, app_.journal("RippleLineCache"), lineCacheCounters_);
+            ++lineCacheCounters_->rebuilds;
+        }
+
         // Assign to the local before the member, because the member is a
         // weak_ptr, and will immediately discard it if there are no other
         // references.
-        lineCache_ = lineCache = std::make_shared<RippleLineCache>(
-            ledger, app_.journal("RippleLineCache"));
+        lineCache_ = lineCache = std::move(next);
     }
     return lineCache;
 }
 
+std::shared_ptr<RippleLineCache>
+PathRequests::advanceLineCache(
+    std::shared_ptr<RippleLineCache> cache,
+    std::shared_ptr<ReadView const> const& ledger)
+{
+    // The ledgers following the cache's, newest first
+    std::vector<std::shared_ptr<ReadView const>> ledgers{ledger};
+    while (ledgers.back()->seq() > cache->getLedger()->seq() + 1)
+    {
+        auto parent = app_.getLedgerMaster().getLedgerByHash(
+            ledgers.back()->info().parentHash);
+        if (!parent)
+            return {};
+        ledgers.push_back(std::move(parent));
+    }
+
+    for (auto it = ledgers.rbegin(); cache && it != ledgers.rend(); ++it)
+        cache = cache->advance(*it);
+    return cache;
+}
+
+void
+PathRequests::getCountsJson(Json::Value& obj) const
+{
+    auto const& counters = *lineCacheCounters_;
+    obj[jss::hits] = std::to_string(counters.hits);
+    obj[jss::loads] = std::to_string(counters.loads);
+    obj[jss::patches] = std::to_string(counters.patches);
+    obj[jss::rebuilds] = std::to_string(counters.rebuilds);
+}
+
 void
 PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
 {
@@ -303,7 +347,8 @@ PathRequests::doLegacyPathRequest(
     Json::Value const& request)
 {
     auto cache = std::make_shared<RippleLineCache>(
-        inLedger, app_.journal("RippleLineCache"));
+        inLedger, app_.journal("RippleLineCache"), lineCacheCounters_);
+    ++lineCacheCounters_->rebuilds;
 
     auto req = std::make_shared<PathRequest>(
         app_, [] {}, consumer, ++mLastIdentifier, *this, mJournal);
@@ -59,6 +59,10 @@ public:
         std::shared_ptr<ReadView const> const& ledger,
         bool authoritative);
 
+    /** Add the line cache counters to `obj`. */
+    void
+    getCountsJson(Json::Value& obj) const;
+
     // Create a new-style path request that pushes
     // updates to a subscriber
     Json::Value
@@ -102,6 +106,13 @@ private:
     void
     insertPathRequest(PathRequest::pointer const&);
 
+    // Carry a line cache forward to a later ledger, through the ledgers
+    // between them, or return nullptr if that is not possible.
+    std::shared_ptr<RippleLineCache>
+    advanceLineCache(
+        std::shared_ptr<RippleLineCache> cache,
+        std::shared_ptr<ReadView const> const& ledger);
+
     Application& app_;
     beast::Journal mJournal;
 
@@ -113,6 +124,8 @@ private:
 
     // Use a RippleLineCache
     std::weak_ptr<RippleLineCache> lineCache_;
+    std::shared_ptr<RippleLineCache::Counters> const lineCacheCounters_ =
+        std::make_shared<RippleLineCache::Counters>();
 
     std::atomic<int> mLastIdentifier;
 
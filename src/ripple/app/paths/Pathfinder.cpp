@@ -24,12 +24,18 @@
 #include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/app/paths/impl/PathfinderUtils.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/WorkerPool.h>
 #include <ripple/basics/join.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/json/to_string.h>
 #include <ripple/ledger/PaymentSandbox.h>
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <tuple>
 
 /*
@@ -156,6 +162,17 @@ smallestUsefulAmount(STAmount const& amount, int maxPaths)
 {
     return divide(amount, STAmount(maxPaths + 2), amount.issue());
 }
+
+// Candidate paths are ranked on a pool of their own, a quarter the size of
+// the machine, so that a burst of path requests can't hold up the cache
+// sweeps and ledger flushes that share the process-wide pool.
+WorkerPool&
+rankingPool()
+{
+    static WorkerPool pool(
+        std::max(1u, std::thread::hardware_concurrency() / 4));
+    return pool;
+}
 }  // namespace
 
 Pathfinder::Pathfinder(
@@ -509,21 +526,61 @@ Pathfinder::rankPaths(
         return largestAmount(mDstAmount);
     }();
 
-    for (int i = 0; i < paths.size(); ++i)
+    // The candidates are evaluated concurrently, each in a sandbox of its
+    // own over the shared read-only ledger, and ranked in their original
+    // order so the result does not depend on which finished first.
+    struct Candidate
     {
-        if (continueCallback && !continueCallback())
+        std::optional<TER> resultCode;
+        STAmount liquidity;
+        std::uint64_t uQuality = 0;
+    };
+    std::vector<Candidate> candidates(paths.size());
+    std::atomic<bool> stopped = false;
+    std::mutex callbackMutex;
+
+    rankingPool().run(paths.size(), [&](std::size_t i) {
+        if (stopped || paths[i].empty())
             return;
+
+        try
+        {
+            if (continueCallback)
+            {
+                std::lock_guard lock(callbackMutex);
+                if (!continueCallback())
+                {
+                    stopped = true;
+                    return;
+                }
+            }
+
+            auto& candidate = candidates[i];
+            candidate.resultCode = getPathLiquidity(
+                paths[i],
+                saMinDstAmount,
+                candidate.liquidity,
+                candidate.uQuality);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.info()) << "rankPaths: exception (" << e.what() << ")";
+        }
+    });
+
+    if (stopped)
+        return;
+
+    for (int i = 0; i < paths.size(); ++i)
+    {
         auto const& currentPath = paths[i];
-        if (!currentPath.empty())
+        auto const& [resultCode, liquidity, uQuality] = candidates[i];
+        if (resultCode)
         {
-            STAmount liquidity;
-            uint64_t uQuality;
-            auto const resultCode = getPathLiquidity(
-                currentPath, saMinDstAmount, liquidity, uQuality);
-            if (resultCode != tesSUCCESS)
+            if (*resultCode != tesSUCCESS)
             {
                 JLOG(j_.debug())
-                    << "findPaths: dropping : " << transToken(resultCode)
+                    << "findPaths: dropping : " << transToken(*resultCode)
                     << ": " << currentPath.getJson(JsonOptions::none);
             }
             else
@@ -20,13 +20,15 @@
 #include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/app/paths/TrustLine.h>
 #include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/STArray.h>
 
 namespace ripple {
 
 RippleLineCache::RippleLineCache(
     std::shared_ptr<ReadView const> const& ledger,
-    beast::Journal j)
-    : ledger_(ledger), journal_(j)
+    beast::Journal j,
+    std::shared_ptr<Counters> counters)
+    : ledger_(ledger), journal_(j), counters_(std::move(counters))
 {
     JLOG(journal_.debug()) << "created for ledger " << ledger_->info().seq;
 }
@@ -38,6 +40,64 @@ RippleLineCache::~RippleLineCache()
                            << totalLineCount_ << " distinct trust lines.";
 }
 
+std::shared_ptr<RippleLineCache>
+RippleLineCache::advance(std::shared_ptr<ReadView const> const& ledger)
+{
+    if (ledger_->open() || ledger->open() ||
+        ledger->info().parentHash != ledger_->info().hash)
+        return {};
+
+    // The accounts on either side of every trust line that was created,
+    // modified or deleted
+    hash_set<AccountID> changed;
+    for (auto const& [tx, meta] : ledger->txs)
+    {
+        if (!meta)
+            return {};
+
+        for (auto const& node : meta->getFieldArray(sfAffectedNodes))
+        {
+            if (node.getFieldU16(sfLedgerEntryType) != ltRIPPLE_STATE)
+                continue;
+
+            int const index = node.getFieldIndex(
+                node.getFName() == sfCreatedNode ? sfNewFields
+                                                 : sfFinalFields);
+            auto const fields = index == -1
+                ? nullptr
+                : dynamic_cast<STObject const*>(&node.peekAtIndex(index));
+            if (!fields || !fields->isFieldPresent(sfLowLimit) ||
+                !fields->isFieldPresent(sfHighLimit))
+                return {};
+
+            changed.insert(fields->getFieldAmount(sfLowLimit).getIssuer());
+            changed.insert(fields->getFieldAmount(sfHighLimit).getIssuer());
+        }
+    }
+
+    auto next = std::make_shared<RippleLineCache>(ledger, journal_, counters_);
+    // The keys carry hashes made with this cache's seed
+    next->hasher_ = hasher_;
+
+    std::lock_guard sl(mLock);
+    next->lines_.reserve(lines_.size());
+    for (auto const& [key, lines] : lines_)
+    {
+        if (changed.count(key.account_))
+            continue;
+        next->lines_.emplace(key, lines);
+        if (lines)
+            next->totalLineCount_ += lines->size();
+    }
+    ++counters_->patches;
+
+    JLOG(journal_.debug()) << "advanced to ledger " << ledger->info().seq
+                           << " keeping " << next->lines_.size() << " of "
+                           << lines_.size() << " accounts, "
+                           << changed.size() << " changed";
+    return next;
+}
+
 std::shared_ptr<std::vector<PathFindTrustLine>>
 RippleLineCache::getRippleLines(
     AccountID const& accountID,
@@ -99,6 +159,7 @@ RippleLineCache::getRippleLines(
 
     if (inserted)
     {
+        ++counters_->loads;
         assert(it->second == nullptr);
         auto lines =
             PathFindTrustLine::getItems(accountID, *ledger_, direction);
@@ -109,6 +170,10 @@ RippleLineCache::getRippleLines(
             totalLineCount_ += it->second->size();
         }
     }
+    else
+    {
+        ++counters_->hits;
+    }
 
     assert(!it->second || (it->second->size() > 0));
     auto const size = it->second ? it->second->size() : 0;
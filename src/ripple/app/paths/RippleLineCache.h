@@ -25,6 +25,7 @@
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/hardened_hash.h>
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <mutex>
@@ -36,11 +37,45 @@ namespace ripple {
 class RippleLineCache final : public CountedObject<RippleLineCache>
 {
 public:
+    /** Counts shared by a cache and the caches advanced from it. */
+    struct Counters
+    {
+        // Requests for trust lines answered from the cache
+        std::atomic<std::uint64_t> hits{0};
+        // Requests for trust lines read from the ledger
+        std::atomic<std::uint64_t> loads{0};
+        // Caches advanced to a following ledger
+        std::atomic<std::uint64_t> patches{0};
+        // Caches built from nothing
+        std::atomic<std::uint64_t> rebuilds{0};
+    };
+
     explicit RippleLineCache(
         std::shared_ptr<ReadView const> const& l,
-        beast::Journal j);
+        beast::Journal j,
+        std::shared_ptr<Counters> counters = std::make_shared<Counters>());
     ~RippleLineCache();
 
+    /** Make a cache for the ledger that follows this cache's ledger.
+
+        The new cache starts with the trust lines of every account whose
+        RippleState entries were not changed by the transactions in
+        `ledger`, as recorded in their metadata. The trust lines of the
+        other accounts are read again when they are next requested.
+
+        @param ledger A closed ledger whose parent is this cache's ledger.
+        @return The new cache, or nullptr if `ledger` does not follow this
+        cache's ledger or its metadata could not be used.
+    */
+    std::shared_ptr<RippleLineCache>
+    advance(std::shared_ptr<ReadView const> const& ledger);
+
+    Counters const&
+    counters() const
+    {
+        return *counters_;
+    }
+
     std::shared_ptr<ReadView const> const&
     getLedger() const
     {
@@ -69,6 +104,7 @@ private:
     std::shared_ptr<ReadView const> ledger_;
 
     beast::Journal journal_;
+    std::shared_ptr<Counters> counters_;
 
     struct AccountKey final : public CountedObject<AccountKey>
     {
@@ -0,0 +1,295 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_RDB_ACCOUNTTXINDEX_H_INCLUDED
+#define RIPPLE_APP_RDB_ACCOUNTTXINDEX_H_INCLUDED
+
+#include <ripple/basics/RangeSet.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/AccountID.h>
+#include <boost/filesystem.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+/** An append-only, ordered index of the transactions affecting accounts.
+
+    Each entry maps an account and a position, the sequence of a ledger and
+    the index of a transaction within it, to the transaction's ID. The
+    entries of a validated ledger arrive as one batch, which is appended to
+    a log and kept in memory. Once enough have gathered they are written,
+    sorted, to an immutable run file, and a background thread merges runs
+    so that each one is more than twice the size of all newer runs put
+    together. The transactions of an account are then one range in each of
+    a handful of runs, found with a single read.
+
+    Nothing is changed in place. Saving a ledger again adds its entries
+    again, and the newest entry for a position wins. Entries left behind
+    by an earlier save of a ledger can name a transaction which has since
+    moved, or which no longer affects the account. The ledgers saved again
+    are noted, and callers check the entries of those against the
+    transaction's metadata and skip those that differ.
+
+    An index without a directory keeps everything in memory, like the
+    databases of a standalone server.
+*/
+class AccountTxIndex
+{
+public:
+    struct Entry
+    {
+        AccountID account;
+        std::uint32_t ledgerSeq = 0;
+        std::uint32_t txnSeq = 0;
+        uint256 txID;
+    };
+
+    // Where a transaction is within the transactions of an account
+    struct Position
+    {
+        std::uint32_t ledgerSeq = 0;
+        std::uint32_t txnSeq = 0;
+    };
+
+    struct Setup
+    {
+        // Where the files are kept. Empty to keep the index in memory.
+        boost::filesystem::path dir;
+
+        // Entries kept in memory before they are written to a run
+        std::size_t memtableEntries = 256 * 1024;
+
+        // A run keeps the key of one entry in this many in memory, and
+        // reads that many at a time to find a key.
+        std::uint32_t fenceInterval = 512;
+    };
+
+    AccountTxIndex(Setup const& setup, beast::Journal journal);
+
+    ~AccountTxIndex();
+
+    AccountTxIndex(AccountTxIndex const&) = delete;
+    AccountTxIndex&
+    operator=(AccountTxIndex const&) = delete;
+
+    /** Add a batch of entries, usually those of one ledger.
+
+        The batch is durable when this returns.
+    */
+    void
+    insert(std::vector<Entry> const& entries);
+
+    /** Visit the entries of an account between two positions.
+
+        Both positions are inclusive. Entries are visited in ascending
+        order, or descending if forward is false, until the callback
+        returns false. Runs are read without holding any lock.
+    */
+    void
+    scan(
+        AccountID const& account,
+        Position const& first,
+        Position const& last,
+        bool forward,
+        std::function<bool(Entry const&)> const& f) const;
+
+    /** Forget the entries of ledgers before the given one.
+
+        They are no longer visited, and are dropped when their runs are
+        next merged.
+    */
+    void
+    deleteBefore(std::uint32_t ledgerSeq);
+
+    /** The sequence of the oldest ledger with entries, if any. */
+    std::optional<std::uint32_t>
+    minLedgerSeq() const;
+
+    /** The number of entries held, counting each saved copy. */
+    std::size_t
+    size() const;
+
+    /** The number of runs. */
+    std::size_t
+    runCount() const;
+
+    /** Write the entries in memory to a run, and wait for merging to
+        finish.
+    */
+    void
+    flush();
+
+    /** Whether the index was marked as filled, now or when last open. */
+    bool
+    imported() const;
+
+    /** Note, durably, that the index holds every entry it was to be
+        filled with when it was created.
+    */
+    void
+    markImported();
+
+    /** Note, durably, that the given ledgers were saved again.
+
+        Call this before inserting their entries again.
+    */
+    void
+    markResaved(RangeSet<std::uint32_t> const& ledgers);
+
+    /** The ledgers noted as saved again, from the oldest with entries. */
+    RangeSet<std::uint32_t>
+    resaved() const;
+
+private:
+    static constexpr std::size_t keySize = 20 + 4 + 4;
+    static constexpr std::size_t recordSize = keySize + 32;
+
+    // The account, then the ledger sequence and the transaction index in
+    // big-endian order, so that keys sort by account and position.
+    using Key = std::array<std::uint8_t, keySize>;
+
+    struct Record
+    {
+        Key key;
+        uint256 txID;
+    };
+
+    using Memtable = std::map<Key, uint256>;
+
+    class LogFile;
+    class Run;
+    class RunWriter;
+    struct Cursor;
+
+    static Key
+    makeKey(AccountID const& account, Position const& position);
+
+    static Entry
+    makeEntry(Record const& record);
+
+    static std::uint32_t
+    ledgerOf(Key const& key);
+
+    static std::uint8_t*
+    encode(Record const& record, std::uint8_t* p);
+
+    static Record
+    decode(std::uint8_t const* p);
+
+    // Merge cursors, newest first, calling f for each distinct key until
+    // it returns false. Of several copies of a key, the newest is kept.
+    static void
+    visit(
+        std::vector<Cursor>& cursors,
+        bool forward,
+        std::function<bool(Record const&)> const& f);
+
+    void
+    open();
+
+    // Write the entries in memory to a run covering the generations from
+    // first to the current one, and start the log of the next.
+    void
+    writeMemtable(std::uint64_t first);
+
+    void
+    writeFloor(std::uint32_t floor);
+
+    void
+    writeResaved(RangeSet<std::uint32_t> const& resaved);
+
+    // Write a small file in place of any with the same name
+    void
+    writeFile(
+        boost::filesystem::path const& path,
+        std::uint8_t const* data,
+        std::size_t size);
+
+    boost::filesystem::path
+    logPath(std::uint64_t generation) const;
+
+    boost::filesystem::path
+    runPath(std::uint64_t first, std::uint64_t last) const;
+
+    // The oldest of the newest runs to merge next, if a merge is due
+    std::optional<std::size_t>
+    pickMerge() const;
+
+    std::shared_ptr<Run>
+    merge(std::vector<std::shared_ptr<Run>> const& inputs, std::uint32_t floor)
+        const;
+
+    void
+    mergeLoop();
+
+    Setup const setup_;
+    beast::Journal const j_;
+
+    // Serializes writers
+    std::mutex writeMutex_;
+
+    // Protects what readers see
+    mutable std::mutex mutex_;
+    std::condition_variable mergeCond_;
+
+    Memtable memtable_;
+    std::uint32_t memtableMinLedger_;
+
+    // Entries being written to a run, still readable meanwhile
+    std::shared_ptr<Memtable const> writing_;
+    std::uint32_t writingMinLedger_;
+
+    // Oldest first
+    std::vector<std::shared_ptr<Run>> runs_;
+
+    std::uint32_t floor_ = 0;
+
+    // Ledgers saved more than once
+    RangeSet<std::uint32_t> resaved_;
+
+    std::atomic<bool> imported_{false};
+
+    // The generation of the entries in memory. Each run covers a range
+    // of generations.
+    std::uint64_t generation_ = 1;
+    std::unique_ptr<LogFile> log_;
+
+    bool merging_ = false;
+
+    // Set after a merge failed. Runs are no longer merged.
+    bool mergeFailed_ = false;
+
+    std::atomic<bool> stop_{false};
+    std::thread mergeThread_;
+};
+
+}  // namespace ripple
+
+#endif
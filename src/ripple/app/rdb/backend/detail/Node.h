@@ -22,6 +22,7 @@
 
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/misc/Manifest.h>
+#include <ripple/app/rdb/AccountTxIndex.h>
 #include <ripple/app/rdb/RelationalDatabase.h>
 #include <ripple/core/Config.h>
 #include <ripple/overlay/PeerReservationTable.h>
@@ -35,6 +36,11 @@ namespace detail {
 enum class TableType { Ledgers, Transactions, AccountTransactions };
 constexpr int TableTypeCount = 3;
 
+/* The stores of the transactions affecting each account: the account
+   transaction index and the AccountTransactions table. Either notes the
+   ledgers saved to the other alone, to catch up with. */
+enum class AccountTxStore { Index, Table };
+
 struct DatabasePairValid
 {
     std::unique_ptr<DatabaseCon> ledgerDb;
@@ -124,6 +130,9 @@ getRowsMinMax(soci::session& session, TableType type);
  * @brief saveValidatedLedger Saves ledger into database.
  * @param lgrDB Link to ledgers database.
  * @param txnDB Link to transactions database.
+ * @param accountTxIndex The account transaction index, or nullptr.
+ * @param accountTxTable True to write the AccountTransactions table, as
+ *        well as the index if there is one.
  * @param app Application object.
  * @param ledger The ledger.
  * @param current True if ledger is current.
@@ -133,6 +142,8 @@ bool
 saveValidatedLedger(
     DatabaseCon& ldgDB,
     DatabaseCon& txnDB,
+    AccountTxIndex* accountTxIndex,
+    bool accountTxTable,
     Application& app,
     std::shared_ptr<Ledger const> const& ledger,
     bool current);
@@ -446,6 +457,250 @@ newestAccountTxPage(
     int limit_used,
     std::uint32_t page_length);
 
+/**
+ * @brief importAccountTransactions Reads the AccountTransactions table a
+ *        batch of rows at a time, each batch in a read transaction of its
+ *        own, and passes them on as entries of the account transaction
+ *        index.
+ * @param session Session with the transactions database.
+ * @param insert Callback function to call on each batch. Returns false to
+ *        stop reading.
+ * @param j Journal.
+ * @return True if every row was read.
+ */
+bool
+importAccountTransactions(
+    soci::session& session,
+    std::function<bool(std::vector<AccountTxIndex::Entry>&)> const& insert,
+    beast::Journal j);
+
+/**
+ * @brief importLedgerAccountTransactions Reads the rows of the given
+ *        ledgers from the AccountTransactions table, and passes them on a
+ *        ledger at a time as entries of the account transaction index.
+ * @param session Session with the transactions database.
+ * @param ledgers Sequences of the ledgers to read.
+ * @param insert Callback function to call on the entries of each ledger.
+ *        Returns false to stop reading.
+ * @param j Journal.
+ * @return True if the rows of every ledger were read.
+ */
+bool
+importLedgerAccountTransactions(
+    soci::session& session,
+    std::vector<LedgerIndex> const& ledgers,
+    std::function<bool(std::vector<AccountTxIndex::Entry>&)> const& insert,
+    beast::Journal j);
+
+/**
+ * @brief saveLedgerAccountTransactions Rewrites the rows of a ledger in the
+ *        AccountTransactions table, in a transaction of its own, from the
+ *        metadata its transactions were saved with in the Transactions
+ *        table, as saving the ledger does.
+ * @param session Session with the transactions database.
+ * @param ledgerSeq Sequence of the ledger.
+ * @param j Journal.
+ * @return Number of rows written.
+ */
+std::size_t
+saveLedgerAccountTransactions(
+    soci::session& session,
+    LedgerIndex ledgerSeq,
+    beast::Journal j);
+
+/**
+ * @brief makeAccountTxGaps Creates the table of the ledgers the given store
+ *        lacks, unless it exists.
+ * @param session Session with the transactions database.
+ * @param store The store which lacks the ledgers.
+ */
+void
+makeAccountTxGaps(soci::session& session, AccountTxStore store);
+
+/**
+ * @brief addAccountTxGap Notes that a ledger is saved to the other store
+ *        alone, for the given store to catch up with.
+ * @param session Session with the transactions database.
+ * @param store The store which lacks the ledger.
+ * @param ledgerSeq Sequence of the ledger.
+ */
+void
+addAccountTxGap(
+    soci::session& session,
+    AccountTxStore store,
+    LedgerIndex ledgerSeq);
+
+/**
+ * @brief getAccountTxGaps Returns the ledgers the given store has to catch
+ *        up with.
+ * @param session Session with the transactions database.
+ * @param store The store which lacks the ledgers.
+ * @return Sequences of the ledgers in ascending order.
+ */
+std::vector<LedgerIndex>
+getAccountTxGaps(soci::session& session, AccountTxStore store);
+
+/**
+ * @brief deleteAccountTxGaps Forgets the ledgers the given store has to
+ *        catch up with before the given one.
+ * @param session Session with the transactions database.
+ * @param store The store which lacks the ledgers.
+ * @param ledgerSeq Ledgers with lesser sequences are forgotten.
+ */
+void
+deleteAccountTxGaps(
+    soci::session& session,
+    AccountTxStore store,
+    LedgerIndex ledgerSeq);
+
+/**
+ * @brief getOldestAccountTxs Returns oldest transactions for given
+ *        account which match given criteria starting from given offset,
+ *        found with the account transaction index.
+ * @param index The account transaction index.
+ * @param session Session with the transactions database.
+ * @param app Application object.
+ * @param ledgerMaster LedgerMaster object.
+ * @param options Struct AccountTxOptions which contain criteria to match:
+ *        the account, minimum and maximum ledger numbers to search,
+ *        offset of first entry to return, number of transactions to return,
+ *        flag if this number unlimited.
+ * @param j Journal.
+ * @return Vector of pairs of found transactions and their metadata
+ *         sorted in ascending order by account sequence.
+ */
+RelationalDatabase::AccountTxs
+getOldestAccountTxs(
+    AccountTxIndex const& index,
+    soci::session& session,
+    Application& app,
+    LedgerMaster& ledgerMaster,
+    RelationalDatabase::AccountTxOptions const& options,
+    beast::Journal j);
+
+/**
+ * @brief getNewestAccountTxs Returns newest transactions for given
+ *        account which match given criteria starting from given offset,
+ *        found with the account transaction index.
+ * @param index The account transaction index.
+ * @param session Session with the transactions database.
+ * @param app Application object.
+ * @param ledgerMaster LedgerMaster object.
+ * @param options Struct AccountTxOptions which contain criteria to match:
+ *        the account, minimum and maximum ledger numbers to search,
+ *        offset of first entry to return, number of transactions to return,
+ *        flag if this number unlimited.
+ * @param j Journal.
+ * @return Vector of pairs of found transactions and their metadata
+ *         sorted in descending order by account sequence.
+ */
+RelationalDatabase::AccountTxs
+getNewestAccountTxs(
+    AccountTxIndex const& index,
+    soci::session& session,
+    Application& app,
+    LedgerMaster& ledgerMaster,
+    RelationalDatabase::AccountTxOptions const& options,
+    beast::Journal j);
+
+/**
+ * @brief getOldestAccountTxsB Returns oldest transactions in binary form
+ *        for given account which match given criteria starting from given
+ *        offset, found with the account transaction index.
+ * @param index The account transaction index.
+ * @param session Session with the transactions database.
+ * @param options Struct AccountTxOptions which contain criteria to match:
+ *        the account, minimum and maximum ledger numbers to search,
+ *        offset of first entry to return, number of transactions to return,
+ *        flag if this number unlimited.
+ * @return Vector of tuples of found transactions, their metadata and
+ *         account sequences sorted in ascending order by account
+ *         sequence.
+ */
+std::vector<RelationalDatabase::txnMetaLedgerType>
+getOldestAccountTxsB(
+    AccountTxIndex const& index,
+    soci::session& session,
+    RelationalDatabase::AccountTxOptions const& options);
+
+/**
+ * @brief getNewestAccountTxsB Returns newest transactions in binary form
+ *        for given account which match given criteria starting from given
+ *        offset, found with the account transaction index.
+ * @param index The account transaction index.
+ * @param session Session with the transactions database.
+ * @param options Struct AccountTxOptions which contain criteria to match:
+ *        the account, minimum and maximum ledger numbers to search,
+ *        offset of first entry to return, number of transactions to return,
+ *        flag if this number unlimited.
+ * @return Vector of tuples of found transactions, their metadata and
+ *         account sequences sorted in descending order by account
+ *         sequence.
+ */
+std::vector<RelationalDatabase::txnMetaLedgerType>
+getNewestAccountTxsB(
+    AccountTxIndex const& index,
+    soci::session& session,
+    RelationalDatabase::AccountTxOptions const& options);
+
+/**
+ * @brief oldestAccountTxPage Searches oldest transactions for given
+ *        account which match given criteria starting from given marker,
+ *        found with the account transaction index, and calls callback for
+ *        each found transaction.
+ * @param index The account transaction index.
+ * @param session Session with the transactions database.
+ * @param onUnsavedLedger Callback function to call on each found unsaved
+ *        ledger within given range.
+ * @param onTransaction Callback function to call on each found transaction.
+ * @param options Struct AccountTxPageOptions which contain criteria to
+ *        match: the account, minimum and maximum ledger numbers to search,
+ *        marker of first returned entry, number of transactions to return,
+ *        flag if this number unlimited.
+ * @param page_length Total number of transactions to return.
+ * @return Marker for next search if search not finished, and number of
+ *         transactions processed during this call.
+ */
+std::pair<std::optional<RelationalDatabase::AccountTxMarker>, int>
+oldestAccountTxPage(
+    AccountTxIndex const& index,
+    soci::session& session,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    std::function<
+        void(std::uint32_t, std::string const&, Blob&&, Blob&&)> const&
+        onTransaction,
+    RelationalDatabase::AccountTxPageOptions const& options,
+    std::uint32_t page_length);
+
+/**
+ * @brief newestAccountTxPage Searches newest transactions for given
+ *        account which match given criteria starting from given marker,
+ *        found with the account transaction index, and calls callback for
+ *        each found transaction.
+ * @param index The account transaction index.
+ * @param session Session with the transactions database.
+ * @param onUnsavedLedger Callback function to call on each found unsaved
+ *        ledger within given range.
+ * @param onTransaction Callback function to call on each found transaction.
+ * @param options Struct AccountTxPageOptions which contain criteria to
+ *        match: the account, minimum and maximum ledger numbers to search,
+ *        marker of first returned entry, number of transactions to return,
+ *        flag if this number unlimited.
+ * @param page_length Total number of transactions to return.
+ * @return Marker for next search if search not finished, and number of
+ *         transactions processed during this call.
+ */
+std::pair<std::optional<RelationalDatabase::AccountTxMarker>, int>
+newestAccountTxPage(
+    AccountTxIndex const& index,
+    soci::session& session,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    std::function<
+        void(std::uint32_t, std::string const&, Blob&&, Blob&&)> const&
+        onTransaction,
+    RelationalDatabase::AccountTxPageOptions const& options,
+    std::uint32_t page_length);
+
 /**
  * @brief getTransaction Returns transaction with given hash. If not found
  *        and range given then check if all ledgers from the range are
@@ -23,6 +23,7 @@
 #include <ripple/app/ledger/PendingSaves.h>
 #include <ripple/app/ledger/TransactionMaster.h>
 #include <ripple/app/misc/Manifest.h>
+#include <ripple/app/rdb/AccountTxIndex.h>
 #include <ripple/app/rdb/RelationalDatabase.h>
 #include <ripple/app/rdb/backend/detail/Node.h>
 #include <ripple/basics/BasicConfig.h>
@@ -30,6 +31,7 @@
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/core/SociDB.h>
 #include <ripple/json/to_string.h>
+#include <ripple/protocol/TxMeta.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <soci/sqlite3/soci-sqlite3.h>
@@ -187,6 +189,8 @@ bool
 saveValidatedLedger(
     DatabaseCon& ldgDB,
     DatabaseCon& txnDB,
+    AccountTxIndex* accountTxIndex,
+    bool accountTxTable,
     Application& app,
     std::shared_ptr<Ledger const> const& ledger,
     bool current)
@@ -262,12 +266,29 @@ saveValidatedLedger(
 
         if (app.config().useTxTables())
         {
+            // The entries of the account transaction index, added once
+            // the transactions they name are committed.
+            std::vector<AccountTxIndex::Entry> indexEntries;
+
             auto db = txnDB.checkoutDb();
 
             soci::transaction tr(*db);
 
-            *db << boost::str(deleteTrans1 % seq);
-            *db << boost::str(deleteTrans2 % seq);
+            soci::statement deleteTrans =
+                (db->prepare << boost::str(deleteTrans1 % seq));
+            deleteTrans.execute(true);
+
+            // Entries of an earlier save of the ledger stay in the index,
+            // so it notes that those need checking.
+            if (accountTxIndex && deleteTrans.get_affected_rows() > 0)
+            {
+                RangeSet<std::uint32_t> resaved;
+                resaved.insert(seq);
+                accountTxIndex->markResaved(resaved);
+            }
+
+            if (accountTxTable)
+                *db << boost::str(deleteTrans2 % seq);
 
             std::string const ledgerSeq(std::to_string(seq));
 
@@ -279,11 +300,22 @@ saveValidatedLedger(
                 std::string const txnSeq(
                     std::to_string(acceptedLedgerTx->getTxnSeq()));
 
-                *db << boost::str(deleteAcctTrans % transactionID);
+                if (accountTxTable)
+                    *db << boost::str(deleteAcctTrans % transactionID);
 
                 auto const& accts = acceptedLedgerTx->getAffected();
 
-                if (!accts.empty())
+                if (accountTxIndex)
+                {
+                    for (auto const& account : accts)
+                        indexEntries.push_back(
+                            {account,
+                             seq,
+                             acceptedLedgerTx->getTxnSeq(),
+                             transactionID});
+                }
+
+                if (!accts.empty() && accountTxTable)
                 {
                     std::string sql(
                         "INSERT INTO AccountTransactions "
@@ -319,7 +351,7 @@ saveValidatedLedger(
                     *db << sql;
                 }
                 else if (auto const& sleTxn = acceptedLedgerTx->getTxn();
-                         !isPseudoTx(*sleTxn))
+                         accts.empty() && !isPseudoTx(*sleTxn))
                 {
                     // It's okay for pseudo transactions to not affect any
                     // accounts.  But otherwise...
@@ -338,6 +370,9 @@ saveValidatedLedger(
             }
 
             tr.commit();
+
+            if (accountTxIndex)
+                accountTxIndex->insert(indexEntries);
         }
 
         {
@@ -675,6 +710,29 @@ getTxHistory(
     return {txs, total};
 }
 
+/**
+ * @brief accountTxsLimit Returns the number of transactions to return for
+ *        the given criteria.
+ * @param options Struct AccountTxOptions which contains the criteria to match.
+ * @param binary True for binary form, false for decoded.
+ * @return Number of transactions.
+ */
+static std::uint32_t
+accountTxsLimit(
+    RelationalDatabase::AccountTxOptions const& options,
+    bool binary)
+{
+    constexpr std::uint32_t NONBINARY_PAGE_LENGTH = 200;
+    constexpr std::uint32_t BINARY_PAGE_LENGTH = 500;
+
+    if (options.limit == UINT32_MAX)
+        return binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH;
+    if (!options.bUnlimited)
+        return std::min(
+            binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH, options.limit);
+    return options.limit;
+}
+
 /**
  * @brief transactionsSQL Returns a SQL query for selecting the oldest or newest
  *        transactions in decoded or binary form for the account that matches
@@ -706,28 +764,9 @@ transactionsSQL(
     bool count,
     beast::Journal j)
 {
-    constexpr std::uint32_t NONBINARY_PAGE_LENGTH = 200;
-    constexpr std::uint32_t BINARY_PAGE_LENGTH = 500;
-
-    std::uint32_t numberOfResults;
-
-    if (count)
-    {
-        numberOfResults = std::numeric_limits<std::uint32_t>::max();
-    }
-    else if (options.limit == UINT32_MAX)
-    {
-        numberOfResults = binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH;
-    }
-    else if (!options.bUnlimited)
-    {
-        numberOfResults = std::min(
-            binary ? BINARY_PAGE_LENGTH : NONBINARY_PAGE_LENGTH, options.limit);
-    }
-    else
-    {
-        numberOfResults = options.limit;
-    }
+    std::uint32_t numberOfResults = count
+        ? std::numeric_limits<std::uint32_t>::max()
+        : accountTxsLimit(options, binary);
 
     if (limit_used)
     {
@@ -1286,6 +1325,780 @@ newestAccountTxPage(
         false);
 }
 
+/**
+ * @brief IndexedTx Holds a row of the Transactions table found through the
+ *        account transaction index.
+ */
+struct IndexedTx
+{
+    std::uint32_t ledgerSeq = 0;
+    std::string status;
+    Blob rawTxn;
+    Blob rawMeta;
+};
+
+/**
+ * @brief getIndexedTxs Reads the transactions named by index entries.
+ * @param session Session with the database.
+ * @param entries Entries of the account transaction index.
+ * @return Rows of the Transactions table by transaction ID. Transactions
+ *         which are not in the table are missing.
+ */
+static std::map<uint256, IndexedTx>
+getIndexedTxs(
+    soci::session& session,
+    std::vector<AccountTxIndex::Entry> const& entries)
+{
+    std::map<uint256, IndexedTx> ret;
+    if (entries.empty())
+        return ret;
+
+    std::string sql =
+        "SELECT TransID, LedgerSeq, Status, RawTxn, TxnMeta "
+        "FROM Transactions WHERE TransID IN (";
+    sql.reserve(sql.size() + entries.size() * 67);
+    for (auto const& entry : entries)
+    {
+        sql += '\'';
+        sql += to_string(entry.txID);
+        sql += "',";
+    }
+    sql.back() = ')';
+    sql += ';';
+
+    // SOCI requires boost::optional (not std::optional) as parameters.
+    boost::optional<std::string> transID;
+    boost::optional<std::uint64_t> ledgerSeq;
+    boost::optional<std::string> status;
+    soci::blob txnData(session);
+    soci::blob txnMeta(session);
+    soci::indicator dataPresent, metaPresent;
+
+    soci::statement st =
+        (session.prepare << sql,
+         soci::into(transID),
+         soci::into(ledgerSeq),
+         soci::into(status),
+         soci::into(txnData, dataPresent),
+         soci::into(txnMeta, metaPresent));
+
+    st.execute();
+    while (st.fetch())
+    {
+        uint256 id;
+        if (!transID || !id.parseHex(*transID))
+            continue;
+
+        auto& tx = ret[id];
+        tx.ledgerSeq = rangeCheckedCast<std::uint32_t>(ledgerSeq.value_or(0));
+        tx.status = status.value_or("");
+        if (dataPresent == soci::i_ok)
+            convert(txnData, tx.rawTxn);
+        if (metaPresent == soci::i_ok)
+            convert(txnMeta, tx.rawMeta);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief isCurrentEntry Checks an entry of the account transaction index
+ *        against the transaction it names. Saving a ledger again leaves the
+ *        entries of the earlier save in the index, and the transaction may
+ *        since have moved to another ledger or to another place in the
+ *        ledger, or no longer affect the account.
+ * @param entry Entry of the account transaction index.
+ * @param tx Row of the Transactions table the entry names.
+ * @param resaved True if the index noted the entry's ledger as saved
+ *        again. Only then is the transaction's metadata parsed.
+ * @return True if the entry was written by the latest save of the ledger.
+ */
+static bool
+isCurrentEntry(
+    AccountTxIndex::Entry const& entry,
+    IndexedTx const& tx,
+    bool resaved)
+{
+    if (tx.ledgerSeq != entry.ledgerSeq)
+        return false;
+
+    // Transactions saved without metadata are recovered by the caller
+    if (!resaved || tx.rawMeta.empty())
+        return true;
+
+    try
+    {
+        TxMeta const meta(entry.txID, entry.ledgerSeq, tx.rawMeta);
+        return meta.getIndex() == entry.txnSeq &&
+            meta.getAffectedAccounts().count(entry.account) != 0;
+    }
+    catch (std::exception const&)
+    {
+        // Metadata that can't be parsed can't rule the entry out either
+        return true;
+    }
+}
+
+// Most transactions read from the database by one query of an indexed scan
+static constexpr std::size_t maxIndexedTxBatch = 4096;
+
+/**
+ * @brief forEachIndexedTx Invokes the callback for each transaction of the
+ *        account between two positions, found with the account transaction
+ *        index, until the callback returns false. Entries left over from an
+ *        earlier save of a ledger saved again are skipped.
+ * @param index The account transaction index.
+ * @param session Session with the database.
+ * @param account The account.
+ * @param first First position to visit, inclusive.
+ * @param last Last position to visit, inclusive.
+ * @param forward True for ascending order, false for descending.
+ * @param batchSize Number of transactions to read at once.
+ * @param f Callback function to call on each found transaction.
+ */
+static void
+forEachIndexedTx(
+    AccountTxIndex const& index,
+    soci::session& session,
+    AccountID const& account,
+    AccountTxIndex::Position first,
+    AccountTxIndex::Position last,
+    bool forward,
+    std::size_t batchSize,
+    std::function<bool(AccountTxIndex::Entry const&, IndexedTx&)> const& f)
+{
+    constexpr auto maxSeq = std::numeric_limits<std::uint32_t>::max();
+
+    auto const resaved = index.resaved();
+
+    batchSize = std::max<std::size_t>(batchSize, 1);
+    for (;;)
+    {
+        std::vector<AccountTxIndex::Entry> entries;
+        index.scan(account, first, last, forward, [&](auto const& entry) {
+            entries.push_back(entry);
+            return entries.size() < batchSize;
+        });
+
+        auto txs = getIndexedTxs(session, entries);
+        for (auto const& entry : entries)
+        {
+            auto const tx = txs.find(entry.txID);
+            if (tx == txs.end() ||
+                !isCurrentEntry(
+                    entry,
+                    tx->second,
+                    boost::icl::contains(resaved, entry.ledgerSeq)))
+                continue;
+            if (!f(entry, tx->second))
+                return;
+        }
+
+        if (entries.size() < batchSize)
+            return;
+
+        // Carry on past the last entry read
+        auto const& back = entries.back();
+        if (forward)
+        {
+            if (back.txnSeq != maxSeq)
+                first = {back.ledgerSeq, back.txnSeq + 1};
+            else if (back.ledgerSeq != maxSeq)
+                first = {back.ledgerSeq + 1, 0};
+            else
+                return;
+        }
+        else
+        {
+            if (back.txnSeq != 0)
+                last = {back.ledgerSeq, back.txnSeq - 1};
+            else if (back.ledgerSeq != 0)
+                last = {back.ledgerSeq - 1, maxSeq};
+            else
+                return;
+        }
+    }
+}
+
+bool
+importAccountTransactions(
+    soci::session& session,
+    std::function<bool(std::vector<AccountTxIndex::Entry>&)> const& insert,
+    beast::Journal j)
+{
+    constexpr std::size_t batchSize = 64 * 1024;
+
+    // SOCI requires boost::optional (not std::optional) as parameters.
+    boost::optional<std::uint64_t> rowID;
+    boost::optional<std::string> account;
+    boost::optional<std::uint64_t> ledgerSeq;
+    boost::optional<std::uint32_t> txnSeq;
+    boost::optional<std::string> transID;
+    std::uint64_t lastRowID = 0;
+
+    std::string const sql =
+        "SELECT rowid, Account, LedgerSeq, TxnSeq, TransID "
+        "FROM AccountTransactions WHERE rowid > :last ORDER BY rowid LIMIT " +
+        std::to_string(batchSize) + ";";
+
+    soci::statement st =
+        (session.prepare << sql,
+         soci::into(rowID),
+         soci::into(account),
+         soci::into(ledgerSeq),
+         soci::into(txnSeq),
+         soci::into(transID),
+         soci::use(lastRowID));
+
+    std::vector<AccountTxIndex::Entry> batch;
+    batch.reserve(batchSize);
+    std::size_t total = 0;
+
+    for (;;)
+    {
+        // Reading a batch at a time lets the database checkpoint its log
+        // between batches.
+        std::size_t rows = 0;
+        st.execute();
+        while (st.fetch())
+        {
+            ++rows;
+            lastRowID = rowID.value_or(lastRowID);
+
+            auto const id = parseBase58<AccountID>(account.value_or(""));
+            uint256 txID;
+            if (!id || !transID || !txID.parseHex(*transID))
+                continue;
+
+            batch.push_back(
+                {*id,
+                 rangeCheckedCast<std::uint32_t>(ledgerSeq.value_or(0)),
+                 txnSeq.value_or(0),
+                 txID});
+        }
+
+        total += batch.size();
+        if (!insert(batch))
+            return false;
+        batch.clear();
+
+        if (rows < batchSize)
+            break;
+        JLOG(j.info()) << "Imported " << total << " account transactions";
+    }
+
+    JLOG(j.info()) << "Imported " << total
+                   << " account transactions into the index";
+    return true;
+}
+
+bool
+importLedgerAccountTransactions(
+    soci::session& session,
+    std::vector<LedgerIndex> const& ledgers,
+    std::function<bool(std::vector<AccountTxIndex::Entry>&)> const& insert,
+    beast::Journal j)
+{
+    // SOCI requires boost::optional (not std::optional) as parameters.
+    boost::optional<std::string> account;
+    boost::optional<std::uint32_t> txnSeq;
+    boost::optional<std::string> transID;
+    std::uint64_t ledgerSeq = 0;
+
+    soci::statement st =
+        (session.prepare << "SELECT Account, TxnSeq, TransID "
+                            "FROM AccountTransactions WHERE LedgerSeq = :seq;",
+         soci::into(account),
+         soci::into(txnSeq),
+         soci::into(transID),
+         soci::use(ledgerSeq));
+
+    std::vector<AccountTxIndex::Entry> batch;
+    std::size_t total = 0;
+
+    for (auto const seq : ledgers)
+    {
+        ledgerSeq = seq;
+        st.execute();
+        while (st.fetch())
+        {
+            auto const id = parseBase58<AccountID>(account.value_or(""));
+            uint256 txID;
+            if (!id || !transID || !txID.parseHex(*transID))
+                continue;
+
+            batch.push_back({*id, seq, txnSeq.value_or(0), txID});
+        }
+
+        total += batch.size();
+        if (!insert(batch))
+            return false;
+        batch.clear();
+    }
+
+    JLOG(j.info()) << "Imported " << total << " account transactions of "
+                   << ledgers.size() << " ledgers into the index";
+    return true;
+}
+
+std::size_t
+saveLedgerAccountTransactions(
+    soci::session& session,
+    LedgerIndex ledgerSeq,
+    beast::Journal j)
+{
+    std::string const seq = std::to_string(ledgerSeq);
+
+    soci::transaction tr(session);
+
+    std::vector<std::pair<std::string, Blob>> txs;
+    {
+        // SOCI requires boost::optional (not std::optional) as parameters.
+        boost::optional<std::string> transID;
+        soci::blob txnMeta(session);
+        soci::indicator metaPresent;
+
+        soci::statement st =
+            (session.prepare << "SELECT TransID, TxnMeta FROM Transactions "
+                                "WHERE LedgerSeq = "
+                             << ledgerSeq << ";",
+             soci::into(transID),
+             soci::into(txnMeta, metaPresent));
+
+        st.execute();
+        while (st.fetch())
+        {
+            if (!transID)
+                continue;
+            auto& tx = txs.emplace_back(*transID, Blob{});
+            if (metaPresent == soci::i_ok)
+                convert(txnMeta, tx.second);
+        }
+    }
+
+    session << "DELETE FROM AccountTransactions WHERE LedgerSeq = "
+            << ledgerSeq << ";";
+
+    std::size_t rows = 0;
+    for (auto const& [transID, rawMeta] : txs)
+    {
+        session << "DELETE FROM AccountTransactions WHERE TransID = '"
+                << transID << "';";
+
+        uint256 txID;
+        if (!txID.parseHex(transID) || rawMeta.empty())
+        {
+            JLOG(j.warn()) << "Transaction " << transID << " in ledger "
+                           << ledgerSeq << " was saved without metadata";
+            continue;
+        }
+
+        boost::container::flat_set<AccountID> accts;
+        std::uint32_t txnSeq = 0;
+        try
+        {
+            TxMeta const meta(txID, ledgerSeq, rawMeta);
+            accts = meta.getAffectedAccounts();
+            txnSeq = meta.getIndex();
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j.warn()) << "Transaction " << transID << " in ledger "
+                           << ledgerSeq << " has unusable metadata: "
+                           << e.what();
+            continue;
+        }
+
+        if (accts.empty())
+            continue;
+
+        std::string sql(
+            "INSERT INTO AccountTransactions "
+            "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
+        sql.reserve(sql.length() + (accts.size() * 128));
+        for (auto const& account : accts)
+        {
+            sql += "('";
+            sql += transID;
+            sql += "','";
+            sql += toBase58(account);
+            sql += "',";
+            sql += seq;
+            sql += ",";
+            sql += std::to_string(txnSeq);
+            sql += "),";
+        }
+        sql.back() = ';';
+        session << sql;
+        rows += accts.size();
+    }
+
+    tr.commit();
+    return rows;
+}
+
+/**
+ * @brief to_string Returns the name of the table of the ledgers a store
+ *        lacks.
+ * @param store The store which lacks the ledgers.
+ * @return Name of the table.
+ */
+static std::string
+to_string(AccountTxStore store)
+{
+    return store == AccountTxStore::Index ? "AccountTxIndexGaps"
+                                          : "AccountTxTableGaps";
+}
+
+void
+makeAccountTxGaps(soci::session& session, AccountTxStore store)
+{
+    session << "CREATE TABLE IF NOT EXISTS " << to_string(store)
+            << " (LedgerSeq BIGINT UNSIGNED PRIMARY KEY);";
+}
+
+void
+addAccountTxGap(
+    soci::session& session,
+    AccountTxStore store,
+    LedgerIndex ledgerSeq)
+{
+    session << "INSERT OR IGNORE INTO " << to_string(store) << " VALUES ("
+            << ledgerSeq << ");";
+}
+
+std::vector<LedgerIndex>
+getAccountTxGaps(soci::session& session, AccountTxStore store)
+{
+    std::vector<LedgerIndex> ledgers;
+
+    // SOCI requires boost::optional (not std::optional) as parameters.
+    boost::optional<std::uint64_t> ledgerSeq;
+    soci::statement st =
+        (session.prepare << "SELECT LedgerSeq FROM " << to_string(store)
+                         << " ORDER BY LedgerSeq;",
+         soci::into(ledgerSeq));
+    st.execute();
+    while (st.fetch())
+    {
+        if (ledgerSeq)
+            ledgers.push_back(rangeCheckedCast<LedgerIndex>(*ledgerSeq));
+    }
+    return ledgers;
+}
+
+void
+deleteAccountTxGaps(
+    soci::session& session,
+    AccountTxStore store,
+    LedgerIndex ledgerSeq)
+{
+    session << "DELETE FROM " << to_string(store) << " WHERE LedgerSeq < "
+            << ledgerSeq << ";";
+}
+
+/**
+ * @brief forEachAccountTx Invokes the callback for each transaction of the
+ *        account found with the account transaction index that matches the
+ *        given criteria, after skipping the given offset.
+ * @param index The account transaction index.
+ * @param session Session with the database.
+ * @param options Struct AccountTxOptions which contains the criteria to match.
+ * @param descending True for descending order, false for ascending.
+ * @param binary True for binary form, false for decoded.
+ * @param f Callback function to call on each found transaction.
+ */
+static void
+forEachAccountTx(
+    AccountTxIndex const& index,
+    soci::session& session,
+    RelationalDatabase::AccountTxOptions const& options,
+    bool descending,
+    bool binary,
+    std::function<void(std::uint32_t, IndexedTx&)> const& f)
+{
+    auto const limit = accountTxsLimit(options, binary);
+    if (limit == 0)
+        return;
+
+    auto offset = options.offset;
+    std::uint32_t total = 0;
+    forEachIndexedTx(
+        index,
+        session,
+        options.account,
+        {options.minLedger, 0},
+        {options.maxLedger ? options.maxLedger
+                           : std::numeric_limits<std::uint32_t>::max(),
+         std::numeric_limits<std::uint32_t>::max()},
+        !descending,
+        std::min(offset + std::size_t{limit}, maxIndexedTxBatch),
+        [&](AccountTxIndex::Entry const& entry, IndexedTx& tx) {
+            if (offset)
+            {
+                --offset;
+                return true;
+            }
+            f(entry.ledgerSeq, tx);
+            return ++total < limit;
+        });
+}
+
+/**
+ * @brief getAccountTxs Returns the oldest or newest transactions for the
+ *        account found with the account transaction index.
+ * @param index The account transaction index.
+ * @param session Session with the database.
+ * @param app Application object.
+ * @param ledgerMaster LedgerMaster object.
+ * @param options Struct AccountTxOptions which contains the criteria to match.
+ * @param descending True for descending order, false for ascending.
+ * @param j Journal.
+ * @return Vector of pairs of found transactions and their metadata.
+ */
+static RelationalDatabase::AccountTxs
+getAccountTxs(
+    AccountTxIndex const& index,
+    soci::session& session,
+    Application& app,
+    LedgerMaster& ledgerMaster,
+    RelationalDatabase::AccountTxOptions const& options,
+    bool descending,
+    beast::Journal j)
+{
+    RelationalDatabase::AccountTxs ret;
+    forEachAccountTx(
+        index,
+        session,
+        options,
+        descending,
+        false,
+        [&](std::uint32_t seq, IndexedTx& tx) {
+            auto txn = Transaction::transactionFromSQL(
+                boost::optional<std::uint64_t>(seq),
+                boost::optional<std::string>(tx.status),
+                tx.rawTxn,
+                app);
+
+            if (tx.rawMeta.empty())
+            {  // Work around a bug that could leave the metadata missing
+                JLOG(j.warn())
+                    << "Recovering ledger " << seq << ", txn " << txn->getID();
+
+                if (auto l = ledgerMaster.getLedgerBySeq(seq))
+                    pendSaveValidated(app, l, false, false);
+            }
+
+            if (txn)
+                ret.emplace_back(
+                    txn,
+                    std::make_shared<TxMeta>(
+                        txn->getID(), txn->getLedger(), tx.rawMeta));
+        });
+    return ret;
+}
+
+RelationalDatabase::AccountTxs
+getOldestAccountTxs(
+    AccountTxIndex const& index,
+    soci::session& session,
+    Application& app,
+    LedgerMaster& ledgerMaster,
+    RelationalDatabase::AccountTxOptions const& options,
+    beast::Journal j)
+{
+    return getAccountTxs(
+        index, session, app, ledgerMaster, options, false, j);
+}
+
+RelationalDatabase::AccountTxs
+getNewestAccountTxs(
+    AccountTxIndex const& index,
+    soci::session& session,
+    Application& app,
+    LedgerMaster& ledgerMaster,
+    RelationalDatabase::AccountTxOptions const& options,
+    beast::Journal j)
+{
+    return getAccountTxs(index, session, app, ledgerMaster, options, true, j);
+}
+
+/**
+ * @brief getAccountTxsB Returns the oldest or newest transactions in binary
+ *        form for the account found with the account transaction index.
+ * @param index The account transaction index.
+ * @param session Session with the database.
+ * @param options Struct AccountTxOptions which contains the criteria to match.
+ * @param descending True for descending order, false for ascending.
+ * @return Vector of tuples each containing the found transactions, their
+ *         metadata, and their account sequences.
+ */
+static std::vector<RelationalDatabase::txnMetaLedgerType>
+getAccountTxsB(
+    AccountTxIndex const& index,
+    soci::session& session,
+    RelationalDatabase::AccountTxOptions const& options,
+    bool descending)
+{
+    std::vector<RelationalDatabase::txnMetaLedgerType> ret;
+    forEachAccountTx(
+        index,
+        session,
+        options,
+        descending,
+        true,
+        [&](std::uint32_t seq, IndexedTx& tx) {
+            ret.emplace_back(std::move(tx.rawTxn), std::move(tx.rawMeta), seq);
+        });
+    return ret;
+}
+
+std::vector<RelationalDatabase::txnMetaLedgerType>
+getOldestAccountTxsB(
+    AccountTxIndex const& index,
+    soci::session& session,
+    RelationalDatabase::AccountTxOptions const& options)
+{
+    return getAccountTxsB(index, session, options, false);
+}
+
+std::vector<RelationalDatabase::txnMetaLedgerType>
+getNewestAccountTxsB(
+    AccountTxIndex const& index,
+    soci::session& session,
+    RelationalDatabase::AccountTxOptions const& options)
+{
+    return getAccountTxsB(index, session, options, true);
+}
+
+/**
+ * @brief accountTxPage Searches for the oldest or newest transactions for the
+ *        account that matches the given criteria starting from the provided
+ *        marker with the account transaction index, and invokes the callback
+ *        parameter for each found transaction.
+ * @param index The account transaction index.
+ * @param session Session with the database.
+ * @param onUnsavedLedger Callback function to call on each found unsaved
+ *        ledger within the given range.
+ * @param onTransaction Callback function to call on each found transaction.
+ * @param options Struct AccountTxPageOptions which contains the criteria to
+ *        match: the account, the ledger search range, the marker of the first
+ *        returned entry, the number of transactions to return, and a flag if
+ *        this number unlimited.
+ * @param page_length Total number of transactions to return.
+ * @param forward True for ascending order, false for descending.
+ * @return A marker for the next search if the search was not finished and
+ *         the number of transactions processed during this call.
+ */
+static std::pair<std::optional<RelationalDatabase::AccountTxMarker>, int>
+accountTxPage(
+    AccountTxIndex const& index,
+    soci::session& session,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    std::function<
+        void(std::uint32_t, std::string const&, Blob&&, Blob&&)> const&
+        onTransaction,
+    RelationalDatabase::AccountTxPageOptions const& options,
+    std::uint32_t page_length,
+    bool forward)
+{
+    std::uint32_t numberOfResults;
+
+    if (options.limit == 0 || options.limit == UINT32_MAX ||
+        (options.limit > page_length && !options.bAdmin))
+        numberOfResults = page_length;
+    else
+        numberOfResults = options.limit;
+
+    AccountTxIndex::Position first{options.minLedger, 0};
+    AccountTxIndex::Position last{
+        options.maxLedger, std::numeric_limits<std::uint32_t>::max()};
+    if (options.marker)
+    {
+        // The marker is the first entry of this page
+        AccountTxIndex::Position const marker{
+            options.marker->ledgerSeq, options.marker->txnSeq};
+        (forward ? first : last) = marker;
+    }
+
+    // We read one more than the limit. If it is there, we return it as the
+    // marker for a subsequent query.
+    int total = 0;
+    std::optional<RelationalDatabase::AccountTxMarker> newmarker;
+    forEachIndexedTx(
+        index,
+        session,
+        options.account,
+        first,
+        last,
+        forward,
+        std::min(std::size_t{numberOfResults} + 1, maxIndexedTxBatch),
+        [&](AccountTxIndex::Entry const& entry, IndexedTx& tx) {
+            if (numberOfResults == 0)
+            {
+                newmarker = {entry.ledgerSeq, entry.txnSeq};
+                return false;
+            }
+
+            // Work around a bug that could leave the metadata missing
+            if (tx.rawMeta.empty())
+                onUnsavedLedger(entry.ledgerSeq);
+
+            onTransaction(
+                entry.ledgerSeq,
+                tx.status,
+                std::move(tx.rawTxn),
+                std::move(tx.rawMeta));
+            --numberOfResults;
+            ++total;
+            return true;
+        });
+
+    return {newmarker, total};
+}
+
+std::pair<std::optional<RelationalDatabase::AccountTxMarker>, int>
+oldestAccountTxPage(
+    AccountTxIndex const& index,
+    soci::session& session,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    std::function<
+        void(std::uint32_t, std::string const&, Blob&&, Blob&&)> const&
+        onTransaction,
+    RelationalDatabase::AccountTxPageOptions const& options,
+    std::uint32_t page_length)
+{
+    return accountTxPage(
+        index,
+        session,
+        onUnsavedLedger,
+        onTransaction,
+        options,
+        page_length,
+        true);
+}
+
+std::pair<std::optional<RelationalDatabase::AccountTxMarker>, int>
+newestAccountTxPage(
+    AccountTxIndex const& index,
+    soci::session& session,
+    std::function<void(std::uint32_t)> const& onUnsavedLedger,
+    std::function<
+        void(std::uint32_t, std::string const&, Blob&&, Blob&&)> const&
+        onTransaction,
+    RelationalDatabase::AccountTxPageOptions const& options,
+    std::uint32_t page_length)
+{
+    return accountTxPage(
+        index,
+        session,
+        onUnsavedLedger,
+        onTransaction,
+        options,
+        page_length,
+        false);
+}
+
 std::variant<RelationalDatabase::AccountTx, TxSearched>
 getTransaction(
     soci::session& session,
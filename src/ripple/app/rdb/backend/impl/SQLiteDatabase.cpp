@@ -21,18 +21,26 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/TransactionMaster.h>
+#include <ripple/app/main/DBInit.h>
 #include <ripple/app/misc/Manifest.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
+#include <ripple/app/rdb/AccountTxIndex.h>
 #include <ripple/app/rdb/backend/SQLiteDatabase.h>
 #include <ripple/app/rdb/backend/detail/Node.h>
 #include <ripple/app/rdb/backend/detail/Shard.h>
 #include <ripple/basics/BasicConfig.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/basics/scope.h>
+#include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/core/SociDB.h>
 #include <ripple/json/to_string.h>
 #include <ripple/nodestore/DatabaseShard.h>
 #include <soci/sqlite3/soci-sqlite3.h>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
 
 namespace ripple {
 
@@ -60,6 +68,15 @@ public:
             Throw<std::runtime_error>(error.data());
         }
 
+        if (useTxTables_ && existsTransaction())
+        {
+            if (config.useAccountTxIndex())
+                makeAccountTxIndex(setup, true);
+            else if (auto const dir = accountTxIndexDir(setup);
+                     !dir.empty() && boost::filesystem::exists(dir))
+                makeAccountTxIndex(setup, false);
+        }
+
         if (app.getShardStore() &&
             !makeMetaDBs(
                 config,
@@ -74,6 +91,11 @@ public:
         }
     }
 
+    ~SQLiteDatabaseImp() override
+    {
+        stopImport();
+    }
+
     std::optional<LedgerIndex>
     getMinLedgerSeq() override;
 
@@ -197,6 +219,33 @@ private:
     std::unique_ptr<DatabaseCon> lgrdb_, txdb_;
     std::unique_ptr<DatabaseCon> lgrMetaDB_, txMetaDB_;
 
+    // Used instead of the AccountTransactions table, if configured
+    std::unique_ptr<AccountTxIndex> accountTxIndex_;
+
+    // Set while queries use the index: once it holds every row of the
+    // AccountTransactions table, or, if it is no longer configured, until
+    // the table holds every ledger of the index. Unless the index is no
+    // longer configured, ledgers are saved to it alone while set.
+    std::atomic<bool> accountTxIndexReady_{false};
+
+    // Fills one store from the other in the background
+    std::thread importThread_;
+    std::atomic<bool> stopImport_{false};
+
+    // Set when the index is no longer configured, but kept open until the
+    // table catches up with it. Ledgers are saved to both meanwhile.
+    bool keepAccountTxTable_ = false;
+
+    // Set when an index was used before but is not now. The ledgers saved
+    // are noted, for the index to catch up with when used again.
+    bool recordIndexGaps_ = false;
+
+    // Ledgers saved while the import runs. Rows the import reads for them
+    // may be older than those already saved, so it skips them.
+    std::mutex importMutex_;
+    bool importing_ = false;
+    std::set<LedgerIndex> savedDuringImport_;
+
     /**
      * @brief makeLedgerDBs Opens ledger and transaction databases for the node
      *        store, and stores their descriptors in private member variables.
@@ -211,6 +260,81 @@ private:
         DatabaseCon::Setup const& setup,
         DatabaseCon::CheckpointerSetup const& checkpointerSetup);
 
+    /**
+     * @brief accountTxIndexDir Returns the directory of the account
+     *        transaction index.
+     * @param setup Path to the databases and other opening parameters.
+     * @return The directory, or an empty path if the databases are
+     *         temporary and the index is kept in memory.
+     */
+    static boost::filesystem::path
+    accountTxIndexDir(DatabaseCon::Setup const& setup);
+
+    /**
+     * @brief makeAccountTxIndex Opens the account transaction index next to
+     *        the transaction database, and starts whichever of it and the
+     *        AccountTransactions table lacks ledgers catching up with the
+     *        other in the background. Queries use the one which does not
+     *        meanwhile. If neither holds every ledger, the table catches up
+     *        first, before the server starts.
+     * @param setup Path to the databases and other opening parameters.
+     * @param configured True if the index is to be used. Otherwise it is
+     *        only kept open until the table holds every ledger it does.
+     */
+    void
+    makeAccountTxIndex(DatabaseCon::Setup const& setup, bool configured);
+
+    /**
+     * @brief importAccountTxIndex Fills the account transaction index from
+     *        the AccountTransactions table, read through a session of its
+     *        own, and marks it ready for queries. An index filled before
+     *        only reads the rows of the ledgers it lacks.
+     * @param dbPath Path to the transaction database.
+     * @param gaps Ledgers saved to the table alone while the index was not
+     *        used, in ascending order.
+     */
+    void
+    importAccountTxIndex(
+        boost::filesystem::path const& dbPath,
+        std::vector<LedgerIndex> const& gaps);
+
+    /**
+     * @brief fillAccountTxTable Adds the ledgers saved to the account
+     *        transaction index alone to the AccountTransactions table, from
+     *        the metadata of their transactions.
+     * @param gaps Ledgers saved to the index alone, in ascending order.
+     * @return True if every ledger was added, false if stopped.
+     */
+    bool
+    fillAccountTxTable(std::vector<LedgerIndex> const& gaps);
+
+    /**
+     * @brief startImport Runs one store catching up with the other on the
+     *        import thread, noting the ledgers saved meanwhile.
+     * @param work The function to run.
+     */
+    void
+    startImport(std::function<void()> work);
+
+    /**
+     * @brief stopImport Stops filling the account transaction index, and
+     *        waits for the import thread to exit.
+     */
+    void
+    stopImport();
+
+    /**
+     * @brief useAccountTxIndex Checks if queries use the account
+     *        transaction index.
+     * @return True if the index exists and holds every ledger the
+     *         AccountTransactions table does.
+     */
+    bool
+    useAccountTxIndex() const
+    {
+        return accountTxIndex_ && accountTxIndexReady_;
+    }
+
     /**
      * @brief makeMetaDBs Opens shard index lookup databases, and stores
      *        their descriptors in private member variables.
@@ -453,6 +577,237 @@ SQLiteDatabaseImp::makeLedgerDBs(
     return res;
 }
 
+boost::filesystem::path
+SQLiteDatabaseImp::accountTxIndexDir(DatabaseCon::Setup const& setup)
+{
+    // Keep the index in memory whenever the databases are temporary
+    if (setup.standAlone && !setup.reporting &&
+        setup.startUp != Config::LOAD && setup.startUp != Config::LOAD_FILE &&
+        setup.startUp != Config::REPLAY)
+        return {};
+    return setup.dataDir / "account_tx_index";
+}
+
+void
+SQLiteDatabaseImp::makeAccountTxIndex(
+    DatabaseCon::Setup const& setup,
+    bool configured)
+{
+    using detail::AccountTxStore;
+
+    std::vector<LedgerIndex> gaps, tableGaps;
+    {
+        auto db = checkoutTransaction();
+        detail::makeAccountTxGaps(*db, AccountTxStore::Index);
+        detail::makeAccountTxGaps(*db, AccountTxStore::Table);
+        gaps = detail::getAccountTxGaps(*db, AccountTxStore::Index);
+        tableGaps = detail::getAccountTxGaps(*db, AccountTxStore::Table);
+    }
+
+    if (!configured && tableGaps.empty())
+    {
+        JLOG(j_.warn()) << "The account transaction index is not used. It "
+                           "catches up with the ledgers saved meanwhile "
+                           "when next used.";
+        recordIndexGaps_ = true;
+        return;
+    }
+
+    AccountTxIndex::Setup indexSetup;
+    indexSetup.dir = accountTxIndexDir(setup);
+
+    accountTxIndex_ = std::make_unique<AccountTxIndex>(
+        indexSetup, app_.journal("AccountTxIndex"));
+
+    // Temporary databases start out empty
+    if (indexSetup.dir.empty())
+        accountTxIndex_->markImported();
+
+    bool const complete = accountTxIndex_->imported() && gaps.empty();
+    if (!tableGaps.empty() && !complete)
+    {
+        JLOG(j_.warn()) << "Adding the " << tableGaps.size()
+                        << " ledgers saved to the account transaction "
+                           "index alone to the AccountTransactions table, "
+                           "which the index can't serve queries for.";
+        fillAccountTxTable(tableGaps);
+        tableGaps.clear();
+    }
+
+    if (!configured)
+    {
+        if (tableGaps.empty())
+        {
+            accountTxIndex_.reset();
+            recordIndexGaps_ = true;
+            return;
+        }
+
+        JLOG(j_.warn()) << "Adding the " << tableGaps.size()
+                        << " ledgers saved to the account transaction "
+                           "index alone to the AccountTransactions table in "
+                           "the background. The index is used until it is "
+                           "done.";
+        keepAccountTxTable_ = true;
+        accountTxIndexReady_ = true;
+        startImport([this, tableGaps = std::move(tableGaps)] {
+            try
+            {
+                if (!fillAccountTxTable(tableGaps))
+                    return;
+                accountTxIndexReady_ = false;
+                JLOG(j_.info()) << "The AccountTransactions table is ready";
+            }
+            catch (std::exception const& e)
+            {
+                JLOG(j_.error())
+                    << "Unable to fill the AccountTransactions table: "
+                    << e.what();
+            }
+        });
+        return;
+    }
+
+    if (complete)
+    {
+        accountTxIndexReady_ = true;
+        return;
+    }
+
+    // The table holds every ledger, so it serves queries meanwhile
+    if (accountTxIndex_->imported())
+    {
+        JLOG(j_.info()) << "Adding the " << gaps.size()
+                        << " ledgers saved while the account transaction "
+                           "index was not used to it in the background. "
+                           "The AccountTransactions table is used until it "
+                           "is done.";
+    }
+    else
+    {
+        JLOG(j_.info()) << "Filling the account transaction index in the "
+                           "background. The AccountTransactions table is "
+                           "used until it is done.";
+    }
+
+    startImport(
+        [this, dbPath = setup.dataDir / TxDBName, gaps = std::move(gaps)] {
+            importAccountTxIndex(dbPath, gaps);
+        });
+}
+
+void
+SQLiteDatabaseImp::importAccountTxIndex(
+    boost::filesystem::path const& dbPath,
+    std::vector<LedgerIndex> const& gaps)
+{
+    try
+    {
+        soci::session session;
+        open(session, "sqlite", dbPath.string());
+
+        auto const insert = [this](std::vector<AccountTxIndex::Entry>& batch) {
+            if (stopImport_)
+                return false;
+
+            std::lock_guard lock(importMutex_);
+            std::erase_if(batch, [this](auto const& entry) {
+                return savedDuringImport_.count(entry.ledgerSeq) != 0;
+            });
+            accountTxIndex_->insert(batch);
+            return true;
+        };
+
+        bool const catchUp = accountTxIndex_->imported();
+        if (catchUp)
+        {
+            // The index may hold entries of an earlier save of these
+            RangeSet<std::uint32_t> resaved;
+            for (auto const seq : gaps)
+                resaved.insert(seq);
+            accountTxIndex_->markResaved(resaved);
+        }
+
+        auto const done = catchUp
+            ? detail::importLedgerAccountTransactions(session, gaps, insert, j_)
+            : detail::importAccountTransactions(session, insert, j_);
+        if (!done)
+            return;
+
+        // The entries added are durable, so the ledgers are not needed
+        if (!gaps.empty())
+            detail::deleteAccountTxGaps(
+                session, detail::AccountTxStore::Index, gaps.back() + 1);
+
+        if (!catchUp)
+            accountTxIndex_->markImported();
+        accountTxIndexReady_ = true;
+        JLOG(j_.info()) << "The account transaction index is ready";
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j_.error()) << "Unable to fill the account transaction index: "
+                         << e.what();
+    }
+}
+
+bool
+SQLiteDatabaseImp::fillAccountTxTable(std::vector<LedgerIndex> const& gaps)
+{
+    std::size_t rows = 0;
+    for (auto const seq : gaps)
+    {
+        if (stopImport_)
+            return false;
+
+        // A ledger saved meanwhile is in the table already
+        std::lock_guard lock(importMutex_);
+        if (savedDuringImport_.count(seq) == 0)
+            rows += detail::saveLedgerAccountTransactions(
+                *checkoutTransaction(), seq, j_);
+    }
+
+    if (!gaps.empty())
+        detail::deleteAccountTxGaps(
+            *checkoutTransaction(),
+            detail::AccountTxStore::Table,
+            gaps.back() + 1);
+
+    JLOG(j_.info()) << "Added " << rows << " account transactions of "
+                    << gaps.size()
+                    << " ledgers to the AccountTransactions table";
+    return true;
+}
+
+void
+SQLiteDatabaseImp::startImport(std::function<void()> work)
+{
+    {
+        std::lock_guard lock(importMutex_);
+        importing_ = true;
+    }
+    importThread_ = std::thread([this, work = std::move(work)] {
+        beast::setCurrentThreadName("AccountTxImport");
+
+        // However the import ends, stop recording the ledgers saved
+        // meanwhile
+        scope_exit finished([this] {
+            std::lock_guard lock(importMutex_);
+            importing_ = false;
+            savedDuringImport_.clear();
+        });
+        work();
+    });
+}
+
+void
+SQLiteDatabaseImp::stopImport()
+{
+    stopImport_ = true;
+    if (importThread_.joinable())
+        importThread_.join();
+}
+
 bool
 SQLiteDatabaseImp::makeMetaDBs(
     Config const& config,
@@ -528,6 +883,9 @@ SQLiteDatabaseImp::getAccountTransactionsMinLedgerSeq()
     if (!useTxTables_)
         return {};
 
+    if (useAccountTxIndex())
+        return accountTxIndex_->minLedgerSeq();
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
@@ -654,11 +1012,23 @@ SQLiteDatabaseImp::deleteAccountTransactionsBeforeLedgerSeq(
     if (!useTxTables_)
         return;
 
+    // Rows written before the index was used are still deleted from the
+    // table below.
+    if (accountTxIndex_)
+        accountTxIndex_->deleteBefore(ledgerSeq);
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
         detail::deleteBeforeLedgerSeq(
             *db, detail::TableType::AccountTransactions, ledgerSeq);
+        if (accountTxIndex_ || recordIndexGaps_)
+        {
+            detail::deleteAccountTxGaps(
+                *db, detail::AccountTxStore::Index, ledgerSeq);
+            detail::deleteAccountTxGaps(
+                *db, detail::AccountTxStore::Table, ledgerSeq);
+        }
         return;
     }
 
@@ -707,6 +1077,9 @@ SQLiteDatabaseImp::getAccountTransactionCount()
     if (!useTxTables_)
         return 0;
 
+    if (useAccountTxIndex())
+        return accountTxIndex_->size();
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
@@ -766,8 +1139,40 @@ SQLiteDatabaseImp::saveValidatedLedger(
 {
     if (existsLedger())
     {
+        // While either store catches up, ledgers go to both
+        bool const indexOnly = useAccountTxIndex() && !keepAccountTxTable_;
+        if (accountTxIndex_)
+        {
+            {
+                std::lock_guard lock(importMutex_);
+                if (importing_)
+                    savedDuringImport_.insert(ledger->info().seq);
+            }
+
+            // Noted first, so that a ledger is never in one store alone
+            // without being noted
+            if (indexOnly)
+                detail::addAccountTxGap(
+                    *checkoutTransaction(),
+                    detail::AccountTxStore::Table,
+                    ledger->info().seq);
+        }
+        else if (recordIndexGaps_)
+        {
+            detail::addAccountTxGap(
+                *checkoutTransaction(),
+                detail::AccountTxStore::Index,
+                ledger->info().seq);
+        }
+
         if (!detail::saveValidatedLedger(
-                *lgrdb_, *txdb_, app_, ledger, current))
+                *lgrdb_,
+                *txdb_,
+                accountTxIndex_.get(),
+                !indexOnly,
+                app_,
+                ledger,
+                current))
             return false;
     }
 
@@ -1089,6 +1494,13 @@ SQLiteDatabaseImp::getOldestAccountTxs(AccountTxOptions const& options)
 
     LedgerMaster& ledgerMaster = app_.getLedgerMaster();
 
+    if (useAccountTxIndex())
+    {
+        auto db = checkoutTransaction();
+        return detail::getOldestAccountTxs(
+            *accountTxIndex_, *db, app_, ledgerMaster, options, j_);
+    }
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
@@ -1149,6 +1561,13 @@ SQLiteDatabaseImp::getNewestAccountTxs(AccountTxOptions const& options)
 
     LedgerMaster& ledgerMaster = app_.getLedgerMaster();
 
+    if (useAccountTxIndex())
+    {
+        auto db = checkoutTransaction();
+        return detail::getNewestAccountTxs(
+            *accountTxIndex_, *db, app_, ledgerMaster, options, j_);
+    }
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
@@ -1207,6 +1626,12 @@ SQLiteDatabaseImp::getOldestAccountTxsB(AccountTxOptions const& options)
     if (!useTxTables_)
         return {};
 
+    if (useAccountTxIndex())
+    {
+        auto db = checkoutTransaction();
+        return detail::getOldestAccountTxsB(*accountTxIndex_, *db, options);
+    }
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
@@ -1263,6 +1688,12 @@ SQLiteDatabaseImp::getNewestAccountTxsB(AccountTxOptions const& options)
     if (!useTxTables_)
         return {};
 
+    if (useAccountTxIndex())
+    {
+        auto db = checkoutTransaction();
+        return detail::getNewestAccountTxsB(*accountTxIndex_, *db, options);
+    }
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
@@ -1334,6 +1765,20 @@ SQLiteDatabaseImp::oldestAccountTxPage(AccountTxPageOptions const& options)
         convertBlobsToTxResult(ret, ledger_index, status, rawTxn, rawMeta, app);
     };
 
+    if (useAccountTxIndex())
+    {
+        auto db = checkoutTransaction();
+        auto newmarker = detail::oldestAccountTxPage(
+                             *accountTxIndex_,
+                             *db,
+                             onUnsavedLedger,
+                             onTransaction,
+                             options,
+                             page_length)
+                             .first;
+        return {ret, newmarker};
+    }
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
@@ -1396,6 +1841,20 @@ SQLiteDatabaseImp::newestAccountTxPage(AccountTxPageOptions const& options)
         convertBlobsToTxResult(ret, ledger_index, status, rawTxn, rawMeta, app);
     };
 
+    if (useAccountTxIndex())
+    {
+        auto db = checkoutTransaction();
+        auto newmarker = detail::newestAccountTxPage(
+                             *accountTxIndex_,
+                             *db,
+                             onUnsavedLedger,
+                             onTransaction,
+                             options,
+                             page_length)
+                             .first;
+        return {ret, newmarker};
+    }
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
@@ -1457,6 +1916,20 @@ SQLiteDatabaseImp::oldestAccountTxPageB(AccountTxPageOptions const& options)
         ret.emplace_back(std::move(rawTxn), std::move(rawMeta), ledgerIndex);
     };
 
+    if (useAccountTxIndex())
+    {
+        auto db = checkoutTransaction();
+        auto newmarker = detail::oldestAccountTxPage(
+                             *accountTxIndex_,
+                             *db,
+                             onUnsavedLedger,
+                             onTransaction,
+                             options,
+                             page_length)
+                             .first;
+        return {ret, newmarker};
+    }
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
@@ -1518,6 +1991,20 @@ SQLiteDatabaseImp::newestAccountTxPageB(AccountTxPageOptions const& options)
         ret.emplace_back(std::move(rawTxn), std::move(rawMeta), ledgerIndex);
     };
 
+    if (useAccountTxIndex())
+    {
+        auto db = checkoutTransaction();
+        auto newmarker = detail::newestAccountTxPage(
+                             *accountTxIndex_,
+                             *db,
+                             onUnsavedLedger,
+                             onTransaction,
+                             options,
+                             page_length)
+                             .first;
+        return {ret, newmarker};
+    }
+
     if (existsTransaction())
     {
         auto db = checkoutTransaction();
@@ -1729,6 +2216,8 @@ SQLiteDatabaseImp::closeLedgerDB()
 void
 SQLiteDatabaseImp::closeTransactionDB()
 {
+    stopImport();
+    accountTxIndex_.reset();
     txdb_.reset();
 }
 
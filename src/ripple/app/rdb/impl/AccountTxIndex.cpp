@@ -0,0 +1,1229 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/rdb/AccountTxIndex.h>
+#include <ripple/basics/Log.h>
+#include <ripple/basics/contract.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/beast/hash/xxhasher.h>
+#include <nudb/native_file.hpp>
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+namespace ripple {
+
+namespace {
+
+/*  A run file is a header, the records sorted by key, and then the key of
+    every fenceInterval'th record:
+
+        8 bytes     magic
+        4 bytes     version
+        4 bytes     fence interval
+        8 bytes     record count
+        4 bytes     lowest ledger sequence
+        4 bytes     highest ledger sequence
+
+    A log file is a series of frames, each a batch as it was inserted:
+
+        4 bytes     record count
+        8 bytes     xxhash of the records
+        ...         records
+
+    Integers are big-endian. A record is a key followed by a transaction ID.
+*/
+std::array<char, 8> constexpr runMagic = {
+    'r', 'i', 'p', 'p', 'l', 'e', 'A', 'T'};
+std::uint32_t constexpr runVersion = 1;
+std::size_t constexpr runHeaderSize = 32;
+std::size_t constexpr frameHeaderSize = 12;
+
+// Records read at once by a merge
+std::size_t constexpr mergeChunk = 16 * 1024;
+
+std::uint32_t constexpr noLedger = std::numeric_limits<std::uint32_t>::max();
+
+void
+put32(std::uint8_t* p, std::uint32_t v)
+{
+    p[0] = static_cast<std::uint8_t>(v >> 24);
+    p[1] = static_cast<std::uint8_t>(v >> 16);
+    p[2] = static_cast<std::uint8_t>(v >> 8);
+    p[3] = static_cast<std::uint8_t>(v);
+}
+
+void
+put64(std::uint8_t* p, std::uint64_t v)
+{
+    put32(p, static_cast<std::uint32_t>(v >> 32));
+    put32(p + 4, static_cast<std::uint32_t>(v));
+}
+
+std::uint32_t
+get32(std::uint8_t const* p)
+{
+    return (std::uint32_t{p[0]} << 24) | (std::uint32_t{p[1]} << 16) |
+        (std::uint32_t{p[2]} << 8) | std::uint32_t{p[3]};
+}
+
+std::uint64_t
+get64(std::uint8_t const* p)
+{
+    return (std::uint64_t{get32(p)} << 32) | get32(p + 4);
+}
+
+std::uint64_t
+checksum(std::uint8_t const* p, std::size_t size)
+{
+    beast::xxhasher h;
+    h(p, size);
+    return static_cast<std::size_t>(h);
+}
+
+void
+check(nudb::error_code const& ec, boost::filesystem::path const& path)
+{
+    if (ec)
+        Throw<std::runtime_error>(
+            "AccountTxIndex: " + path.string() + ": " + ec.message());
+}
+
+// Parse "<prefix><n>" or "<prefix><n>-<m>"
+std::optional<std::pair<std::uint64_t, std::uint64_t>>
+parseName(std::string_view name, std::string_view prefix, bool range)
+{
+    if (name.substr(0, prefix.size()) != prefix)
+        return std::nullopt;
+    auto p = name.data() + prefix.size();
+    auto const end = name.data() + name.size();
+
+    std::uint64_t first, last;
+    auto r = std::from_chars(p, end, first);
+    if (r.ec != std::errc{})
+        return std::nullopt;
+    last = first;
+    if (range)
+    {
+        if (r.ptr == end || *r.ptr != '-')
+            return std::nullopt;
+        r = std::from_chars(r.ptr + 1, end, last);
+        if (r.ec != std::errc{})
+            return std::nullopt;
+    }
+    if (r.ptr != end)
+        return std::nullopt;
+    return std::make_pair(first, last);
+}
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+
+// Where the batches in memory are kept until they are in a run
+class AccountTxIndex::LogFile
+{
+public:
+    explicit LogFile(boost::filesystem::path const& path) : path_(path)
+    {
+        nudb::error_code ec;
+        file_.create(nudb::file_mode::append, path_.string(), ec);
+        check(ec, path_);
+    }
+
+    void
+    append(std::vector<Record> const& records)
+    {
+        std::vector<std::uint8_t> frame(
+            frameHeaderSize + records.size() * recordSize);
+        auto p = frame.data() + frameHeaderSize;
+        for (auto const& record : records)
+            p = encode(record, p);
+        put32(frame.data(), static_cast<std::uint32_t>(records.size()));
+        put64(
+            frame.data() + 4,
+            checksum(
+                frame.data() + frameHeaderSize,
+                frame.size() - frameHeaderSize));
+
+        nudb::error_code ec;
+        file_.write(size_, frame.data(), frame.size(), ec);
+        check(ec, path_);
+        file_.sync(ec);
+        check(ec, path_);
+        size_ += frame.size();
+    }
+
+    // Delete the log once its entries are in a run
+    void
+    remove()
+    {
+        file_.close();
+        boost::system::error_code ec;
+        boost::filesystem::remove(path_, ec);
+    }
+
+    // Call f for each record of the complete frames of a log. A frame
+    // cut short by a crash, and anything after it, is ignored.
+    static void
+    replay(
+        boost::filesystem::path const& path,
+        std::function<void(Record const&)> const& f,
+        beast::Journal j)
+    {
+        nudb::native_file file;
+        nudb::error_code ec;
+        file.open(nudb::file_mode::scan, path.string(), ec);
+        check(ec, path);
+        std::vector<std::uint8_t> buffer(file.size(ec));
+        check(ec, path);
+        if (!buffer.empty())
+            file.read(0, buffer.data(), buffer.size(), ec);
+        check(ec, path);
+
+        std::size_t offset = 0;
+        while (buffer.size() - offset >= frameHeaderSize)
+        {
+            auto const frame = buffer.data() + offset;
+            auto const bytes = std::uint64_t{get32(frame)} * recordSize;
+            if (buffer.size() - offset - frameHeaderSize < bytes)
+                break;
+            auto const records = frame + frameHeaderSize;
+            if (checksum(records, bytes) != get64(frame + 4))
+                break;
+            for (std::size_t i = 0; i < bytes; i += recordSize)
+                f(decode(records + i));
+            offset += frameHeaderSize + bytes;
+        }
+
+        if (offset != buffer.size())
+            JLOG(j.warn()) << "Ignoring " << buffer.size() - offset
+                           << " bytes at the end of " << path.string();
+    }
+
+private:
+    boost::filesystem::path const path_;
+    nudb::native_file file_;
+    std::uint64_t size_ = 0;
+};
+
+//------------------------------------------------------------------------------
+
+// An immutable file of records sorted by key
+class AccountTxIndex::Run
+{
+public:
+    // The generations of the entries in the run
+    std::uint64_t const first;
+    std::uint64_t const last;
+
+    // Set when the run was replaced. The file is deleted when the last
+    // reader lets go of it.
+    std::atomic<bool> obsolete{false};
+
+    Run(boost::filesystem::path const& path,
+        std::uint64_t first_,
+        std::uint64_t last_)
+        : first(first_), last(last_), path_(path)
+    {
+        nudb::error_code ec;
+        file_.open(nudb::file_mode::read, path_.string(), ec);
+        check(ec, path_);
+        auto const fileSize = file_.size(ec);
+        check(ec, path_);
+
+        std::array<std::uint8_t, runHeaderSize> header;
+        if (fileSize < header.size())
+            Throw<std::runtime_error>(
+                "AccountTxIndex: " + path_.string() + ": short run");
+        file_.read(0, header.data(), header.size(), ec);
+        check(ec, path_);
+        if (std::memcmp(header.data(), runMagic.data(), runMagic.size()) !=
+                0 ||
+            get32(header.data() + 8) != runVersion)
+            Throw<std::runtime_error>(
+                "AccountTxIndex: " + path_.string() + ": not a run");
+        fenceInterval_ = get32(header.data() + 12);
+        count_ = get64(header.data() + 16);
+        minLedger_ = get32(header.data() + 24);
+        maxLedger_ = get32(header.data() + 28);
+
+        auto const fences =
+            fenceInterval_ ? (count_ + fenceInterval_ - 1) / fenceInterval_ : 0;
+        if ((count_ && !fenceInterval_) ||
+            fileSize !=
+                runHeaderSize + count_ * recordSize + fences * keySize)
+            Throw<std::runtime_error>(
+                "AccountTxIndex: " + path_.string() + ": bad run size");
+
+        std::vector<std::uint8_t> buffer(fences * keySize);
+        if (!buffer.empty())
+            file_.read(
+                runHeaderSize + count_ * recordSize,
+                buffer.data(),
+                buffer.size(),
+                ec);
+        check(ec, path_);
+        fences_.resize(fences);
+        for (std::size_t i = 0; i < fences; ++i)
+            std::memcpy(fences_[i].data(), &buffer[i * keySize], keySize);
+    }
+
+    ~Run()
+    {
+        file_.close();
+        if (obsolete)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(path_, ec);
+        }
+    }
+
+    std::uint64_t
+    count() const
+    {
+        return count_;
+    }
+
+    std::uint32_t
+    minLedger() const
+    {
+        return minLedger_;
+    }
+
+    std::uint32_t
+    maxLedger() const
+    {
+        return maxLedger_;
+    }
+
+    // The index of the first record not less than the key
+    std::uint64_t
+    lowerBound(Key const& key) const
+    {
+        std::vector<Record> block;
+        auto const start = readBlock(key, block);
+        return start +
+            (std::lower_bound(
+                 block.begin(),
+                 block.end(),
+                 key,
+                 [](Record const& r, Key const& k) { return r.key < k; }) -
+             block.begin());
+    }
+
+    // The index of the first record greater than the key
+    std::uint64_t
+    upperBound(Key const& key) const
+    {
+        std::vector<Record> block;
+        auto const start = readBlock(key, block);
+        return start +
+            (std::upper_bound(
+                 block.begin(),
+                 block.end(),
+                 key,
+                 [](Key const& k, Record const& r) { return k < r.key; }) -
+             block.begin());
+    }
+
+    void
+    read(std::uint64_t index, std::size_t n, std::vector<Record>& out) const
+    {
+        std::vector<std::uint8_t> buffer(n * recordSize);
+        nudb::error_code ec;
+        if (n)
+            file_.read(
+                runHeaderSize + index * recordSize,
+                buffer.data(),
+                buffer.size(),
+                ec);
+        check(ec, path_);
+        out.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = decode(&buffer[i * recordSize]);
+    }
+
+private:
+    // Read the records between the last fence not greater than the key
+    // and the next fence. Returns the index of the first.
+    std::uint64_t
+    readBlock(Key const& key, std::vector<Record>& block) const
+    {
+        auto const fence =
+            std::upper_bound(fences_.begin(), fences_.end(), key);
+        if (fence == fences_.begin())
+        {
+            block.clear();
+            return 0;
+        }
+        std::uint64_t const start =
+            (fence - fences_.begin() - 1) * std::uint64_t{fenceInterval_};
+        read(
+            start,
+            static_cast<std::size_t>(
+                std::min<std::uint64_t>(fenceInterval_, count_ - start)),
+            block);
+        return start;
+    }
+
+    boost::filesystem::path const path_;
+    mutable nudb::native_file file_;
+    std::uint32_t fenceInterval_ = 0;
+    std::uint64_t count_ = 0;
+    std::uint32_t minLedger_ = 0;
+    std::uint32_t maxLedger_ = 0;
+    std::vector<Key> fences_;
+};
+
+//------------------------------------------------------------------------------
+
+// Writes records, added in key order, to a new run
+class AccountTxIndex::RunWriter
+{
+public:
+    RunWriter(boost::filesystem::path const& path, std::uint32_t fenceInterval)
+        : path_(path)
+        , tmp_(path.string() + ".tmp")
+        , fenceInterval_(fenceInterval)
+    {
+        boost::system::error_code bec;
+        boost::filesystem::remove(tmp_, bec);
+
+        nudb::error_code ec;
+        file_.create(nudb::file_mode::write, tmp_.string(), ec);
+        check(ec, tmp_);
+        buffer_.reserve(bufferSize + recordSize);
+    }
+
+    ~RunWriter()
+    {
+        if (file_.is_open())
+        {
+            file_.close();
+            boost::system::error_code ec;
+            boost::filesystem::remove(tmp_, ec);
+        }
+    }
+
+    void
+    add(Record const& record)
+    {
+        assert(count_ == 0 || last_ < record.key);
+        if (count_ % fenceInterval_ == 0)
+            fences_.push_back(record.key);
+        last_ = record.key;
+        ++count_;
+
+        auto const ledger = ledgerOf(record.key);
+        minLedger_ = std::min(minLedger_, ledger);
+        maxLedger_ = std::max(maxLedger_, ledger);
+
+        buffer_.resize(buffer_.size() + recordSize);
+        encode(record, buffer_.data() + buffer_.size() - recordSize);
+        if (buffer_.size() >= bufferSize)
+            drain();
+    }
+
+    // Complete the run, and give it its name
+    void
+    finish()
+    {
+        for (auto const& fence : fences_)
+        {
+            buffer_.insert(buffer_.end(), fence.begin(), fence.end());
+            if (buffer_.size() >= bufferSize)
+                drain();
+        }
+        drain();
+
+        std::array<std::uint8_t, runHeaderSize> header{};
+        std::memcpy(header.data(), runMagic.data(), runMagic.size());
+        put32(header.data() + 8, runVersion);
+        put32(header.data() + 12, fenceInterval_);
+        put64(header.data() + 16, count_);
+        put32(header.data() + 24, count_ ? minLedger_ : 0);
+        put32(header.data() + 28, maxLedger_);
+
+        nudb::error_code ec;
+        file_.write(0, header.data(), header.size(), ec);
+        check(ec, tmp_);
+        file_.sync(ec);
+        check(ec, tmp_);
+        file_.close();
+        boost::filesystem::rename(tmp_, path_);
+    }
+
+private:
+    static constexpr std::size_t bufferSize = 1024 * 1024;
+
+    void
+    drain()
+    {
+        nudb::error_code ec;
+        if (!buffer_.empty())
+            file_.write(offset_, buffer_.data(), buffer_.size(), ec);
+        check(ec, tmp_);
+        offset_ += buffer_.size();
+        buffer_.clear();
+    }
+
+    boost::filesystem::path const path_;
+    boost::filesystem::path const tmp_;
+    std::uint32_t const fenceInterval_;
+    nudb::native_file file_;
+    std::vector<std::uint8_t> buffer_;
+    std::uint64_t offset_ = runHeaderSize;
+    std::uint64_t count_ = 0;
+    Key last_{};
+    std::uint32_t minLedger_ = noLedger;
+    std::uint32_t maxLedger_ = 0;
+    std::vector<Key> fences_;
+};
+
+//------------------------------------------------------------------------------
+
+// The records of a range of keys in one run, or copied from memory, read a
+// chunk at a time in either direction.
+struct AccountTxIndex::Cursor
+{
+    std::shared_ptr<Run> run;
+    bool forward = true;
+
+    // Records of the run not yet read
+    std::uint64_t begin = 0;
+    std::uint64_t end = 0;
+
+    // Records read, in the order they are visited
+    std::vector<Record> buffer;
+    std::size_t next = 0;
+
+    // Most scans want only a page, so reads start small and grow
+    std::size_t chunk = 64;
+    std::size_t maxChunk = 4096;
+
+    // The current record, or nullptr at the end
+    Record const*
+    peek()
+    {
+        if (next == buffer.size())
+        {
+            if (!run || begin == end)
+                return nullptr;
+            auto const n = static_cast<std::size_t>(
+                std::min<std::uint64_t>(chunk, end - begin));
+            if (forward)
+            {
+                run->read(begin, n, buffer);
+                begin += n;
+            }
+            else
+            {
+                run->read(end - n, n, buffer);
+                std::reverse(buffer.begin(), buffer.end());
+                end -= n;
+            }
+            next = 0;
+            chunk = std::min(chunk * 2, maxChunk);
+        }
+        return &buffer[next];
+    }
+
+    void
+    pop()
+    {
+        ++next;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+AccountTxIndex::AccountTxIndex(Setup const& setup, beast::Journal journal)
+    : setup_(setup)
+    , j_(journal)
+    , memtableMinLedger_(noLedger)
+    , writingMinLedger_(noLedger)
+{
+    if (setup_.fenceInterval == 0)
+        Throw<std::invalid_argument>("AccountTxIndex: fence interval is 0");
+
+    if (!setup_.dir.empty())
+    {
+        open();
+        mergeThread_ = std::thread([this] {
+            beast::setCurrentThreadName("AccountTxMerge");
+            mergeLoop();
+        });
+    }
+}
+
+AccountTxIndex::~AccountTxIndex()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    mergeCond_.notify_all();
+    if (mergeThread_.joinable())
+        mergeThread_.join();
+}
+
+void
+AccountTxIndex::insert(std::vector<Entry> const& entries)
+{
+    if (entries.empty())
+        return;
+
+    std::vector<Record> records;
+    records.reserve(entries.size());
+    for (auto const& entry : entries)
+        records.push_back(
+            {makeKey(entry.account, {entry.ledgerSeq, entry.txnSeq}),
+             entry.txID});
+
+    std::lock_guard writeLock(writeMutex_);
+    if (log_)
+        log_->append(records);
+
+    bool full;
+    {
+        std::lock_guard lock(mutex_);
+        for (auto const& record : records)
+        {
+            memtable_[record.key] = record.txID;
+            memtableMinLedger_ =
+                std::min(memtableMinLedger_, ledgerOf(record.key));
+        }
+        full = log_ && memtable_.size() >= setup_.memtableEntries;
+    }
+
+    if (full)
+        writeMemtable(generation_);
+}
+
+void
+AccountTxIndex::scan(
+    AccountID const& account,
+    Position const& first,
+    Position const& last,
+    bool forward,
+    std::function<bool(Entry const&)> const& f) const
+{
+    std::vector<Cursor> cursors;
+    Key lo, hi;
+    {
+        std::lock_guard lock(mutex_);
+        lo = makeKey(
+            account, first.ledgerSeq < floor_ ? Position{floor_, 0} : first);
+        hi = makeKey(account, last);
+        if (hi < lo)
+            return;
+
+        auto const copy = [&](Memtable const& memtable) {
+            Cursor& cursor = cursors.emplace_back();
+            for (auto iter = memtable.lower_bound(lo),
+                      end = memtable.upper_bound(hi);
+                 iter != end;
+                 ++iter)
+                cursor.buffer.push_back({iter->first, iter->second});
+            if (!forward)
+                std::reverse(cursor.buffer.begin(), cursor.buffer.end());
+        };
+        copy(memtable_);
+        if (writing_)
+            copy(*writing_);
+
+        for (auto iter = runs_.rbegin(); iter != runs_.rend(); ++iter)
+        {
+            auto const& run = *iter;
+            if (run->count() == 0 || run->maxLedger() < ledgerOf(lo) ||
+                run->minLedger() > ledgerOf(hi))
+                continue;
+            Cursor& cursor = cursors.emplace_back();
+            cursor.run = run;
+            cursor.forward = forward;
+        }
+    }
+
+    for (auto& cursor : cursors)
+    {
+        if (cursor.run)
+        {
+            cursor.begin = cursor.run->lowerBound(lo);
+            cursor.end = cursor.run->upperBound(hi);
+        }
+    }
+
+    visit(cursors, forward, [&f](Record const& record) {
+        return f(makeEntry(record));
+    });
+}
+
+void
+AccountTxIndex::deleteBefore(std::uint32_t ledgerSeq)
+{
+    std::lock_guard writeLock(writeMutex_);
+    {
+        std::lock_guard lock(mutex_);
+        if (ledgerSeq <= floor_)
+            return;
+    }
+
+    if (!setup_.dir.empty())
+        writeFloor(ledgerSeq);
+
+    std::lock_guard lock(mutex_);
+    floor_ = ledgerSeq;
+    resaved_ -= range<std::uint32_t>(0, ledgerSeq - 1);
+
+    std::erase_if(runs_, [this](auto const& run) {
+        if (run->count() != 0 && run->maxLedger() >= floor_)
+            return false;
+        run->obsolete = true;
+        return true;
+    });
+
+    memtableMinLedger_ = noLedger;
+    for (auto iter = memtable_.begin(); iter != memtable_.end();)
+    {
+        auto const ledger = ledgerOf(iter->first);
+        if (ledger < floor_)
+        {
+            iter = memtable_.erase(iter);
+        }
+        else
+        {
+            memtableMinLedger_ = std::min(memtableMinLedger_, ledger);
+            ++iter;
+        }
+    }
+}
+
+std::optional<std::uint32_t>
+AccountTxIndex::minLedgerSeq() const
+{
+    std::lock_guard lock(mutex_);
+    auto seq = memtableMinLedger_;
+    if (writing_)
+        seq = std::min(seq, writingMinLedger_);
+    for (auto const& run : runs_)
+    {
+        if (run->count())
+            seq = std::min(seq, run->minLedger());
+    }
+    if (seq == noLedger)
+        return std::nullopt;
+    return std::max(seq, floor_);
+}
+
+std::size_t
+AccountTxIndex::size() const
+{
+    std::lock_guard lock(mutex_);
+    std::size_t size = memtable_.size();
+    if (writing_)
+        size += writing_->size();
+    for (auto const& run : runs_)
+        size += run->count();
+    return size;
+}
+
+std::size_t
+AccountTxIndex::runCount() const
+{
+    std::lock_guard lock(mutex_);
+    return runs_.size();
+}
+
+void
+AccountTxIndex::flush()
+{
+    if (setup_.dir.empty())
+        return;
+
+    {
+        std::lock_guard writeLock(writeMutex_);
+        writeMemtable(generation_);
+    }
+
+    std::unique_lock lock(mutex_);
+    mergeCond_.wait(lock, [this] {
+        return stop_ || mergeFailed_ || (!merging_ && !pickMerge());
+    });
+}
+
+bool
+AccountTxIndex::imported() const
+{
+    return imported_;
+}
+
+void
+AccountTxIndex::markImported()
+{
+    if (!setup_.dir.empty())
+    {
+        flush();
+        writeFile(setup_.dir / "imported", nullptr, 0);
+    }
+    imported_ = true;
+}
+
+void
+AccountTxIndex::markResaved(RangeSet<std::uint32_t> const& ledgers)
+{
+    std::lock_guard writeLock(writeMutex_);
+    RangeSet<std::uint32_t> resaved;
+    {
+        std::lock_guard lock(mutex_);
+        if (boost::icl::contains(resaved_, ledgers))
+            return;
+        resaved = resaved_ + ledgers;
+    }
+
+    if (!setup_.dir.empty())
+        writeResaved(resaved);
+
+    std::lock_guard lock(mutex_);
+    resaved_ = std::move(resaved);
+}
+
+RangeSet<std::uint32_t>
+AccountTxIndex::resaved() const
+{
+    std::lock_guard lock(mutex_);
+    return resaved_;
+}
+
+//------------------------------------------------------------------------------
+
+auto
+AccountTxIndex::makeKey(AccountID const& account, Position const& position)
+    -> Key
+{
+    Key key;
+    std::memcpy(key.data(), account.data(), account.size());
+    put32(key.data() + 20, position.ledgerSeq);
+    put32(key.data() + 24, position.txnSeq);
+    return key;
+}
+
+auto
+AccountTxIndex::makeEntry(Record const& record) -> Entry
+{
+    Entry entry;
+    entry.account = AccountID::fromVoid(record.key.data());
+    entry.ledgerSeq = get32(record.key.data() + 20);
+    entry.txnSeq = get32(record.key.data() + 24);
+    entry.txID = record.txID;
+    return entry;
+}
+
+std::uint32_t
+AccountTxIndex::ledgerOf(Key const& key)
+{
+    return get32(key.data() + 20);
+}
+
+std::uint8_t*
+AccountTxIndex::encode(Record const& record, std::uint8_t* p)
+{
+    std::memcpy(p, record.key.data(), keySize);
+    std::memcpy(p + keySize, record.txID.data(), record.txID.size());
+    return p + recordSize;
+}
+
+auto
+AccountTxIndex::decode(std::uint8_t const* p) -> Record
+{
+    Record record;
+    std::memcpy(record.key.data(), p, keySize);
+    record.txID = uint256::fromVoid(p + keySize);
+    return record;
+}
+
+void
+AccountTxIndex::visit(
+    std::vector<Cursor>& cursors,
+    bool forward,
+    std::function<bool(Record const&)> const& f)
+{
+    for (;;)
+    {
+        // Ties go to the newest
+        std::size_t best = 0;
+        Record const* next = nullptr;
+        for (std::size_t i = 0; i < cursors.size(); ++i)
+        {
+            auto const record = cursors[i].peek();
+            if (record &&
+                (!next ||
+                 (forward ? record->key < next->key
+                          : next->key < record->key)))
+            {
+                best = i;
+                next = record;
+            }
+        }
+        if (!next)
+            return;
+
+        Record const record = *next;
+        for (std::size_t i = best + 1; i < cursors.size(); ++i)
+        {
+            if (auto const older = cursors[i].peek();
+                older && older->key == record.key)
+                cursors[i].pop();
+        }
+        cursors[best].pop();
+
+        if (!f(record))
+            return;
+    }
+}
+
+void
+AccountTxIndex::open()
+{
+    namespace fs = boost::filesystem;
+    fs::create_directories(setup_.dir);
+
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> runs;
+    std::vector<std::uint64_t> logs;
+    for (auto const& file : fs::directory_iterator(setup_.dir))
+    {
+        auto const& path = file.path();
+        auto const name = path.filename().string();
+        if (path.extension() == ".tmp")
+            fs::remove(path);
+        else if (auto const run = parseName(name, "run-", true))
+            runs.push_back(*run);
+        else if (auto const log = parseName(name, "log-", false))
+            logs.push_back(log->first);
+    }
+
+    imported_ = fs::exists(setup_.dir / "imported");
+
+    if (auto const path = setup_.dir / "floor"; fs::exists(path))
+    {
+        nudb::native_file file;
+        nudb::error_code ec;
+        file.open(nudb::file_mode::read, path.string(), ec);
+        check(ec, path);
+        std::array<std::uint8_t, 4> floor;
+        file.read(0, floor.data(), floor.size(), ec);
+        check(ec, path);
+        floor_ = get32(floor.data());
+    }
+
+    if (auto const path = setup_.dir / "resaved"; fs::exists(path))
+    {
+        nudb::native_file file;
+        nudb::error_code ec;
+        file.open(nudb::file_mode::read, path.string(), ec);
+        check(ec, path);
+        std::string resaved(file.size(ec), '\0');
+        check(ec, path);
+        file.read(0, resaved.data(), resaved.size(), ec);
+        check(ec, path);
+        if (!resaved.empty() && !from_string(resaved_, resaved))
+            Throw<std::runtime_error>(
+                "AccountTxIndex: " + path.string() + ": malformed");
+        if (floor_ != 0)
+            resaved_ -= range<std::uint32_t>(0, floor_ - 1);
+    }
+
+    std::sort(runs.begin(), runs.end(), [](auto const& a, auto const& b) {
+        return a.second < b.second;
+    });
+    for (auto const& [first, last] : runs)
+    {
+        // The input of a merge which finished before it was removed
+        if (std::any_of(runs.begin(), runs.end(), [&](auto const& other) {
+                return other != std::make_pair(first, last) &&
+                    other.first <= first && last <= other.second;
+            }))
+        {
+            fs::remove(runPath(first, last));
+            continue;
+        }
+
+        auto run = std::make_shared<Run>(runPath(first, last), first, last);
+        if (run->count() == 0 || run->maxLedger() < floor_)
+            run->obsolete = true;
+        else
+            runs_.push_back(std::move(run));
+        generation_ = last + 1;
+    }
+
+    std::sort(logs.begin(), logs.end());
+    std::vector<std::uint64_t> replayed;
+    for (auto const generation : logs)
+    {
+        if (generation < generation_)
+        {
+            fs::remove(logPath(generation));
+            continue;
+        }
+        LogFile::replay(
+            logPath(generation),
+            [this](Record const& record) {
+                memtable_[record.key] = record.txID;
+                memtableMinLedger_ =
+                    std::min(memtableMinLedger_, ledgerOf(record.key));
+            },
+            j_);
+        replayed.push_back(generation);
+    }
+
+    if (!replayed.empty())
+    {
+        generation_ = replayed.back();
+        writeMemtable(replayed.front());
+        if (!log_)
+            ++generation_;
+        for (auto const generation : replayed)
+            fs::remove(logPath(generation));
+    }
+
+    if (!log_)
+        log_ = std::make_unique<LogFile>(logPath(generation_));
+
+    JLOG(j_.info()) << "Opened " << setup_.dir.string() << ": "
+                    << runs_.size() << " runs, " << size() << " entries";
+}
+
+void
+AccountTxIndex::writeMemtable(std::uint64_t first)
+{
+    std::shared_ptr<Memtable const> writing;
+    std::uint64_t last;
+    std::uint32_t floor;
+    {
+        std::lock_guard lock(mutex_);
+        if (memtable_.empty())
+            return;
+        writing_ = writing =
+            std::make_shared<Memtable const>(std::move(memtable_));
+        memtable_.clear();
+        writingMinLedger_ = std::exchange(memtableMinLedger_, noLedger);
+        last = generation_++;
+        floor = floor_;
+    }
+
+    // New batches go to a new log while this one is written out
+    auto oldLog = std::move(log_);
+    log_ = std::make_unique<LogFile>(logPath(generation_));
+
+    auto const path = runPath(first, last);
+    RunWriter writer(path, setup_.fenceInterval);
+    for (auto const& [key, txID] : *writing)
+    {
+        if (ledgerOf(key) >= floor)
+            writer.add({key, txID});
+    }
+    writer.finish();
+    auto run = std::make_shared<Run>(path, first, last);
+
+    {
+        std::lock_guard lock(mutex_);
+        runs_.push_back(std::move(run));
+        writing_.reset();
+    }
+    mergeCond_.notify_all();
+
+    if (oldLog)
+        oldLog->remove();
+
+    JLOG(j_.debug()) << "Wrote " << writing->size() << " entries to "
+                     << path.string();
+}
+
+void
+AccountTxIndex::writeFloor(std::uint32_t floor)
+{
+    std::array<std::uint8_t, 4> data;
+    put32(data.data(), floor);
+    writeFile(setup_.dir / "floor", data.data(), data.size());
+}
+
+void
+AccountTxIndex::writeResaved(RangeSet<std::uint32_t> const& resaved)
+{
+    auto const data = resaved.empty() ? std::string{} : to_string(resaved);
+    writeFile(
+        setup_.dir / "resaved",
+        reinterpret_cast<std::uint8_t const*>(data.data()),
+        data.size());
+}
+
+void
+AccountTxIndex::writeFile(
+    boost::filesystem::path const& path,
+    std::uint8_t const* data,
+    std::size_t size)
+{
+    auto const tmp = path.string() + ".tmp";
+
+    boost::system::error_code bec;
+    boost::filesystem::remove(tmp, bec);
+
+    {
+        nudb::native_file file;
+        nudb::error_code ec;
+        file.create(nudb::file_mode::write, tmp, ec);
+        check(ec, tmp);
+        if (size)
+            file.write(0, data, size, ec);
+        check(ec, tmp);
+        file.sync(ec);
+        check(ec, tmp);
+    }
+    boost::filesystem::rename(tmp, path);
+}
+
+boost::filesystem::path
+AccountTxIndex::logPath(std::uint64_t generation) const
+{
+    return setup_.dir / ("log-" + std::to_string(generation));
+}
+
+boost::filesystem::path
+AccountTxIndex::runPath(std::uint64_t first, std::uint64_t last) const
+{
+    return setup_.dir /
+        ("run-" + std::to_string(first) + "-" + std::to_string(last));
+}
+
+std::optional<std::size_t>
+AccountTxIndex::pickMerge() const
+{
+    // Merge the newest runs from the oldest which is no more than twice
+    // the size of those newer than it. Every run then ends up more than
+    // twice the size of all newer ones, so there are few of them, and an
+    // entry is rewritten a logarithmic number of times.
+    std::optional<std::size_t> from;
+    std::uint64_t newer = 0;
+    for (std::size_t i = runs_.size(); i-- > 0;)
+    {
+        if (runs_.size() - i >= 2 && runs_[i]->count() <= 2 * newer)
+            from = i;
+        newer += runs_[i]->count();
+    }
+    return from;
+}
+
+auto
+AccountTxIndex::merge(
+    std::vector<std::shared_ptr<Run>> const& inputs,
+    std::uint32_t floor) const -> std::shared_ptr<Run>
+{
+    std::vector<Cursor> cursors;
+    for (auto iter = inputs.rbegin(); iter != inputs.rend(); ++iter)
+    {
+        Cursor& cursor = cursors.emplace_back();
+        cursor.run = *iter;
+        cursor.end = cursor.run->count();
+        cursor.chunk = cursor.maxChunk = mergeChunk;
+    }
+
+    auto const first = inputs.front()->first;
+    auto const last = inputs.back()->last;
+    auto const path = runPath(first, last);
+    RunWriter writer(path, setup_.fenceInterval);
+    std::uint64_t visited = 0;
+    visit(cursors, true, [&](Record const& record) {
+        if (ledgerOf(record.key) >= floor)
+            writer.add(record);
+        return ++visited % mergeChunk != 0 || !stop_;
+    });
+    if (stop_)
+        return nullptr;
+    writer.finish();
+    return std::make_shared<Run>(path, first, last);
+}
+
+void
+AccountTxIndex::mergeLoop()
+{
+    std::unique_lock lock(mutex_);
+    for (;;)
+    {
+        std::optional<std::size_t> from;
+        mergeCond_.wait(
+            lock, [&] { return stop_ || (from = pickMerge()).has_value(); });
+        if (stop_)
+            return;
+
+        std::vector<std::shared_ptr<Run>> inputs(
+            runs_.begin() + *from, runs_.end());
+        auto const floor = floor_;
+        merging_ = true;
+        lock.unlock();
+
+        std::shared_ptr<Run> output;
+        try
+        {
+            output = merge(inputs, floor);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.error()) << "Merging stopped: " << e.what();
+        }
+
+        lock.lock();
+        merging_ = false;
+        if (!output)
+        {
+            mergeFailed_ = !stop_;
+            mergeCond_.notify_all();
+            return;
+        }
+
+        // Runs may have been added, or dropped for being too old, while
+        // these were merged.
+        for (auto const& input : inputs)
+        {
+            input->obsolete = true;
+            std::erase(runs_, input);
+        }
+        if (output->count() == 0 || output->maxLedger() < floor_)
+            output->obsolete = true;
+        else
+            runs_.insert(
+                std::upper_bound(
+                    runs_.begin(),
+                    runs_.end(),
+                    output,
+                    [](auto const& a, auto const& b) {
+                        return a->last < b->last;
+                    }),
+                std::move(output));
+        mergeCond_.notify_all();
+
+        JLOG(j_.debug()) << "Merged " << inputs.size() << " runs, "
+                         << runs_.size() << " left";
+    }
+}
+
+}  // namespace ripple
@@ -22,16 +22,19 @@
 
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/core/Config.h>
+#include <ripple/json/json_value.h>
 #include <ripple/ledger/View.h>
 #include <ripple/protocol/STTx.h>
 #include <ripple/protocol/TER.h>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
 class Application;
 class HashRouter;
+class Ledger;
 
 /** Describes the pre-processing validity of a transaction.
 
@@ -156,6 +159,45 @@ applyTransaction(
     ApplyFlags flags,
     beast::Journal journal);
 
+/** Apply transactions in order, executing them speculatively in parallel
+
+    Each transaction is first executed on its own against the view as it
+    stands, with the state it reads recorded. The results are then committed
+    in order. A transaction that read state changed by one committed before
+    it is executed again against the updated view. Pseudo-transactions are
+    never executed speculatively. A transaction that throws when executed
+    again is reported as failed.
+
+    The view ends up exactly as if `applyTransaction` had been called on
+    each transaction in turn.
+
+    @return The result of each transaction, in order.
+*/
+std::vector<ApplyResult>
+applyTransactions(
+    Application& app,
+    OpenView& view,
+    std::vector<std::shared_ptr<STTx const>> const& txns,
+    bool retryAssured,
+    ApplyFlags flags,
+    beast::Journal journal);
+
+/** Start loading the ledger state a transaction is likely to need
+
+    The state map nodes leading to the entries a transaction will probably
+    read when applied on top of `ledger`, such as the accounts, trust lines
+    and order books it names, are read from the node store asynchronously.
+    Applying the transaction later then need not wait on those reads.
+
+    @note Does not throw.
+*/
+void
+prefetchTransaction(Ledger const& ledger, STTx const& tx);
+
+/** Add the counts of state prefetched ahead of transactions to `obj`. */
+void
+getPrefetchCounts(Json::Value& obj);
+
 }  // namespace ripple
 
 #endif
@@ -0,0 +1,392 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/tx/apply.h>
+#include <ripple/basics/Log.h>
+#include <ripple/basics/WorkerPool.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/TxMeta.h>
+#include <algorithm>
+#include <set>
+
+namespace ripple {
+
+namespace {
+
+// Passes reads through to a base view, recording what was read so that it
+// can later be checked against the changes made by other transactions.
+class RecordingView : public ReadView
+{
+    ReadView const& base_;
+
+public:
+    // Keys of the state items read, whether or not they were found
+    mutable std::vector<uint256> keys;
+
+    // Key ranges (first, last] passed over looking for a successor. An
+    // unseated last is the end of the key space.
+    mutable std::vector<std::pair<uint256, std::optional<uint256>>> ranges;
+
+    // Keys of the transactions looked up
+    mutable std::vector<uint256> txKeys;
+
+    // Whether the state or transactions were iterated
+    mutable bool iterated = false;
+
+    explicit RecordingView(ReadView const& base) : base_(base)
+    {
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists(Keylet const& k) const override
+    {
+        keys.push_back(k.key);
+        return base_.exists(k);
+    }
+
+    std::optional<key_type>
+    succ(key_type const& key, std::optional<key_type> const& last)
+        const override
+    {
+        auto next = base_.succ(key, last);
+        ranges.emplace_back(key, next ? next : last);
+        return next;
+    }
+
+    std::shared_ptr<SLE const>
+    read(Keylet const& k) const override
+    {
+        keys.push_back(k.key);
+        return base_.read(k);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        iterated = true;
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        iterated = true;
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound(uint256 const& key) const override
+    {
+        iterated = true;
+        return base_.slesUpperBound(key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        iterated = true;
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        iterated = true;
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists(key_type const& key) const override
+    {
+        txKeys.push_back(key);
+        return base_.txExists(key);
+    }
+
+    tx_type
+    txRead(key_type const& key) const override
+    {
+        txKeys.push_back(key);
+        return base_.txRead(key);
+    }
+};
+
+// The keys changed in the view since the transactions were executed
+struct Changes
+{
+    std::set<uint256> state;
+    std::set<uint256> txs;
+
+    bool
+    empty() const
+    {
+        return state.empty() && txs.empty();
+    }
+};
+
+// Collects the keys a view would change, without changing anything
+class ChangeCollector : public TxsRawView
+{
+public:
+    Changes changes;
+
+    void
+    rawErase(std::shared_ptr<SLE> const& sle) override
+    {
+        changes.state.insert(sle->key());
+    }
+
+    void
+    rawInsert(std::shared_ptr<SLE> const& sle) override
+    {
+        changes.state.insert(sle->key());
+    }
+
+    void
+    rawReplace(std::shared_ptr<SLE> const& sle) override
+    {
+        changes.state.insert(sle->key());
+    }
+
+    void
+    rawDestroyXRP(XRPAmount const&) override
+    {
+    }
+
+    void
+    rawTxInsert(
+        ReadView::key_type const& key,
+        std::shared_ptr<Serializer const> const&,
+        std::shared_ptr<Serializer const> const&) override
+    {
+        changes.txs.insert(key);
+    }
+};
+
+// Commits the changes a transaction made in a view of its own to the view
+// being built, noting the keys changed. The transaction was the first in
+// its own view, so its metadata is renumbered with its place in this one.
+class CommitView : public TxsRawView
+{
+    OpenView& to_;
+    Changes& changes_;
+
+public:
+    CommitView(OpenView& to, Changes& changes) : to_(to), changes_(changes)
+    {
+    }
+
+    void
+    rawErase(std::shared_ptr<SLE> const& sle) override
+    {
+        changes_.state.insert(sle->key());
+        to_.rawErase(sle);
+    }
+
+    void
+    rawInsert(std::shared_ptr<SLE> const& sle) override
+    {
+        changes_.state.insert(sle->key());
+        to_.rawInsert(sle);
+    }
+
+    void
+    rawReplace(std::shared_ptr<SLE> const& sle) override
+    {
+        changes_.state.insert(sle->key());
+        to_.rawReplace(sle);
+    }
+
+    void
+    rawDestroyXRP(XRPAmount const& fee) override
+    {
+        to_.rawDestroyXRP(fee);
+    }
+
+    void
+    rawTxInsert(
+        ReadView::key_type const& key,
+        std::shared_ptr<Serializer const> const& txn,
+        std::shared_ptr<Serializer const> const& metaData) override
+    {
+        changes_.txs.insert(key);
+
+        if (!metaData || to_.txCount() == 0)
+        {
+            to_.rawTxInsert(key, txn, metaData);
+            return;
+        }
+
+        TxMeta meta(key, to_.seq(), metaData->peekData());
+        auto renumbered = std::make_shared<Serializer>();
+        meta.addRaw(*renumbered, meta.getResultTER(), to_.txCount());
+        to_.rawTxInsert(key, txn, renumbered);
+    }
+};
+
+bool
+conflicts(RecordingView const& reads, Changes const& changes)
+{
+    if (reads.iterated)
+        return !changes.empty();
+
+    for (auto const& key : reads.keys)
+    {
+        if (changes.state.count(key))
+            return true;
+    }
+
+    for (auto const& [first, last] : reads.ranges)
+    {
+        auto const it = changes.state.upper_bound(first);
+        if (it != changes.state.end() && (!last || *it <= *last))
+            return true;
+    }
+
+    for (auto const& key : reads.txKeys)
+    {
+        if (changes.txs.count(key))
+            return true;
+    }
+
+    return false;
+}
+
+// A transaction executed against the view before any of the others
+struct Speculation
+{
+    RecordingView reads;
+    OpenView view;
+    ApplyResult result;
+
+    explicit Speculation(ReadView const& base) : reads(base), view(&reads)
+    {
+    }
+};
+
+}  // namespace
+
+std::vector<ApplyResult>
+applyTransactions(
+    Application& app,
+    OpenView& view,
+    std::vector<std::shared_ptr<STTx const>> const& txns,
+    bool retryAssured,
+    ApplyFlags flags,
+    beast::Journal j)
+{
+    std::vector<std::unique_ptr<Speculation>> speculations(txns.size());
+
+    // Nothing changes the view until every speculation has finished
+    WorkerPool::instance().run(txns.size(), [&](std::size_t i) {
+        if (isPseudoTx(*txns[i]))
+            return;
+
+        try
+        {
+            auto s = std::make_unique<Speculation>(view);
+            s->result = applyTransaction(
+                app, s->view, *txns[i], retryAssured, flags, j);
+            speculations[i] = std::move(s);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j.warn()) << "Speculation on " << txns[i]->getTransactionID()
+                           << " throws: " << e.what();
+        }
+    });
+
+    std::vector<ApplyResult> results;
+    results.reserve(txns.size());
+    Changes changes;
+    CommitView commit(view, changes);
+    std::size_t reapplied = 0;
+
+    for (std::size_t i = 0; i < txns.size(); ++i)
+    {
+        auto const& s = speculations[i];
+
+        if (s && !conflicts(s->reads, changes))
+        {
+            ChangeCollector writes;
+            s->view.apply(writes);
+
+            if (std::none_of(
+                    writes.changes.state.begin(),
+                    writes.changes.state.end(),
+                    [&changes](uint256 const& key) {
+                        return changes.state.count(key) != 0;
+                    }))
+            {
+                s->view.apply(commit);
+                results.push_back(s->result);
+                speculations[i].reset();
+                continue;
+            }
+        }
+
+        // Execute the transaction again on top of the ones committed
+        speculations[i].reset();
+        ++reapplied;
+
+        try
+        {
+            OpenView again(&view);
+            auto const result =
+                applyTransaction(app, again, *txns[i], retryAssured, flags, j);
+            again.apply(commit);
+            results.push_back(result);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j.warn()) << "Transaction " << txns[i]->getTransactionID()
+                           << " throws: " << e.what();
+            results.push_back(ApplyResult::Fail);
+        }
+    }
+
+    JLOG(j.debug()) << "Applied " << txns.size() << " transactions, "
+                    << reapplied << " executed again";
+    return results;
+}
+
+}  // namespace ripple
@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/protocol/Book.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/jss.h>
+#include <atomic>
+
+namespace ripple {
+
+namespace {
+
+std::atomic<std::uint64_t> prefetchedKeys{0};
+std::atomic<std::uint64_t> nodesLoaded{0};
+
+// The keys of the state entries applying a transaction will most likely read
+std::vector<uint256>
+likelyKeys(STTx const& tx)
+{
+    std::vector<uint256> keys;
+
+    auto const account = tx.getAccountID(sfAccount);
+    keys.push_back(keylet::account(account).key);
+    keys.push_back(keylet::ownerDir(account).key);
+    if (tx.isFieldPresent(sfTicketSequence))
+        keys.push_back(keylet::ticket(account, tx[sfTicketSequence]).key);
+    if (tx.isFieldPresent(sfOfferSequence))
+        keys.push_back(keylet::offer(account, tx[sfOfferSequence]).key);
+
+    std::optional<AccountID> const destination = tx[~sfDestination];
+    if (destination)
+        keys.push_back(keylet::account(*destination).key);
+
+    // The issuers of the amounts named and the trust lines holding them
+    for (auto const field :
+         {&sfAmount,
+          &sfSendMax,
+          &sfDeliverMin,
+          &sfLimitAmount,
+          &sfTakerPays,
+          &sfTakerGets})
+    {
+        if (!tx.isFieldPresent(*field))
+            continue;
+        auto const& amount = tx.getFieldAmount(*field);
+        if (amount.native())
+            continue;
+        keys.push_back(keylet::account(amount.getIssuer()).key);
+        keys.push_back(keylet::line(account, amount.issue()).key);
+        if (destination)
+            keys.push_back(keylet::line(*destination, amount.issue()).key);
+    }
+
+    // The book an offer is placed in and the book it crosses. An offer
+    // trading an asset for itself has no book: it fails preflight later.
+    if (tx.isFieldPresent(sfTakerPays) && tx.isFieldPresent(sfTakerGets))
+    {
+        Book const book(tx[sfTakerPays].issue(), tx[sfTakerGets].issue());
+        if (isConsistent(book))
+        {
+            keys.push_back(getBookBase(book));
+            keys.push_back(getBookBase(reversed(book)));
+        }
+    }
+
+    if (tx.isFieldPresent(sfPaths))
+    {
+        for (auto const& path : tx.getFieldPathSet(sfPaths))
+        {
+            for (auto const& node : path)
+            {
+                if (node.isAccount())
+                    keys.push_back(keylet::account(node.getAccountID()).key);
+            }
+        }
+    }
+
+    return keys;
+}
+
+}  // namespace
+
+void
+prefetchTransaction(Ledger const& ledger, STTx const& tx)
+{
+    if (isPseudoTx(tx))
+        return;
+
+    try
+    {
+        for (auto const& key : likelyKeys(tx))
+        {
+            ++prefetchedKeys;
+            ledger.stateMap().prefetch(
+                key, [](std::size_t loaded) { nodesLoaded += loaded; });
+        }
+    }
+    catch (std::exception const&)
+    {
+        // Prefetching is only a hint. A malformed transaction
+        // fails when it is applied.
+    }
+}
+
+void
+getPrefetchCounts(Json::Value& obj)
+{
+    obj[jss::keys] = std::to_string(prefetchedKeys.load());
+    obj[jss::nodes_loaded] = std::to_string(nodesLoaded.load());
+}
+
+}  // namespace ripple
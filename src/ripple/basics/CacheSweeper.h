@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_CACHESWEEPER_H_INCLUDED
+#define RIPPLE_BASICS_CACHESWEEPER_H_INCLUDED
+
+#include <ripple/basics/WorkerPool.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+namespace ripple {
+
+/** Coordinates the sweeps of every cache.
+
+    TaggedCache sweeps each of its partitions in parallel. Rather than
+    starting a thread per partition on every sweep, all caches hand their
+    partitions to the shared WorkerPool through this class.
+
+    The sweeper also holds the time budget of a sweep slice: the longest a
+    sweep may keep any lock before releasing it and letting other work in.
+*/
+class CacheSweeper
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    CacheSweeper(CacheSweeper const&) = delete;
+    CacheSweeper&
+    operator=(CacheSweeper const&) = delete;
+
+    /** Return the process-wide sweeper. */
+    static CacheSweeper&
+    instance();
+
+    /** Call f(i) for every i in [0, n) and wait for all calls to return.
+        The calls are spread across the worker pool and the calling thread.
+    */
+    void
+    run(std::size_t n, std::function<void(std::size_t)> const& f)
+    {
+        WorkerPool::instance().run(n, f);
+    }
+
+    /** The longest time a sweep holds a lock before yielding it. */
+    clock_type::duration
+    budget() const
+    {
+        return budget_.load();
+    }
+
+    void
+    setBudget(clock_type::duration budget)
+    {
+        budget_ = budget;
+    }
+
+    std::size_t
+    threads() const
+    {
+        return WorkerPool::instance().threads();
+    }
+
+    /** Default time slice of a sweep. */
+    static constexpr std::chrono::milliseconds defaultBudget{25};
+
+private:
+    CacheSweeper() = default;
+
+    std::atomic<clock_type::duration> budget_{defaultBudget};
+};
+
+}  // namespace ripple
+
+#endif
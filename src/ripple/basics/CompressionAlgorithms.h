@@ -24,8 +24,10 @@
 #include <algorithm>
 #include <cstdint>
 #include <lz4.h>
+#include <memory>
 #include <stdexcept>
 #include <vector>
+#include <zstd.h>
 
 namespace ripple {
 
@@ -96,23 +98,22 @@ lz4Decompress(
     return decompressedSize;
 }
 
-/** LZ4 block decompression.
+namespace detail {
+
+/** Collect the compressed bytes of a message from an input stream.
  * @tparam InputStream ZeroCopyInputStream
  * @param in Input source stream
  * @param inSize Size of compressed data
- * @param decompressed Buffer to hold decompressed data
- * @param decompressedSize Size of the decompressed buffer
- * @return size of the decompressed data
+ * @param buffer Holds the data if it spans more than one chunk
+ * @return Pointer to inSize bytes of compressed data
  */
 template <typename InputStream>
-std::size_t
-lz4Decompress(
+std::uint8_t const*
+readCompressed(
     InputStream& in,
     std::size_t inSize,
-    std::uint8_t* decompressed,
-    std::size_t decompressedSize)
+    std::vector<std::uint8_t>& buffer)
 {
-    std::vector<std::uint8_t> compressed;
     std::uint8_t const* chunk = nullptr;
     int chunkSize = 0;
     int copiedInSize = 0;
@@ -130,20 +131,20 @@ lz4Decompress(
                 copiedInSize = inSize;
                 break;
             }
-            compressed.resize(inSize);
+            buffer.resize(inSize);
         }
 
         chunkSize = chunkSize < (inSize - copiedInSize)
             ? chunkSize
             : (inSize - copiedInSize);
 
-        std::copy(chunk, chunk + chunkSize, compressed.data() + copiedInSize);
+        std::copy(chunk, chunk + chunkSize, buffer.data() + copiedInSize);
 
         copiedInSize += chunkSize;
 
         if (copiedInSize == inSize)
         {
-            chunk = compressed.data();
+            chunk = buffer.data();
             break;
         }
     }
@@ -154,11 +155,155 @@ lz4Decompress(
 
     if ((copiedInSize == 0 && chunkSize < inSize) ||
         (copiedInSize > 0 && copiedInSize != inSize))
-        Throw<std::runtime_error>("lz4 decompress: insufficient input size");
+        Throw<std::runtime_error>("decompress: insufficient input size");
+
+    return chunk;
+}
 
+}  // namespace detail
+
+/** LZ4 block decompression.
+ * @tparam InputStream ZeroCopyInputStream
+ * @param in Input source stream
+ * @param inSize Size of compressed data
+ * @param decompressed Buffer to hold decompressed data
+ * @param decompressedSize Size of the decompressed buffer
+ * @return size of the decompressed data
+ */
+template <typename InputStream>
+std::size_t
+lz4Decompress(
+    InputStream& in,
+    std::size_t inSize,
+    std::uint8_t* decompressed,
+    std::size_t decompressedSize)
+{
+    std::vector<std::uint8_t> compressed;
+    auto const chunk = detail::readCompressed(in, inSize, compressed);
     return lz4Decompress(chunk, inSize, decompressed, decompressedSize);
 }
 
+namespace detail {
+
+// Contexts hold the working memory of the codec, which is sized for the
+// largest input seen so far. Keeping one per thread avoids allocating it
+// for every message.
+inline ZSTD_CCtx*
+zstdCompressContext()
+{
+    thread_local std::unique_ptr<ZSTD_CCtx, std::size_t (*)(ZSTD_CCtx*)> const
+        ctx(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+    if (!ctx)
+        Throw<std::bad_alloc>();
+    return ctx.get();
+}
+
+inline ZSTD_DCtx*
+zstdDecompressContext()
+{
+    thread_local std::unique_ptr<ZSTD_DCtx, std::size_t (*)(ZSTD_DCtx*)> const
+        ctx(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+    if (!ctx)
+        Throw<std::bad_alloc>();
+    return ctx.get();
+}
+
+}  // namespace detail
+
+/** Zstandard compression with a dictionary.
+ * @tparam BufferFactory Callable object or lambda.
+ *     Takes the requested buffer size and returns allocated buffer pointer.
+ * @param in Data to compress
+ * @param inSize Size of the data
+ * @param bf Compressed buffer allocator
+ * @param dictionary The dictionary, with its compression level
+ * @return Size of compressed data, or zero if failed to compress
+ */
+template <typename BufferFactory>
+std::size_t
+zstdCompress(
+    void const* in,
+    std::size_t inSize,
+    BufferFactory&& bf,
+    ZSTD_CDict const* dictionary)
+{
+    if (inSize > UINT32_MAX)
+        Throw<std::runtime_error>("zstd compress: invalid size");
+
+    auto const outCapacity = ZSTD_compressBound(inSize);
+
+    // Request the caller to allocate and return the buffer to hold compressed
+    // data
+    auto compressed = bf(outCapacity);
+
+    auto const compressedSize = ZSTD_compress_usingCDict(
+        detail::zstdCompressContext(),
+        compressed,
+        outCapacity,
+        in,
+        inSize,
+        dictionary);
+    if (ZSTD_isError(compressedSize))
+        Throw<std::runtime_error>("zstd compress: failed");
+
+    return compressedSize;
+}
+
+/**
+ * @param in Compressed data
+ * @param inSize Size of compressed data
+ * @param decompressed Buffer to hold decompressed data
+ * @param decompressedSize Size of the decompressed buffer
+ * @param dictionary The dictionary the data was compressed with
+ * @return size of the decompressed data
+ */
+inline std::size_t
+zstdDecompress(
+    std::uint8_t const* in,
+    std::size_t inSize,
+    std::uint8_t* decompressed,
+    std::size_t decompressedSize,
+    ZSTD_DDict const* dictionary)
+{
+    if (inSize == 0)
+        Throw<std::runtime_error>("zstdDecompress: empty input");
+
+    if (ZSTD_decompress_usingDDict(
+            detail::zstdDecompressContext(),
+            decompressed,
+            decompressedSize,
+            in,
+            inSize,
+            dictionary) != decompressedSize)
+        Throw<std::runtime_error>("zstdDecompress: failed");
+
+    return decompressedSize;
+}
+
+/** Zstandard decompression with a dictionary.
+ * @tparam InputStream ZeroCopyInputStream
+ * @param in Input source stream
+ * @param inSize Size of compressed data
+ * @param decompressed Buffer to hold decompressed data
+ * @param decompressedSize Size of the decompressed buffer
+ * @param dictionary The dictionary the data was compressed with
+ * @return size of the decompressed data
+ */
+template <typename InputStream>
+std::size_t
+zstdDecompress(
+    InputStream& in,
+    std::size_t inSize,
+    std::uint8_t* decompressed,
+    std::size_t decompressedSize,
+    ZSTD_DDict const* dictionary)
+{
+    std::vector<std::uint8_t> compressed;
+    auto const chunk = detail::readCompressed(in, inSize, compressed);
+    return zstdDecompress(
+        chunk, inSize, decompressed, decompressedSize, dictionary);
+}
+
 }  // namespace compression_algorithms
 
 }  // namespace ripple
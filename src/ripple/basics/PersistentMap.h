@@ -0,0 +1,436 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_PERSISTENTMAP_H_INCLUDED
+#define RIPPLE_BASICS_PERSISTENTMAP_H_INCLUDED
+
+#include <ripple/basics/hardened_hash.h>
+#include <boost/container/small_vector.hpp>
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace ripple {
+
+/** An ordered map whose copies share structure.
+
+    The map is a treap whose nodes are reference counted and never changed
+    while more than one map can reach them. Copying a map takes constant
+    time; a later insert or erase on either copy duplicates only the nodes
+    on the path to the changed key, so a copy costs what is changed in it
+    rather than what it holds. Nodes reachable from one map only are
+    changed in place, so a map that is not shared costs about as much to
+    fill as a std::map.
+
+    Node priorities come from a hash of the key seeded once per process,
+    which keeps the tree balanced whatever the order of the keys.
+
+    Iterators hold the tree they were taken from, so they stay valid, and
+    keep showing the same contents, however the map is changed after.
+
+    Distinct maps may be used from different threads, even if one is a
+    copy of the other. A single map needs external synchronization.
+*/
+template <
+    class Key,
+    class T,
+    class Compare = std::less<Key>,
+    class Hash = hardened_hash<>>
+class PersistentMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key const, T>;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+
+private:
+    struct Node;
+    using NodePtr = boost::intrusive_ptr<Node>;
+
+    struct Node
+    {
+        mutable std::atomic<std::uint32_t> refs{0};
+        value_type value;
+        std::size_t priority;
+        NodePtr left;
+        NodePtr right;
+
+        Node(Key const& key, T&& mapped, std::size_t priority_)
+            : value(key, std::move(mapped)), priority(priority_)
+        {
+        }
+
+        Node(Node const& other)
+            : value(other.value)
+            , priority(other.priority)
+            , left(other.left)
+            , right(other.right)
+        {
+        }
+
+        friend void
+        intrusive_ptr_add_ref(Node const* node)
+        {
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        friend void
+        intrusive_ptr_release(Node const* node)
+        {
+            if (node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete node;
+        }
+    };
+
+public:
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PersistentMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+
+        const_iterator() = default;
+
+        reference
+        operator*() const
+        {
+            return stack_.back()->value;
+        }
+
+        pointer
+        operator->() const
+        {
+            return &stack_.back()->value;
+        }
+
+        const_iterator&
+        operator++()
+        {
+            Node const* node = stack_.back();
+            stack_.pop_back();
+            pushLeft(node->right.get());
+            return *this;
+        }
+
+        const_iterator
+        operator++(int)
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        friend bool
+        operator==(const_iterator const& lhs, const_iterator const& rhs)
+        {
+            if (lhs.stack_.empty() || rhs.stack_.empty())
+                return lhs.stack_.empty() == rhs.stack_.empty();
+            return lhs.stack_.back() == rhs.stack_.back();
+        }
+
+        friend bool
+        operator!=(const_iterator const& lhs, const_iterator const& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend class PersistentMap;
+
+        explicit const_iterator(NodePtr const& root) : root_(root)
+        {
+        }
+
+        void
+        pushLeft(Node const* node)
+        {
+            for (; node; node = node->left.get())
+                stack_.push_back(node);
+        }
+
+        // The back of the stack is the current element. Below it are the
+        // ancestors still to be visited, each greater than the ones above.
+        boost::intrusive_ptr<Node const> root_;
+        boost::container::small_vector<Node const*, 32> stack_;
+    };
+
+    PersistentMap() = default;
+    PersistentMap(PersistentMap const&) = default;
+    PersistentMap(PersistentMap&&) = default;
+    PersistentMap&
+    operator=(PersistentMap const&) = default;
+    PersistentMap&
+    operator=(PersistentMap&&) = default;
+
+    size_type
+    size() const
+    {
+        return size_;
+    }
+
+    bool
+    empty() const
+    {
+        return size_ == 0;
+    }
+
+    void
+    clear()
+    {
+        root_.reset();
+        size_ = 0;
+    }
+
+    const_iterator
+    begin() const
+    {
+        const_iterator iter(root_);
+        iter.pushLeft(root_.get());
+        return iter;
+    }
+
+    const_iterator
+    end() const
+    {
+        return const_iterator(root_);
+    }
+
+    /** Return the first element whose key is not less than the given one. */
+    const_iterator
+    lower_bound(Key const& key) const
+    {
+        const_iterator iter(root_);
+        for (Node const* node = root_.get(); node;)
+        {
+            if (compare_(node->value.first, key))
+            {
+                node = node->right.get();
+            }
+            else
+            {
+                iter.stack_.push_back(node);
+                node = node->left.get();
+            }
+        }
+        return iter;
+    }
+
+    /** Return the first element whose key is greater than the given one. */
+    const_iterator
+    upper_bound(Key const& key) const
+    {
+        const_iterator iter(root_);
+        for (Node const* node = root_.get(); node;)
+        {
+            if (compare_(key, node->value.first))
+            {
+                iter.stack_.push_back(node);
+                node = node->left.get();
+            }
+            else
+            {
+                node = node->right.get();
+            }
+        }
+        return iter;
+    }
+
+    /** Return the value mapped to the key, or nullptr if there is none.
+
+        The pointer is invalidated by any change to the map.
+    */
+    T const*
+    lookup(Key const& key) const
+    {
+        for (Node const* node = root_.get(); node;)
+        {
+            if (compare_(key, node->value.first))
+                node = node->left.get();
+            else if (compare_(node->value.first, key))
+                node = node->right.get();
+            else
+                return &node->value.second;
+        }
+        return nullptr;
+    }
+
+    /** Add the key with the given value, if the key is not present.
+
+        @return `true` if the key was added.
+    */
+    bool
+    insert(Key const& key, T value)
+    {
+        if (!insert(root_, key, value, false))
+            return false;
+        ++size_;
+        return true;
+    }
+
+    /** Map the key to the given value, adding the key if not present.
+
+        @return `true` if the key was added.
+    */
+    bool
+    insert_or_assign(Key const& key, T value)
+    {
+        if (!insert(root_, key, value, true))
+            return false;
+        ++size_;
+        return true;
+    }
+
+    /** Remove the key, if present.
+
+        @return The number of elements removed.
+    */
+    size_type
+    erase(Key const& key)
+    {
+        // Check first, so a miss doesn't copy the path to it.
+        if (!lookup(key))
+            return 0;
+        erase(root_, key);
+        --size_;
+        return 1;
+    }
+
+private:
+    // Return the node for changing, copying it first unless this map is the
+    // only one which can reach it. The caller must already own the parent.
+    static Node&
+    own(NodePtr& node)
+    {
+        // The acquire pairs with the release of any other map which held
+        // the node, so its reads happen before our changes.
+        if (node->refs.load(std::memory_order_acquire) != 1)
+            node = new Node(*node);
+        return *node;
+    }
+
+    static std::size_t
+    priority(Key const& key)
+    {
+        static Hash const hash;
+        return hash(key);
+    }
+
+    // Both the node and its left child must be owned.
+    static void
+    rotateRight(NodePtr& node)
+    {
+        NodePtr child = std::move(node->left);
+        node->left = std::move(child->right);
+        child->right = std::move(node);
+        node = std::move(child);
+    }
+
+    // Both the node and its right child must be owned.
+    static void
+    rotateLeft(NodePtr& node)
+    {
+        NodePtr child = std::move(node->right);
+        node->right = std::move(child->left);
+        child->left = std::move(node);
+        node = std::move(child);
+    }
+
+    bool
+    insert(NodePtr& node, Key const& key, T& value, bool assign)
+    {
+        if (!node)
+        {
+            node = new Node(key, std::move(value), priority(key));
+            return true;
+        }
+
+        if (compare_(key, node->value.first))
+        {
+            Node& n = own(node);
+            if (!insert(n.left, key, value, assign))
+                return false;
+            if (n.left->priority > n.priority)
+                rotateRight(node);
+            return true;
+        }
+
+        if (compare_(node->value.first, key))
+        {
+            Node& n = own(node);
+            if (!insert(n.right, key, value, assign))
+                return false;
+            if (n.right->priority > n.priority)
+                rotateLeft(node);
+            return true;
+        }
+
+        if (assign)
+            own(node).value.second = std::move(value);
+        return false;
+    }
+
+    // The key must be present.
+    void
+    erase(NodePtr& node, Key const& key)
+    {
+        Node& n = own(node);
+        if (compare_(key, n.value.first))
+            return erase(n.left, key);
+        if (compare_(n.value.first, key))
+            return erase(n.right, key);
+        auto joined = join(std::move(n.left), std::move(n.right));
+        node = std::move(joined);
+    }
+
+    // Every key under lhs must be less than every key under rhs.
+    static NodePtr
+    join(NodePtr lhs, NodePtr rhs)
+    {
+        if (!lhs)
+            return rhs;
+        if (!rhs)
+            return lhs;
+        if (lhs->priority > rhs->priority)
+        {
+            Node& n = own(lhs);
+            n.right = join(std::move(n.right), std::move(rhs));
+            return lhs;
+        }
+        Node& n = own(rhs);
+        n.left = join(std::move(lhs), std::move(n.left));
+        return rhs;
+    }
+
+    NodePtr root_;
+    size_type size_ = 0;
+    Compare compare_;
+};
+
+}  // namespace ripple
+
+#endif
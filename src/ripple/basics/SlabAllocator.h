@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_SLABALLOCATOR_H_INCLUDED
+#define RIPPLE_BASICS_SLABALLOCATOR_H_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** Hands out blocks of one size, carved from large slabs.
+
+    Objects allocated by the million pay the general purpose allocator's
+    per-block header and rounding for each one. Slabs put the blocks side
+    by side instead, and a block costs exactly its size.
+
+    Each slab is aligned to its own size, so the slab owning a block is
+    found from the block's address alone. Threads take blocks through one
+    of a few arenas, each with its own lock, and a block goes back to the
+    arena which owns its slab. A slab whose blocks have all been freed is
+    returned to the system once its arena has another with room.
+*/
+class SlabAllocator
+{
+public:
+    struct Stats
+    {
+        // Bytes of the blocks currently handed out
+        std::size_t bytesInUse = 0;
+
+        // Slabs currently held, and the bytes they take
+        std::size_t slabs = 0;
+        std::size_t slabBytes = 0;
+
+        // Slabs obtained from the system since construction
+        std::size_t slabsAllocated = 0;
+    };
+
+    /** Create an allocator of blocks of the given size.
+
+        @param blockSize The size of each block. It is rounded up to a
+                         multiple of the largest fundamental alignment.
+        @param slabSize The size of each slab. Must be a power of two.
+    */
+    explicit SlabAllocator(
+        std::size_t blockSize,
+        std::size_t slabSize = 64 * 1024);
+
+    ~SlabAllocator();
+
+    SlabAllocator(SlabAllocator const&) = delete;
+    SlabAllocator&
+    operator=(SlabAllocator const&) = delete;
+
+    std::size_t
+    blockSize() const
+    {
+        return blockSize_;
+    }
+
+    /** Return a block, or throw std::bad_alloc. */
+    void*
+    allocate();
+
+    /** Return a block obtained from allocate(). */
+    void
+    deallocate(void* p) noexcept;
+
+    Stats
+    stats() const;
+
+private:
+    struct Arena;
+    struct Slab;
+
+    Slab*
+    makeSlab(Arena& arena);
+
+    void
+    freeSlab(Slab* slab) noexcept;
+
+    Arena&
+    arenaForThisThread();
+
+    std::size_t const blockSize_;
+    std::size_t const slabSize_;
+    std::size_t const blocksPerSlab_;
+    std::size_t const arenaCount_;
+    std::unique_ptr<Arena[]> const arenas_;
+
+    std::atomic<std::size_t> blocksInUse_{0};
+    std::atomic<std::size_t> slabs_{0};
+    std::atomic<std::size_t> slabsAllocated_{0};
+};
+
+//------------------------------------------------------------------------------
+
+/** Hands out blocks of any size from a set of slab allocators.
+
+    A request is served by the allocator with the smallest blocks that fit
+    it. Requests larger than the largest block go to operator new.
+*/
+class SlabAllocatorSet
+{
+public:
+    struct Stats
+    {
+        SlabAllocator::Stats slabs;
+
+        // Blocks too large for any slab, currently handed out
+        std::size_t oversize = 0;
+    };
+
+    /** Create the set.
+
+        @param blockSizes The block sizes of the allocators, in increasing
+                          order.
+        @param slabSize The size of each slab. Must be a power of two.
+    */
+    explicit SlabAllocatorSet(
+        std::vector<std::size_t> const& blockSizes,
+        std::size_t slabSize = 64 * 1024);
+
+    /** Return a block of at least the given size. */
+    void*
+    allocate(std::size_t size);
+
+    /** Return a block obtained from allocate() with the same size. */
+    void
+    deallocate(void* p, std::size_t size) noexcept;
+
+    Stats
+    stats() const;
+
+private:
+    SlabAllocator*
+    find(std::size_t size) const;
+
+    std::vector<std::unique_ptr<SlabAllocator>> allocators_;
+    std::atomic<std::size_t> oversize_{0};
+};
+
+}  // namespace ripple
+
+#endif
@@ -20,14 +20,17 @@
 #ifndef RIPPLE_BASICS_TAGGEDCACHE_H_INCLUDED
 #define RIPPLE_BASICS_TAGGEDCACHE_H_INCLUDED
 
+#include <ripple/basics/CacheSweeper.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/UnorderedContainers.h>
 #include <ripple/basics/hardened_hash.h>
 #include <ripple/beast/clock/abstract_clock.h>
 #include <ripple/beast/insight/Insight.h>
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <type_traits>
 #include <vector>
@@ -43,6 +46,12 @@ namespace ripple {
     If it stays in memory even after it is ejected from the cache,
     the map will track it.
 
+    When IsPartitionLocked is true, every partition of the underlying map
+    is guarded by its own mutex and keeps its own counters, so operations
+    on keys that fall in different partitions never contend and a sweep
+    only blocks one partition at a time. The cache-wide mutex then only
+    protects the target size and age, and peekMutex() is not available.
+
     @note Callers must not modify data objects that are stored in the cache
           unless they hold their own lock over all cache operations.
 */
@@ -52,7 +61,8 @@ template <
     bool IsKeyCache = false,
     class Hash = hardened_hash<>,
     class KeyEqual = std::equal_to<Key>,
-    class Mutex = std::recursive_mutex>
+    class Mutex = std::recursive_mutex,
+    bool IsPartitionLocked = false>
 class TaggedCache
 {
 public:
@@ -79,9 +89,7 @@ public:
         , m_name(name)
         , m_target_size(size)
         , m_target_age(expiration)
-        , m_cache_count(0)
-        , m_hits(0)
-        , m_misses(0)
+        , m_partitions(m_cache.partitions())
     {
     }
 
@@ -97,25 +105,29 @@ public:
     std::size_t
     size() const
     {
-        std::lock_guard lock(m_mutex);
-        return m_cache.size();
+        std::size_t ret = 0;
+        forEachPartition(
+            [&](std::size_t p) { ret += m_cache.map()[p].size(); });
+        return ret;
     }
 
     void
     setTargetSize(int s)
     {
-        std::lock_guard lock(m_mutex);
-        m_target_size = s;
+        {
+            std::lock_guard lock(m_mutex);
+            m_target_size = s;
+        }
 
         if (s > 0)
         {
-            for (auto& partition : m_cache.map())
-            {
+            forEachPartition([&](std::size_t p) {
+                auto& partition = m_cache.map()[p];
                 partition.rehash(static_cast<std::size_t>(
                     (s + (s >> 2)) /
                         (partition.max_load_factor() * m_cache.partitions()) +
                     1));
-            }
+            });
         }
 
         JLOG(m_journal.debug()) << m_name << " target size set to " << s;
@@ -140,41 +152,44 @@ public:
     int
     getCacheSize() const
     {
-        std::lock_guard lock(m_mutex);
-        return m_cache_count;
+        int ret = 0;
+        forEachPartition(
+            [&](std::size_t p) { ret += m_partitions[p].cacheCount; });
+        return ret;
     }
 
     int
     getTrackSize() const
     {
-        std::lock_guard lock(m_mutex);
-        return m_cache.size();
+        return size();
     }
 
     float
     getHitRate()
     {
-        std::lock_guard lock(m_mutex);
-        auto const total = static_cast<float>(m_hits + m_misses);
-        return m_hits * (100.0f / std::max(1.0f, total));
+        auto const [hits, misses] = hitsAndMisses();
+        auto const total = static_cast<float>(hits + misses);
+        return hits * (100.0f / std::max(1.0f, total));
     }
 
     void
     clear()
     {
-        std::lock_guard lock(m_mutex);
-        m_cache.clear();
-        m_cache_count = 0;
+        forEachPartition([&](std::size_t p) {
+            m_cache.map()[p].clear();
+            m_partitions[p].cacheCount = 0;
+        });
     }
 
     void
     reset()
     {
-        std::lock_guard lock(m_mutex);
-        m_cache.clear();
-        m_cache_count = 0;
-        m_hits = 0;
-        m_misses = 0;
+        forEachPartition([&](std::size_t p) {
+            m_cache.map()[p].clear();
+            m_partitions[p].cacheCount = 0;
+            m_partitions[p].hits = 0;
+            m_partitions[p].misses = 0;
+        });
     }
 
     /** Refresh the last access time on a key if present.
@@ -184,9 +199,11 @@ public:
     bool
     touch_if_exists(KeyComparable const& key)
     {
-        std::lock_guard lock(m_mutex);
-        auto const iter(m_cache.find(key));
-        if (iter == m_cache.end())
+        auto const p = partitionOf(key);
+        auto const lock = lockPartition(p);
+        auto& partition = m_cache.map()[p];
+        auto const iter(partition.find(key));
+        if (iter == partition.end())
         {
             ++m_stats.misses;
             return false;
@@ -200,69 +217,97 @@ public:
         std::vector<std::shared_ptr<mapped_type>>,
         std::vector<std::weak_ptr<mapped_type>>>;
 
+    /** Remove expired entries.
+
+        Partitions are swept in parallel on the shared WorkerPool,
+        in slices no longer than CacheSweeper::budget(). Between slices
+        the sweep releases its lock so other threads are not stalled by a
+        large cache.
+    */
     void
     sweep()
     {
         // Keep references to all the stuff we sweep
-        // For performance, each worker thread should exit before the swept data
-        // is destroyed but still within the main cache lock.
+        // so that we can destroy them outside the lock.
         std::vector<SweptPointersVector> allStuffToSweep(m_cache.partitions());
+        std::vector<SweepState> states(m_cache.partitions());
+
+        auto& sweeper = CacheSweeper::instance();
+        auto const budget = sweeper.budget();
 
         clock_type::time_point const now(m_clock.now());
-        clock_type::time_point when_expire;
 
         auto const start = std::chrono::steady_clock::now();
         {
-            std::lock_guard lock(m_mutex);
-
-            if (m_target_size == 0 ||
-                (static_cast<int>(m_cache.size()) <= m_target_size))
-            {
-                when_expire = now - m_target_age;
-            }
-            else
-            {
-                when_expire =
-                    now - m_target_age * m_target_size / m_cache.size();
-
-                clock_type::duration const minimumAge(std::chrono::seconds(1));
-                if (when_expire > (now - minimumAge))
-                    when_expire = now - minimumAge;
-
-                JLOG(m_journal.trace())
-                    << m_name << " is growing fast " << m_cache.size() << " of "
-                    << m_target_size << " aging at "
-                    << (now - when_expire).count() << " of "
-                    << m_target_age.count();
-            }
+            std::unique_lock lock(m_mutex);
+            auto const when_expire = expirationTime(now);
 
-            std::vector<std::thread> workers;
-            workers.reserve(m_cache.partitions());
-            std::atomic<int> allRemovals = 0;
-
-            for (std::size_t p = 0; p < m_cache.partitions(); ++p)
-            {
-                workers.push_back(sweepHelper(
+            auto const slice = [&](std::size_t p) {
+                auto const sliceStart = std::chrono::steady_clock::now();
+                sweepPartition(
                     when_expire,
                     now,
+                    p,
                     m_cache.map()[p],
                     allStuffToSweep[p],
-                    allRemovals,
-                    lock));
+                    states[p],
+                    sliceStart + budget);
+                states[p].longestSlice = std::max(
+                    states[p].longestSlice,
+                    std::chrono::steady_clock::now() - sliceStart);
+            };
+
+            if constexpr (IsPartitionLocked)
+            {
+                // Each partition is swept under its own lock, which is
+                // released between slices to let waiting threads in.
+                lock.unlock();
+                sweeper.run(m_cache.partitions(), [&](std::size_t p) {
+                    while (!states[p].done)
+                    {
+                        {
+                            auto const l = lockPartition(p);
+                            slice(p);
+                        }
+                        std::this_thread::yield();
+                    }
+                });
+            }
+            else
+            {
+                // The cache-wide lock covers every partition, so all of
+                // them advance by one slice before it is released.
+                for (;;)
+                {
+                    sweeper.run(m_cache.partitions(), [&](std::size_t p) {
+                        if (!states[p].done)
+                            slice(p);
+                    });
+
+                    if (std::all_of(
+                            states.begin(), states.end(), [](auto const& s) {
+                                return s.done;
+                            }))
+                        break;
+
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                }
             }
-            for (std::thread& worker : workers)
-                worker.join();
-
-            m_cache_count -= allRemovals;
         }
         // At this point allStuffToSweep will go out of scope outside the lock
         // and decrement the reference count on each strong pointer.
+        std::chrono::steady_clock::duration longestSlice{0};
+        for (auto const& state : states)
+            longestSlice = std::max(longestSlice, state.longestSlice);
+
+        using namespace std::chrono;
         JLOG(m_journal.debug())
-            << m_name << " TaggedCache sweep lock duration "
-            << std::chrono::duration_cast<std::chrono::milliseconds>(
-                   std::chrono::steady_clock::now() - start)
-                   .count()
-            << "ms";
+            << m_name << " TaggedCache sweep duration "
+            << duration_cast<milliseconds>(steady_clock::now() - start).count()
+            << "ms, longest lock duration "
+            << duration_cast<milliseconds>(longestSlice).count() << "ms";
     }
 
     bool
@@ -270,11 +315,13 @@ public:
     {
         // Remove from cache, if !valid, remove from map too. Returns true if
         // removed from cache
-        std::lock_guard lock(m_mutex);
+        auto const p = partitionOf(key);
+        auto const lock = lockPartition(p);
+        auto& partition = m_cache.map()[p];
 
-        auto cit = m_cache.find(key);
+        auto cit = partition.find(key);
 
-        if (cit == m_cache.end())
+        if (cit == partition.end())
             return false;
 
         Entry& entry = cit->second;
@@ -283,13 +330,13 @@ public:
 
         if (entry.isCached())
         {
-            --m_cache_count;
+            --m_partitions[p].cacheCount;
             entry.ptr.reset();
             ret = true;
         }
 
         if (!valid || entry.isExpired())
-            m_cache.erase(cit);
+            partition.erase(cit);
 
         return ret;
     }
@@ -316,17 +363,20 @@ public:
     {
         // Return canonical value, store if needed, refresh in cache
         // Return values: true=we had the data already
-        std::lock_guard lock(m_mutex);
+        auto const p = partitionOf(key);
+        auto const lock = lockPartition(p);
+        auto& partition = m_cache.map()[p];
+        auto& cacheCount = m_partitions[p].cacheCount;
 
-        auto cit = m_cache.find(key);
+        auto cit = partition.find(key);
 
-        if (cit == m_cache.end())
+        if (cit == partition.end())
         {
-            m_cache.emplace(
+            partition.emplace(
                 std::piecewise_construct,
                 std::forward_as_tuple(key),
                 std::forward_as_tuple(m_clock.now(), data));
-            ++m_cache_count;
+            ++cacheCount;
             return false;
         }
 
@@ -363,13 +413,13 @@ public:
                 data = cachedData;
             }
 
-            ++m_cache_count;
+            ++cacheCount;
             return true;
         }
 
         entry.ptr = data;
         entry.weak_ptr = data;
-        ++m_cache_count;
+        ++cacheCount;
 
         return false;
     }
@@ -395,10 +445,11 @@ public:
     std::shared_ptr<T>
     fetch(const key_type& key)
     {
-        std::lock_guard<mutex_type> l(m_mutex);
-        auto ret = initialFetch(key, l);
+        auto const p = partitionOf(key);
+        auto const l = lockPartition(p);
+        auto ret = initialFetch(key, p, l);
         if (!ret)
-            ++m_misses;
+            ++m_partitions[p].misses;
         return ret;
     }
 
@@ -419,9 +470,10 @@ public:
     auto
     insert(key_type const& key) -> std::enable_if_t<IsKeyCache, ReturnType>
     {
-        std::lock_guard lock(m_mutex);
+        auto const p = partitionOf(key);
+        auto const lock = lockPartition(p);
         clock_type::time_point const now(m_clock.now());
-        auto [it, inserted] = m_cache.emplace(
+        auto [it, inserted] = m_cache.map()[p].emplace(
             std::piecewise_construct,
             std::forward_as_tuple(key),
             std::forward_as_tuple(now));
@@ -448,8 +500,13 @@ public:
         return true;
     }
 
-    mutex_type&
-    peekMutex()
+    /** Return the cache-wide mutex.
+        Only available without partition locking: holding this mutex does
+        not exclude operations on a partition-locked cache.
+    */
+    template <class ReturnType = mutex_type&>
+    auto
+    peekMutex() -> std::enable_if_t<!IsPartitionLocked, ReturnType>
     {
         return m_mutex;
     }
@@ -458,14 +515,11 @@ public:
     getKeys() const
     {
         std::vector<key_type> v;
-
-        {
-            std::lock_guard lock(m_mutex);
-            v.reserve(m_cache.size());
-            for (auto const& _ : m_cache)
+        v.reserve(size());
+        forEachPartition([&](std::size_t p) {
+            for (auto const& _ : m_cache.map()[p])
                 v.push_back(_.first);
-        }
-
+        });
         return v;
     }
 
@@ -474,11 +528,11 @@ public:
     double
     rate() const
     {
-        std::lock_guard lock(m_mutex);
-        auto const tot = m_hits + m_misses;
+        auto const [hits, misses] = hitsAndMisses();
+        auto const tot = hits + misses;
         if (tot == 0)
             return 0;
-        return double(m_hits) / tot;
+        return double(hits) / tot;
     }
 
     /** Fetch an item from the cache.
@@ -490,9 +544,10 @@ public:
     std::shared_ptr<T>
     fetch(key_type const& digest, Handler const& h)
     {
+        auto const p = partitionOf(digest);
         {
-            std::lock_guard l(m_mutex);
-            if (auto ret = initialFetch(digest, l))
+            auto const l = lockPartition(p);
+            if (auto ret = initialFetch(digest, p, l))
                 return ret;
         }
 
@@ -500,10 +555,10 @@ public:
         if (!sle)
             return {};
 
-        std::lock_guard l(m_mutex);
-        ++m_misses;
-        auto const [it, inserted] =
-            m_cache.emplace(digest, Entry(m_clock.now(), std::move(sle)));
+        auto const l = lockPartition(p);
+        ++m_partitions[p].misses;
+        auto const [it, inserted] = m_cache.map()[p].emplace(
+            digest, Entry(m_clock.now(), std::move(sle)));
         if (!inserted)
             it->second.touch(m_clock.now());
         return it->second.ptr;
@@ -511,17 +566,108 @@ public:
     // End CachedSLEs functions.
 
 private:
+    using partition_lock = std::unique_lock<mutex_type>;
+
+    std::size_t
+    partitionOf(key_type const& key) const
+    {
+        return partitioner(key, m_cache.partitions());
+    }
+
+    /** Lock the state of a single partition.
+        This is the partition's own mutex with partition locking, and the
+        cache-wide mutex otherwise.
+    */
+    partition_lock
+    lockPartition(std::size_t p) const
+    {
+        if constexpr (IsPartitionLocked)
+            return partition_lock(m_partitions[p].mutex);
+        else
+            return partition_lock(m_mutex);
+    }
+
+    /** Invoke f with the index of each partition while it is locked.
+        Without partition locking the cache-wide mutex is held across all
+        of the calls so the result is a consistent snapshot.
+    */
+    template <class F>
+    void
+    forEachPartition(F&& f) const
+    {
+        if constexpr (IsPartitionLocked)
+        {
+            for (std::size_t p = 0; p < m_partitions.size(); ++p)
+            {
+                std::lock_guard lock(m_partitions[p].mutex);
+                f(p);
+            }
+        }
+        else
+        {
+            std::lock_guard lock(m_mutex);
+            for (std::size_t p = 0; p < m_partitions.size(); ++p)
+                f(p);
+        }
+    }
+
+    std::pair<std::uint64_t, std::uint64_t>
+    hitsAndMisses() const
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        forEachPartition([&](std::size_t p) {
+            hits += m_partitions[p].hits;
+            misses += m_partitions[p].misses;
+        });
+        return {hits, misses};
+    }
+
+    // Requires the lock on m_mutex
+    clock_type::time_point
+    expirationTime(clock_type::time_point const& now) const
+    {
+        // Without partition locking the caller holds m_mutex, which
+        // protects the partitions as well.
+        std::size_t const trackSize = [this] {
+            if constexpr (IsPartitionLocked)
+                return size();
+            else
+                return m_cache.size();
+        }();
+
+        if (m_target_size == 0 ||
+            (static_cast<int>(trackSize) <= m_target_size))
+        {
+            return now - m_target_age;
+        }
+
+        auto when_expire = now - m_target_age * m_target_size / trackSize;
+
+        clock_type::duration const minimumAge(std::chrono::seconds(1));
+        if (when_expire > (now - minimumAge))
+            when_expire = now - minimumAge;
+
+        JLOG(m_journal.trace())
+            << m_name << " is growing fast " << trackSize << " of "
+            << m_target_size << " aging at " << (now - when_expire).count()
+            << " of " << m_target_age.count();
+
+        return when_expire;
+    }
+
     std::shared_ptr<T>
-    initialFetch(key_type const& key, std::lock_guard<mutex_type> const& l)
+    initialFetch(key_type const& key, std::size_t p, partition_lock const&)
     {
-        auto cit = m_cache.find(key);
-        if (cit == m_cache.end())
+        auto& partition = m_cache.map()[p];
+        auto cit = partition.find(key);
+        if (cit == partition.end())
             return {};
 
         Entry& entry = cit->second;
         if (entry.isCached())
         {
-            ++m_hits;
+            ++m_partitions[p].hits;
             entry.touch(m_clock.now());
             return entry.ptr;
         }
@@ -529,12 +675,12 @@ private:
         if (entry.isCached())
         {
             // independent of cache size, so not counted as a hit
-            ++m_cache_count;
+            ++m_partitions[p].cacheCount;
             entry.touch(m_clock.now());
             return entry.ptr;
         }
 
-        m_cache.erase(cit);
+        partition.erase(cit);
         return {};
     }
 
@@ -546,10 +692,10 @@ private:
         {
             beast::insight::Gauge::value_type hit_rate(0);
             {
-                std::lock_guard lock(m_mutex);
-                auto const total(m_hits + m_misses);
+                auto const [hits, misses] = hitsAndMisses();
+                auto const total(hits + misses);
                 if (total != 0)
-                    hit_rate = (m_hits * 100) / total;
+                    hit_rate = (hits * 100) / total;
             }
             m_stats.hit_rate.set(hit_rate);
         }
@@ -575,8 +721,21 @@ private:
         beast::insight::Gauge size;
         beast::insight::Gauge hit_rate;
 
-        std::size_t hits;
-        std::size_t misses;
+        std::atomic<std::size_t> hits;
+        std::atomic<std::size_t> misses;
+    };
+
+    // Per partition state. The mutex is only used with partition locking;
+    // otherwise the counters are protected by m_mutex. Aligned so that
+    // threads working on neighbouring partitions do not share cache lines.
+    struct alignas(64) Partition
+    {
+        mutex_type mutable mutex;
+
+        // Number of items cached
+        int cacheCount = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
     };
 
     class KeyOnlyEntry
@@ -650,126 +809,184 @@ private:
     using cache_type =
         hardened_partitioned_hash_map<key_type, Entry, Hash, KeyEqual>;
 
-    [[nodiscard]] std::thread
-    sweepHelper(
+    // Progress of the sweep of one partition
+    struct SweepState
+    {
+        // Bucket to resume from, zero before the first slice, and the
+        // bucket count it refers to. Buckets keep their place unless an
+        // insert rehashes the partition, which restarts its sweep.
+        std::size_t bucket = 0;
+        std::size_t bucketCount = 0;
+        bool done = false;
+        int cacheRemovals = 0;
+        int mapRemovals = 0;
+        std::chrono::steady_clock::duration longestSlice{0};
+    };
+
+    // How many entries to examine between checks of the slice deadline
+    static constexpr int sweepDeadlineStride = 64;
+
+    /** Sweep one slice of a partition.
+
+        Examines the partition bucket by bucket from where the previous
+        slice stopped, until every bucket was examined or the deadline
+        passes. Without partition locking the caller holds m_mutex; with it,
+        the partition's lock.
+
+        If the partition was rehashed in between, its buckets were
+        reordered, and the sweep starts over. Examining an entry twice is
+        harmless.
+    */
+    void
+    sweepPartition(
         clock_type::time_point const& when_expire,
         [[maybe_unused]] clock_type::time_point const& now,
+        std::size_t p,
         typename KeyValueCacheType::map_type& partition,
         SweptPointersVector& stuffToSweep,
-        std::atomic<int>& allRemovals,
-        std::lock_guard<std::recursive_mutex> const&)
+        SweepState& state,
+        std::chrono::steady_clock::time_point deadline)
     {
-        return std::thread([&, this]() {
-            int cacheRemovals = 0;
-            int mapRemovals = 0;
+        int cacheRemovals = 0;
 
+        auto b = resumeBucket(partition, state);
+        if (b == 0)
+        {
             // Keep references to all the stuff we sweep
             // so that we can destroy them outside the lock.
             stuffToSweep.first.reserve(partition.size());
             stuffToSweep.second.reserve(partition.size());
+        }
+
+        // Entries can't be erased through a bucket's iterators, so those
+        // to remove are erased by key once their bucket was examined.
+        std::vector<key_type> removed;
+        for (int n = 0; b < state.bucketCount; ++b)
+        {
+            if (n >= sweepDeadlineStride)
             {
-                auto cit = partition.begin();
-                while (cit != partition.end())
+                n = 0;
+                if (std::chrono::steady_clock::now() >= deadline)
                 {
-                    if (cit->second.isWeak())
+                    state.bucket = b;
+                    break;
+                }
+            }
+
+            for (auto cit = partition.begin(b); cit != partition.end(b);
+                 ++cit, ++n)
+            {
+                if (cit->second.isWeak())
+                {
+                    // weak
+                    if (cit->second.isExpired())
                     {
-                        // weak
-                        if (cit->second.isExpired())
-                        {
-                            stuffToSweep.second.push_back(
-                                std::move(cit->second.weak_ptr));
-                            ++mapRemovals;
-                            cit = partition.erase(cit);
-                        }
-                        else
-                        {
-                            ++cit;
-                        }
+                        stuffToSweep.second.push_back(
+                            std::move(cit->second.weak_ptr));
+                        removed.push_back(cit->first);
                     }
-                    else if (cit->second.last_access <= when_expire)
+                }
+                else if (cit->second.last_access <= when_expire)
+                {
+                    // strong, expired
+                    ++cacheRemovals;
+                    if (cit->second.ptr.use_count() == 1)
                     {
-                        // strong, expired
-                        ++cacheRemovals;
-                        if (cit->second.ptr.use_count() == 1)
-                        {
-                            stuffToSweep.first.push_back(
-                                std::move(cit->second.ptr));
-                            ++mapRemovals;
-                            cit = partition.erase(cit);
-                        }
-                        else
-                        {
-                            // remains weakly cached
-                            cit->second.ptr.reset();
-                            ++cit;
-                        }
+                        stuffToSweep.first.push_back(
+                            std::move(cit->second.ptr));
+                        removed.push_back(cit->first);
                     }
                     else
                     {
-                        // strong, not expired
-                        ++cit;
+                        // remains weakly cached
+                        cit->second.ptr.reset();
                     }
                 }
             }
 
-            if (mapRemovals || cacheRemovals)
-            {
-                JLOG(m_journal.debug())
-                    << "TaggedCache partition sweep " << m_name
-                    << ": cache = " << partition.size() << "-" << cacheRemovals
-                    << ", map-=" << mapRemovals;
-            }
+            state.mapRemovals += removed.size();
+            for (auto const& key : removed)
+                partition.erase(key);
+            removed.clear();
+        }
 
-            allRemovals += cacheRemovals;
-        });
+        m_partitions[p].cacheCount -= cacheRemovals;
+        state.cacheRemovals += cacheRemovals;
+
+        if (b == state.bucketCount)
+            finishPartition(partition, state);
     }
 
-    [[nodiscard]] std::thread
-    sweepHelper(
+    void
+    sweepPartition(
         clock_type::time_point const& when_expire,
         clock_type::time_point const& now,
+        std::size_t,
         typename KeyOnlyCacheType::map_type& partition,
         SweptPointersVector&,
-        std::atomic<int>& allRemovals,
-        std::lock_guard<std::recursive_mutex> const&)
+        SweepState& state,
+        std::chrono::steady_clock::time_point deadline)
     {
-        return std::thread([&, this]() {
-            int cacheRemovals = 0;
-            int mapRemovals = 0;
-
-            // Keep references to all the stuff we sweep
-            // so that we can destroy them outside the lock.
+        std::vector<key_type> removed;
+        auto b = resumeBucket(partition, state);
+        for (int n = 0; b < state.bucketCount; ++b)
+        {
+            if (n >= sweepDeadlineStride)
             {
-                auto cit = partition.begin();
-                while (cit != partition.end())
+                n = 0;
+                if (std::chrono::steady_clock::now() >= deadline)
                 {
-                    if (cit->second.last_access > now)
-                    {
-                        cit->second.last_access = now;
-                        ++cit;
-                    }
-                    else if (cit->second.last_access <= when_expire)
-                    {
-                        cit = partition.erase(cit);
-                    }
-                    else
-                    {
-                        ++cit;
-                    }
+                    state.bucket = b;
+                    break;
                 }
             }
 
-            if (mapRemovals || cacheRemovals)
+            for (auto cit = partition.begin(b); cit != partition.end(b);
+                 ++cit, ++n)
             {
-                JLOG(m_journal.debug())
-                    << "TaggedCache partition sweep " << m_name
-                    << ": cache = " << partition.size() << "-" << cacheRemovals
-                    << ", map-=" << mapRemovals;
+                if (cit->second.last_access > now)
+                    cit->second.last_access = now;
+                else if (cit->second.last_access <= when_expire)
+                    removed.push_back(cit->first);
             }
 
-            allRemovals += cacheRemovals;
-        });
-    };
+            for (auto const& key : removed)
+                partition.erase(key);
+            removed.clear();
+        }
+
+        if (b == state.bucketCount)
+            finishPartition(partition, state);
+    }
+
+    // The bucket a slice starts from. Starts over if the partition was
+    // rehashed since the previous slice.
+    template <class Map>
+    static std::size_t
+    resumeBucket(Map const& partition, SweepState& state)
+    {
+        auto b = state.bucket;
+        if (state.bucketCount != partition.bucket_count())
+            b = 0;
+        state.bucket = 0;
+        state.bucketCount = partition.bucket_count();
+        return b;
+    }
+
+    template <class Map>
+    void
+    finishPartition(Map const& partition, SweepState& state)
+    {
+        state.done = true;
+
+        if (state.mapRemovals || state.cacheRemovals)
+        {
+            JLOG(m_journal.debug())
+                << "TaggedCache partition sweep " << m_name
+                << ": cache = " << partition.size() << "-"
+                << state.cacheRemovals << ", map-=" << state.mapRemovals;
+        }
+    }
 
     beast::Journal m_journal;
     clock_type& m_clock;
@@ -786,13 +1003,23 @@ private:
     // Desired maximum cache age
     clock_type::duration m_target_age;
 
-    // Number of items cached
-    int m_cache_count;
     cache_type m_cache;  // Hold strong reference to recent objects
-    std::uint64_t m_hits;
-    std::uint64_t m_misses;
+
+    // Locks and counters, one per partition of m_cache
+    std::vector<Partition> m_partitions;
 };
 
+/** A TaggedCache that locks each of its partitions separately. */
+template <class Key, class T, bool IsKeyCache = false>
+using PartitionedTaggedCache = TaggedCache<
+    Key,
+    T,
+    IsKeyCache,
+    hardened_hash<>,
+    std::equal_to<Key>,
+    std::mutex,
+    true>;
+
 }  // namespace ripple
 
 #endif
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_WORKERPOOL_H_INCLUDED
+#define RIPPLE_BASICS_WORKERPOOL_H_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+/** Long-lived worker threads for splitting one task across cores.
+
+    Code below the JobQueue in the levelization, such as cache sweeps and
+    SHAMap flushes, hands batches of independent items to this pool rather
+    than starting threads of its own. The thread calling run() also works
+    on its batch, so a batch makes progress even while the pool is busy
+    with another one.
+
+    The process-wide pool has a thread per core and is meant for work that
+    keeps them busy. Work that mostly waits, such as disk reads, should use
+    a pool of its own instead.
+*/
+class WorkerPool
+{
+public:
+    /** Start a pool with the given number of threads.
+        With none, run() does all the work on the calling thread.
+    */
+    explicit WorkerPool(std::size_t threads);
+    ~WorkerPool();
+
+    WorkerPool(WorkerPool const&) = delete;
+    WorkerPool&
+    operator=(WorkerPool const&) = delete;
+
+    /** Return the process-wide pool, starting its threads on first use. */
+    static WorkerPool&
+    instance();
+
+    /** Call f(i) for every i in [0, n) and wait for all calls to return.
+        The calls are spread across the pool and the calling thread.
+
+        If a call throws, items not yet started are skipped, and the first
+        exception is rethrown once every started call has returned.
+    */
+    void
+    run(std::size_t n, std::function<void(std::size_t)> const& f);
+
+    std::size_t
+    threads() const
+    {
+        return threads_.size();
+    }
+
+private:
+    struct Batch
+    {
+        std::function<void(std::size_t)> const& f;
+        std::size_t const n;
+        std::atomic<std::size_t> next{0};
+        std::size_t finished = 0;
+        std::condition_variable done;
+
+        // The first exception thrown by f
+        std::exception_ptr error;
+
+        Batch(std::function<void(std::size_t)> const& f_, std::size_t n_)
+            : f(f_), n(n_)
+        {
+        }
+    };
+
+    void
+    work(Batch& batch, std::unique_lock<std::mutex>& lock);
+
+    void
+    worker();
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::deque<std::shared_ptr<Batch>> batches_;
+    bool stop_ = false;
+    std::vector<std::thread> threads_;
+};
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,286 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/SlabAllocator.h>
+#include <ripple/basics/contract.h>
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace ripple {
+
+namespace {
+
+std::size_t constexpr blockAlignment = alignof(std::max_align_t);
+
+std::size_t constexpr
+roundUp(std::size_t size, std::size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+struct alignas(64) SlabAllocator::Arena
+{
+    std::mutex mutex;
+
+    // Slabs with at least one free block
+    Slab* available = nullptr;
+};
+
+// The header at the start of each slab. The blocks follow it.
+struct SlabAllocator::Slab
+{
+    Arena* const arena;
+    Slab* prev = nullptr;
+    Slab* next = nullptr;
+
+    // Blocks which were handed out and have come back
+    void* free = nullptr;
+
+    // Blocks handed out now, and blocks handed out at least once
+    std::size_t used = 0;
+    std::size_t carved = 0;
+
+    explicit Slab(Arena* arena_) : arena(arena_)
+    {
+    }
+
+    std::uint8_t*
+    blocks()
+    {
+        return reinterpret_cast<std::uint8_t*>(this) +
+            roundUp(sizeof(Slab), blockAlignment);
+    }
+
+    void
+    link()
+    {
+        next = arena->available;
+        if (next)
+            next->prev = this;
+        arena->available = this;
+    }
+
+    void
+    unlink()
+    {
+        if (prev)
+            prev->next = next;
+        else
+            arena->available = next;
+        if (next)
+            next->prev = prev;
+        prev = next = nullptr;
+    }
+};
+
+SlabAllocator::SlabAllocator(std::size_t blockSize, std::size_t slabSize)
+    : blockSize_(roundUp(std::max(blockSize, sizeof(void*)), blockAlignment))
+    , slabSize_(slabSize)
+    , blocksPerSlab_(
+          slabSize > roundUp(sizeof(Slab), blockAlignment)
+              ? (slabSize - roundUp(sizeof(Slab), blockAlignment)) /
+                  blockSize_
+              : 0)
+    , arenaCount_(std::clamp(std::thread::hardware_concurrency(), 1u, 8u))
+    , arenas_(std::make_unique<Arena[]>(arenaCount_))
+{
+    if ((slabSize_ & (slabSize_ - 1)) != 0)
+        Throw<std::invalid_argument>("SlabAllocator: slab size not 2^n");
+    if (blocksPerSlab_ == 0)
+        Throw<std::invalid_argument>("SlabAllocator: block size too large");
+}
+
+SlabAllocator::~SlabAllocator()
+{
+    // Every block must have been returned, which leaves every slab on
+    // the available list of its arena.
+    assert(blocksInUse_ == 0);
+    for (std::size_t i = 0; i < arenaCount_; ++i)
+    {
+        while (auto const slab = arenas_[i].available)
+        {
+            slab->unlink();
+            freeSlab(slab);
+        }
+    }
+}
+
+void*
+SlabAllocator::allocate()
+{
+    auto& arena = arenaForThisThread();
+    void* p;
+    {
+        std::lock_guard lock(arena.mutex);
+        auto slab = arena.available;
+        if (!slab)
+        {
+            slab = makeSlab(arena);
+            slab->link();
+        }
+
+        if (slab->free)
+        {
+            p = slab->free;
+            slab->free = *static_cast<void**>(p);
+        }
+        else
+        {
+            p = slab->blocks() + slab->carved * blockSize_;
+            ++slab->carved;
+        }
+
+        if (++slab->used == blocksPerSlab_)
+            slab->unlink();
+    }
+    blocksInUse_.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+void
+SlabAllocator::deallocate(void* p) noexcept
+{
+    assert(p);
+    auto const slab = reinterpret_cast<Slab*>(
+        reinterpret_cast<std::uintptr_t>(p) & ~(slabSize_ - 1));
+    auto& arena = *slab->arena;
+    Slab* release = nullptr;
+    {
+        std::lock_guard lock(arena.mutex);
+        bool const wasFull = slab->used == blocksPerSlab_;
+        *static_cast<void**>(p) = slab->free;
+        slab->free = p;
+        --slab->used;
+
+        if (wasFull)
+        {
+            slab->link();
+        }
+        else if (
+            slab->used == 0 && (arena.available != slab || slab->next))
+        {
+            // Keep an empty slab only if the arena has nothing else
+            slab->unlink();
+            release = slab;
+        }
+    }
+    if (release)
+        freeSlab(release);
+    blocksInUse_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+auto
+SlabAllocator::stats() const -> Stats
+{
+    Stats s;
+    s.bytesInUse = blocksInUse_.load(std::memory_order_relaxed) * blockSize_;
+    s.slabs = slabs_.load(std::memory_order_relaxed);
+    s.slabBytes = s.slabs * slabSize_;
+    s.slabsAllocated = slabsAllocated_.load(std::memory_order_relaxed);
+    return s;
+}
+
+auto
+SlabAllocator::makeSlab(Arena& arena) -> Slab*
+{
+    auto const memory = ::operator new(slabSize_, std::align_val_t{slabSize_});
+    ++slabs_;
+    ++slabsAllocated_;
+    return new (memory) Slab(&arena);
+}
+
+void
+SlabAllocator::freeSlab(Slab* slab) noexcept
+{
+    slab->~Slab();
+    ::operator delete(slab, std::align_val_t{slabSize_});
+    --slabs_;
+}
+
+auto
+SlabAllocator::arenaForThisThread() -> Arena&
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t const index = next++;
+    return arenas_[index % arenaCount_];
+}
+
+//------------------------------------------------------------------------------
+
+SlabAllocatorSet::SlabAllocatorSet(
+    std::vector<std::size_t> const& blockSizes,
+    std::size_t slabSize)
+{
+    assert(std::is_sorted(blockSizes.begin(), blockSizes.end()));
+    allocators_.reserve(blockSizes.size());
+    for (auto const size : blockSizes)
+        allocators_.push_back(std::make_unique<SlabAllocator>(size, slabSize));
+}
+
+SlabAllocator*
+SlabAllocatorSet::find(std::size_t size) const
+{
+    auto const iter = std::find_if(
+        allocators_.begin(), allocators_.end(), [size](auto const& a) {
+            return a->blockSize() >= size;
+        });
+    return iter == allocators_.end() ? nullptr : iter->get();
+}
+
+void*
+SlabAllocatorSet::allocate(std::size_t size)
+{
+    if (auto const allocator = find(size))
+        return allocator->allocate();
+    auto const p = ::operator new(size);
+    oversize_.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+void
+SlabAllocatorSet::deallocate(void* p, std::size_t size) noexcept
+{
+    if (auto const allocator = find(size))
+        return allocator->deallocate(p);
+    ::operator delete(p);
+    oversize_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+auto
+SlabAllocatorSet::stats() const -> Stats
+{
+    Stats s;
+    for (auto const& allocator : allocators_)
+    {
+        auto const a = allocator->stats();
+        s.slabs.bytesInUse += a.bytesInUse;
+        s.slabs.slabs += a.slabs;
+        s.slabs.slabBytes += a.slabBytes;
+        s.slabs.slabsAllocated += a.slabsAllocated;
+    }
+    s.oversize = oversize_.load(std::memory_order_relaxed);
+    return s;
+}
+
+}  // namespace ripple
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/WorkerPool.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <algorithm>
+
+namespace ripple {
+
+WorkerPool&
+WorkerPool::instance()
+{
+    static WorkerPool pool(
+        std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+WorkerPool::WorkerPool(std::size_t threads)
+{
+    threads_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        threads_.emplace_back(&WorkerPool::worker, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    wakeup_.notify_all();
+    for (auto& t : threads_)
+        t.join();
+}
+
+// Claim and run items of the batch until none are left unclaimed.
+// Called and returns with the lock held.
+void
+WorkerPool::work(Batch& batch, std::unique_lock<std::mutex>& lock)
+{
+    std::size_t ran = 0;
+    std::exception_ptr error;
+    lock.unlock();
+    for (auto i = batch.next++; i < batch.n; i = batch.next++)
+    {
+        ++ran;
+        try
+        {
+            batch.f(i);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+
+            // Skip the items nobody started, counting them as finished
+            if (auto const rest = batch.next.exchange(batch.n);
+                rest < batch.n)
+                ran += batch.n - rest;
+            break;
+        }
+    }
+    lock.lock();
+
+    if (error && !batch.error)
+        batch.error = error;
+
+    // Nothing left to claim, so stop offering the batch to workers
+    if (auto it = std::find_if(
+            batches_.begin(),
+            batches_.end(),
+            [&batch](auto const& b) { return b.get() == &batch; });
+        it != batches_.end())
+    {
+        batches_.erase(it);
+    }
+
+    batch.finished += ran;
+    if (batch.finished == batch.n)
+        batch.done.notify_all();
+}
+
+void
+WorkerPool::run(std::size_t n, std::function<void(std::size_t)> const& f)
+{
+    if (n == 0)
+        return;
+
+    auto batch = std::make_shared<Batch>(f, n);
+
+    std::unique_lock lock(mutex_);
+    if (n > 1 && !threads_.empty())
+    {
+        batches_.push_back(batch);
+        wakeup_.notify_all();
+    }
+
+    work(*batch, lock);
+    batch->done.wait(lock, [&batch] { return batch->finished == batch->n; });
+
+    if (batch->error)
+        std::rethrow_exception(batch->error);
+}
+
+void
+WorkerPool::worker()
+{
+    beast::setCurrentThreadName("worker pool");
+
+    std::unique_lock lock(mutex_);
+    for (;;)
+    {
+        wakeup_.wait(lock, [this] { return stop_ || !batches_.empty(); });
+        if (stop_)
+            return;
+
+        // Keep the batch alive even if its caller returns while we are
+        // finishing our last item.
+        auto batch = batches_.front();
+        work(*batch, lock);
+    }
+}
+
+}  // namespace ripple
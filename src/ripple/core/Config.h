@@ -110,6 +110,11 @@ private:
 
     bool USE_TX_TABLES = true;
 
+    // Find the transactions of accounts with an append-only index kept
+    // beside the transaction database, instead of its AccountTransactions
+    // table.
+    bool USE_ACCOUNT_TX_INDEX = false;
+
     /** Determines if the server will sign a tx, given an account's secret seed.
 
         In the past, this was allowed, but this functionality can have security
@@ -207,6 +212,9 @@ public:
     // Enable the experimental Ledger Replay functionality
     bool LEDGER_REPLAY = false;
 
+    // Execute the transactions of a new ledger speculatively in parallel
+    bool PARALLEL_APPLY = false;
+
     // Work queue limits
     int MAX_TRANSACTIONS = 250;
     static constexpr int MAX_JOB_QUEUE_TX = 1000;
@@ -218,6 +226,7 @@ public:
     // Thread pool configuration (0 = choose for me)
     int WORKERS = 0;           // jobqueue thread count. default: upto 6
     int IO_WORKERS = 0;        // io svc thread count. default: 2
+    int IO_CONTEXTS = 0;       // io svcs for connections. default: none
     int PREFETCH_WORKERS = 0;  // prefetch thread count. default: 4
 
     // Can only be set in code, specifically unit tests
@@ -227,6 +236,10 @@ public:
     // size, but we allow admins to explicitly set it in the config.
     std::optional<int> SWEEP_INTERVAL;
 
+    // Longest time, in milliseconds, that a cache sweep may hold a lock
+    // before yielding it.
+    std::optional<int> SWEEP_BUDGET;
+
     // Reduce-relay - these parameters are experimental.
     // Enable reduce-relay features
     // Validation/proposal reduce-relay feature
@@ -325,6 +338,18 @@ public:
         return USE_TX_TABLES;
     }
 
+    bool
+    useAccountTxIndex() const
+    {
+        return USE_ACCOUNT_TX_INDEX;
+    }
+
+    void
+    setUseAccountTxIndex(bool b)
+    {
+        USE_ACCOUNT_TX_INDEX = b;
+    }
+
     bool
     reportingReadOnly() const
     {
@@ -29,6 +29,8 @@
 #include <boost/coroutine/all.hpp>
 #include <boost/range/begin.hpp>  // workaround for boost 1.72 bug
 #include <boost/range/end.hpp>    // workaround for boost 1.72 bug
+#include <array>
+#include <deque>
 
 namespace ripple {
 
@@ -242,10 +244,23 @@ private:
 
     using JobDataMap = std::map<JobType, JobTypeData>;
 
+    // Every job type has a bit in the mask of types with waiting jobs
+    static constexpr std::size_t maxJobTypes = 64;
+    static_assert(jtNS_WRITE < maxJobTypes);
+
     beast::Journal m_journal;
     mutable std::mutex m_mutex;
     std::uint64_t m_lastJob;
-    std::set<Job> m_jobSet;
+
+    // Waiting jobs in FIFO order, one queue per job type
+    std::array<std::deque<Job>, maxJobTypes> m_jobQueues;
+
+    // Bit N is set when the queue for job type N is not empty
+    std::uint64_t m_waitingTypes = 0;
+
+    // The number of waiting jobs of all types
+    std::size_t m_jobCount = 0;
+
     JobCounter jobCounter_;
     std::atomic_bool stopping_{false};
     std::atomic_bool stopped_{false};
@@ -290,15 +305,16 @@ private:
     // Returns the next Job we should run now.
     //
     // RunnableJob:
-    //  A Job in the JobSet whose slots count for its type is greater than zero.
+    //  A waiting Job whose slots count for its type is greater than zero.
+    //  The oldest RunnableJob of the highest priority type runs first.
     //
     // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
+    //  m_jobQueues must not be empty.
+    //  m_jobQueues holds at least one RunnableJob
     //
     // Post-conditions:
     //  job is a valid Job object.
-    //  job is removed from mJobQueue.
+    //  job is removed from its queue.
     //  Waiting job count of its type is decremented
     //  Running job count of its type is incremented
     //
@@ -310,7 +326,7 @@ private:
     // Indicates that a running Job has completed its task.
     //
     // Pre-conditions:
-    //  Job must not exist in mJobSet.
+    //  Job must not exist in m_jobQueues.
     //  The JobType must not be invalid.
     //
     // Post-conditions:
@@ -326,7 +342,7 @@ private:
     // Runs the next appropriate waiting Job.
     //
     // Pre-conditions:
-    //  A RunnableJob must exist in the JobSet
+    //  A RunnableJob must exist in m_jobQueues
     //
     // Post-conditions:
     //  The chosen RunnableJob will have Job::doJob() called.
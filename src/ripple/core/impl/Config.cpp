@@ -427,6 +427,8 @@ Config::setup(
     std::string ledgerTxDbType;
     Section ledgerTxTablesSection = section("ledger_tx_tables");
     get_if_exists(ledgerTxTablesSection, "use_tx_tables", USE_TX_TABLES);
+    get_if_exists(
+        ledgerTxTablesSection, "account_tx_index", USE_ACCOUNT_TX_INDEX);
 
     Section& nodeDbSection{section(ConfigSection::nodeDatabase())};
     get_if_exists(nodeDbSection, "fast_load", FAST_LOAD);
@@ -649,6 +651,15 @@ Config::loadFromString(std::string const& fileContents)
                                       ": must be between 10 and 600 inclusive");
     }
 
+    if (getSingleSection(secConfig, SECTION_SWEEP_BUDGET, strTemp, j_))
+    {
+        SWEEP_BUDGET = beast::lexicalCastThrow<int>(strTemp);
+
+        if (SWEEP_BUDGET < 1 || SWEEP_BUDGET > 1000)
+            Throw<std::runtime_error>("Invalid " SECTION_SWEEP_BUDGET
+                                      ": must be between 1 and 1000 inclusive");
+    }
+
     if (getSingleSection(secConfig, SECTION_WORKERS, strTemp, j_))
     {
         WORKERS = beast::lexicalCastThrow<int>(strTemp);
@@ -669,6 +680,16 @@ Config::loadFromString(std::string const& fileContents)
                 ": must be between 1 and 1024 inclusive.");
     }
 
+    if (getSingleSection(secConfig, SECTION_IO_CONTEXTS, strTemp, j_))
+    {
+        IO_CONTEXTS = beast::lexicalCastThrow<int>(strTemp);
+
+        if (IO_CONTEXTS < 1 || IO_CONTEXTS > 1024)
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_IO_CONTEXTS
+                ": must be between 1 and 1024 inclusive.");
+    }
+
     if (getSingleSection(secConfig, SECTION_PREFETCH_WORKERS, strTemp, j_))
     {
         PREFETCH_WORKERS = beast::lexicalCastThrow<int>(strTemp);
@@ -685,6 +706,9 @@ Config::loadFromString(std::string const& fileContents)
     if (getSingleSection(secConfig, SECTION_LEDGER_REPLAY, strTemp, j_))
         LEDGER_REPLAY = beast::lexicalCastThrow<bool>(strTemp);
 
+    if (getSingleSection(secConfig, SECTION_PARALLEL_APPLY, strTemp, j_))
+        PARALLEL_APPLY = beast::lexicalCastThrow<bool>(strTemp);
+
     if (exists(SECTION_REDUCE_RELAY))
     {
         auto sec = section(SECTION_REDUCE_RELAY);
@@ -20,6 +20,7 @@
 #include <ripple/basics/PerfLog.h>
 #include <ripple/basics/contract.h>
 #include <ripple/core/JobQueue.h>
+#include <bit>
 #include <mutex>
 
 namespace ripple {
@@ -71,7 +72,7 @@ void
 JobQueue::collect()
 {
     std::lock_guard lock(m_mutex);
-    job_count = m_jobSet.size();
+    job_count = m_jobCount;
 }
 
 bool
@@ -99,18 +100,13 @@ JobQueue::addRefCountedJob(
 
     {
         std::lock_guard lock(m_mutex);
-        auto result =
-            m_jobSet.emplace(type, name, ++m_lastJob, data.load(), func);
-        auto const& job = *result.first;
-
-        JobType const type(job.getType());
-        assert(type != jtINVALID);
-        assert(m_jobSet.find(job) != m_jobSet.end());
+        m_jobQueues[type].emplace_back(
+            type, name, ++m_lastJob, data.load(), func);
+        m_waitingTypes |= std::uint64_t(1) << type;
+        ++m_jobCount;
         perfLog_.jobQueue(type);
 
-        JobTypeData& data(getJobTypeData(type));
-
-        if (data.waiting + data.running < getJobLimit(type))
+        if (data.waiting + data.running < data.info.limit())
         {
             m_workers.addTask();
         }
@@ -254,7 +250,7 @@ void
 JobQueue::rendezvous()
 {
     std::unique_lock<std::mutex> lock(m_mutex);
-    cv_.wait(lock, [this] { return m_processCount == 0 && m_jobSet.empty(); });
+    cv_.wait(lock, [this] { return m_processCount == 0 && m_jobCount == 0; });
 }
 
 JobTypeData&
@@ -285,9 +281,9 @@ JobQueue::stop()
         // we must wait on the condition variable to make these assertions.
         std::unique_lock<std::mutex> lock(m_mutex);
         cv_.wait(
-            lock, [this] { return m_processCount == 0 && m_jobSet.empty(); });
+            lock, [this] { return m_processCount == 0 && m_jobCount == 0; });
         assert(m_processCount == 0);
-        assert(m_jobSet.empty());
+        assert(m_jobCount == 0);
         assert(nSuspend_ == 0);
         stopped_ = true;
     }
@@ -302,30 +298,40 @@ JobQueue::isStopped() const
 void
 JobQueue::getNextJob(Job& job)
 {
-    assert(!m_jobSet.empty());
+    assert(m_jobCount != 0);
 
-    std::set<Job>::const_iterator iter;
-    for (iter = m_jobSet.begin(); iter != m_jobSet.end(); ++iter)
+    // Visit the types with waiting jobs from the highest priority down
+    for (auto pending = m_waitingTypes; pending != 0;)
     {
-        JobType const type = iter->getType();
-        assert(type != jtINVALID);
+        auto const type =
+            static_cast<JobType>(maxJobTypes - 1 - std::countl_zero(pending));
+        auto const bit = std::uint64_t(1) << type;
+        pending &= ~bit;
 
         JobTypeData& data(getJobTypeData(type));
-        assert(data.running <= getJobLimit(type));
+        assert(data.running <= data.info.limit());
 
         // Run this job if we're running below the limit.
-        if (data.running < getJobLimit(data.type()))
+        if (data.running < data.info.limit())
         {
+            auto& queue = m_jobQueues[type];
             assert(data.waiting > 0);
+            assert(!queue.empty());
             --data.waiting;
             ++data.running;
-            break;
+
+            job = std::move(queue.front());
+            queue.pop_front();
+
+            if (queue.empty())
+                m_waitingTypes &= ~bit;
+            --m_jobCount;
+            return;
         }
     }
 
-    assert(iter != m_jobSet.end());
-    job = *iter;
-    m_jobSet.erase(iter);
+    // The pre-conditions guarantee a runnable job
+    assert(false);
 }
 
 void
@@ -392,7 +398,7 @@ JobQueue::processTask(int instance)
         // otherwise destructors with side effects can access
         // parent objects that are already destroyed.
         finishJob(type);
-        if (--m_processCount == 0 && m_jobSet.empty())
+        if (--m_processCount == 0 && m_jobCount == 0)
             cv_.notify_all();
     }
 
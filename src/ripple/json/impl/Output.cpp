@@ -72,11 +72,10 @@ outputJson(Json::Value const& value, Writer& writer)
 
         case Json::objectValue: {
             writer.startRoot(Writer::object);
-            auto members = value.getMemberNames();
-            for (auto const& tag : members)
+            for (auto i = value.begin(); i != value.end(); ++i)
             {
-                writer.rawSet(tag);
-                outputJson(value[tag], writer);
+                writer.rawSet(i.memberName());
+                outputJson(*i, writer);
             }
             writer.finish();
             break;
@@ -23,6 +23,8 @@
 #include <ripple/json/json_writer.h>
 #include <ripple/json/to_string.h>
 
+#include <tuple>
+
 namespace Json {
 
 const Value Value::null;
@@ -132,8 +134,10 @@ Value::CZString::~CZString()
 bool
 Value::CZString::operator<(const CZString& other) const
 {
+    // Static member names are usually looked up through the same pointer
+    // they were stored with, so identical pointers are checked first.
     if (cstr_ && other.cstr_)
-        return strcmp(cstr_, other.cstr_) < 0;
+        return cstr_ != other.cstr_ && strcmp(cstr_, other.cstr_) < 0;
 
     return index_ < other.index_;
 }
@@ -142,7 +146,7 @@ bool
 Value::CZString::operator==(const CZString& other) const
 {
     if (cstr_ && other.cstr_)
-        return strcmp(cstr_, other.cstr_) == 0;
+        return cstr_ == other.cstr_ || strcmp(cstr_, other.cstr_) == 0;
 
     return index_ == other.index_;
 }
@@ -165,6 +169,104 @@ Value::CZString::isStaticString() const
     return index_ == noDuplication;
 }
 
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// class Value::ObjectValues
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+
+Value::ObjectValues::ObjectValues(ObjectValues const& other)
+    : std::map<CZString, Value>(other)
+{
+    if (other.index_)
+        buildIndex();
+}
+
+auto
+Value::ObjectValues::findMember(const char* key) -> iterator
+{
+    if (index_)
+    {
+        auto const found = index_->find(key);
+        return found == index_->end() ? end() : found->second;
+    }
+    return find(CZString(key, CZString::noDuplication));
+}
+
+auto
+Value::ObjectValues::findMember(const char* key) const -> const_iterator
+{
+    if (index_)
+    {
+        auto const found = index_->find(key);
+        return found == index_->end() ? end() : const_iterator(found->second);
+    }
+    return find(CZString(key, CZString::noDuplication));
+}
+
+Value&
+Value::ObjectValues::resolveMember(const char* key, bool isStatic)
+{
+    CZString actualKey(
+        key, isStatic ? CZString::noDuplication : CZString::duplicateOnCopy);
+
+    if (index_)
+    {
+        if (auto const found = index_->find(key); found != index_->end())
+            return found->second->second;
+
+        auto const it = emplace(
+                            std::piecewise_construct,
+                            std::forward_as_tuple(actualKey),
+                            std::forward_as_tuple())
+                            .first;
+        index_->emplace(it->first.c_str(), it);
+        return it->second;
+    }
+
+    iterator it = lower_bound(actualKey);
+    if (it != end() && it->first == actualKey)
+        return it->second;
+
+    // Construct the member in place so that a duplicated name is copied
+    // only once.
+    it = emplace_hint(
+        it,
+        std::piecewise_construct,
+        std::forward_as_tuple(actualKey),
+        std::forward_as_tuple());
+    Value& value = it->second;
+    if (size() > indexThreshold)
+        buildIndex();
+    return value;
+}
+
+void
+Value::ObjectValues::eraseMember(iterator it)
+{
+    if (index_)
+        index_->erase(it->first.c_str());
+    erase(it);
+}
+
+void
+Value::ObjectValues::clear()
+{
+    index_.reset();
+    std::map<CZString, Value>::clear();
+}
+
+void
+Value::ObjectValues::buildIndex()
+{
+    index_ = std::make_unique<std::unordered_map<std::string_view, iterator>>(
+        size());
+    for (auto it = begin(); it != end(); ++it)
+        index_->emplace(it->first.c_str(), it);
+}
+
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
@@ -781,8 +883,11 @@ Value::operator[](UInt index)
     if (it != value_.map_->end() && (*it).first == key)
         return (*it).second;
 
-    ObjectValues::value_type defaultValue(key, null);
-    it = value_.map_->insert(it, defaultValue);
+    it = value_.map_->emplace_hint(
+        it,
+        std::piecewise_construct,
+        std::forward_as_tuple(key),
+        std::forward_as_tuple());
     return (*it).second;
 }
 
@@ -817,17 +922,7 @@ Value::resolveReference(const char* key, bool isStatic)
     if (type_ == nullValue)
         *this = Value(objectValue);
 
-    CZString actualKey(
-        key, isStatic ? CZString::noDuplication : CZString::duplicateOnCopy);
-    ObjectValues::iterator it = value_.map_->lower_bound(actualKey);
-
-    if (it != value_.map_->end() && (*it).first == actualKey)
-        return (*it).second;
-
-    ObjectValues::value_type defaultValue(actualKey, null);
-    it = value_.map_->insert(it, defaultValue);
-    Value& value = (*it).second;
-    return value;
+    return value_.map_->resolveMember(key, isStatic);
 }
 
 Value
@@ -851,8 +946,7 @@ Value::operator[](const char* key) const
     if (type_ == nullValue)
         return null;
 
-    CZString actualKey(key, CZString::noDuplication);
-    ObjectValues::const_iterator it = value_.map_->find(actualKey);
+    ObjectValues::const_iterator it = value_.map_->findMember(key);
 
     if (it == value_.map_->end())
         return null;
@@ -881,13 +975,25 @@ Value::operator[](const StaticString& key)
 Value&
 Value::append(const Value& value)
 {
-    return (*this)[size()] = value;
+    return append(Value(value));
 }
 
 Value&
 Value::append(Value&& value)
 {
-    return (*this)[size()] = std::move(value);
+    JSON_ASSERT(type_ == nullValue || type_ == arrayValue);
+
+    if (type_ == nullValue)
+        *this = Value(arrayValue);
+
+    // The new element always sorts last, so it is inserted at the end
+    // without searching the array.
+    auto const it = value_.map_->emplace_hint(
+        value_.map_->end(),
+        std::piecewise_construct,
+        std::forward_as_tuple(CZString(size())),
+        std::forward_as_tuple(std::move(value)));
+    return (*it).second;
 }
 
 Value
@@ -911,14 +1017,13 @@ Value::removeMember(const char* key)
     if (type_ == nullValue)
         return null;
 
-    CZString actualKey(key, CZString::noDuplication);
-    ObjectValues::iterator it = value_.map_->find(actualKey);
+    ObjectValues::iterator it = value_.map_->findMember(key);
 
     if (it == value_.map_->end())
         return null;
 
     Value old(it->second);
-    value_.map_->erase(it);
+    value_.map_->eraseMember(it);
     return old;
 }
 
@@ -107,7 +107,7 @@ ValueIteratorBase::copy(const SelfType& other)
 Value
 ValueIteratorBase::key() const
 {
-    const Value::CZString czstring = (*current_).first;
+    Value::CZString const& czstring = (*current_).first;
 
     if (czstring.c_str())
     {
@@ -123,7 +123,7 @@ ValueIteratorBase::key() const
 UInt
 ValueIteratorBase::index() const
 {
-    const Value::CZString czstring = (*current_).first;
+    Value::CZString const& czstring = (*current_).first;
 
     if (!czstring.c_str())
         return czstring.index();
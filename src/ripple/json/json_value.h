@@ -23,7 +23,10 @@
 #include <ripple/json/json_forwards.h>
 #include <cstring>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 /** \brief JSON (JavaScript Object Notation).
@@ -191,7 +194,7 @@ private:
     };
 
 public:
-    using ObjectValues = std::map<CZString, Value>;
+    class ObjectValues;
 
 public:
     /** \brief Create a default Value of the given type.
@@ -433,6 +436,47 @@ private:
     int allocated_ : 1;  // Notes: if declared as bool, bitfield is useless.
 };
 
+/** The members of an object, or the elements of an array, in order.
+
+    An object with many members also keeps a hash index of their names, so
+    that finding one doesn't compare strings at every level of the tree.
+    The members themselves stay in the ordered map: references to them
+    survive inserting more, and iteration and output stay sorted.
+*/
+class Value::ObjectValues : public std::map<CZString, Value>
+{
+public:
+    /// Members an object holds before their names are indexed
+    static constexpr std::size_t indexThreshold = 32;
+
+    ObjectValues() = default;
+    ObjectValues(ObjectValues const& other);
+    ObjectValues&
+    operator=(ObjectValues const& other) = delete;
+
+    /// Find the member with the given name, or end()
+    iterator
+    findMember(const char* key);
+    const_iterator
+    findMember(const char* key) const;
+
+    /// Find the member with the given name, adding a null one if needed
+    Value&
+    resolveMember(const char* key, bool isStatic);
+
+    void
+    eraseMember(iterator it);
+
+    void
+    clear();
+
+private:
+    void
+    buildIndex();
+
+    std::unique_ptr<std::unordered_map<std::string_view, iterator>> index_;
+};
+
 bool
 operator==(const Value&, const Value&);
 
@@ -20,14 +20,12 @@
 #ifndef RIPPLE_LEDGER_OPENVIEW_H_INCLUDED
 #define RIPPLE_LEDGER_OPENVIEW_H_INCLUDED
 
+#include <ripple/basics/PersistentMap.h>
 #include <ripple/basics/XRPAmount.h>
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/ledger/detail/RawStateTable.h>
 
-#include <boost/container/pmr/monotonic_buffer_resource.hpp>
-#include <boost/container/pmr/polymorphic_allocator.hpp>
-
 #include <functional>
 #include <utility>
 
@@ -55,11 +53,6 @@ extern open_ledger_t const open_ledger;
 class OpenView final : public ReadView, public TxsRawView
 {
 private:
-    // Initial size for the monotonic_buffer_resource used for allocations
-    // The size was chosen from the old `qalloc` code (which this replaces).
-    // It is unclear how the size initially chosen in qalloc.
-    static constexpr size_t initialBufferSize = kilobytes(256);
-
     class txs_iter_impl;
 
     struct txData
@@ -67,7 +60,6 @@ private:
         std::shared_ptr<Serializer const> txn;
         std::shared_ptr<Serializer const> meta;
 
-        // Constructor needed for emplacement in std::map
         txData(
             std::shared_ptr<Serializer const> const& txn_,
             std::shared_ptr<Serializer const> const& meta_)
@@ -77,19 +69,8 @@ private:
     };
 
     // List of tx, key order
-    // Use boost::pmr functionality instead of std::pmr
-    // functions b/c clang does not support pmr yet (as-of 9/2020)
-    using txs_map = std::map<
-        key_type,
-        txData,
-        std::less<key_type>,
-        boost::container::pmr::polymorphic_allocator<
-            std::pair<key_type const, txData>>>;
-
-    // monotonic_resource_ must outlive `items_`. Make a pointer so it may be
-    // easily moved.
-    std::unique_ptr<boost::container::pmr::monotonic_buffer_resource>
-        monotonic_resource_;
+    using txs_map = PersistentMap<key_type, txData>;
+
     txs_map txs_;
     Rules rules_;
     LedgerInfo info_;
@@ -111,8 +92,15 @@ public:
 
         Effects:
 
-            Creates a new object with a copy of
-            the modification state table.
+            Creates a new object which shares the
+            modification state table and tx list.
+
+        The table and list are persistent maps, so
+        the copy takes constant time and a later
+        change to either view duplicates only what
+        it touches. This keeps OpenLedger::modify,
+        which copies the open ledger for every
+        batch, from growing with the ledger.
 
         The objects managed by shared pointers are
         not duplicated but shared between instances.
@@ -20,41 +20,26 @@
 #ifndef RIPPLE_LEDGER_RAWSTATETABLE_H_INCLUDED
 #define RIPPLE_LEDGER_RAWSTATETABLE_H_INCLUDED
 
+#include <ripple/basics/PersistentMap.h>
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
 
-#include <boost/container/pmr/monotonic_buffer_resource.hpp>
-#include <boost/container/pmr/polymorphic_allocator.hpp>
-
-#include <map>
 #include <utility>
 
 namespace ripple {
 namespace detail {
 
 // Helper class that buffers raw modifications
+//
+// Copies share their modifications, so copying a table takes constant
+// time and later changes to either copy cost only what they touch.
 class RawStateTable
 {
 public:
     using key_type = ReadView::key_type;
-    // Initial size for the monotonic_buffer_resource used for allocations
-    // The size was chosen from the old `qalloc` code (which this replaces).
-    // It is unclear how the size initially chosen in qalloc.
-    static constexpr size_t initialBufferSize = kilobytes(256);
-
-    RawStateTable()
-        : monotonic_resource_{std::make_unique<
-              boost::container::pmr::monotonic_buffer_resource>(
-              initialBufferSize)}
-        , items_{monotonic_resource_.get()} {};
-
-    RawStateTable(RawStateTable const& rhs)
-        : monotonic_resource_{std::make_unique<
-              boost::container::pmr::monotonic_buffer_resource>(
-              initialBufferSize)}
-        , items_{rhs.items_, monotonic_resource_.get()}
-        , dropsDestroyed_{rhs.dropsDestroyed_} {};
 
+    RawStateTable() = default;
+    RawStateTable(RawStateTable const&) = default;
     RawStateTable(RawStateTable&&) = default;
 
     RawStateTable&
@@ -112,25 +97,13 @@ private:
         Action action;
         std::shared_ptr<SLE> sle;
 
-        // Constructor needed for emplacement in std::map
         sleAction(Action action_, std::shared_ptr<SLE> const& sle_)
             : action(action_), sle(sle_)
         {
         }
     };
 
-    // Use boost::pmr functionality instead of the std::pmr
-    // functions b/c clang does not support pmr yet (as-of 9/2020)
-    using items_t = std::map<
-        key_type,
-        sleAction,
-        std::less<key_type>,
-        boost::container::pmr::polymorphic_allocator<
-            std::pair<const key_type, sleAction>>>;
-    // monotonic_resource_ must outlive `items_`. Make a pointer so it may be
-    // easily moved.
-    std::unique_ptr<boost::container::pmr::monotonic_buffer_resource>
-        monotonic_resource_;
+    using items_t = PersistentMap<key_type, sleAction>;
     items_t items_;
 
     XRPAmount dropsDestroyed_{0};
@@ -78,9 +78,7 @@ public:
 OpenView::OpenView(OpenView const& rhs)
     : ReadView(rhs)
     , TxsRawView(rhs)
-    , monotonic_resource_{std::make_unique<
-          boost::container::pmr::monotonic_buffer_resource>(initialBufferSize)}
-    , txs_{rhs.txs_, monotonic_resource_.get()}
+    , txs_{rhs.txs_}
     , rules_{rhs.rules_}
     , info_{rhs.info_}
     , base_{rhs.base_}
@@ -93,10 +91,7 @@ OpenView::OpenView(
     ReadView const* base,
     Rules const& rules,
     std::shared_ptr<void const> hold)
-    : monotonic_resource_{std::make_unique<
-          boost::container::pmr::monotonic_buffer_resource>(initialBufferSize)}
-    , txs_{monotonic_resource_.get()}
-    , rules_(rules)
+    : rules_(rules)
     , info_(base->info())
     , base_(base)
     , hold_(std::move(hold))
@@ -109,10 +104,7 @@ OpenView::OpenView(
 }
 
 OpenView::OpenView(ReadView const* base, std::shared_ptr<void const> hold)
-    : monotonic_resource_{std::make_unique<
-          boost::container::pmr::monotonic_buffer_resource>(initialBufferSize)}
-    , txs_{monotonic_resource_.get()}
-    , rules_(base->rules())
+    : rules_(base->rules())
     , info_(base->info())
     , base_(base)
     , hold_(std::move(hold))
@@ -195,33 +187,32 @@ OpenView::slesUpperBound(uint256 const& key) const
 auto
 OpenView::txsBegin() const -> std::unique_ptr<txs_type::iter_base>
 {
-    return std::make_unique<txs_iter_impl>(!open(), txs_.cbegin());
+    return std::make_unique<txs_iter_impl>(!open(), txs_.begin());
 }
 
 auto
 OpenView::txsEnd() const -> std::unique_ptr<txs_type::iter_base>
 {
-    return std::make_unique<txs_iter_impl>(!open(), txs_.cend());
+    return std::make_unique<txs_iter_impl>(!open(), txs_.end());
 }
 
 bool
 OpenView::txExists(key_type const& key) const
 {
-    return txs_.find(key) != txs_.end();
+    return txs_.lookup(key) != nullptr;
 }
 
 auto
 OpenView::txRead(key_type const& key) const -> tx_type
 {
-    auto const iter = txs_.find(key);
-    if (iter == txs_.end())
+    auto const item = txs_.lookup(key);
+    if (!item)
         return base_->txRead(key);
-    auto const& item = iter->second;
-    auto stx = std::make_shared<STTx const>(SerialIter{item.txn->slice()});
+    auto stx = std::make_shared<STTx const>(SerialIter{item->txn->slice()});
     decltype(tx_type::second) sto;
-    if (item.meta)
+    if (item->meta)
         sto = std::make_shared<STObject const>(
-            SerialIter{item.meta->slice()}, sfMetadata);
+            SerialIter{item->meta->slice()}, sfMetadata);
     else
         sto = nullptr;
     return {std::move(stx), std::move(sto)};
@@ -263,11 +254,7 @@ OpenView::rawTxInsert(
     std::shared_ptr<Serializer const> const& txn,
     std::shared_ptr<Serializer const> const& metaData)
 {
-    auto const result = txs_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(key),
-        std::forward_as_tuple(txn, metaData));
-    if (!result.second)
+    if (!txs_.insert(key, {txn, metaData}))
         LogicError("rawTxInsert: duplicate TX id" + to_string(key));
 }
 
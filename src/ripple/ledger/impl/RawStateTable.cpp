@@ -180,13 +180,12 @@ bool
 RawStateTable::exists(ReadView const& base, Keylet const& k) const
 {
     assert(k.key.isNonZero());
-    auto const iter = items_.find(k.key);
-    if (iter == items_.end())
+    auto const item = items_.lookup(k.key);
+    if (!item)
         return base.exists(k);
-    auto const& item = iter->second;
-    if (item.action == Action::erase)
+    if (item->action == Action::erase)
         return false;
-    if (!k.check(*item.sle))
+    if (!k.check(*item->sle))
         return false;
     return true;
 }
@@ -202,7 +201,7 @@ RawStateTable::succ(
     std::optional<key_type> const& last) const -> std::optional<key_type>
 {
     std::optional<key_type> next = key;
-    items_t::const_iterator iter;
+    sleAction const* item;
     // Find base successor that is
     // not also deleted in our list
     do
@@ -210,10 +209,10 @@ RawStateTable::succ(
         next = base.succ(*next, last);
         if (!next)
             break;
-        iter = items_.find(*next);
-    } while (iter != items_.end() && iter->second.action == Action::erase);
+        item = items_.lookup(*next);
+    } while (item && item->action == Action::erase);
     // Find non-deleted successor in our list
-    for (iter = items_.upper_bound(key); iter != items_.end(); ++iter)
+    for (auto iter = items_.upper_bound(key); iter != items_.end(); ++iter)
     {
         if (iter->second.action != Action::erase)
         {
@@ -234,24 +233,22 @@ void
 RawStateTable::erase(std::shared_ptr<SLE> const& sle)
 {
     // The base invariant is checked during apply
-    auto const result = items_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(sle->key()),
-        std::forward_as_tuple(Action::erase, sle));
-    if (result.second)
+    auto const item = items_.lookup(sle->key());
+    if (!item)
+    {
+        items_.insert(sle->key(), {Action::erase, sle});
         return;
-    auto& item = result.first->second;
-    switch (item.action)
+    }
+    switch (item->action)
     {
         case Action::erase:
             LogicError("RawStateTable::erase: already erased");
             break;
         case Action::insert:
-            items_.erase(result.first);
+            items_.erase(sle->key());
             break;
         case Action::replace:
-            item.action = Action::erase;
-            item.sle = sle;
+            items_.insert_or_assign(sle->key(), {Action::erase, sle});
             break;
     }
 }
@@ -259,18 +256,16 @@ RawStateTable::erase(std::shared_ptr<SLE> const& sle)
 void
 RawStateTable::insert(std::shared_ptr<SLE> const& sle)
 {
-    auto const result = items_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(sle->key()),
-        std::forward_as_tuple(Action::insert, sle));
-    if (result.second)
+    auto const item = items_.lookup(sle->key());
+    if (!item)
+    {
+        items_.insert(sle->key(), {Action::insert, sle});
         return;
-    auto& item = result.first->second;
-    switch (item.action)
+    }
+    switch (item->action)
     {
         case Action::erase:
-            item.action = Action::replace;
-            item.sle = sle;
+            items_.insert_or_assign(sle->key(), {Action::replace, sle});
             break;
         case Action::insert:
             LogicError("RawStateTable::insert: already inserted");
@@ -284,21 +279,20 @@ RawStateTable::insert(std::shared_ptr<SLE> const& sle)
 void
 RawStateTable::replace(std::shared_ptr<SLE> const& sle)
 {
-    auto const result = items_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(sle->key()),
-        std::forward_as_tuple(Action::replace, sle));
-    if (result.second)
+    auto const item = items_.lookup(sle->key());
+    if (!item)
+    {
+        items_.insert(sle->key(), {Action::replace, sle});
         return;
-    auto& item = result.first->second;
-    switch (item.action)
+    }
+    switch (item->action)
     {
         case Action::erase:
             LogicError("RawStateTable::replace: was erased");
             break;
         case Action::insert:
         case Action::replace:
-            item.sle = sle;
+            items_.insert_or_assign(sle->key(), {item->action, sle});
             break;
     }
 }
@@ -306,14 +300,13 @@ RawStateTable::replace(std::shared_ptr<SLE> const& sle)
 std::shared_ptr<SLE const>
 RawStateTable::read(ReadView const& base, Keylet const& k) const
 {
-    auto const iter = items_.find(k.key);
-    if (iter == items_.end())
+    auto const item = items_.lookup(k.key);
+    if (!item)
         return base.read(k);
-    auto const& item = iter->second;
-    if (item.action == Action::erase)
+    if (item->action == Action::erase)
         return nullptr;
     // Convert to SLE const
-    std::shared_ptr<SLE const> sle = item.sle;
+    std::shared_ptr<SLE const> sle = item->sle;
     if (!k.check(*sle))
         return nullptr;
     return sle;
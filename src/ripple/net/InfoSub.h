@@ -23,6 +23,7 @@
 #include <ripple/app/misc/Manifest.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/json/json_value.h>
+#include <ripple/net/PubMessage.h>
 #include <ripple/protocol/Book.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/resource/Consumer.h>
@@ -201,6 +202,17 @@ public:
     virtual void
     send(Json::Value const& jvObj, bool broadcast) = 0;
 
+    /** Send a message that is also published to other subscribers.
+
+        By default this sends the message's JSON. Subscribers that write
+        serialized text should override it to share the message's text.
+    */
+    virtual void
+    send(PubMessage const& msg, bool broadcast)
+    {
+        send(msg.json(), broadcast);
+    }
+
     std::uint64_t
     getSeq();
 
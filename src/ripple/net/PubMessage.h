@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NET_PUBMESSAGE_H_INCLUDED
+#define RIPPLE_NET_PUBMESSAGE_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <ripple/json/json_writer.h>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace ripple {
+
+/** A message published to the subscribers of a stream.
+
+    The JSON is serialized the first time a subscriber asks for its text,
+    and that text is then shared, unmodified, with every later subscriber.
+    Fanning a message out to N sessions therefore costs one serialization
+    instead of N.
+
+    The JSON value must outlive the PubMessage. Instances are used by the
+    single thread that publishes them and are not thread safe.
+*/
+class PubMessage
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+private:
+    Json::Value const& jv_;
+    mutable std::shared_ptr<std::string const> text_;
+    mutable clock_type::duration serializeTime_{};
+    mutable std::size_t shares_ = 0;
+
+public:
+    explicit PubMessage(Json::Value const& jv) : jv_(jv)
+    {
+    }
+
+    PubMessage(PubMessage const&) = delete;
+    PubMessage&
+    operator=(PubMessage const&) = delete;
+
+    /** The message, for subscribers that consume JSON directly. */
+    Json::Value const&
+    json() const
+    {
+        return jv_;
+    }
+
+    /** The message serialized as compact JSON text. */
+    std::shared_ptr<std::string const> const&
+    text() const
+    {
+        ++shares_;
+        if (!text_)
+        {
+            auto const start = clock_type::now();
+            auto text = std::make_shared<std::string>();
+            Json::stream(jv_, [&text](void const* data, std::size_t n) {
+                text->append(static_cast<char const*>(data), n);
+            });
+            text_ = std::move(text);
+            serializeTime_ = clock_type::now() - start;
+        }
+        return text_;
+    }
+
+    /** Number of subscribers that asked for the serialized text. */
+    std::size_t
+    shares() const
+    {
+        return shares_;
+    }
+
+    /** Time spent serializing, zero if nobody asked for the text. */
+    clock_type::duration
+    serializeTime() const
+    {
+        return serializeTime_;
+    }
+};
+
+}  // namespace ripple
+
+#endif
@@ -382,6 +382,28 @@ private:
         FetchReport& fetchReport,
         bool duplicate) = 0;
 
+    /** Fetch a bundle of objects for the asynchronous read threads.
+
+        Each hash is paired with the sequence of the ledger it was requested
+        for. The default fetches the objects one at a time; databases whose
+        backends can look up many keys in one call should override it.
+
+        @note This can be called concurrently.
+        @return One entry per hash, nullptr if the object couldn't be
+                retrieved.
+    */
+    virtual std::vector<std::shared_ptr<NodeObject>>
+    fetchNodeObjects(
+        std::vector<uint256 const*> const& hashes,
+        std::vector<std::uint32_t> const& ledgerSeqs);
+
+    // Perform a bundled fetch for the read threads and report the time it
+    // took
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBundle(
+        std::vector<uint256 const*> const& hashes,
+        std::vector<std::uint32_t> const& ledgerSeqs);
+
     /** Visit every object in the database
         This is usually called during import.
 
@@ -49,6 +49,17 @@ public:
     virtual void
     rotateWithLock(std::function<std::unique_ptr<NodeStore::Backend>(
                        std::string const& writableBackendName)> const& f) = 0;
+
+    /** Copy objects from the archive backend into the writable backend.
+
+        Objects already in the writable backend are left alone. The objects
+        are looked up in both backends, and stored, as batches.
+
+        @param hashes The keys of the objects to copy.
+        @return The number of objects copied.
+    */
+    virtual std::size_t
+    copyToWritable(std::vector<uint256> const& hashes) = 0;
 };
 
 }  // namespace NodeStore
@@ -31,7 +31,7 @@ class DummyScheduler : public Scheduler
 public:
     DummyScheduler() = default;
     ~DummyScheduler() = default;
-    void
+    bool
     scheduleTask(Task& task) override;
     void
     onFetch(FetchReport const& report) override;
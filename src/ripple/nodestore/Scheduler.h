@@ -38,6 +38,9 @@ struct FetchReport
     std::chrono::milliseconds elapsed;
     FetchType const fetchType;
     bool wasFound = false;
+
+    // The number of objects looked up, when several are read together
+    int count = 1;
 };
 
 /** Contains information about a batch write operation. */
@@ -66,8 +69,11 @@ public:
         Depending on the implementation, the task may be invoked either on
         the current thread of execution, or an unspecified
        implementation-defined foreign thread.
+
+        @return `false` if the task will never be invoked, for example
+                because the scheduler is stopped.
     */
-    virtual void
+    virtual bool
     scheduleTask(Task& task) = 0;
 
     /** Reports completion of a fetch
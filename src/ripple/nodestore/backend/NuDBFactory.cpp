@@ -17,25 +17,98 @@
 */
 //==============================================================================
 
+#include <ripple/basics/WorkerPool.h>
 #include <ripple/basics/contract.h>
+#include <ripple/beast/core/LexicalCast.h>
 #include <ripple/nodestore/Factory.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/Task.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
 #include <ripple/nodestore/impl/codec.h>
 #include <boost/filesystem.hpp>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdio>
 #include <exception>
 #include <memory>
+#include <mutex>
 #include <nudb/nudb.hpp>
+#include <string>
 
 namespace ripple {
 namespace NodeStore {
 
-class NuDBBackend : public Backend
+// Threads which, with the caller, read the objects of a batch fetch
+// concurrently. Each read waits on the disk, so keeping several in flight
+// lets a fast device serve them side by side. One pool serves every
+// backend the factory creates and is only started by the first batch
+// fetch that needs it.
+class NuDBReaders
+{
+    std::mutex mutex_;
+    std::size_t depth_ = 1;
+    std::shared_ptr<WorkerPool> pool_;
+
+public:
+    // Make sure later batch fetches can keep depth reads in flight
+    void
+    reserve(std::size_t depth)
+    {
+        std::lock_guard lock(mutex_);
+        if (depth <= depth_)
+            return;
+        depth_ = depth;
+
+        // Fetches running on the smaller pool keep it until they finish
+        pool_.reset();
+    }
+
+    std::shared_ptr<WorkerPool>
+    get()
+    {
+        std::lock_guard lock(mutex_);
+        if (!pool_)
+            pool_ = std::make_shared<WorkerPool>(depth_ - 1);
+        return pool_;
+    }
+};
+
+// The most reads a batch fetch may keep in flight. Every read beyond the
+// first holds a thread of the shared pool, but those threads wait on the
+// device rather than the processor, so the limit does not depend on the
+// number of cores.
+static constexpr std::size_t maxReadQueueDepth = 256;
+
+// The number of reads a batch fetch keeps in flight, from the backend's
+// configuration.
+static std::size_t
+readQueueDepth(Section const& keyValues, std::size_t defaultDepth)
+{
+    auto const value = get(keyValues, "read_queue_depth");
+    if (value.empty())
+        return defaultDepth;
+
+    std::size_t depth = 0;
+    try
+    {
+        depth = beast::lexicalCastThrow<std::size_t>(value);
+    }
+    catch (std::exception const&)
+    {
+    }
+
+    if (depth == 0 || depth > maxReadQueueDepth)
+        Throw<std::runtime_error>(
+            "nodestore: Invalid read_queue_depth '" + value +
+            "', must be between 1 and " + std::to_string(maxReadQueueDepth));
+    return depth;
+}
+
+class NuDBBackend : public Backend, private Task
 {
 public:
     static constexpr std::uint64_t currentType = 1;
@@ -44,6 +117,9 @@ public:
     /* "SHRD" in ASCII */
     static constexpr std::uint64_t deterministicType = 0x5348524400000000ull;
 
+    /* Bytes of objects to sample before training a dictionary */
+    static constexpr std::size_t dictionarySampleBytes = 1024 * 1024;
+
     beast::Journal const j_;
     size_t const keyBytes_;
     std::size_t const burstSize_;
@@ -52,11 +128,28 @@ public:
     std::atomic<bool> deletePath_;
     Scheduler& scheduler_;
 
+    // Compress objects against a dictionary trained from the first ones
+    // written, if the database doesn't have one already. Training runs as
+    // a scheduled task, and writes go on without a dictionary until then.
+    bool const useDictionary_;
+    CompressionDictionaries dictionaries_;
+    std::mutex samplesMutex_;
+    std::condition_variable trained_;
+    std::vector<Blob> samples_;
+    std::size_t sampledBytes_ = 0;
+    bool training_ = false;
+
+    // Reads a batch fetch keeps in flight, on threads shared with the
+    // other backends
+    NuDBReaders& readers_;
+    std::size_t const readQueueDepth_;
+
     NuDBBackend(
         size_t keyBytes,
         Section const& keyValues,
         std::size_t burstSize,
         Scheduler& scheduler,
+        NuDBReaders& readers,
         beast::Journal journal)
         : j_(journal)
         , keyBytes_(keyBytes)
@@ -64,18 +157,25 @@ public:
         , name_(get(keyValues, "path"))
         , deletePath_(false)
         , scheduler_(scheduler)
+        , useDictionary_(get<bool>(keyValues, "compression_dictionary", false))
+        , readers_(readers)
+        , readQueueDepth_(readQueueDepth(keyValues, 8))
     {
         if (name_.empty())
             Throw<std::runtime_error>(
                 "nodestore: Missing path in NuDB backend");
+        readers_.reserve(readQueueDepth_);
     }
 
+    // Shards are many and mostly idle, so unless configured otherwise
+    // they read the objects of a batch one at a time.
     NuDBBackend(
         size_t keyBytes,
         Section const& keyValues,
         std::size_t burstSize,
         Scheduler& scheduler,
         nudb::context& context,
+        NuDBReaders& readers,
         beast::Journal journal)
         : j_(journal)
         , keyBytes_(keyBytes)
@@ -84,10 +184,14 @@ public:
         , db_(context)
         , deletePath_(false)
         , scheduler_(scheduler)
+        , useDictionary_(get<bool>(keyValues, "compression_dictionary", false))
+        , readers_(readers)
+        , readQueueDepth_(readQueueDepth(keyValues, 1))
     {
         if (name_.empty())
             Throw<std::runtime_error>(
                 "nodestore: Missing path in NuDB backend");
+        readers_.reserve(readQueueDepth_);
     }
 
     ~NuDBBackend() override
@@ -149,6 +253,15 @@ public:
         if (ec)
             Throw<nudb::system_error>(ec);
 
+        // Dictionaries are needed to read objects whether or not new ones
+        // are compressed with them.
+        for (auto const& entry : directory_iterator(folder))
+        {
+            if (entry.path().extension() == ".dict")
+                dictionaries_.insert(
+                    CompressionDictionary::load(entry.path().string()));
+        }
+
         /** Old value currentType is accepted for appnum in traditional
          *  databases, new value is used for deterministic shard databases.
          *  New 64-bit value is constructed from fixed and random parts.
@@ -178,6 +291,11 @@ public:
     void
     close() override
     {
+        {
+            std::unique_lock lock(samplesMutex_);
+            trained_.wait(lock, [this] { return !training_; });
+        }
+
         if (db_.is_open())
         {
             nudb::error_code ec;
@@ -209,9 +327,10 @@ public:
         nudb::error_code ec;
         db_.fetch(
             key,
-            [key, pno, &status](void const* data, std::size_t size) {
+            [this, key, pno, &status](void const* data, std::size_t size) {
                 nudb::detail::buffer bf;
-                auto const result = nodeobject_decompress(data, size, bf);
+                auto const result =
+                    nodeobject_decompress(data, size, bf, &dictionaries_);
                 DecodedBlob decoded(key, result.first, result.second);
                 if (!decoded.wasOk())
                 {
@@ -232,18 +351,21 @@ public:
     std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
     fetchBatch(std::vector<uint256 const*> const& hashes) override
     {
-        std::vector<std::shared_ptr<NodeObject>> results;
-        results.reserve(hashes.size());
-        for (auto const& h : hashes)
-        {
+        std::vector<std::shared_ptr<NodeObject>> results(hashes.size());
+        auto read = [&](std::size_t i) {
             std::shared_ptr<NodeObject> nObj;
-            Status status = fetch(h->begin(), &nObj);
-            if (status != ok)
-                results.push_back({});
-            else
-                results.push_back(nObj);
+            if (fetch(hashes[i]->begin(), &nObj) == ok)
+                results[i] = std::move(nObj);
+        };
+
+        if (readQueueDepth_ <= 1 || hashes.size() < 2)
+        {
+            for (std::size_t i = 0; i < hashes.size(); ++i)
+                read(i);
+            return {results, ok};
         }
 
+        readers_.get()->run(hashes.size(), read);
         return {results, ok};
     }
 
@@ -254,10 +376,94 @@ public:
         e.prepare(no);
         nudb::error_code ec;
         nudb::detail::buffer bf;
-        auto const result = nodeobject_compress(e.getData(), e.getSize(), bf);
+        auto const dictionary =
+            useDictionary_ ? dictionaries_.current() : nullptr;
+        auto const result = nodeobject_compress(
+            e.getData(), e.getSize(), bf, dictionary.get());
         db_.insert(e.getKey(), result.first, result.second, ec);
         if (ec && ec != nudb::error::key_exists)
             Throw<nudb::system_error>(ec);
+
+        // Sample objects the codec compresses with lz4, which leaves out
+        // inner nodes.
+        if (useDictionary_ && !dictionary &&
+            *static_cast<std::uint8_t const*>(result.first) == 1)
+            sample(e);
+    }
+
+    void
+    sample(EncodedBlob const& e)
+    {
+        {
+            std::lock_guard lock(samplesMutex_);
+            if (sampledBytes_ >= dictionarySampleBytes)
+                return;
+            auto const data = static_cast<std::uint8_t const*>(e.getData());
+            samples_.emplace_back(data, data + e.getSize());
+            sampledBytes_ += e.getSize();
+            if (sampledBytes_ < dictionarySampleBytes)
+                return;
+            training_ = true;
+        }
+
+        // A stopped scheduler never runs the task, and close() would wait
+        // for it forever, so train here instead.
+        if (!scheduler_.scheduleTask(*this))
+            performScheduledTask();
+    }
+
+    void
+    performScheduledTask() override
+    {
+        std::vector<Blob> samples;
+        {
+            std::lock_guard lock(samplesMutex_);
+            samples.swap(samples_);
+        }
+
+        try
+        {
+            train(samples);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.error())
+                << "Unable to train compression dictionary: " << e.what();
+        }
+
+        std::lock_guard lock(samplesMutex_);
+        training_ = false;
+        trained_.notify_all();
+    }
+
+    // Train a dictionary, save it with the database and start compressing
+    // new objects against it.
+    void
+    train(std::vector<Blob> const& samples)
+    {
+        auto const dictionary = CompressionDictionary::train(samples);
+        if (!dictionary)
+        {
+            JLOG(j_.warn()) << "No compression dictionary could be trained";
+            return;
+        }
+
+        auto const path =
+            boost::filesystem::path(name_) / dictionary->fileName();
+        try
+        {
+            dictionary->save(path.string());
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.error()) << "Unable to save compression dictionary "
+                             << path.string() << ": " << e.what();
+            return;
+        }
+        dictionaries_.insert(dictionary);
+        JLOG(j_.info()) << "Compressing with dictionary " << path.string()
+                        << ", " << dictionary->content().size()
+                        << " bytes from " << samples.size() << " objects";
     }
 
     void
@@ -309,7 +515,8 @@ public:
                 std::size_t size,
                 nudb::error_code&) {
                 nudb::detail::buffer bf;
-                auto const result = nodeobject_decompress(data, size, bf);
+                auto const result =
+                    nodeobject_decompress(data, size, bf, &dictionaries_);
                 DecodedBlob decoded(key, result.first, result.second);
                 if (!decoded.wasOk())
                 {
@@ -369,6 +576,8 @@ public:
 
 class NuDBFactory : public Factory
 {
+    NuDBReaders readers_;
+
 public:
     NuDBFactory()
     {
@@ -395,7 +604,7 @@ public:
         beast::Journal journal) override
     {
         return std::make_unique<NuDBBackend>(
-            keyBytes, keyValues, burstSize, scheduler, journal);
+            keyBytes, keyValues, burstSize, scheduler, readers_, journal);
     }
 
     std::unique_ptr<Backend>
@@ -408,7 +617,13 @@ public:
         beast::Journal journal) override
     {
         return std::make_unique<NuDBBackend>(
-            keyBytes, keyValues, burstSize, scheduler, context, journal);
+            keyBytes,
+            keyValues,
+            burstSize,
+            scheduler,
+            context,
+            readers_,
+            journal);
     }
 };
 
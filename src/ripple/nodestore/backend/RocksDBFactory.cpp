@@ -325,16 +325,47 @@ public:
     std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
     fetchBatch(std::vector<uint256 const*> const& hashes) override
     {
+        assert(m_db);
+
+        // Look up all the keys with a single MultiGet, which lets RocksDB
+        // batch its block cache and file accesses.
+        std::vector<rocksdb::Slice> keys;
+        keys.reserve(hashes.size());
+        for (auto const& h : hashes)
+            keys.emplace_back(
+                reinterpret_cast<char const*>(h->data()), m_keyBytes);
+
+        std::vector<std::string> values;
+        rocksdb::ReadOptions const options;
+        auto const statuses = m_db->MultiGet(options, keys, &values);
+
         std::vector<std::shared_ptr<NodeObject>> results;
         results.reserve(hashes.size());
-        for (auto const& h : hashes)
+        for (std::size_t i = 0; i < hashes.size(); ++i)
         {
             std::shared_ptr<NodeObject> nObj;
-            Status status = fetch(h->begin(), &nObj);
-            if (status != ok)
-                results.push_back({});
-            else
-                results.push_back(nObj);
+
+            if (statuses[i].ok())
+            {
+                DecodedBlob decoded(
+                    hashes[i]->data(), values[i].data(), values[i].size());
+
+                if (decoded.wasOk())
+                {
+                    nObj = decoded.createObject();
+                }
+                else
+                {
+                    JLOG(m_journal.error())
+                        << "Corrupt NodeObject #" << *hashes[i];
+                }
+            }
+            else if (!statuses[i].IsNotFound())
+            {
+                JLOG(m_journal.error()) << statuses[i].ToString();
+            }
+
+            results.push_back(std::move(nObj));
         }
 
         return {results, ok};
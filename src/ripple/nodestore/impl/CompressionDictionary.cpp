@@ -0,0 +1,349 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+// Disable lz4 deprecation warning due to incompatibility with clang attributes
+#define LZ4_DISABLE_DEPRECATE_WARNINGS
+
+#include <ripple/basics/contract.h>
+#include <ripple/basics/strHex.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
+#include <ripple/protocol/digest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <lz4.h>
+#include <nudb/detail/field.hpp>
+#include <nudb/native_file.hpp>
+#include <queue>
+#include <stdexcept>
+
+namespace ripple {
+namespace NodeStore {
+
+struct CompressionDictionary::Stream
+{
+    LZ4_stream_t lz4;
+};
+
+static std::uint32_t
+dictionaryId(Blob const& content)
+{
+    auto const hash = sha512Half(makeSlice(content));
+    return (std::uint32_t{hash.data()[0]} << 24) |
+        (std::uint32_t{hash.data()[1]} << 16) |
+        (std::uint32_t{hash.data()[2]} << 8) | std::uint32_t{hash.data()[3]};
+}
+
+CompressionDictionary::CompressionDictionary(
+    Blob content,
+    std::uint64_t created)
+    : content_(std::move(content))
+    , id_(dictionaryId(content_))
+    , created_(created)
+    , stream_(std::make_unique<Stream>())
+{
+    if (content_.empty() || content_.size() > maxSize)
+        Throw<std::runtime_error>(
+            "compression dictionary: bad size " +
+            std::to_string(content_.size()));
+
+    LZ4_initStream(&stream_->lz4, sizeof(stream_->lz4));
+    LZ4_loadDict(
+        &stream_->lz4,
+        reinterpret_cast<char const*>(content_.data()),
+        static_cast<int>(content_.size()));
+}
+
+CompressionDictionary::~CompressionDictionary() = default;
+
+std::shared_ptr<CompressionDictionary>
+CompressionDictionary::train(std::vector<Blob> const& samples, std::size_t size)
+{
+    // Content is compared in runs of this many bytes, about the shortest
+    // match lz4 will encode as a reference.
+    constexpr std::size_t runBytes = 8;
+    constexpr int tableBits = 20;
+
+    auto slot = [](std::uint8_t const* p) {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return static_cast<std::size_t>(
+            (v * 0x9E3779B97F4A7C15ull) >> (64 - tableBits));
+    };
+
+    // How often each run occurs across all of the samples.
+    std::vector<std::uint32_t> counts(std::size_t{1} << tableBits, 0);
+    for (auto const& s : samples)
+    {
+        for (std::size_t i = 0; i + runBytes <= s.size(); ++i)
+            ++counts[slot(s.data() + i)];
+    }
+
+    // A sample is worth the number of times its runs occur in other
+    // samples. Runs already in the dictionary are worth nothing more, so
+    // the scores only fall as samples are chosen: a sample whose
+    // recomputed score is still the highest can be taken without
+    // rescoring the rest.
+    auto score = [&](Blob const& s) {
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i + runBytes <= s.size(); ++i)
+            total += counts[slot(s.data() + i)] - 1;
+        return total;
+    };
+
+    std::priority_queue<std::pair<std::uint64_t, std::size_t>> candidates;
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        if (samples[i].size() >= runBytes && samples[i].size() <= size)
+            candidates.emplace(score(samples[i]), i);
+    }
+
+    std::vector<std::size_t> chosen;
+    std::size_t total = 0;
+    while (!candidates.empty())
+    {
+        auto const [oldScore, i] = candidates.top();
+        candidates.pop();
+
+        if (total + samples[i].size() > size)
+            continue;
+
+        auto const newScore = score(samples[i]);
+        if (newScore == 0)
+            continue;
+
+        if (newScore < oldScore && !candidates.empty() &&
+            newScore < candidates.top().first)
+        {
+            candidates.emplace(newScore, i);
+            continue;
+        }
+
+        chosen.push_back(i);
+        total += samples[i].size();
+        for (std::size_t j = 0; j + runBytes <= samples[i].size(); ++j)
+            counts[slot(samples[i].data() + j)] = 1;
+    }
+
+    if (chosen.empty())
+        return nullptr;
+
+    // The most valuable samples go last, nearest the data being
+    // compressed.
+    Blob content;
+    content.reserve(total);
+    for (auto it = chosen.rbegin(); it != chosen.rend(); ++it)
+        content.insert(
+            content.end(), samples[*it].begin(), samples[*it].end());
+
+    using namespace std::chrono;
+    return std::make_shared<CompressionDictionary>(
+        std::move(content),
+        duration_cast<seconds>(system_clock::now().time_since_epoch())
+            .count());
+}
+
+// File layout:
+//
+//  "XRPLDICT"      magic
+//  uint16          version
+//  uint32          id
+//  uint64          created
+//  uint32          size
+//  size bytes      content
+//
+static constexpr char dictionaryMagic[8] = {
+    'X', 'R', 'P', 'L', 'D', 'I', 'C', 'T'};
+static constexpr std::size_t dictionaryHeaderSize =
+    sizeof(dictionaryMagic) + 2 + 4 + 8 + 4;
+
+std::shared_ptr<CompressionDictionary>
+CompressionDictionary::load(std::string const& path)
+{
+    using namespace nudb::detail;
+
+    nudb::error_code ec;
+    nudb::native_file f;
+    f.open(nudb::file_mode::read, path, ec);
+    if (ec)
+        Throw<nudb::system_error>(ec);
+
+    auto const fileSize = f.size(ec);
+    if (ec)
+        Throw<nudb::system_error>(ec);
+    if (fileSize < dictionaryHeaderSize ||
+        fileSize > dictionaryHeaderSize + maxSize)
+        Throw<std::runtime_error>(
+            "compression dictionary: bad file size in " + path);
+
+    Blob buf(fileSize);
+    f.read(0, buf.data(), buf.size(), ec);
+    if (ec)
+        Throw<nudb::system_error>(ec);
+
+    istream is(buf.data(), buf.size());
+    if (std::memcmp(
+            is(sizeof(dictionaryMagic)),
+            dictionaryMagic,
+            sizeof(dictionaryMagic)) != 0)
+        Throw<std::runtime_error>(
+            "compression dictionary: bad magic in " + path);
+
+    std::uint16_t version;
+    std::uint32_t id;
+    std::uint64_t created;
+    std::uint32_t size;
+    read<std::uint16_t>(is, version);
+    read<std::uint32_t>(is, id);
+    read<std::uint64_t>(is, created);
+    read<std::uint32_t>(is, size);
+    if (version != currentVersion)
+        Throw<std::runtime_error>(
+            "compression dictionary: unknown version " +
+            std::to_string(version) + " in " + path);
+    if (size != fileSize - dictionaryHeaderSize)
+        Throw<std::runtime_error>(
+            "compression dictionary: truncated " + path);
+
+    auto const data = is(size);
+    auto dictionary = std::make_shared<CompressionDictionary>(
+        Blob(data, data + size), created);
+    if (dictionary->id() != id)
+        Throw<std::runtime_error>(
+            "compression dictionary: corrupt " + path);
+    return dictionary;
+}
+
+void
+CompressionDictionary::save(std::string const& path) const
+{
+    using namespace nudb::detail;
+
+    Blob buf(dictionaryHeaderSize + content_.size());
+    ostream os(buf.data(), buf.size());
+    write(os, dictionaryMagic, sizeof(dictionaryMagic));
+    write<std::uint16_t>(os, currentVersion);
+    write<std::uint32_t>(os, id_);
+    write<std::uint64_t>(os, created_);
+    write<std::uint32_t>(os, static_cast<std::uint32_t>(content_.size()));
+    write(os, content_.data(), content_.size());
+
+    // Objects compressed with this dictionary can't be read without it,
+    // so it must be on disk before any of them are.
+    nudb::error_code ec;
+    nudb::native_file f;
+    f.create(nudb::file_mode::write, path, ec);
+    if (!ec)
+        f.write(0, buf.data(), buf.size(), ec);
+    if (!ec)
+        f.sync(ec);
+    if (ec)
+        Throw<nudb::system_error>(ec);
+}
+
+std::string
+CompressionDictionary::fileName() const
+{
+    std::uint8_t const id[] = {
+        static_cast<std::uint8_t>(id_ >> 24),
+        static_cast<std::uint8_t>(id_ >> 16),
+        static_cast<std::uint8_t>(id_ >> 8),
+        static_cast<std::uint8_t>(id_)};
+    return "nudb." + strHex(std::begin(id), std::end(id)) + ".dict";
+}
+
+std::size_t
+CompressionDictionary::compress(
+    void const* in,
+    std::size_t inSize,
+    void* out,
+    std::size_t outMax) const
+{
+    // Loading the dictionary hashes all of it, far more work than
+    // compressing one small object, so a copy of the loaded stream is
+    // used instead.
+    thread_local LZ4_stream_t stream;
+    std::memcpy(&stream, &stream_->lz4, sizeof(stream));
+
+    auto const n = LZ4_compress_fast_continue(
+        &stream,
+        reinterpret_cast<char const*>(in),
+        reinterpret_cast<char*>(out),
+        static_cast<int>(inSize),
+        static_cast<int>(outMax),
+        1);
+    return n > 0 ? n : 0;
+}
+
+bool
+CompressionDictionary::decompress(
+    void const* in,
+    std::size_t inSize,
+    void* out,
+    std::size_t outSize) const
+{
+    return LZ4_decompress_safe_usingDict(
+               reinterpret_cast<char const*>(in),
+               reinterpret_cast<char*>(out),
+               static_cast<int>(inSize),
+               static_cast<int>(outSize),
+               reinterpret_cast<char const*>(content_.data()),
+               static_cast<int>(content_.size())) ==
+        static_cast<int>(outSize);
+}
+
+//------------------------------------------------------------------------------
+
+void
+CompressionDictionaries::insert(
+    std::shared_ptr<CompressionDictionary const> const& dictionary)
+{
+    auto state = std::atomic_load(&state_);
+    for (;;)
+    {
+        auto next = std::make_shared<State>(*state);
+        next->dictionaries.emplace(dictionary->id(), dictionary);
+        if (!next->current ||
+            dictionary->created() > next->current->created())
+            next->current = dictionary;
+        if (std::atomic_compare_exchange_weak(
+                &state_, &state, std::shared_ptr<State const>(next)))
+            return;
+    }
+}
+
+std::shared_ptr<CompressionDictionary const>
+CompressionDictionaries::find(std::uint32_t id) const
+{
+    auto const state = std::atomic_load(&state_);
+    if (auto const it = state->dictionaries.find(id);
+        it != state->dictionaries.end())
+        return it->second;
+    return nullptr;
+}
+
+std::shared_ptr<CompressionDictionary const>
+CompressionDictionaries::current() const
+{
+    return std::atomic_load(&state_)->current;
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_COMPRESSIONDICTIONARY_H_INCLUDED
+#define RIPPLE_NODESTORE_COMPRESSIONDICTIONARY_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/Slice.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A dictionary for compressing node objects with lz4.
+
+    Leaf nodes are a few hundred bytes of serialized STObject, too short
+    for lz4 to find much to reference within a single object. Compressed
+    against a dictionary of typical objects, the field headers, accounts
+    and amounts they share with other objects become back references.
+
+    A dictionary is identified by a hash of its content. Each object
+    records the dictionary it was compressed with, so a database needs
+    every dictionary it has used in order to read its objects back.
+*/
+class CompressionDictionary
+{
+public:
+    /** The largest useful dictionary: lz4 refers back at most 64KB. */
+    static constexpr std::size_t maxSize = 64 * 1024;
+
+    /** The version of the file format written by save(). */
+    static constexpr std::uint16_t currentVersion = 1;
+
+    CompressionDictionary(Blob content, std::uint64_t created);
+
+    ~CompressionDictionary();
+
+    CompressionDictionary(CompressionDictionary const&) = delete;
+    CompressionDictionary&
+    operator=(CompressionDictionary const&) = delete;
+
+    /** Build a dictionary from sample objects.
+
+        Samples are chosen greedily by how much of their content also
+        appears in other samples and is not yet in the dictionary.
+
+        @param samples Objects as they are passed to the codec.
+        @param size The largest dictionary to build.
+        @return The dictionary, or nullptr if the samples have nothing in
+                common.
+    */
+    static std::shared_ptr<CompressionDictionary>
+    train(std::vector<Blob> const& samples, std::size_t size = maxSize);
+
+    /** Read a dictionary written by save().
+
+        Throws if the file can't be read, or its content does not match
+        the identifier it was saved with.
+    */
+    static std::shared_ptr<CompressionDictionary>
+    load(std::string const& path);
+
+    /** Write the dictionary to a new file and sync it to disk.
+
+        Throws if the file already exists or can't be written.
+    */
+    void
+    save(std::string const& path) const;
+
+    /** The file name a database keeps this dictionary under. */
+    std::string
+    fileName() const;
+
+    std::uint32_t
+    id() const
+    {
+        return id_;
+    }
+
+    /** When the dictionary was trained, in seconds since the epoch. */
+    std::uint64_t
+    created() const
+    {
+        return created_;
+    }
+
+    Blob const&
+    content() const
+    {
+        return content_;
+    }
+
+    /** Compress using this dictionary.
+
+        @return The compressed size, or 0 if it did not fit in `out`.
+    */
+    std::size_t
+    compress(void const* in, std::size_t inSize, void* out, std::size_t outMax)
+        const;
+
+    /** Decompress data compressed with this dictionary.
+
+        @return `true` if exactly `outSize` bytes were produced.
+    */
+    bool
+    decompress(
+        void const* in,
+        std::size_t inSize,
+        void* out,
+        std::size_t outSize) const;
+
+private:
+    struct Stream;
+
+    Blob const content_;
+    std::uint32_t const id_;
+    std::uint64_t const created_;
+
+    // The dictionary loaded into an lz4 stream once, so each compression
+    // only attaches it instead of hashing the whole dictionary again.
+    std::unique_ptr<Stream> const stream_;
+};
+
+/** The compression dictionaries used by a database.
+
+    The most recently trained dictionary compresses new objects; the
+    others are kept to read objects written with them.
+
+    Every store and every read of a compressed object looks a dictionary
+    up, so lookups read an immutable snapshot without locking. Inserting
+    a dictionary, which is rare, publishes a new snapshot.
+*/
+class CompressionDictionaries
+{
+public:
+    void
+    insert(std::shared_ptr<CompressionDictionary const> const& dictionary);
+
+    /** Return the dictionary with the given identifier, if known. */
+    std::shared_ptr<CompressionDictionary const>
+    find(std::uint32_t id) const;
+
+    /** Return the dictionary to compress new objects with, if any. */
+    std::shared_ptr<CompressionDictionary const>
+    current() const;
+
+private:
+    struct State
+    {
+        std::map<std::uint32_t, std::shared_ptr<CompressionDictionary const>>
+            dictionaries;
+        std::shared_ptr<CompressionDictionary const> current;
+    };
+
+    // Accessed only through the std::atomic_ free functions.
+    std::shared_ptr<State const> state_ = std::make_shared<State const>();
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
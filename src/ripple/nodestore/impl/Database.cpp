@@ -94,16 +94,32 @@ Database::Database(
                             read.insert(read_.extract(read_.begin()));
                     }
 
-                    for (auto it = read.begin(); it != read.end(); ++it)
+                    if (read.empty())
+                        continue;
+
+                    // Look up the whole bundle in one go, so that backends
+                    // able to read many keys at once can do so.
+                    std::vector<uint256 const*> hashes;
+                    std::vector<std::uint32_t> seqs;
+                    hashes.reserve(read.size());
+                    seqs.reserve(read.size());
+
+                    for (auto const& [hash, data] : read)
                     {
-                        assert(!it->second.empty());
+                        assert(!data.empty());
+                        hashes.push_back(&hash);
+                        seqs.push_back(data[0].first);
+                    }
+
+                    auto const objs = fetchBundle(hashes, seqs);
 
+                    std::size_t n = 0;
+                    for (auto it = read.begin(); it != read.end(); ++it, ++n)
+                    {
                         auto const& hash = it->first;
                         auto const& data = it->second;
-                        auto const seqn = data[0].first;
-
-                        auto obj =
-                            fetchNodeObject(hash, seqn, FetchType::async);
+                        auto const seqn = seqs[n];
+                        auto const& obj = objs[n];
 
                         // This could be further optimized: if there are
                         // multiple requests for sequence numbers mapping to
@@ -275,6 +291,56 @@ Database::fetchNodeObject(
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchNodeObjects(
+    std::vector<uint256 const*> const& hashes,
+    std::vector<std::uint32_t> const& ledgerSeqs)
+{
+    assert(hashes.size() == ledgerSeqs.size());
+
+    std::vector<std::shared_ptr<NodeObject>> results;
+    results.reserve(hashes.size());
+
+    for (std::size_t i = 0; i < hashes.size(); ++i)
+    {
+        FetchReport fetchReport(FetchType::async);
+        results.push_back(
+            fetchNodeObject(*hashes[i], ledgerSeqs[i], fetchReport, false));
+    }
+
+    return results;
+}
+
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchBundle(
+    std::vector<uint256 const*> const& hashes,
+    std::vector<std::uint32_t> const& ledgerSeqs)
+{
+    FetchReport fetchReport(FetchType::async);
+    fetchReport.count = static_cast<int>(hashes.size());
+
+    using namespace std::chrono;
+    auto const begin{steady_clock::now()};
+
+    auto results{fetchNodeObjects(hashes, ledgerSeqs)};
+    auto dur = steady_clock::now() - begin;
+    fetchDurationUs_ += duration_cast<microseconds>(dur).count();
+    for (auto const& nodeObject : results)
+    {
+        if (nodeObject)
+        {
+            ++fetchHitCount_;
+            fetchSz_ += nodeObject->getData().size();
+            fetchReport.wasFound = true;
+        }
+    }
+    fetchTotalCount_ += hashes.size();
+
+    fetchReport.elapsed = duration_cast<milliseconds>(dur);
+    scheduler_.onFetch(fetchReport);
+    return results;
+}
+
 bool
 Database::storeLedger(
     Ledger const& srcLedger,
@@ -21,6 +21,8 @@
 #include <ripple/nodestore/impl/DatabaseNodeImp.h>
 #include <ripple/protocol/HashPrefix.h>
 
+#include <tuple>
+
 namespace ripple {
 namespace NodeStore {
 
@@ -143,6 +145,91 @@ DatabaseNodeImp::fetchNodeObject(
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+DatabaseNodeImp::fetchNodeObjects(
+    std::vector<uint256 const*> const& hashes,
+    std::vector<std::uint32_t> const&)
+{
+    std::vector<std::shared_ptr<NodeObject>> results(hashes.size());
+
+    // Objects not in the cache are read from the backend together
+    std::vector<std::size_t> index;
+    std::vector<uint256 const*> cacheMisses;
+
+    for (std::size_t i = 0; i < hashes.size(); ++i)
+    {
+        if (auto obj = cache_ ? cache_->fetch(*hashes[i]) : nullptr)
+        {
+            if (obj->getType() != hotDUMMY)
+                results[i] = std::move(obj);
+            continue;
+        }
+
+        index.push_back(i);
+        cacheMisses.push_back(hashes[i]);
+    }
+
+    if (cacheMisses.empty())
+        return results;
+
+    std::vector<std::shared_ptr<NodeObject>> dbResults;
+    Status status;
+
+    try
+    {
+        std::tie(dbResults, status) = backend_->fetchBatch(cacheMisses);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j_.fatal()) << "fetchNodeObjects: Exception fetching "
+                         << cacheMisses.size()
+                         << " objects from backend: " << e.what();
+        Rethrow();
+    }
+
+    assert(dbResults.size() == cacheMisses.size());
+
+    switch (status)
+    {
+        case ok:
+        case notFound:
+            break;
+        case dataCorrupt:
+            JLOG(j_.fatal()) << "fetchNodeObjects: nodestore data is corrupted";
+            break;
+        default:
+            JLOG(j_.warn())
+                << "fetchNodeObjects: backend returns unknown result "
+                << status;
+            break;
+    }
+
+    for (std::size_t i = 0; i < dbResults.size(); ++i)
+    {
+        auto& nodeObject = dbResults[i];
+        auto const& hash = *cacheMisses[i];
+
+        // Ensure all threads get the same object, and remember the objects
+        // the backend doesn't have so that asking again doesn't read it.
+        if (cache_)
+        {
+            if (nodeObject)
+                cache_->canonicalize_replace_client(hash, nodeObject);
+            else if (status == ok)
+            {
+                auto notFound = NodeObject::createObject(hotDUMMY, {}, hash);
+                cache_->canonicalize_replace_client(hash, notFound);
+                if (notFound->getType() != hotDUMMY)
+                    nodeObject = std::move(notFound);
+            }
+        }
+
+        results[index[i]] = std::move(nodeObject);
+    }
+
+    return results;
+}
+
 std::vector<std::shared_ptr<NodeObject>>
 DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
 {
@@ -68,7 +68,8 @@ public:
 
         if (cacheSize != 0 || cacheAge != 0)
         {
-            cache_ = std::make_shared<TaggedCache<uint256, NodeObject>>(
+            cache_ = std::make_shared<
+                PartitionedTaggedCache<uint256, NodeObject>>(
                 "DatabaseNodeImp",
                 cacheSize.value_or(0),
                 std::chrono::minutes(cacheAge.value_or(0)),
@@ -140,7 +141,7 @@ public:
 private:
     // Cache for database objects. This cache is not always initialized. Check
     // for null before using.
-    std::shared_ptr<TaggedCache<uint256, NodeObject>> cache_;
+    std::shared_ptr<PartitionedTaggedCache<uint256, NodeObject>> cache_;
     // Persistent key/value storage
     std::shared_ptr<Backend> backend_;
 
@@ -151,6 +152,11 @@ private:
         FetchReport& fetchReport,
         bool duplicate) override;
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchNodeObjects(
+        std::vector<uint256 const*> const& hashes,
+        std::vector<std::uint32_t> const& ledgerSeqs) override;
+
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override
     {
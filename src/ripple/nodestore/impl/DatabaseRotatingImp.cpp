@@ -54,6 +54,59 @@ DatabaseRotatingImp::rotateWithLock(
     writableBackend_ = std::move(newBackend);
 }
 
+std::size_t
+DatabaseRotatingImp::copyToWritable(std::vector<uint256> const& hashes)
+{
+    auto [writable, archive] = [&] {
+        std::lock_guard lock(mutex_);
+        return std::make_pair(writableBackend_, archiveBackend_);
+    }();
+
+    std::vector<uint256 const*> keys;
+    keys.reserve(hashes.size());
+    for (auto const& hash : hashes)
+        keys.push_back(&hash);
+
+    // Only look in the archive backend for what the writable one lacks
+    auto const present = fetchBatch(*writable, keys);
+    assert(present.size() == keys.size());
+
+    std::vector<uint256 const*> misses;
+    for (std::size_t i = 0; i < present.size(); ++i)
+    {
+        if (!present[i])
+            misses.push_back(keys[i]);
+    }
+
+    if (misses.empty())
+        return 0;
+
+    Batch batch;
+    batch.reserve(misses.size());
+    std::uint64_t bytes = 0;
+    for (auto& nodeObject : fetchBatch(*archive, misses))
+    {
+        if (nodeObject)
+        {
+            bytes += nodeObject->getData().size();
+            batch.push_back(std::move(nodeObject));
+        }
+    }
+
+    if (batch.empty())
+        return 0;
+
+    {
+        // Refresh the writable backend pointer
+        std::lock_guard lock(mutex_);
+        writable = writableBackend_;
+    }
+
+    writable->storeBatch(batch);
+    storeStats(batch.size(), bytes);
+    return batch.size();
+}
+
 std::string
 DatabaseRotatingImp::getName() const
 {
@@ -191,6 +244,60 @@ DatabaseRotatingImp::fetchNodeObject(
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+DatabaseRotatingImp::fetchBatch(
+    Backend& backend,
+    std::vector<uint256 const*> const& keys)
+{
+    try
+    {
+        return backend.fetchBatch(keys).first;
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j_.fatal()) << "Exception, " << e.what();
+        Rethrow();
+    }
+    return {};
+}
+
+std::vector<std::shared_ptr<NodeObject>>
+DatabaseRotatingImp::fetchNodeObjects(
+    std::vector<uint256 const*> const& hashes,
+    std::vector<std::uint32_t> const&)
+{
+    auto [writable, archive] = [&] {
+        std::lock_guard lock(mutex_);
+        return std::make_pair(writableBackend_, archiveBackend_);
+    }();
+
+    // Try to fetch from the writable backend
+    auto results = fetchBatch(*writable, hashes);
+    assert(results.size() == hashes.size());
+
+    // Otherwise try to fetch from the archive backend
+    std::vector<std::size_t> index;
+    std::vector<uint256 const*> misses;
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        if (!results[i])
+        {
+            index.push_back(i);
+            misses.push_back(hashes[i]);
+        }
+    }
+
+    if (!misses.empty())
+    {
+        auto archived = fetchBatch(*archive, misses);
+        assert(archived.size() == misses.size());
+        for (std::size_t i = 0; i < archived.size(); ++i)
+            results[index[i]] = std::move(archived[i]);
+    }
+
+    return results;
+}
+
 void
 DatabaseRotatingImp::for_each(
     std::function<void(std::shared_ptr<NodeObject>)> f)
@@ -51,6 +51,9 @@ public:
         std::function<std::unique_ptr<NodeStore::Backend>(
             std::string const& writableBackendName)> const& f) override;
 
+    std::size_t
+    copyToWritable(std::vector<uint256> const& hashes) override;
+
     std::string
     getName() const override;
 
@@ -84,6 +87,9 @@ private:
     std::shared_ptr<Backend> archiveBackend_;
     mutable std::mutex mutex_;
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch(Backend& backend, std::vector<uint256 const*> const& keys);
+
     std::shared_ptr<NodeObject>
     fetchNodeObject(
         uint256 const& hash,
@@ -91,6 +97,11 @@ private:
         FetchReport& fetchReport,
         bool duplicate) override;
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchNodeObjects(
+        std::vector<uint256 const*> const& hashes,
+        std::vector<std::uint32_t> const& ledgerSeqs) override;
+
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override;
 };
@@ -22,11 +22,12 @@
 namespace ripple {
 namespace NodeStore {
 
-void
+bool
 DummyScheduler::scheduleTask(Task& task)
 {
     // Invoke the task synchronously.
     task.performScheduledTask();
+    return true;
 }
 
 void
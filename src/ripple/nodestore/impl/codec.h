@@ -26,6 +26,7 @@
 #include <ripple/basics/contract.h>
 #include <ripple/basics/safe_cast.h>
 #include <ripple/nodestore/NodeObject.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
 #include <ripple/nodestore/impl/varint.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <cstddef>
@@ -40,7 +41,11 @@ namespace NodeStore {
 
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
-lz4_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
+lz4_decompress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    CompressionDictionary const* dictionary = nullptr)
 {
     if (static_cast<int>(in_size) < 0)
         Throw<std::runtime_error>("lz4_decompress: integer overflow (input)");
@@ -58,7 +63,17 @@ lz4_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
 
     void* const out = bf(outSize);
 
-    if (LZ4_decompress_safe(
+    if (dictionary)
+    {
+        if (!dictionary->decompress(
+                reinterpret_cast<char const*>(in) + n,
+                in_size - n,
+                out,
+                outSize))
+            Throw<std::runtime_error>("lz4_decompress: dictionary");
+    }
+    else if (
+        LZ4_decompress_safe(
             reinterpret_cast<char const*>(in) + n,
             reinterpret_cast<char*>(out),
             static_cast<int>(in_size - n),
@@ -70,7 +85,11 @@ lz4_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
 
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
-lz4_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
+lz4_compress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    CompressionDictionary const* dictionary = nullptr)
 {
     using std::runtime_error;
     using namespace nudb::detail;
@@ -81,11 +100,13 @@ lz4_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
     std::uint8_t* out = reinterpret_cast<std::uint8_t*>(bf(n + out_max));
     result.first = out;
     std::memcpy(out, vi.data(), n);
-    auto const out_size = LZ4_compress_default(
-        reinterpret_cast<char const*>(in),
-        reinterpret_cast<char*>(out + n),
-        in_size,
-        out_max);
+    auto const out_size = dictionary
+        ? dictionary->compress(in, in_size, out + n, out_max)
+        : LZ4_compress_default(
+              reinterpret_cast<char const*>(in),
+              reinterpret_cast<char*>(out + n),
+              in_size,
+              out_max);
     if (out_size == 0)
         Throw<std::runtime_error>("lz4 compress");
     result.second = n + out_size;
@@ -101,11 +122,16 @@ lz4_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
     1 = lz4 compressed
     2 = inner node compressed
     3 = full inner node
+    4 = lz4 compressed with a dictionary, preceded by its 32-bit id
 */
 
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
-nodeobject_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
+nodeobject_decompress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    CompressionDictionaries const* dictionaries = nullptr)
 {
     using namespace nudb::detail;
 
@@ -199,6 +225,25 @@ nodeobject_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
             write(os, is(512), 512);
             break;
         }
+        case 4:  // lz4 with a dictionary
+        {
+            auto const hs = field<std::uint32_t>::size;  // Dictionary id
+            if (in_size < hs)
+                Throw<std::runtime_error>(
+                    "nodeobject codec: short dictionary id, in_size = " +
+                    std::to_string(in_size));
+            istream is(p, in_size);
+            std::uint32_t id;
+            read<std::uint32_t>(is, id);
+            auto const dictionary =
+                dictionaries ? dictionaries->find(id) : nullptr;
+            if (!dictionary)
+                Throw<std::runtime_error>(
+                    "nodeobject codec: unknown dictionary " +
+                    std::to_string(id));
+            result = lz4_decompress(p + hs, in_size - hs, bf, dictionary.get());
+            break;
+        }
         default:
             Throw<std::runtime_error>(
                 "nodeobject codec: bad type=" + std::to_string(type));
@@ -216,7 +261,11 @@ zero32()
 
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
-nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
+nodeobject_compress(
+    void const* in,
+    std::size_t in_size,
+    BufferFactory&& bf,
+    CompressionDictionary const* dictionary = nullptr)
 {
     using std::runtime_error;
     using namespace nudb::detail;
@@ -280,7 +329,7 @@ nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
 
     std::array<std::uint8_t, varint_traits<std::size_t>::max> vi;
 
-    constexpr std::size_t codecType = 1;
+    std::size_t const codecType = dictionary ? 4 : 1;
     auto const vn = write_varint(vi.data(), codecType);
     std::pair<void const*, std::size_t> result;
     switch (codecType)
@@ -299,6 +348,25 @@ nodeobject_compress(void const* in, std::size_t in_size, BufferFactory&& bf)
             result.second = vn + lzr.second;
             break;
         }
+        case 4:  // lz4 with a dictionary
+        {
+            auto const hs = field<std::uint32_t>::size;  // Dictionary id
+            std::uint8_t* p;
+            auto const lzr = NodeStore::lz4_compress(
+                in,
+                in_size,
+                [&p, &vn, &bf](std::size_t n) {
+                    p = reinterpret_cast<std::uint8_t*>(bf(vn + hs + n));
+                    return p + vn + hs;
+                },
+                dictionary);
+            ostream os(p, vn + hs);
+            write(os, vi.data(), vn);
+            write<std::uint32_t>(os, dictionary->id());
+            result.first = p;
+            result.second = vn + hs + lzr.second;
+            break;
+        }
         default:
             Throw<std::logic_error>(
                 "nodeobject codec: unknown=" + std::to_string(codecType));
@@ -22,7 +22,9 @@
 
 #include <ripple/basics/CompressionAlgorithms.h>
 #include <ripple/basics/Log.h>
+#include <ripple/basics/Slice.h>
 #include <lz4frame.h>
+#include <cassert>
 
 namespace ripple {
 
@@ -33,10 +35,55 @@ std::size_t constexpr headerBytesCompressed = 10;
 
 // All values other than 'none' must have the high bit. The low order four bits
 // must be 0.
-enum class Algorithm : std::uint8_t { None = 0x00, LZ4 = 0x90 };
+enum class Algorithm : std::uint8_t { None = 0x00, LZ4 = 0x90, ZSTD = 0xA0 };
 
 enum class Compressed : std::uint8_t { On, Off };
 
+// The number of algorithms other than 'none'
+std::size_t constexpr algorithms = 2;
+
+/** The position of an algorithm other than 'none' in tables kept for each */
+constexpr std::size_t
+algorithmIndex(Algorithm algorithm)
+{
+    assert(algorithm != Algorithm::None);
+    return algorithm == Algorithm::ZSTD ? 1 : 0;
+}
+
+constexpr char const*
+algorithmName(Algorithm algorithm)
+{
+    switch (algorithm)
+    {
+        case Algorithm::LZ4:
+            return "lz4";
+        case Algorithm::ZSTD:
+            return "zstd";
+        default:
+            break;
+    }
+    return "none";
+}
+
+/** The dictionary which messages compressed with Algorithm::ZSTD use.
+
+    It is built in, so both ends of a link have it without exchanging it.
+    Its content is part of the protocol: changing it requires a new value
+    of the compression feature in the handshake.
+*/
+struct ZstdDictionary
+{
+    ZSTD_CDict const* compress;
+    ZSTD_DDict const* decompress;
+};
+
+ZstdDictionary const&
+zstdDictionary();
+
+/** The built-in dictionary's content, for tests. */
+Slice
+zstdDictionaryContent();
+
 /** Decompress input stream.
  * @tparam InputStream ZeroCopyInputStream
  * @param in Input source stream
@@ -59,6 +106,13 @@ decompress(
         if (algorithm == Algorithm::LZ4)
             return ripple::compression_algorithms::lz4Decompress(
                 in, inSize, decompressed, decompressedSize);
+        else if (algorithm == Algorithm::ZSTD)
+            return ripple::compression_algorithms::zstdDecompress(
+                in,
+                inSize,
+                decompressed,
+                decompressedSize,
+                zstdDictionary().decompress);
         else
         {
             JLOG(debugLog().warn())
@@ -95,6 +149,12 @@ compress(
         if (algorithm == Algorithm::LZ4)
             return ripple::compression_algorithms::lz4Compress(
                 in, inSize, std::forward<BufferFactory>(bf));
+        else if (algorithm == Algorithm::ZSTD)
+            return ripple::compression_algorithms::zstdCompress(
+                in,
+                inSize,
+                std::forward<BufferFactory>(bf),
+                zstdDictionary().compress);
         else
         {
             JLOG(debugLog().warn()) << "compress: invalid compression algorithm"
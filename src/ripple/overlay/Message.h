@@ -31,10 +31,13 @@
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 
 namespace ripple {
 
+class TrafficCount;
+
 constexpr std::size_t maximiumMessageSize = megabytes(64);
 
 // VFALCO NOTE If we forward declare Message and write out shared_ptr
@@ -81,10 +84,16 @@ public:
      * the message is not compressible then the uncompressed buffer is returned.
      * @param compressed Request compressed (Compress::On) or
      *     uncompressed (Compress::Off) payload buffer
+     * @param algorithm The algorithm to compress with
+     * @param traffic If not null, counts the compression if this call is
+     *     the one which compresses the message
      * @return Payload buffer
      */
     std::vector<uint8_t> const&
-    getBuffer(Compressed tryCompressed);
+    getBuffer(
+        Compressed tryCompressed,
+        Algorithm algorithm = Algorithm::LZ4,
+        TrafficCount* traffic = nullptr);
 
     /** Get the traffic category */
     std::size_t
@@ -101,18 +110,24 @@ public:
     }
 
 private:
+    // The message compressed with one algorithm, if it got smaller
+    struct CompressedBuffer
+    {
+        std::vector<uint8_t> buffer;
+        std::once_flag once;
+    };
+
     std::vector<uint8_t> buffer_;
-    std::vector<uint8_t> bufferCompressed_;
+    std::array<CompressedBuffer, compression::algorithms> compressed_;
     std::size_t category_;
-    std::once_flag once_flag_;
     std::optional<PublicKey> validatorKey_;
 
     /** Set the payload header
      * @param in Pointer to the payload
      * @param payloadBytes Size of the payload excluding the header size
      * @param type Protocol message type
-     * @param compression Compression algorithm used in compression,
-     *   currently LZ4 only. If None then the message is uncompressed.
+     * @param compression Compression algorithm used in compression.
+     *   If None then the message is uncompressed.
      * @param uncompressedBytes Size of the uncompressed message
      */
     void
@@ -124,11 +139,14 @@ private:
         std::uint32_t uncompressedBytes);
 
     /** Try to compress the payload.
-     * Can be called concurrently by multiple peers but is compressed once.
+     * Can be called concurrently by multiple peers but is compressed once
+     * with each algorithm.
      * If the message is not compressible then the serialized buffer_ is used.
+     * @param algorithm The algorithm to compress with
+     * @param traffic If not null, counts the compression
      */
     void
-    compress();
+    compress(Algorithm algorithm, TrafficCount* traffic);
 
     /** Get the message type from the payload header.
      * First four bytes are the compression/algorithm flag and the payload size.
@@ -79,7 +79,8 @@ makeFeaturesRequestHeader(
 {
     std::stringstream str;
     if (comprEnabled)
-        str << FEATURE_COMPR << "=lz4" << DELIM_FEATURE;
+        str << FEATURE_COMPR << "=" << COMPR_ZSTD << DELIM_VALUE << COMPR_LZ4
+            << DELIM_FEATURE;
     if (ledgerReplayEnabled)
         str << FEATURE_LEDGER_REPLAY << "=1" << DELIM_FEATURE;
     if (txReduceRelayEnabled)
@@ -98,8 +99,12 @@ makeFeaturesResponseHeader(
     bool vpReduceRelayEnabled)
 {
     std::stringstream str;
-    if (comprEnabled && isFeatureValue(headers, FEATURE_COMPR, "lz4"))
-        str << FEATURE_COMPR << "=lz4" << DELIM_FEATURE;
+    if (auto const algorithm = peerCompressionAlgorithm(headers, comprEnabled);
+        algorithm != compression::Algorithm::None)
+        str << FEATURE_COMPR << "="
+            << (algorithm == compression::Algorithm::ZSTD ? COMPR_ZSTD
+                                                          : COMPR_LZ4)
+            << DELIM_FEATURE;
     if (ledgerReplayEnabled && featureEnabled(headers, FEATURE_LEDGER_REPLAY))
         str << FEATURE_LEDGER_REPLAY << "=1" << DELIM_FEATURE;
     if (txReduceRelayEnabled && featureEnabled(headers, FEATURE_TXRR))
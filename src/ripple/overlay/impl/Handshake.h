@@ -22,6 +22,7 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/overlay/Compression.h>
 #include <ripple/overlay/impl/ProtocolVersion.h>
 #include <ripple/protocol/BuildInfo.h>
 #include <boost/asio/ip/tcp.hpp>
@@ -138,8 +139,14 @@ makeResponse(
 // X-Protocol-Ctl: feature1=value1[,value2]*[\s*;\s*feature2=value1[,value2]*]*
 // value: \S+
 
-// compression feature
+// compression feature. A request lists the algorithms the peer supports,
+// most preferred first, and a response the one chosen.
 static constexpr char FEATURE_COMPR[] = "compr";
+// compression algorithms
+static constexpr char COMPR_LZ4[] = "lz4";
+// zstd with version 1 of the built-in dictionary,
+// compression::zstdDictionary(). Another dictionary needs another value.
+static constexpr char COMPR_ZSTD[] = "zstd1";
 // validation/proposal reduce-relay feature
 static constexpr char FEATURE_VPRR[] = "vprr";
 // transaction reduce-relay feature
@@ -216,6 +223,24 @@ peerFeatureEnabled(
     return config && peerFeatureEnabled(request, feature, "1", config);
 }
 
+/** Find the compression algorithm to use with a peer. The link uses
+    the first of zstd and lz4 which both ends support.
+   @tparam headers request (inbound) or response (outbound) header
+   @param request http headers
+   @param config true if compression is enabled in our configuration
+   @return the algorithm, or Algorithm::None if the link isn't compressed
+ */
+template <typename headers>
+compression::Algorithm
+peerCompressionAlgorithm(headers const& request, bool config)
+{
+    if (peerFeatureEnabled(request, FEATURE_COMPR, COMPR_ZSTD, config))
+        return compression::Algorithm::ZSTD;
+    if (peerFeatureEnabled(request, FEATURE_COMPR, COMPR_LZ4, config))
+        return compression::Algorithm::LZ4;
+    return compression::Algorithm::None;
+}
+
 /** Make request header X-Protocol-Ctl value with supported features
    @param comprEnabled if true then compression feature is enabled
    @param ledgerReplayEnabled if true then ledger-replay feature is enabled
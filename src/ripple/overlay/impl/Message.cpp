@@ -19,6 +19,7 @@
 
 #include <ripple/overlay/Message.h>
 #include <ripple/overlay/impl/TrafficCount.h>
+#include <chrono>
 #include <cstdint>
 
 namespace ripple {
@@ -65,10 +66,11 @@ Message::totalSize(::google::protobuf::Message const& message)
 }
 
 void
-Message::compress()
+Message::compress(Algorithm algorithm, TrafficCount* traffic)
 {
     using namespace ripple::compression;
     auto const messageBytes = buffer_.size() - headerBytes;
+    auto& bufferCompressed = compressed_[algorithmIndex(algorithm)].buffer;
 
     auto type = getType(buffer_.data());
 
@@ -111,27 +113,39 @@ Message::compress()
     {
         auto payload = static_cast<void const*>(buffer_.data() + headerBytes);
 
+        auto const start = std::chrono::steady_clock::now();
         auto compressedSize = ripple::compression::compress(
             payload,
             messageBytes,
             [&](std::size_t inSize) {  // size of required compressed buffer
-                bufferCompressed_.resize(inSize + headerBytesCompressed);
-                return (bufferCompressed_.data() + headerBytesCompressed);
-            });
-
-        if (compressedSize <
-            (messageBytes - (headerBytesCompressed - headerBytes)))
+                bufferCompressed.resize(inSize + headerBytesCompressed);
+                return (bufferCompressed.data() + headerBytesCompressed);
+            },
+            algorithm);
+        auto const elapsed = std::chrono::steady_clock::now() - start;
+
+        if (compressedSize != 0 &&
+            compressedSize <
+                (messageBytes - (headerBytesCompressed - headerBytes)))
         {
-            bufferCompressed_.resize(headerBytesCompressed + compressedSize);
+            bufferCompressed.resize(headerBytesCompressed + compressedSize);
             setHeader(
-                bufferCompressed_.data(),
+                bufferCompressed.data(),
                 compressedSize,
                 type,
-                Algorithm::LZ4,
+                algorithm,
                 messageBytes);
         }
         else
-            bufferCompressed_.resize(0);
+            bufferCompressed.resize(0);
+
+        if (traffic)
+            traffic->addCompression(
+                type,
+                algorithm,
+                messageBytes,
+                bufferCompressed.empty() ? messageBytes : compressedSize,
+                elapsed);
     }
 }
 
@@ -207,15 +221,20 @@ Message::getBufferSize()
 }
 
 std::vector<uint8_t> const&
-Message::getBuffer(Compressed tryCompressed)
+Message::getBuffer(
+    Compressed tryCompressed,
+    Algorithm algorithm,
+    TrafficCount* traffic)
 {
-    if (tryCompressed == Compressed::Off)
+    if (tryCompressed == Compressed::Off || algorithm == Algorithm::None)
         return buffer_;
 
-    std::call_once(once_flag_, &Message::compress, this);
+    auto& compressed = compressed_[compression::algorithmIndex(algorithm)];
+    std::call_once(
+        compressed.once, &Message::compress, this, algorithm, traffic);
 
-    if (bufferCompressed_.size() > 0)
-        return bufferCompressed_;
+    if (compressed.buffer.size() > 0)
+        return compressed.buffer;
     else
         return buffer_;
 }
@@ -407,7 +407,7 @@ OverlayImpl::connect(beast::IP::Endpoint const& remote_endpoint)
 
     auto const p = std::make_shared<ConnectAttempt>(
         app_,
-        io_service_,
+        app_.getConnectionIOService(),
         beast::IPAddressConversion::to_asio_endpoint(remote_endpoint),
         usage,
         setup_.context,
@@ -568,18 +568,63 @@ OverlayImpl::stop()
 void
 OverlayImpl::onWrite(beast::PropertyStream::Map& stream)
 {
-    beast::PropertyStream::Set set("traffic", stream);
-    auto const stats = m_traffic.getCounts();
-    for (auto const& i : stats)
     {
-        if (i)
+        beast::PropertyStream::Set set("traffic", stream);
+        auto const stats = m_traffic.getCounts();
+        for (auto const& i : stats)
         {
-            beast::PropertyStream::Map item(set);
-            item["category"] = i.name;
-            item["bytes_in"] = std::to_string(i.bytesIn.load());
-            item["messages_in"] = std::to_string(i.messagesIn.load());
-            item["bytes_out"] = std::to_string(i.bytesOut.load());
-            item["messages_out"] = std::to_string(i.messagesOut.load());
+            if (i)
+            {
+                beast::PropertyStream::Map item(set);
+                item["category"] = i.name;
+                item["bytes_in"] = std::to_string(i.bytesIn.load());
+                item["messages_in"] = std::to_string(i.messagesIn.load());
+                item["bytes_out"] = std::to_string(i.bytesOut.load());
+                item["messages_out"] = std::to_string(i.messagesOut.load());
+            }
+        }
+    }
+
+    // Batched writes to peers
+    {
+        auto const& w = m_traffic.getWriteStats();
+        beast::PropertyStream::Map writes("writes", stream);
+        writes["count"] = std::to_string(w.writes.load());
+        writes["messages"] = std::to_string(w.messages.load());
+        writes["bytes"] = std::to_string(w.bytes.load());
+    }
+
+    // Compression by algorithm and message type
+    {
+        beast::PropertyStream::Set set("compression", stream);
+        auto const& stats = m_traffic.getCompressionStats();
+        for (auto const algorithm :
+             {compression::Algorithm::LZ4, compression::Algorithm::ZSTD})
+        {
+            auto const& byType = stats[compression::algorithmIndex(algorithm)];
+            for (std::size_t type = 0; type < byType.size(); ++type)
+            {
+                auto const& i = byType[type];
+                if (!i)
+                    continue;
+                beast::PropertyStream::Map item(set);
+                item["algorithm"] = compression::algorithmName(algorithm);
+                item["message"] = protocolMessageName(type);
+                item["messages_out"] = std::to_string(i.messagesOut.load());
+                item["bytes_out_uncompressed"] =
+                    std::to_string(i.bytesOutBefore.load());
+                item["bytes_out_compressed"] =
+                    std::to_string(i.bytesOutAfter.load());
+                item["compress_us"] =
+                    std::to_string(i.compressNanoseconds.load() / 1000);
+                item["messages_in"] = std::to_string(i.messagesIn.load());
+                item["bytes_in_compressed"] =
+                    std::to_string(i.bytesInBefore.load());
+                item["bytes_in_uncompressed"] =
+                    std::to_string(i.bytesInAfter.load());
+                item["decompress_us"] =
+                    std::to_string(i.decompressNanoseconds.load() / 1000);
+            }
         }
     }
 }
@@ -683,6 +728,12 @@ OverlayImpl::reportTraffic(
     m_traffic.addCount(cat, isInbound, number);
 }
 
+void
+OverlayImpl::reportWrite(std::size_t messages, std::size_t bytes)
+{
+    m_traffic.addWrite(messages, bytes);
+}
+
 Json::Value
 OverlayImpl::crawlShards(bool includePublicKey, std::uint32_t relays)
 {
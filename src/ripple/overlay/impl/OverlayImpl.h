@@ -350,6 +350,17 @@ public:
     void
     reportTraffic(TrafficCount::category cat, bool isInbound, int bytes);
 
+    /** Account for one batched write of messages to a peer */
+    void
+    reportWrite(std::size_t messages, std::size_t bytes);
+
+    /** The traffic counters, for the compression of messages to count in */
+    TrafficCount&
+    traffic()
+    {
+        return m_traffic;
+    }
+
     void
     incJqTransOverflow() override
     {
@@ -598,12 +609,19 @@ private:
             : peerDisconnects(
                   collector->make_gauge("Overlay", "Peer_Disconnects"))
             , trafficGauges(std::move(trafficGauges_))
+            , writes(collector->make_gauge("Overlay", "Writes"))
+            , messagesPerWrite(
+                  collector->make_gauge("Overlay", "Messages_Per_Write"))
+            , bytesPerWrite(collector->make_gauge("Overlay", "Bytes_Per_Write"))
             , hook(collector->make_hook(handler))
         {
         }
 
         beast::insight::Gauge peerDisconnects;
         std::vector<TrafficGauges> trafficGauges;
+        beast::insight::Gauge writes;
+        beast::insight::Gauge messagesPerWrite;
+        beast::insight::Gauge bytesPerWrite;
         beast::insight::Hook hook;
     };
 
@@ -625,6 +643,14 @@ private:
             m_stats.trafficGauges[i].messagesIn = counts[i].messagesIn;
             m_stats.trafficGauges[i].messagesOut = counts[i].messagesOut;
         }
+
+        auto const& w = m_traffic.getWriteStats();
+        if (auto const writes = w.writes.load())
+        {
+            m_stats.writes = writes;
+            m_stats.messagesPerWrite = w.messages / writes;
+            m_stats.bytesPerWrite = w.bytes / writes;
+        }
         m_stats.peerDisconnects = getPeerDisconnect();
     }
 };
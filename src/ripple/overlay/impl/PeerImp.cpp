@@ -100,12 +100,10 @@ PeerImp::PeerImp(
     , slot_(slot)
     , request_(std::move(request))
     , headers_(request_)
+    , compressionAlgorithm_(
+          peerCompressionAlgorithm(headers_, app_.config().COMPRESSION))
     , compressionEnabled_(
-          peerFeatureEnabled(
-              headers_,
-              FEATURE_COMPR,
-              "lz4",
-              app_.config().COMPRESSION)
+          compressionAlgorithm_ != compression::Algorithm::None
               ? Compressed::On
               : Compressed::Off)
     , txReduceRelayEnabled_(peerFeatureEnabled(
@@ -122,8 +120,8 @@ PeerImp::PeerImp(
           app_.config().LEDGER_REPLAY))
     , ledgerReplayMsgHandler_(app, app.getLedgerReplayer())
 {
-    JLOG(journal_.info()) << "compression enabled "
-                          << (compressionEnabled_ == Compressed::On)
+    JLOG(journal_.info()) << "compression "
+                          << compression::algorithmName(compressionAlgorithm_)
                           << " vp reduce-relay enabled "
                           << vpReduceRelayEnabled_
                           << " tx reduce-relay enabled "
@@ -251,10 +249,12 @@ PeerImp::send(std::shared_ptr<Message> const& m)
     if (validator && !squelch_.expireSquelch(*validator))
         return;
 
+    auto const& buffer = m->getBuffer(
+        compressionEnabled_, compressionAlgorithm_, &overlay_.traffic());
     overlay_.reportTraffic(
         safe_cast<TrafficCount::category>(m->getCategory()),
         false,
-        static_cast<int>(m->getBuffer(compressionEnabled_).size()));
+        static_cast<int>(buffer.size()));
 
     auto sendq_size = send_queue_.size();
 
@@ -273,15 +273,32 @@ PeerImp::send(std::shared_ptr<Message> const& m)
              << " sendq: " << sendq_size;
     }
 
-    send_queue_.push(m);
+    send_queue_.push_back(m);
 
     if (sendq_size != 0)
         return;
 
+    writeSendQueue();
+}
+
+void
+PeerImp::writeSendQueue()
+{
+    assert(strand_.running_in_this_thread());
+    assert(sending_ == 0 && !send_queue_.empty());
+
+    // The SSL stream flattens small buffers, so batched messages also
+    // share SSL records instead of paying for one each.
+    auto const buffers =
+        sendBatch(send_queue_, compressionEnabled_, compressionAlgorithm_);
+
+    sending_ = buffers.size();
+    overlay_.reportWrite(sending_, boost::asio::buffer_size(buffers));
+
+    // Timeout on writes only
     boost::asio::async_write(
         stream_,
-        boost::asio::buffer(
-            send_queue_.front()->getBuffer(compressionEnabled_)),
+        buffers,
         bind_executor(
             strand_,
             std::bind(
@@ -967,25 +984,17 @@ PeerImp::onWriteMessage(error_code ec, std::size_t bytes_transferred)
             stream << "onWriteMessage";
     }
 
-    metrics_.sent.add_message(bytes_transferred);
+    assert(sending_ > 0 && send_queue_.size() >= sending_);
+    for (std::size_t i = 0; i < sending_; ++i)
+        metrics_.sent.add_message(
+            send_queue_[i]
+                ->getBuffer(compressionEnabled_, compressionAlgorithm_)
+                .size());
 
-    assert(!send_queue_.empty());
-    send_queue_.pop();
+    send_queue_.erase(send_queue_.begin(), send_queue_.begin() + sending_);
+    sending_ = 0;
     if (!send_queue_.empty())
-    {
-        // Timeout on writes only
-        return boost::asio::async_write(
-            stream_,
-            boost::asio::buffer(
-                send_queue_.front()->getBuffer(compressionEnabled_)),
-            bind_executor(
-                strand_,
-                std::bind(
-                    &PeerImp::onWriteMessage,
-                    shared_from_this(),
-                    std::placeholders::_1,
-                    std::placeholders::_2)));
-    }
+        return writeSendQueue();
 
     if (gracefulClose_)
     {
@@ -1016,13 +1025,17 @@ PeerImp::onMessageBegin(
     std::shared_ptr<::google::protobuf::Message> const& m,
     std::size_t size,
     std::size_t uncompressed_size,
-    bool isCompressed)
+    compression::Algorithm algorithm,
+    std::chrono::nanoseconds decompressTime)
 {
     load_event_ =
         app_.getJobQueue().makeLoadEvent(jtPEER, protocolMessageName(type));
     fee_ = Resource::feeLightPeer;
     auto const category = TrafficCount::categorize(*m, type, true);
     overlay_.reportTraffic(category, true, static_cast<int>(size));
+    if (algorithm != compression::Algorithm::None)
+        overlay_.traffic().addDecompression(
+            type, algorithm, size, uncompressed_size, decompressTime);
     using namespace protocol;
     if ((type == MessageType::mtTRANSACTION ||
          type == MessageType::mtHAVE_TRANSACTIONS ||
@@ -1041,7 +1054,8 @@ PeerImp::onMessageBegin(
             static_cast<MessageType>(type), static_cast<std::uint64_t>(size));
     }
     JLOG(journal_.trace()) << "onMessageBegin: " << type << " " << size << " "
-                           << uncompressed_size << " " << isCompressed;
+                           << uncompressed_size << " "
+                           << compression::algorithmName(algorithm);
 }
 
 void
@@ -3712,4 +3726,27 @@ PeerImp::Metrics::total_bytes() const
     return totalBytes_;
 }
 
+std::vector<boost::asio::const_buffer>
+sendBatch(
+    std::deque<std::shared_ptr<Message>> const& queue,
+    compression::Compressed compressed,
+    compression::Algorithm algorithm)
+{
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.reserve(
+        std::min<std::size_t>(queue.size(), Tuning::sendBatchMessages));
+    std::size_t bytes = 0;
+    for (auto const& m : queue)
+    {
+        auto const& buffer = m->getBuffer(compressed, algorithm);
+        if (!buffers.empty() &&
+            (buffers.size() == Tuning::sendBatchMessages ||
+             bytes + buffer.size() > Tuning::sendBatchBytes))
+            break;
+        buffers.emplace_back(buffer.data(), buffer.size());
+        bytes += buffer.size();
+    }
+    return buffers;
+}
+
 }  // namespace ripple
@@ -41,8 +41,8 @@
 #include <boost/endian/conversion.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <cstdint>
+#include <deque>
 #include <optional>
-#include <queue>
 
 namespace ripple {
 
@@ -155,7 +155,9 @@ private:
     http_request_type request_;
     http_response_type response_;
     boost::beast::http::fields const& headers_;
-    std::queue<std::shared_ptr<Message>> send_queue_;
+    std::deque<std::shared_ptr<Message>> send_queue_;
+    // Number of messages at the front of send_queue_ being written
+    std::size_t sending_ = 0;
     bool gracefulClose_ = false;
     int large_sendq_ = 0;
     std::unique_ptr<LoadEvent> load_event_;
@@ -167,6 +169,7 @@ private:
     hash_map<PublicKey, NodeStore::ShardInfo> shardInfos_;
     std::mutex mutable shardInfoMutex_;
 
+    compression::Algorithm compressionAlgorithm_ = compression::Algorithm::None;
     Compressed compressionEnabled_ = Compressed::Off;
 
     // Queue of transactions' hashes that have not been
@@ -479,6 +482,10 @@ private:
     void
     onReadMessage(error_code ec, std::size_t bytes_transferred);
 
+    // Writes as many queued messages as fit in one batch
+    void
+    writeSendQueue();
+
     // Called when protocol messages bytes are sent
     void
     onWriteMessage(error_code ec, std::size_t bytes_transferred);
@@ -527,7 +534,8 @@ public:
         std::shared_ptr<::google::protobuf::Message> const& m,
         std::size_t size,
         std::size_t uncompressed_size,
-        bool isCompressed);
+        compression::Algorithm algorithm,
+        std::chrono::nanoseconds decompressTime);
 
     void
     onMessageEnd(
@@ -644,6 +652,19 @@ private:
     processLedgerRequest(std::shared_ptr<protocol::TMGetLedger> const& m);
 };
 
+/** Gather the messages at the front of a send queue into one write
+
+    A batch holds at most Tuning::sendBatchMessages messages and
+    Tuning::sendBatchBytes bytes, but always at least one message.
+
+    @return the buffers of the messages in the batch, in queue order.
+*/
+std::vector<boost::asio::const_buffer>
+sendBatch(
+    std::deque<std::shared_ptr<Message>> const& queue,
+    compression::Compressed compressed,
+    compression::Algorithm algorithm);
+
 //------------------------------------------------------------------------------
 
 template <class Buffers>
@@ -685,12 +706,10 @@ PeerImp::PeerImp(
     , slot_(std::move(slot))
     , response_(std::move(response))
     , headers_(response_)
+    , compressionAlgorithm_(
+          peerCompressionAlgorithm(headers_, app_.config().COMPRESSION))
     , compressionEnabled_(
-          peerFeatureEnabled(
-              headers_,
-              FEATURE_COMPR,
-              "lz4",
-              app_.config().COMPRESSION)
+          compressionAlgorithm_ != compression::Algorithm::None
               ? Compressed::On
               : Compressed::Off)
     , txReduceRelayEnabled_(peerFeatureEnabled(
@@ -709,8 +728,8 @@ PeerImp::PeerImp(
 {
     read_buffer_.commit(boost::asio::buffer_copy(
         read_buffer_.prepare(boost::asio::buffer_size(buffers)), buffers));
-    JLOG(journal_.info()) << "compression enabled "
-                          << (compressionEnabled_ == Compressed::On)
+    JLOG(journal_.info()) << "compression "
+                          << compression::algorithmName(compressionAlgorithm_)
                           << " vp reduce-relay enabled "
                           << vpReduceRelayEnabled_
                           << " tx reduce-relay enabled "
@@ -29,6 +29,7 @@
 #include <boost/asio/buffers_iterator.hpp>
 #include <boost/system/error_code.hpp>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -210,7 +211,8 @@ parseMessageHeader(
 
         hdr.algorithm = static_cast<compression::Algorithm>(*iter & 0xF0);
 
-        if (hdr.algorithm != compression::Algorithm::LZ4)
+        if (hdr.algorithm != compression::Algorithm::LZ4 &&
+            hdr.algorithm != compression::Algorithm::ZSTD)
         {
             ec = make_error_code(boost::system::errc::protocol_error);
             return std::nullopt;
@@ -270,7 +272,10 @@ template <
     class = std::enable_if_t<
         std::is_base_of<::google::protobuf::Message, T>::value>>
 std::shared_ptr<T>
-parseMessageContent(MessageHeader const& header, Buffers const& buffers)
+parseMessageContent(
+    MessageHeader const& header,
+    Buffers const& buffers,
+    std::chrono::nanoseconds* decompressTime = nullptr)
 {
     auto const m = std::make_shared<T>();
 
@@ -282,12 +287,15 @@ parseMessageContent(MessageHeader const& header, Buffers const& buffers)
         std::vector<std::uint8_t> payload;
         payload.resize(header.uncompressed_size);
 
+        auto const start = std::chrono::steady_clock::now();
         auto const payloadSize = ripple::compression::decompress(
             stream,
             header.payload_wire_size,
             payload.data(),
             header.uncompressed_size,
             header.algorithm);
+        if (decompressTime)
+            *decompressTime = std::chrono::steady_clock::now() - start;
 
         if (payloadSize == 0 || !m->ParseFromArray(payload.data(), payloadSize))
             return {};
@@ -307,17 +315,18 @@ template <
 bool
 invoke(MessageHeader const& header, Buffers const& buffers, Handler& handler)
 {
-    auto const m = parseMessageContent<T>(header, buffers);
+    std::chrono::nanoseconds decompressTime{0};
+    auto const m = parseMessageContent<T>(header, buffers, &decompressTime);
     if (!m)
         return false;
 
-    using namespace ripple::compression;
     handler.onMessageBegin(
         header.message_type,
         m,
         header.payload_wire_size,
         header.uncompressed_size,
-        header.algorithm != Algorithm::None);
+        header.algorithm,
+        decompressTime);
     handler.onMessage(m);
     handler.onMessageEnd(header.message_type, m);
 
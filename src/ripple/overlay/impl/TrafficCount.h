@@ -21,10 +21,12 @@
 #define RIPPLE_OVERLAY_TRAFFIC_H_INCLUDED
 
 #include <ripple/basics/safe_cast.h>
+#include <ripple/overlay/Compression.h>
 #include <ripple/protocol/messages.h>
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 
 namespace ripple {
@@ -61,6 +63,44 @@ public:
         }
     };
 
+    /** Counts of the socket writes to peers, which may each carry several
+        queued messages. Dividing by writes gives the average number of
+        messages and bytes per write.
+    */
+    class WriteStats
+    {
+    public:
+        std::atomic<std::uint64_t> writes{0};
+        std::atomic<std::uint64_t> messages{0};
+        std::atomic<std::uint64_t> bytes{0};
+    };
+
+    /** Counts of the compression of one type of protocol message with one
+        algorithm. The bytes before and after give the compression ratio.
+        Messages which didn't get smaller go out uncompressed, and count as
+        the same size after as before.
+    */
+    class CompressionStats
+    {
+    public:
+        // Messages we compressed to send
+        std::atomic<std::uint64_t> messagesOut{0};
+        std::atomic<std::uint64_t> bytesOutBefore{0};
+        std::atomic<std::uint64_t> bytesOutAfter{0};
+        std::atomic<std::uint64_t> compressNanoseconds{0};
+
+        // Compressed messages we received
+        std::atomic<std::uint64_t> messagesIn{0};
+        std::atomic<std::uint64_t> bytesInBefore{0};
+        std::atomic<std::uint64_t> bytesInAfter{0};
+        std::atomic<std::uint64_t> decompressNanoseconds{0};
+
+        operator bool() const
+        {
+            return messagesIn || messagesOut;
+        }
+    };
+
     // If you add entries to this enum, you need to update the initialization
     // of the arrays at the bottom of this file which map array numbers to
     // human-readable, monitoring-tool friendly names.
@@ -186,6 +226,63 @@ public:
         }
     }
 
+    /** Account for one write of one or more messages to a peer */
+    void
+    addWrite(std::size_t messages, std::size_t bytes)
+    {
+        ++writes_.writes;
+        writes_.messages += messages;
+        writes_.bytes += bytes;
+    }
+
+    /** Account for the compression of a message we send
+        @param type Protocol message type
+        @param algorithm The algorithm the message was compressed with
+        @param before Size of the message
+        @param after Size of the message as sent
+        @param elapsed The time compressing it took
+    */
+    void
+    addCompression(
+        int type,
+        compression::Algorithm algorithm,
+        std::size_t before,
+        std::size_t after,
+        std::chrono::nanoseconds elapsed)
+    {
+        if (auto const stats = compressionStats(algorithm, type))
+        {
+            ++stats->messagesOut;
+            stats->bytesOutBefore += before;
+            stats->bytesOutAfter += after;
+            stats->compressNanoseconds += elapsed.count();
+        }
+    }
+
+    /** Account for the decompression of a message we received
+        @param type Protocol message type
+        @param algorithm The algorithm the message was compressed with
+        @param before Size of the message as received
+        @param after Size of the decompressed message
+        @param elapsed The time decompressing it took
+    */
+    void
+    addDecompression(
+        int type,
+        compression::Algorithm algorithm,
+        std::size_t before,
+        std::size_t after,
+        std::chrono::nanoseconds elapsed)
+    {
+        if (auto const stats = compressionStats(algorithm, type))
+        {
+            ++stats->messagesIn;
+            stats->bytesInBefore += before;
+            stats->bytesInAfter += after;
+            stats->decompressNanoseconds += elapsed.count();
+        }
+    }
+
     TrafficCount() = default;
 
     /** An up-to-date copy of all the counters
@@ -198,7 +295,31 @@ public:
         return counts_;
     }
 
+    WriteStats const&
+    getWriteStats() const
+    {
+        return writes_;
+    }
+
+    /** The compression counters of each algorithm, indexed by
+        compression::algorithmIndex and then by protocol message type.
+    */
+    auto const&
+    getCompressionStats() const
+    {
+        return compression_;
+    }
+
 protected:
+    CompressionStats*
+    compressionStats(compression::Algorithm algorithm, int type)
+    {
+        if (algorithm == compression::Algorithm::None || type < 0 ||
+            type >= protocol::MessageType_ARRAYSIZE)
+            return nullptr;
+        return &compression_[compression::algorithmIndex(algorithm)][type];
+    }
+
     std::array<TrafficStats, category::unknown + 1> counts_{{
         {"overhead"},           // category::base
         {"overhead_cluster"},   // category::cluster
@@ -250,6 +371,13 @@ protected:
         {"requested_transactions"},  // category::transactions
         {"unknown"}                  // category::unknown
     }};
+
+    WriteStats writes_;
+
+    std::array<
+        std::array<CompressionStats, protocol::MessageType_ARRAYSIZE>,
+        compression::algorithms>
+        compression_;
 };
 
 }  // namespace ripple
@@ -54,6 +54,9 @@ enum {
     /** How often to log send queue size */
     sendQueueLogFreq = 64,
 
+    /** The most queued messages to send to a peer in a single write */
+    sendBatchMessages = 64,
+
     /** How often we check for idle peers (seconds) */
     checkIdlePeers = 4,
 
@@ -64,6 +67,11 @@ enum {
 /** Size of buffer used to read from the socket. */
 std::size_t constexpr readBufferBytes = 16384;
 
+/** The most bytes of queued messages to send to a peer in a single write.
+    A single larger message is still sent on its own.
+*/
+std::size_t constexpr sendBatchBytes = 65536;
+
 }  // namespace Tuning
 
 }  // namespace ripple
@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/basics/contract.h>
+#include <ripple/overlay/Compression.h>
+#include <memory>
+#include <stdexcept>
+
+namespace ripple {
+
+namespace compression {
+
+namespace {
+
+// The compression level of messages compressed with the dictionary, the
+// library's default. Higher levels gain little on messages this small.
+int constexpr zstdLevel = 3;
+
+// The dictionary is raw content: the library finds matches in it as if it
+// preceded every message. It holds the bytes which recur across messages
+// without recurring within most of them: field headers and common values
+// of serialized transactions and ledger entries, SHAMap leaf framing and
+// the protobuf framing of the messages which carry them. Keys, hashes and
+// signatures are zero, as they are different in every message anyway.
+//
+// Matches close to the end of the dictionary are the cheapest to encode, so
+// the most frequent messages come last.
+//
+// The content must never change: a peer decompressing with another
+// dictionary reads garbage. This is version 1, negotiated as COMPR_ZSTD;
+// a dictionary trained on captured traffic needs the next version.
+char const* const dictionaryHex[] = {
+    // AccountRoot
+    "1100612200000000240000000025000000002D00000000550000000000000000"
+    "0000000000000000000000000000000000000000000000006240000000000000"
+    "0081140000000000000000000000000000000000000000000000000000000000"
+    "000000000000000000000000000000000000000000000001"
+    // Offer
+    "11006F2200000000240000000025000000003300000000000000003400000000"
+    "0000000055000000000000000000000000000000000000000000000000000000"
+    "0000000000501000000000000000000000000000000000000000000000000000"
+    "0000000000000064D4838D7EA4C6800000000000000000000000000055534400"
+    "0000000000000000000000000000000000000000000000006540000000000000"
+    "0081140000000000000000000000000000000000000000000000000000000000"
+    "000000000000000000000000000000000000000000000001"
+    // RippleState
+    "1100722200000000250000000037000000000000000038000000000000000055"
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    "62D4838D7EA4C680000000000000000000000000005553440000000000000000"
+    "000000000000000000000000000000000166D4838D7EA4C68000000000000000"
+    "0000000000005553440000000000000000000000000000000000000000000000"
+    "000067D4838D7EA4C68000000000000000000000000000555344000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000001"
+    // DirectoryNode
+    "1100642200000000580000000000000000000000000000000000000000000000"
+    "0000000000000000000113400000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    "0000000000000000000000008214000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    "000001"
+    // TMLedgerData
+    "0A20000000000000000000000000000000000000000000000000000000000000"
+    "0000108080808008180222E9030AC30400000000000000000000000000000000"
+    "0000000000000000000000000000000012210000000000000000000000000000"
+    "00000000000000000000000000000000000000"
+    // TMGetObjectByHash
+    "080410012A240A20000000000000000000000000000000000000000000000000"
+    "00000000000000002800"
+    // TrustSet
+    "12001422000200002400000000201B0000000063D4838D7EA4C6800000000000"
+    "0000000000000000555344000000000000000000000000000000000000000000"
+    "0000000068400000000000000C73210200000000000000000000000000000000"
+    "0000000000000000000000000000000074463044022000000000000000000000"
+    "0000000000000000000000000000000000000000000002200000000000000000"
+    "0000000000000000000000000000000000000000000000008114000000000000"
+    "0000000000000000000000000000"
+    // OfferCancel
+    "12000822800000002400000000201B0000000020190000000068400000000000"
+    "000C732102000000000000000000000000000000000000000000000000000000"
+    "0000000000744730450221000000000000000000000000000000000000000000"
+    "0000000000000000000000000220000000000000000000000000000000000000"
+    "0000000000000000000000000000811400000000000000000000000000000000"
+    "00000000"
+    // OfferCreate
+    "12000722800000002400000000201B0000000064D4838D7EA4C6800000000000"
+    "0000000000000000555344000000000000000000000000000000000000000000"
+    "0000000065400000000000000068400000000000000C73210200000000000000"
+    "0000000000000000000000000000000000000000000000000074473045022100"
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    "0220000000000000000000000000000000000000000000000000000000000000"
+    "000081140000000000000000000000000000000000000000"
+    // Payment IOU
+    "120000228002000024000000002E00000000201B0000000061D4838D7EA4C680"
+    "0000000000000000000000000055534400000000000000000000000000000000"
+    "00000000000000000068400000000000000C69D4838D7EA4C680000000000000"
+    "0000000000000055534400000000000000000000000000000000000000000000"
+    "0000007321ED0000000000000000000000000000000000000000000000000000"
+    "0000000000007440000000000000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    "0000000000000000811400000000000000000000000000000000000000008314"
+    "0000000000000000000000000000000000000000"
+    // TMTransaction
+    "0AF401120000228000000024000000002E00000000201B000000006140000000"
+    "000F424068400000000000000C73210200000000000000000000000000000000"
+    "0000000000000000000000000000000074473045022100000000000000000000"
+    "0000000000000000000000000000000000000000000000022000000000000000"
+    "0000000000000000000000000000000000000000000000000081140000000000"
+    "0000000000000000000000000000008314000000000000000000000000000000"
+    "00000000001002188080808080808080012000"
+};
+
+struct Dictionary
+{
+    Blob content;
+    std::unique_ptr<ZSTD_CDict, std::size_t (*)(ZSTD_CDict*)> compress;
+    std::unique_ptr<ZSTD_DDict, std::size_t (*)(ZSTD_DDict*)> decompress;
+
+    Dictionary()
+        : content([] {
+            std::string hex;
+            for (auto const fragment : dictionaryHex)
+                hex += fragment;
+            return *strUnHex(hex);
+        }())
+        , compress(
+              ZSTD_createCDict(content.data(), content.size(), zstdLevel),
+              &ZSTD_freeCDict)
+        , decompress(
+              ZSTD_createDDict(content.data(), content.size()),
+              &ZSTD_freeDDict)
+    {
+        if (!compress || !decompress)
+            Throw<std::runtime_error>("zstd: can't load dictionary");
+    }
+};
+
+Dictionary const&
+dictionary()
+{
+    static Dictionary const d;
+    return d;
+}
+
+}  // namespace
+
+ZstdDictionary const&
+zstdDictionary()
+{
+    static ZstdDictionary const d{
+        dictionary().compress.get(), dictionary().decompress.get()};
+    return d;
+}
+
+Slice
+zstdDictionaryContent()
+{
+    return makeSlice(dictionary().content);
+}
+
+}  // namespace compression
+
+}  // namespace ripple
@@ -31,6 +31,7 @@
 #include <optional>
 #include <ostream>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -257,6 +258,31 @@ verify(
     Slice const& sig,
     bool mustBeFullyCanonical = true) noexcept;
 
+/** A signature to be checked by verifyBatch. */
+struct SignatureCheck
+{
+    PublicKey const* publicKey;
+    Slice message;
+    Slice signature;
+};
+
+/** Verify a batch of signatures on messages.
+
+    Returns one result per check, in order. Ed25519 signatures are verified
+    together, up to 64 at a time, using a randomized batch equation; large
+    groups cost about a quarter as much per signature as verify(). If a
+    group does not verify, its signatures are checked one at a time. Other
+    signatures are checked with verify().
+
+    @note The batch equation is not multiplied by the cofactor, so a signer
+          who deliberately builds R with a small-order component can produce
+          a signature that verify() rejects but this function accepts with
+          probability up to 1/8. Anything other servers must agree on, such
+          as whether a transaction is properly signed, must use verify().
+*/
+[[nodiscard]] std::vector<bool>
+verifyBatch(std::vector<SignatureCheck> const& checks);
+
 /** Calculate the 160-bit node ID from a node public key. */
 NodeID
 calcNodeID(PublicKey const&);
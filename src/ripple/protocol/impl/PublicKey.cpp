@@ -298,6 +298,65 @@ verify(
     return false;
 }
 
+std::vector<bool>
+verifyBatch(std::vector<SignatureCheck> const& checks)
+{
+    std::vector<bool> result(checks.size(), false);
+
+    // Ed25519 signatures that pass the checks verify() makes before calling
+    // into the library are gathered for the batch; everything else is
+    // settled here.
+    std::vector<std::size_t> index;
+    std::vector<unsigned char const*> m;
+    std::vector<std::size_t> mlen;
+    std::vector<unsigned char const*> pk;
+    std::vector<unsigned char const*> sig;
+
+    index.reserve(checks.size());
+    m.reserve(checks.size());
+    mlen.reserve(checks.size());
+    pk.reserve(checks.size());
+    sig.reserve(checks.size());
+
+    for (std::size_t i = 0; i < checks.size(); ++i)
+    {
+        auto const& c = checks[i];
+
+        if (publicKeyType(*c.publicKey) != KeyType::ed25519)
+        {
+            result[i] = verify(*c.publicKey, c.message, c.signature);
+            continue;
+        }
+
+        if (!ed25519Canonical(c.signature))
+            continue;
+
+        index.push_back(i);
+        m.push_back(c.message.data());
+        mlen.push_back(c.message.size());
+        // Strip the 0xED prefix, as verify() does.
+        pk.push_back(c.publicKey->data() + 1);
+        sig.push_back(c.signature.data());
+    }
+
+    if (!index.empty())
+    {
+        std::vector<int> valid(index.size(), 0);
+        ed25519_sign_open_batch(
+            m.data(),
+            mlen.data(),
+            pk.data(),
+            sig.data(),
+            index.size(),
+            valid.data());
+
+        for (std::size_t j = 0; j < index.size(); ++j)
+            result[index[j]] = valid[j] == 1;
+    }
+
+    return result;
+}
+
 NodeID
 calcNodeID(PublicKey const& pk)
 {
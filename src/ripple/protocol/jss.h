@@ -214,6 +214,7 @@ JSS(dbKBTransaction);         // out: getCounts
 JSS(debug_signing);           // in: TransactionSign
 JSS(deletion_blockers_only);  // in: AccountObjects
 JSS(delivered_amount);        // out: insertDeliveredAmount
+JSS(deliveries);              // out: GetCounts
 JSS(deposit_authorized);      // out: deposit_authorized
 JSS(deposit_preauth);         // in: AccountObjects, LedgerData
 JSS(deprecated);              // out
@@ -290,6 +291,7 @@ JSS(high);                  // out: BookChanges
 JSS(highest_sequence);      // out: AccountInfo
 JSS(highest_ticket);        // out: AccountInfo
 JSS(historical_perminute);  // historical_perminute.
+JSS(hits);                  // out: GetCounts
 JSS(hostid);                // out: NetworkOPs
 JSS(hotwallet);             // in: GatewayBalances
 JSS(id);                    // websocket.
@@ -303,14 +305,15 @@ JSS(index);                 // in: LedgerEntry, DownloadShard
                             //      LedgerEntry, TxHistory, LedgerData
 JSS(info);                  // out: ServerInfo, ConsensusInfo, FetchInfo
 JSS(initial_sync_duration_us);
-JSS(internal_command);     // in: Internal
-JSS(invalid_API_version);  // out: Many, when a request has an invalid
-                           //      version
-JSS(io_latency_ms);        // out: NetworkOPs
-JSS(ip);                   // in: Connect, out: OverlayImpl
-JSS(issuer);               // in: RipplePathFind, Subscribe,
-                           //     Unsubscribe, BookOffers
-                           // out: STPathSet, STAmount
+JSS(internal_command);       // in: Internal
+JSS(invalid_API_version);    // out: Many, when a request has an invalid
+                             //      version
+JSS(io_context_latency_ms);  // out: NetworkOPs
+JSS(io_latency_ms);          // out: NetworkOPs
+JSS(ip);                     // in: Connect, out: OverlayImpl
+JSS(issuer);                 // in: RipplePathFind, Subscribe,
+                             //     Unsubscribe, BookOffers
+                             // out: STPathSet, STAmount
 JSS(job);
 JSS(job_queue);
 JSS(jobs);
@@ -319,6 +322,7 @@ JSS(jq_trans_overflow);           // JobQueue transaction limit overflow.
 JSS(kept);                        // out: SubmitTransaction
 JSS(key);                         // out
 JSS(key_type);                    // in/out: WalletPropose, TransactionSign
+JSS(keys);                        // out: GetCounts
 JSS(latency);                     // out: PeerImp
 JSS(last);                        // out: RPCVersion
 JSS(lastSequence);                // out: NodeToShardStatus
@@ -352,6 +356,7 @@ JSS(limit);                       // in/out: AccountTx*, AccountOffers,
                                   //         AccountLines, AccountObjects
                                   // in: LedgerData, BookOffers
 JSS(limit_peer);                  // out: AccountLines
+JSS(line_cache);                  // out: GetCounts
 JSS(lines);                       // out: AccountLines
 JSS(list);                        // out: ValidatorList
 JSS(load);                        // out: NetworkOPs, PeerImp
@@ -365,6 +370,7 @@ JSS(load_factor_local);           // out: NetworkOPs
 JSS(load_factor_net);             // out: NetworkOPs
 JSS(load_factor_server);          // out: NetworkOPs
 JSS(load_fee);                    // out: LoadFeeTrackImp, NetworkOPs
+JSS(loads);                       // out: GetCounts
 JSS(local);                       // out: resource/Logic.h
 JSS(local_txs);                   // out: GetCounts
 JSS(local_static_keys);           // out: ValidatorList
@@ -390,6 +396,7 @@ JSS(max_spend_drops_total);       // out: AccountInfo
 JSS(median_fee);                  // out: TxQ
 JSS(median_level);                // out: TxQ
 JSS(message);                     // error.
+JSS(messages);                    // out: GetCounts
 JSS(meta);                        // out: NetworkOPs, AccountTx*, Tx
 JSS(metaData);
 JSS(metadata);  // out: TransactionEntry
@@ -424,6 +431,7 @@ JSS(node_reads_total);           // out: GetCounts
 JSS(node_reads_duration_us);     // out: GetCounts
 JSS(node_size);                  // out: server_info
 JSS(nodestore);                  // out: GetCounts
+JSS(nodes_loaded);               // out: GetCounts
 JSS(node_writes);                // out: GetCounts
 JSS(node_written_bytes);         // out: GetCounts
 JSS(node_writes_duration_us);    // out: GetCounts
@@ -434,6 +442,7 @@ JSS(offer);                      // in: LedgerEntry
 JSS(offers);                     // out: NetworkOPs, AccountOffers, Subscribe
 JSS(offline);                    // in: TransactionSign
 JSS(offset);                     // in/out: AccountTxOld
+JSS(online_delete);              // out: GetCounts, NetworkOPs
 JSS(open);                       // out: handlers/Ledger
 JSS(open_ledger_cost);           // out: SubmitTransaction
 JSS(open_ledger_fee);            // out: TxQ
@@ -447,6 +456,7 @@ JSS(parent_hash);                 // out: LedgerToJson
 JSS(partition);                   // in: LogLevel
 JSS(passphrase);                  // in: WalletPropose
 JSS(password);                    // in: Subscribe
+JSS(patches);                     // out: GetCounts
 JSS(paths);                       // in: RipplePathFind
 JSS(paths_canonical);             // out: RipplePathFind
 JSS(paths_computed);              // out: PathRequest, RipplePathFind
@@ -459,6 +469,7 @@ JSS(peer_disconnects);            // Severed peer connection counter.
 JSS(peer_disconnects_resources);  // Severed peer connections because of
                                   // excess resource consumption.
 JSS(port);                        // in: Connect
+JSS(prefetch);                    // out: GetCounts
 JSS(previous);                    // out: Reservations
 JSS(previous_ledger);             // out: LedgerPropose
 JSS(proof);                       // in: BookOffers
@@ -484,6 +495,7 @@ JSS(queued);                      // out: SubmitTransaction
 JSS(queued_duration_us);
 JSS(random);                // out: Random
 JSS(raw_meta);              // out: AcceptedLedgerTx
+JSS(rebuilds);              // out: GetCounts
 JSS(receive_currencies);    // out: AccountCurrencies
 JSS(reference_level);       // out: TxQ
 JSS(refresh_interval);      // in: UNL
@@ -522,6 +534,8 @@ JSS(seq);                       // in: LedgerEntry;
 JSS(seqNum);                    // out: LedgerToJson
 JSS(sequence);                  // in: UNL
 JSS(sequence_count);            // out: AccountInfo
+JSS(serialize_saved_us);        // out: GetCounts
+JSS(serialize_us);              // out: GetCounts
 JSS(server_domain);             // out: NetworkOPs
 JSS(server_state);              // out: NetworkOPs
 JSS(server_state_duration_us);  // out: NetworkOPs
@@ -553,6 +567,7 @@ JSS(stop);                  // in: LedgerCleaner
 JSS(stop_history_tx_only);  // in: Unsubscribe, stop history tx stream
 JSS(storedSeqs);            // out: NodeToShardStatus
 JSS(streams);               // in: Subscribe, Unsubscribe
+                            // out: GetCounts
 JSS(strict);                // in: AccountCurrencies, AccountInfo
 JSS(sub_index);             // in: LedgerEntry
 JSS(subcommand);            // in: PathFind
@@ -21,19 +21,39 @@
 #define RIPPLE_RPC_RPCHANDLER_H_INCLUDED
 
 #include <ripple/core/Config.h>
+#include <ripple/json/Object.h>
 #include <ripple/net/InfoSub.h>
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/Status.h>
+#include <functional>
 
 namespace ripple {
 namespace RPC {
 
 struct JsonContext;
 
+/** Receives a function writing the result of a command to a Json::Object. */
+using ResultStream =
+    std::function<void(std::function<void(Json::Object&)> const&)>;
+
 /** Execute an RPC command and store the results in a Json::Value. */
 Status
 doCommand(RPC::JsonContext&, Json::Value&);
 
+/** Execute an RPC command, streaming its result if it is large.
+
+    The result of a command whose handler can write it a piece at a time is
+    passed to `stream`, once the request has passed the handler's checks, so
+    that it need never be held in full. Any other outcome, including every
+    error, is stored in the Json::Value as by the other overload.
+
+    An exception thrown while the result is streamed is caught, and reported
+    as an error in the Json::Value. Whatever was streamed so far must then be
+    discarded.
+*/
+Status
+doCommand(RPC::JsonContext&, Json::Value&, ResultStream const& stream);
+
 Role
 roleRequired(unsigned int version, bool betaEnabled, std::string const& method);
 
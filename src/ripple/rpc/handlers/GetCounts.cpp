@@ -22,7 +22,10 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/SHAMapStore.h>
+#include <ripple/app/paths/PathRequests.h>
 #include <ripple/app/rdb/backend/SQLiteDatabase.h>
+#include <ripple/app/tx/apply.h>
 #include <ripple/basics/UptimeClock.h>
 #include <ripple/json/json_value.h>
 #include <ripple/ledger/CachedSLEs.h>
@@ -119,6 +122,8 @@ getCountsJson(Application& app, int minObjectCount)
     ret[jss::treenode_track_size] =
         app.getNodeFamily().getTreeNodeCache(0)->getTrackSize();
 
+    app.getOPs().streamCounts(ret);
+
     std::string uptime;
     auto s = UptimeClock::now();
     using namespace std::chrono_literals;
@@ -151,6 +156,17 @@ getCountsJson(Application& app, int minObjectCount)
         app.getNodeStore().getCountsJson(ret);
     }
 
+    Json::Value& lineCache = (ret[jss::line_cache] = Json::objectValue);
+    app.getPathRequests().getCountsJson(lineCache);
+
+    Json::Value& prefetch = (ret[jss::prefetch] = Json::objectValue);
+    getPrefetchCounts(prefetch);
+
+    Json::Value onlineDelete(Json::objectValue);
+    app.getSHAMapStore().getCountsJson(onlineDelete);
+    if (onlineDelete.size())
+        ret[jss::online_delete] = onlineDelete;
+
     return ret;
 }
 
@@ -57,6 +57,20 @@ handle(JsonContext& context, Object& object)
     return status;
 };
 
+template <class HandlerImpl>
+Status
+handleStream(JsonContext& context, Json::Value& error, ResultStream const& out)
+{
+    HandlerImpl handler(context);
+
+    auto status = handler.check();
+    if (status)
+        status.inject(error);
+    else
+        out([&](Json::Object& object) { handler.writeResult(object); });
+    return status;
+};
+
 Handler const handlerArray[]{
     // Some handlers not specified here are added to the table via addHandler()
     // Request-response methods
@@ -106,7 +120,6 @@ Handler const handlerArray[]{
      byRef(&doLedgerCurrent),
      Role::USER,
      NEEDS_CURRENT_LEDGER},
-    {"ledger_data", byRef(&doLedgerData), Role::USER, NO_CONDITION},
     {"ledger_entry", byRef(&doLedgerEntry), Role::USER, NO_CONDITION},
     {"ledger_header", byRef(&doLedgerHeader), Role::USER, NO_CONDITION},
     {"ledger_request", byRef(&doLedgerRequest), Role::ADMIN, NO_CONDITION},
@@ -184,7 +197,8 @@ private:
         }
 
         // This is where the new-style handlers are added.
-        addHandler<LedgerHandler>();
+        addHandler<LedgerHandler>(true);
+        addHandler<LedgerDataHandler>(true);
         addHandler<VersionHandler>();
     }
 
@@ -221,15 +235,19 @@ public:
 private:
     std::map<std::string, Handler> table_;
 
+    // A handler which streams its result must write it the same way to a
+    // Json::Object as to a Json::Value.
     template <class HandlerImpl>
     void
-    addHandler()
+    addHandler(bool streams = false)
     {
         assert(table_.find(HandlerImpl::name()) == table_.end());
 
         Handler h;
         h.name_ = HandlerImpl::name();
         h.valueMethod_ = &handle<Json::Value, HandlerImpl>;
+        if (streams)
+            h.streamMethod_ = &handleStream<HandlerImpl>;
         h.role_ = HandlerImpl::role();
         h.condition_ = HandlerImpl::condition();
 
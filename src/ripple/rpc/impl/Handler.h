@@ -48,10 +48,17 @@ struct Handler
     template <class JsonValue>
     using Method = std::function<Status(JsonContext&, JsonValue&)>;
 
+    using StreamMethod =
+        std::function<Status(JsonContext&, Json::Value&, ResultStream const&)>;
+
     const char* name_;
     Method<Json::Value> valueMethod_;
     Role role_;
     RPC::Condition condition_;
+    // Hands a result which passed its checks to a ResultStream, instead of
+    // storing it in the Json::Value. Only set for handlers whose results can
+    // be large.
+    StreamMethod streamMethod_;
 };
 
 Handler const*
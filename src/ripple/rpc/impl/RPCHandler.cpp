@@ -248,6 +248,15 @@ injectReportingWarning(RPC::JsonContext& context, Json::Value& result)
 
 Status
 doCommand(RPC::JsonContext& context, Json::Value& result)
+{
+    return doCommand(context, result, nullptr);
+}
+
+Status
+doCommand(
+    RPC::JsonContext& context,
+    Json::Value& result,
+    ResultStream const& stream)
 {
     if (shouldForwardToP2p(context))
     {
@@ -263,7 +272,16 @@ doCommand(RPC::JsonContext& context, Json::Value& result)
         return error;
     }
 
-    if (auto method = handler->valueMethod_)
+    auto method = handler->valueMethod_;
+    // A reporting server may yet forward the request, so it never streams
+    if (stream && handler->streamMethod_ && !context.app.config().reporting())
+    {
+        method = [&](JsonContext& context, Json::Value& result) {
+            return handler->streamMethod_(context, result, stream);
+        };
+    }
+
+    if (method)
     {
         if (!context.headers.user.empty() ||
             !context.headers.forwardedFor.empty())
@@ -26,6 +26,7 @@
 #include <ripple/beast/net/IPAddressConversion.h>
 #include <ripple/beast/rfc2616.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/json/Writer.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/json/to_string.h>
 #include <ripple/net/RPCErr.h>
@@ -47,7 +48,9 @@
 #include <boost/beast/http/string_body.hpp>
 #include <boost/type_traits.hpp>
 #include <algorithm>
+#include <exception>
 #include <mutex>
+#include <optional>
 #include <stdexcept>
 
 namespace ripple {
@@ -111,7 +114,13 @@ ServerHandlerImp::ServerHandlerImp(
     , m_resourceManager(resourceManager)
     , m_journal(app_.journal("Server"))
     , m_networkOPs(networkOPs)
-    , m_server(make_Server(*this, io_service, app_.journal("Server")))
+    , m_server(make_Server(
+          *this,
+          io_service,
+          app_.journal("Server"),
+          [&app]() -> boost::asio::io_context& {
+              return app.getConnectionIOService();
+          }))
     , m_jobQueue(jobQueue)
 {
     auto const& group(cm.group("rpc"));
@@ -240,6 +249,22 @@ makeOutput(Session& session)
     };
 }
 
+// Suspend the coroutine while too much of a streamed reply waits to be sent,
+// so that the reply is produced no faster than the client reads it. Returns
+// false if the session failed.
+static bool
+waitUntilSent(Session& session, std::shared_ptr<JobQueue::Coro> const& coro)
+{
+    bool sent = true;
+    if (!session.whenSent(
+            RPC::Tuning::maxStreamUnsent, [&sent, coro](bool ok) {
+                sent = ok;
+                coro->post();
+            }))
+        coro->yield();
+    return sent;
+}
+
 static std::map<std::string, std::string>
 build_map(boost::beast::http::fields const& h)
 {
@@ -343,12 +368,22 @@ ServerHandlerImp::onWSMessage(
         "WS-Client",
         [this, session, jv = std::move(jv)](
             std::shared_ptr<JobQueue::Coro> const& coro) {
-            auto const jr = this->processSession(session, coro, jv);
-            auto const s = to_string(jr);
-            auto const n = s.length();
-            boost::beast::multi_buffer sb(n);
-            sb.commit(boost::asio::buffer_copy(
-                sb.prepare(n), boost::asio::buffer(s.c_str(), n)));
+            boost::beast::multi_buffer sb;
+            auto const jr = this->processSession(
+                session, coro, jv, [&sb](boost::beast::string_view const& b) {
+                    sb.commit(boost::asio::buffer_copy(
+                        sb.prepare(b.size()),
+                        boost::asio::buffer(b.data(), b.size())));
+                });
+            if (jr)
+            {
+                // Drop any part of a result that failed as it was written
+                sb.consume(sb.size());
+                auto const s = to_string(jr);
+                auto const n = s.length();
+                sb.commit(boost::asio::buffer_copy(
+                    sb.prepare(n), boost::asio::buffer(s.c_str(), n)));
+            }
             session->send(
                 std::make_shared<StreambufWSMsg<decltype(sb)>>(std::move(sb)));
             session->complete();
@@ -400,7 +435,8 @@ Json::Value
 ServerHandlerImp::processSession(
     std::shared_ptr<WSSession> const& session,
     std::shared_ptr<JobQueue::Coro> const& coro,
-    Json::Value const& jv)
+    Json::Value const& jv,
+    Output const& output)
 {
     auto is = std::static_pointer_cast<WSInfoSub>(session->appDefined);
     if (is->getConsumer().disconnect(m_journal))
@@ -415,6 +451,8 @@ ServerHandlerImp::processSession(
     // Requests without "command" are invalid.
     Json::Value jr(Json::objectValue);
     Resource::Charge loadType = Resource::feeReferenceRPC;
+    bool streamed = false;
+    bool charged = false;
     try
     {
         auto apiVersion =
@@ -477,8 +515,37 @@ ServerHandlerImp::processSession(
                 jv,
                 {is->user(), is->forwarded_for()}};
 
+            // A large result is written right to the output, instead of
+            // being built up first.
+            auto stream =
+                [&](std::function<void(Json::Object&)> const& write) {
+                    streamed = true;
+                    Json::Writer writer(output);
+                    Json::Object::Root root(writer);
+                    {
+                        auto&& object = Json::addObject(root, jss::result);
+                        write(object);
+                    }
+
+                    is->getConsumer().charge(loadType);
+                    charged = true;
+                    if (is->getConsumer().warn())
+                        root[jss::warning] = jss::load;
+                    root[jss::status] = jss::success;
+                    for (auto const& field :
+                         {jss::id,
+                          jss::jsonrpc,
+                          jss::ripplerpc,
+                          jss::api_version})
+                    {
+                        if (jv.isMember(field))
+                            root[field] = jv[field];
+                    }
+                    root[jss::type] = jss::response;
+                };
+
             auto start = std::chrono::system_clock::now();
-            RPC::doCommand(context, jr[jss::result]);
+            RPC::doCommand(context, jr[jss::result], stream);
             auto end = std::chrono::system_clock::now();
             logDuration(jv, end - start, m_journal);
         }
@@ -491,7 +558,11 @@ ServerHandlerImp::processSession(
             << "Input JSON: " << Json::Compact{Json::Value{jv}};
     }
 
-    is->getConsumer().charge(loadType);
+    if (streamed && !jr[jss::result].isMember(jss::error))
+        return Json::Value{};
+
+    if (!charged)
+        is->getConsumer().charge(loadType);
     if (is->getConsumer().warn())
         jr[jss::warning] = jss::load;
 
@@ -548,7 +619,7 @@ ServerHandlerImp::processSession(
     std::shared_ptr<Session> const& session,
     std::shared_ptr<JobQueue::Coro> coro)
 {
-    processRequest(
+    bool const complete = processRequest(
         session->port(),
         buffers_to_string(session->request().body().data()),
         session->remoteAddress().at_port(0),
@@ -560,9 +631,10 @@ ServerHandlerImp::processSession(
             if (iter != session->request().end())
                 return iter->value();
             return boost::beast::string_view{};
-        }());
+        }(),
+        session);
 
-    if (beast::rfc2616::is_keep_alive(session->request()))
+    if (complete && beast::rfc2616::is_keep_alive(session->request()))
         session->complete();
     else
         session->close(true);
@@ -584,7 +656,7 @@ Json::Int constexpr server_overloaded = -32604;
 Json::Int constexpr forbidden = -32605;
 Json::Int constexpr wrong_version = -32606;
 
-void
+bool
 ServerHandlerImp::processRequest(
     Port const& port,
     std::string const& request,
@@ -592,7 +664,8 @@ ServerHandlerImp::processRequest(
     Output&& output,
     std::shared_ptr<JobQueue::Coro> coro,
     boost::string_view forwardedFor,
-    boost::string_view user)
+    boost::string_view user,
+    std::shared_ptr<Session> const& session)
 {
     auto rpcJ = app_.journal("RPC");
 
@@ -608,7 +681,7 @@ ServerHandlerImp::processRequest(
                 "Unable to parse request: " + reader.getFormatedErrorMessages(),
                 output,
                 rpcJ);
-            return;
+            return true;
         }
     }
 
@@ -620,7 +693,7 @@ ServerHandlerImp::processRequest(
         if (!jsonOrig.isMember(jss::params) || !jsonOrig[jss::params].isArray())
         {
             HTTPReply(400, "Malformed batch request", output, rpcJ);
-            return;
+            return true;
         }
         size = jsonOrig[jss::params].size();
     }
@@ -664,7 +737,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, jss::invalid_API_version.c_str(), output, rpcJ);
-                return;
+                return true;
             }
             Json::Value r(Json::objectValue);
             r[jss::request] = jsonRPC;
@@ -714,7 +787,7 @@ ServerHandlerImp::processRequest(
                 if (!batch)
                 {
                     HTTPReply(503, "Server is overloaded", output, rpcJ);
-                    return;
+                    return true;
                 }
                 Json::Value r = jsonRPC;
                 r[jss::error] =
@@ -730,7 +803,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(403, "Forbidden", output, rpcJ);
-                return;
+                return true;
             }
             Json::Value r = jsonRPC;
             r[jss::error] = make_json_error(forbidden, "Forbidden");
@@ -744,7 +817,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, "Null method", output, rpcJ);
-                return;
+                return true;
             }
             Json::Value r = jsonRPC;
             r[jss::error] = make_json_error(method_not_found, "Null method");
@@ -759,7 +832,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, "method is not string", output, rpcJ);
-                return;
+                return true;
             }
             Json::Value r = jsonRPC;
             r[jss::error] =
@@ -775,7 +848,7 @@ ServerHandlerImp::processRequest(
             if (!batch)
             {
                 HTTPReply(400, "method is empty", output, rpcJ);
-                return;
+                return true;
             }
             Json::Value r = jsonRPC;
             r[jss::error] =
@@ -801,7 +874,7 @@ ServerHandlerImp::processRequest(
             {
                 usage.charge(Resource::feeInvalidRPC);
                 HTTPReply(400, "params unparseable", output, rpcJ);
-                return;
+                return true;
             }
             else
             {
@@ -810,7 +883,7 @@ ServerHandlerImp::processRequest(
                 {
                     usage.charge(Resource::feeInvalidRPC);
                     HTTPReply(400, "params unparseable", output, rpcJ);
-                    return;
+                    return true;
                 }
             }
         }
@@ -828,7 +901,7 @@ ServerHandlerImp::processRequest(
                 if (!batch)
                 {
                     HTTPReply(400, "ripplerpc is not a string", output, rpcJ);
-                    return;
+                    return true;
                 }
 
                 Json::Value r = jsonRPC;
@@ -874,11 +947,61 @@ ServerHandlerImp::processRequest(
             {user, forwardedFor}};
         Json::Value result;
 
+        // A large result is sent as it is written, instead of being built
+        // up first. Only a single request is streamed, never a batch, and
+        // only to a client which can take a chunked reply.
+        bool const canStream = !batch && session->request().version() >= 11;
+        std::optional<HTTPStreamedReply> streamed;
+        std::size_t streamedSize = 0;
+        bool connected = true;
+        bool streamFinished = false;
+        bool charged = false;
+        auto stream = [&](std::function<void(Json::Object&)> const& write) {
+            streamed.emplace(
+                [&](boost::beast::string_view const& b) {
+                    // Once the result fails or the client goes away, the rest
+                    // of the reply is dropped and the connection closed.
+                    if (!connected || std::uncaught_exceptions() != 0)
+                        return;
+                    session->write(b.data(), b.size());
+                    connected = waitUntilSent(*session, coro);
+                },
+                RPC::Tuning::streamChunkSize);
+            {
+                Json::Writer writer([&](boost::beast::string_view const& b) {
+                    streamedSize += b.size();
+                    streamed->write(b);
+                });
+                Json::Object::Root root(writer);
+                {
+                    auto&& object = Json::addObject(root, jss::result);
+                    write(object);
+
+                    usage.charge(loadType);
+                    charged = true;
+                    if (usage.warn())
+                        object[jss::warning] = jss::load;
+                    object[jss::status] = jss::success;
+                }
+                for (auto const& field :
+                     {jss::jsonrpc, jss::ripplerpc, jss::id})
+                {
+                    if (params.isMember(field))
+                        root[field] = params[field];
+                }
+            }
+            streamed->finish();
+            streamFinished = connected;
+        };
+
         auto start = std::chrono::system_clock::now();
 
         try
         {
-            RPC::doCommand(context, result);
+            RPC::doCommand(
+                context,
+                result,
+                canStream ? RPC::ResultStream{stream} : RPC::ResultStream{});
         }
         catch (std::exception const& ex)
         {
@@ -892,6 +1015,29 @@ ServerHandlerImp::processRequest(
 
         logDuration(params, end - start, m_journal);
 
+        if (streamed)
+        {
+            if (!charged)
+                usage.charge(loadType);
+
+            if (!streamFinished)
+            {
+                JLOG(m_journal.warn())
+                    << "Streamed reply to " << strMethod << " abandoned"
+                    << (result.isMember(jss::error)
+                            ? ": " + result[jss::error_message].asString()
+                            : std::string{});
+                return false;
+            }
+
+            rpc_time_.notify(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    end - start));
+            ++rpc_requests_;
+            rpc_size_.notify(beast::insight::Event::value_type{streamedSize});
+            return true;
+        }
+
         usage.charge(loadType);
         if (usage.warn())
             result[jss::warning] = jss::load;
@@ -989,6 +1135,7 @@ ServerHandlerImp::processRequest(
     }
 
     HTTPReply(200, response, output, rpcJ);
+    return true;
 }
 
 //------------------------------------------------------------------------------
@@ -171,18 +171,22 @@ public:
     onStopped(Server&);
 
 private:
+    // Returns null if the response was written to the Output instead.
     Json::Value
     processSession(
         std::shared_ptr<WSSession> const& session,
         std::shared_ptr<JobQueue::Coro> const& coro,
-        Json::Value const& jv);
+        Json::Value const& jv,
+        Output const& output);
 
     void
     processSession(
         std::shared_ptr<Session> const&,
         std::shared_ptr<JobQueue::Coro> coro);
 
-    void
+    // Returns false if a streamed reply was left incomplete, in which case
+    // the session must be closed.
+    bool
     processRequest(
         Port const& port,
         std::string const& request,
@@ -190,7 +194,8 @@ private:
         Output&&,
         std::shared_ptr<JobQueue::Coro> coro,
         boost::string_view forwardedFor,
-        boost::string_view user);
+        boost::string_view user,
+        std::shared_ptr<Session> const& session);
 
     Handoff
     statusResponse(http_request_type const& request) const;
@@ -77,6 +77,13 @@ inline int constexpr pageLength(bool isBinary)
     return isBinary ? binaryPageLength : jsonPageLength;
 }
 
+/** Size of the chunks in which a streamed HTTP reply is sent. */
+static std::size_t constexpr streamChunkSize = 64 * 1024;
+
+/** Amount of a streamed HTTP reply which may wait to be sent before the
+    handler writing it is suspended. */
+static std::size_t constexpr maxStreamUnsent = 1024 * 1024;
+
 /** Maximum number of source currencies allowed in a path find request. */
 static int constexpr max_src_cur = 18;
 
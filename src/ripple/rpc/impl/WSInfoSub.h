@@ -81,6 +81,15 @@ public:
         auto m = std::make_shared<StreambufWSMsg<decltype(sb)>>(std::move(sb));
         sp->send(m);
     }
+
+    void
+    send(PubMessage const& msg, bool) override
+    {
+        auto sp = ws_.lock();
+        if (!sp)
+            return;
+        sp->send(std::make_shared<SharedWSMsg>(msg.text()));
+    }
 };
 
 }  // namespace ripple
@@ -28,15 +28,22 @@
 
 namespace ripple {
 
-/** Create the HTTP server using the specified handler. */
+/** Create the HTTP server using the specified handler.
+
+    @param chooseContext If set, chooses the io_service each accepted
+                         connection runs on. Otherwise connections run on
+                         io_service with the listening sockets.
+*/
 template <class Handler>
 std::unique_ptr<Server>
 make_Server(
     Handler& handler,
     boost::asio::io_service& io_service,
-    beast::Journal journal)
+    beast::Journal journal,
+    IOContextChooser chooseContext = {})
 {
-    return std::make_unique<ServerImpl<Handler>>(handler, io_service, journal);
+    return std::make_unique<ServerImpl<Handler>>(
+        handler, io_service, journal, std::move(chooseContext));
 }
 
 }  // namespace ripple
@@ -100,6 +100,20 @@ public:
 
     /** @} */
 
+    /** Wait for written data to be sent.
+
+        This lets a response produced faster than the remote end reads it
+        wait, rather than pile up in memory.
+
+        @param bytes The amount of data which may remain unsent.
+        @param f Called once no more than `bytes` remain unsent, with
+                 `true`, or with `false` if the session fails first.
+        @return `true`, without calling `f`, if no more than `bytes` already
+                remain unsent.
+    */
+    virtual bool
+    whenSent(std::size_t bytes, std::function<void(bool)> f) = 0;
+
     /** Detach the session.
         This holds the session open so that the response can be sent
         asynchronously. Calls to io_service::run made by the server
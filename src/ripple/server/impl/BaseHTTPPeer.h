@@ -90,6 +90,10 @@ protected:
     http_request_type message_;
     std::vector<buffer> wq_;
     std::vector<buffer> wq2_;
+    std::size_t unsent_ = 0;
+    std::size_t whenSentBytes_ = 0;
+    std::function<void(bool)> whenSent_;
+    bool failed_ = false;
     std::mutex mutex_;
     bool graceful_ = false;
     bool complete_ = false;
@@ -191,6 +195,9 @@ protected:
     void
     write(std::shared_ptr<Writer> const& writer, bool keep_alive) override;
 
+    bool
+    whenSent(std::size_t bytes, std::function<void(bool)> f) override;
+
     std::shared_ptr<Session>
     detach() override;
 
@@ -262,6 +269,16 @@ BaseHTTPPeer<Handler, Impl>::fail(error_code ec, char const* what)
             << id_ << std::string(what) << ": " << ec.message();
         boost::beast::get_lowest_layer(impl().stream_).close();
     }
+
+    // Nothing written from now on will be sent
+    std::function<void(bool)> f;
+    {
+        std::lock_guard lock(mutex_);
+        failed_ = true;
+        std::swap(f, whenSent_);
+    }
+    if (f)
+        f(false);
 }
 
 template <class Handler, class Impl>
@@ -327,12 +344,18 @@ BaseHTTPPeer<Handler, Impl>::on_write(
     if (ec)
         return fail(ec, "write");
     bytes_out_ += bytes_transferred;
+    std::function<void(bool)> f;
     {
         std::lock_guard lock(mutex_);
         wq2_.clear();
         wq2_.reserve(wq_.size());
         std::swap(wq2_, wq_);
+        unsent_ -= bytes_transferred;
+        if (whenSent_ && unsent_ <= whenSentBytes_)
+            std::swap(f, whenSent_);
     }
+    if (f)
+        f(true);
     if (!wq2_.empty())
     {
         std::vector<boost::asio::const_buffer> v;
@@ -425,6 +448,7 @@ BaseHTTPPeer<Handler, Impl>::write(void const* buf, std::size_t bytes)
     if ([&] {
             std::lock_guard lock(mutex_);
             wq_.emplace_back(buf, bytes);
+            unsent_ += bytes;
             return wq_.size() == 1 && wq2_.size() == 0;
         }())
     {
@@ -457,6 +481,28 @@ BaseHTTPPeer<Handler, Impl>::write(
             std::placeholders::_1)));
 }
 
+template <class Handler, class Impl>
+bool
+BaseHTTPPeer<Handler, Impl>::whenSent(
+    std::size_t bytes,
+    std::function<void(bool)> f)
+{
+    {
+        std::lock_guard lock(mutex_);
+        if (unsent_ <= bytes)
+            return true;
+        if (!failed_)
+        {
+            assert(!whenSent_);
+            whenSentBytes_ = bytes;
+            whenSent_ = std::move(f);
+            return false;
+        }
+    }
+    f(false);
+    return false;
+}
+
 // DEPRECATED
 // Make the Session asynchronous
 template <class Handler, class Impl>
@@ -42,6 +42,13 @@
 
 namespace ripple {
 
+/** Chooses the io_context an accepted connection runs on.
+
+    The connection stays on it for its whole lifetime. When empty, the
+    connection runs on the io_context of the listening socket.
+*/
+using IOContextChooser = std::function<boost::asio::io_context&()>;
+
 /** A listening socket. */
 template <class Handler>
 class Door : public io_list::work,
@@ -94,6 +101,7 @@ private:
     Port const& port_;
     Handler& handler_;
     boost::asio::io_context& ioc_;
+    IOContextChooser const chooseContext_;
     acceptor_type acceptor_;
     boost::asio::io_context::strand strand_;
     bool ssl_;
@@ -106,6 +114,7 @@ public:
     Door(
         Handler& handler,
         boost::asio::io_context& io_context,
+        IOContextChooser chooseContext,
         Port const& port,
         beast::Journal j);
 
@@ -134,6 +143,7 @@ private:
     create(
         bool ssl,
         ConstBufferSequence const& buffers,
+        boost::asio::io_context& ioc,
         stream_type&& stream,
         endpoint_type remote_address);
 
@@ -284,12 +294,14 @@ template <class Handler>
 Door<Handler>::Door(
     Handler& handler,
     boost::asio::io_context& io_context,
+    IOContextChooser chooseContext,
     Port const& port,
     beast::Journal j)
     : j_(j)
     , port_(port)
     , handler_(handler)
     , ioc_(io_context)
+    , chooseContext_(std::move(chooseContext))
     , acceptor_(io_context)
     , strand_(io_context)
     , ssl_(
@@ -334,6 +346,7 @@ void
 Door<Handler>::create(
     bool ssl,
     ConstBufferSequence const& buffers,
+    boost::asio::io_context& ioc,
     stream_type&& stream,
     endpoint_type remote_address)
 {
@@ -342,7 +355,7 @@ Door<Handler>::create(
         if (auto sp = ios().template emplace<SSLHTTPPeer<Handler>>(
                 port_,
                 handler_,
-                ioc_,
+                ioc,
                 j_,
                 remote_address,
                 buffers,
@@ -353,7 +366,7 @@ Door<Handler>::create(
     if (auto sp = ios().template emplace<PlainHTTPPeer<Handler>>(
             port_,
             handler_,
-            ioc_,
+            ioc,
             j_,
             remote_address,
             buffers,
@@ -369,7 +382,8 @@ Door<Handler>::do_accept(boost::asio::yield_context do_yield)
     {
         error_code ec;
         endpoint_type remote_address;
-        stream_type stream(ioc_);
+        auto& ioc = chooseContext_ ? chooseContext_() : ioc_;
+        stream_type stream(ioc);
         socket_type& socket = stream.socket();
         acceptor_.async_accept(socket, remote_address, do_yield[ec]);
         if (ec)
@@ -390,7 +404,7 @@ Door<Handler>::do_accept(boost::asio::yield_context do_yield)
             if (auto sp = ios().template emplace<Detector>(
                     port_,
                     handler_,
-                    ioc_,
+                    ioc,
                     std::move(stream),
                     remote_address,
                     j_))
@@ -401,6 +415,7 @@ Door<Handler>::do_accept(boost::asio::yield_context do_yield)
             create(
                 ssl_,
                 boost::asio::null_buffers{},
+                ioc,
                 std::move(stream),
                 remote_address);
         }
@@ -24,6 +24,7 @@
 #include <ripple/protocol/jss.h>
 #include <ripple/server/impl/JSONRPCUtil.h>
 #include <boost/algorithm/string.hpp>
+#include <sstream>
 
 namespace ripple {
 
@@ -141,4 +142,50 @@ HTTPReply(
     output("\r\n");
 }
 
+HTTPStreamedReply::HTTPStreamedReply(
+    Json::Output const& output,
+    std::size_t chunkSize)
+    : output_(output), chunkSize_(chunkSize)
+{
+    output_("HTTP/1.1 200 OK\r\n");
+    output_(getHTTPHeaderTimestamp());
+    output_(
+        "Connection: Keep-Alive\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "Content-Type: application/json; charset=UTF-8\r\n");
+    output_("Server: " + systemName() + "-json-rpc/");
+    output_(BuildInfo::getFullVersionString());
+    output_(
+        "\r\n"
+        "\r\n");
+    chunk_.reserve(chunkSize_);
+}
+
+void
+HTTPStreamedReply::write(boost::beast::string_view const& s)
+{
+    chunk_.append(s.data(), s.size());
+    if (chunk_.size() >= chunkSize_)
+        flush();
+}
+
+void
+HTTPStreamedReply::finish()
+{
+    chunk_ += '\n';
+    flush();
+    output_("0\r\n\r\n");
+}
+
+void
+HTTPStreamedReply::flush()
+{
+    std::stringstream size;
+    size << std::hex << chunk_.size() << "\r\n";
+    chunk_ += "\r\n";
+    output_(size.str());
+    output_(chunk_);
+    chunk_.clear();
+}
+
 }  // namespace ripple
@@ -22,6 +22,7 @@
 
 #include <ripple/json/Output.h>
 #include <ripple/json/json_value.h>
+#include <string>
 
 namespace ripple {
 
@@ -32,6 +33,44 @@ HTTPReply(
     Json::Output const&,
     beast::Journal j);
 
+/** An HTTP 200 reply whose body is written a piece at a time.
+
+    The body is sent with chunked transfer encoding, so its length need not
+    be known and it need never be held in full. What is written is gathered
+    into chunks of about `chunkSize` bytes, each passed to the Output as soon
+    as it fills.
+*/
+class HTTPStreamedReply
+{
+public:
+    /** Write the headers of the reply. */
+    HTTPStreamedReply(Json::Output const& output, std::size_t chunkSize);
+
+    HTTPStreamedReply(HTTPStreamedReply const&) = delete;
+    HTTPStreamedReply&
+    operator=(HTTPStreamedReply const&) = delete;
+
+    /** Append to the body. */
+    void
+    write(boost::beast::string_view const& s);
+
+    /** Send the rest of the body, and end the reply.
+
+        A reply destroyed without this being called is left incomplete, and
+        the connection it was sent on must be closed.
+    */
+    void
+    finish();
+
+private:
+    void
+    flush();
+
+    Json::Output const output_;
+    std::size_t const chunkSize_;
+    std::string chunk_;
+};
+
 }  // namespace ripple
 
 #endif
@@ -83,6 +83,7 @@ private:
     Handler& handler_;
     beast::Journal const j_;
     boost::asio::io_service& io_service_;
+    IOContextChooser const chooseContext_;
     boost::asio::io_service::strand strand_;
     std::optional<boost::asio::io_service::work> work_;
 
@@ -98,7 +99,8 @@ public:
     ServerImpl(
         Handler& handler,
         boost::asio::io_service& io_service,
-        beast::Journal journal);
+        beast::Journal journal,
+        IOContextChooser chooseContext = {});
 
     ~ServerImpl();
 
@@ -138,10 +140,12 @@ template <class Handler>
 ServerImpl<Handler>::ServerImpl(
     Handler& handler,
     boost::asio::io_service& io_service,
-    beast::Journal journal)
+    beast::Journal journal,
+    IOContextChooser chooseContext)
     : handler_(handler)
     , j_(journal)
     , io_service_(io_service)
+    , chooseContext_(std::move(chooseContext))
     , strand_(io_service_)
     , work_(io_service_)
 {
@@ -169,7 +173,7 @@ ServerImpl<Handler>::ports(std::vector<Port> const& ports)
     {
         ports_.push_back(port);
         if (auto sp = ios_.emplace<Door<Handler>>(
-                handler_, io_service_, ports_.back(), j_))
+                handler_, io_service_, chooseContext_, ports_.back(), j_))
         {
             list_.push_back(sp);
             eps.push_back(sp->get_endpoint());
@@ -120,8 +120,8 @@ public:
     static inline constexpr unsigned int leafDepth = 64;
 
     using DeltaItem = std::pair<
-        std::shared_ptr<SHAMapItem const>,
-        std::shared_ptr<SHAMapItem const>>;
+        boost::intrusive_ptr<SHAMapItem const>,
+        boost::intrusive_ptr<SHAMapItem const>>;
     using Delta = std::map<uint256, DeltaItem>;
 
     SHAMap(SHAMap const&) = delete;
@@ -190,25 +190,40 @@ public:
     delItem(uint256 const& id);
 
     bool
-    addItem(SHAMapNodeType type, SHAMapItem&& i);
+    addItem(SHAMapNodeType type, boost::intrusive_ptr<SHAMapItem const> item);
 
     SHAMapHash
     getHash() const;
 
     // save a copy if you have a temporary anyway
     bool
-    updateGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const>);
+    updateGiveItem(SHAMapNodeType type, boost::intrusive_ptr<SHAMapItem const>);
 
     bool
-    addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item);
+    addGiveItem(
+        SHAMapNodeType type,
+        boost::intrusive_ptr<SHAMapItem const> item);
 
     // Save a copy if you need to extend the life
     // of the SHAMapItem beyond this SHAMap
-    std::shared_ptr<SHAMapItem const> const&
+    boost::intrusive_ptr<SHAMapItem const> const&
     peekItem(uint256 const& id) const;
-    std::shared_ptr<SHAMapItem const> const&
+    boost::intrusive_ptr<SHAMapItem const> const&
     peekItem(uint256 const& id, SHAMapHash& hash) const;
 
+    /** Start loading the nodes on the path to an item
+
+        Walks towards the item as far as the nodes in memory allow, then
+        reads the rest of the path from the node store asynchronously into
+        the tree node cache, so that a later lookup need not wait for it.
+
+        @param id the identifier of the item. It does not need to exist.
+        @param done called once the walk ends, possibly on another thread,
+        with the number of nodes this walk was first to put in the cache.
+    */
+    void
+    prefetch(uint256 const& id, std::function<void(std::size_t)> done) const;
+
     // traverse functions
     /** Find the first item after the given item.
 
@@ -236,6 +251,25 @@ public:
     void
     visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const;
 
+    /**  Visit every node in this SHAMap using several threads
+
+         The subtrees below the root's branches are shared out among
+         `threads` threads, the calling thread being one of them.
+
+         @param function called with the index of the visiting thread,
+         in [0, threads), and every node visited. Calls from different
+         threads are concurrent. If function returns false, every thread
+         stops and visitNodesParallel exits.
+
+         @throws SHAMapMissingNode if a node could not be fetched, once
+         every thread has stopped.
+    */
+    void
+    visitNodesParallel(
+        std::size_t threads,
+        std::function<bool(std::size_t, SHAMapTreeNode&)> const& function)
+        const;
+
     /**  Visit every node in this SHAMap that
          is not present in the specified SHAMap
 
@@ -253,8 +287,8 @@ public:
     */
     void
     visitLeaves(
-        std::function<void(std::shared_ptr<SHAMapItem const> const&)> const&)
-        const;
+        std::function<
+            void(boost::intrusive_ptr<SHAMapItem const> const&)> const&) const;
 
     // comparison/sync functions
 
@@ -336,9 +370,13 @@ public:
     int
     unshare();
 
-    /** Flush modified nodes to the nodestore and convert them to shared. */
+    /** Flush modified nodes to the nodestore and convert them to shared.
+
+        Unless parallel is false, the subtrees below the root's branches
+        are hashed and written concurrently on the shared WorkerPool.
+    */
     int
-    flushDirty(NodeObjectType t);
+    flushDirty(NodeObjectType t, bool parallel = true);
 
     void
     walkMap(std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const;
@@ -361,8 +399,8 @@ private:
     using SharedPtrNodeStack =
         std::stack<std::pair<std::shared_ptr<SHAMapTreeNode>, SHAMapNodeID>>;
     using DeltaRef = std::pair<
-        std::shared_ptr<SHAMapItem const> const&,
-        std::shared_ptr<SHAMapItem const> const&>;
+        boost::intrusive_ptr<SHAMapItem const> const&,
+        boost::intrusive_ptr<SHAMapItem const> const&>;
 
     // tree node cache operations
     std::shared_ptr<SHAMapTreeNode>
@@ -475,7 +513,7 @@ private:
     descendNoStore(std::shared_ptr<SHAMapInnerNode> const&, int branch) const;
 
     /** If there is only one leaf below this node, get its contents */
-    std::shared_ptr<SHAMapItem const> const&
+    boost::intrusive_ptr<SHAMapItem const> const&
     onlyBelow(SHAMapTreeNode*) const;
 
     bool
@@ -490,12 +528,25 @@ private:
     bool
     walkBranch(
         SHAMapTreeNode* node,
-        std::shared_ptr<SHAMapItem const> const& otherMapItem,
+        boost::intrusive_ptr<SHAMapItem const> const& otherMapItem,
         bool isFirstMap,
         Delta& differences,
         int& maxCount) const;
     int
-    walkSubTree(bool doWrite, NodeObjectType t);
+    walkSubTree(bool doWrite, NodeObjectType t, bool parallel);
+
+    /** Flush an inner node that this map owns and everything below it.
+
+        On return, node points to the flushed, shared node, which may be a
+        different instance if the node was canonicalized when written.
+
+        @return the number of nodes flushed
+    */
+    int
+    flushInner(
+        std::shared_ptr<SHAMapInnerNode>& node,
+        bool doWrite,
+        NodeObjectType t) const;
 
     // Structure to track information about call to
     // getMissingNodes while it's in progress
@@ -20,27 +20,84 @@
 #ifndef RIPPLE_SHAMAP_SHAMAPITEM_H_INCLUDED
 #define RIPPLE_SHAMAP_SHAMAPITEM_H_INCLUDED
 
-#include <ripple/basics/Buffer.h>
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/SlabAllocator.h>
 #include <ripple/basics/Slice.h>
 #include <ripple/basics/base_uint.h>
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
 
 namespace ripple {
 
+namespace detail {
+
+// Items are a 40 byte header and a payload of usually a few hundred
+// bytes. The block sizes are spaced to waste little of either.
+inline SlabAllocatorSet&
+shamapItemAllocator()
+{
+    // Never destroyed, so that items outliving static destruction can
+    // still be released.
+    static auto* const allocator = [] {
+        std::vector<std::size_t> sizes;
+        for (std::size_t size = 64; size <= 256; size += 16)
+            sizes.push_back(size);
+        for (std::size_t size = 288; size <= 512; size += 32)
+            sizes.push_back(size);
+        for (std::size_t size = 576; size <= 1024; size += 64)
+            sizes.push_back(size);
+        return new SlabAllocatorSet(sizes);
+    }();
+    return *allocator;
+}
+
+}  // namespace detail
+
 // an item stored in a SHAMap
+//
+// There are tens of millions of these in a full state map, so the payload
+// is kept in the same block as the item, the block comes from a slab sized
+// for it, and the item counts its own references. Items are only made by
+// make_shamapitem and only held through boost::intrusive_ptr.
 class SHAMapItem : public CountedObject<SHAMapItem>
 {
 private:
-    uint256 tag_;
-    Buffer data_;
-
-public:
-    SHAMapItem() = delete;
+    uint256 const tag_;
+    std::uint32_t const size_;
+    mutable std::atomic<std::uint32_t> refcount_{1};
 
-    SHAMapItem(uint256 const& tag, Slice data) : tag_(tag), data_(data)
+    // The payload follows the item
+    SHAMapItem(uint256 const& tag, Slice data)
+        : tag_(tag), size_(static_cast<std::uint32_t>(data.size()))
     {
+        if (!data.empty())
+            std::memcpy(
+                reinterpret_cast<std::uint8_t*>(this) + sizeof(*this),
+                data.data(),
+                data.size());
     }
 
+    friend boost::intrusive_ptr<SHAMapItem const>
+    make_shamapitem(uint256 const& tag, Slice data);
+
+    friend void
+    intrusive_ptr_add_ref(SHAMapItem const* item);
+
+    friend void
+    intrusive_ptr_release(SHAMapItem const* item);
+
+public:
+    SHAMapItem() = delete;
+    SHAMapItem(SHAMapItem const&) = delete;
+    SHAMapItem&
+    operator=(SHAMapItem const&) = delete;
+
     uint256 const&
     key() const
     {
@@ -50,22 +107,56 @@ public:
     Slice
     slice() const
     {
-        return static_cast<Slice>(data_);
+        return {data(), size()};
     }
 
     std::size_t
     size() const
     {
-        return data_.size();
+        return size_;
     }
 
     void const*
     data() const
     {
-        return data_.data();
+        return reinterpret_cast<std::uint8_t const*>(this) + sizeof(*this);
     }
 };
 
+inline boost::intrusive_ptr<SHAMapItem const>
+make_shamapitem(uint256 const& tag, Slice data)
+{
+    assert(data.size() <= std::numeric_limits<std::uint32_t>::max());
+    auto const raw = detail::shamapItemAllocator().allocate(
+        sizeof(SHAMapItem) + data.size());
+    // The reference the item starts with is adopted, not added
+    return {new (raw) SHAMapItem(tag, data), false};
+}
+
+inline boost::intrusive_ptr<SHAMapItem const>
+make_shamapitem(SHAMapItem const& other)
+{
+    return make_shamapitem(other.key(), other.slice());
+}
+
+inline void
+intrusive_ptr_add_ref(SHAMapItem const* item)
+{
+    item->refcount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void
+intrusive_ptr_release(SHAMapItem const* item)
+{
+    if (item->refcount_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        auto const bytes = sizeof(SHAMapItem) + item->size_;
+        item->~SHAMapItem();
+        detail::shamapItemAllocator().deallocate(
+            const_cast<SHAMapItem*>(item), bytes);
+    }
+}
+
 }  // namespace ripple
 
 #endif
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/WorkerPool.h>
 #include <ripple/basics/contract.h>
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/shamap/SHAMapAccountStateLeafNode.h>
@@ -30,7 +31,7 @@ namespace ripple {
 [[nodiscard]] std::shared_ptr<SHAMapLeafNode>
 makeTypedLeaf(
     SHAMapNodeType type,
-    std::shared_ptr<SHAMapItem const> item,
+    boost::intrusive_ptr<SHAMapItem const> item,
     std::uint32_t owner)
 {
     if (type == SHAMapNodeType::tnTRANSACTION_NM)
@@ -501,9 +502,9 @@ SHAMap::firstBelow(
 
     return belowHelper(node, stack, branch, {init, cmp, incr});
 }
-static const std::shared_ptr<SHAMapItem const> no_item;
+static const boost::intrusive_ptr<SHAMapItem const> no_item;
 
-std::shared_ptr<SHAMapItem const> const&
+boost::intrusive_ptr<SHAMapItem const> const&
 SHAMap::onlyBelow(SHAMapTreeNode* node) const
 {
     // If there is only one item below this node, return it
@@ -582,7 +583,7 @@ SHAMap::peekNextItem(uint256 const& id, SharedPtrNodeStack& stack) const
     return nullptr;
 }
 
-std::shared_ptr<SHAMapItem const> const&
+boost::intrusive_ptr<SHAMapItem const> const&
 SHAMap::peekItem(uint256 const& id) const
 {
     SHAMapLeafNode* leaf = findKey(id);
@@ -593,7 +594,7 @@ SHAMap::peekItem(uint256 const& id) const
     return leaf->peekItem();
 }
 
-std::shared_ptr<SHAMapItem const> const&
+boost::intrusive_ptr<SHAMapItem const> const&
 SHAMap::peekItem(uint256 const& id, SHAMapHash& hash) const
 {
     SHAMapLeafNode* leaf = findKey(id);
@@ -605,6 +606,103 @@ SHAMap::peekItem(uint256 const& id, SHAMapHash& hash) const
     return leaf->peekItem();
 }
 
+// Continue a prefetch walk below a node that must come from the node store.
+// This may run after the map is gone, so it uses only the family's caches.
+static void
+prefetchBelow(
+    Family& f,
+    std::uint32_t ledgerSeq,
+    SHAMapHash const& hash,
+    SHAMapNodeID const& nodeID,
+    uint256 const& id,
+    std::size_t loaded,
+    std::function<void(std::size_t)> done)
+{
+    f.db().asyncFetch(
+        hash.as_uint256(),
+        ledgerSeq,
+        [&f, ledgerSeq, hash, nodeID, id, loaded, done{std::move(done)}](
+            std::shared_ptr<NodeObject> const& object) mutable {
+            std::shared_ptr<SHAMapTreeNode> node;
+            try
+            {
+                if (object)
+                    node = SHAMapTreeNode::makeFromPrefix(
+                        makeSlice(object->getData()), hash);
+            }
+            catch (std::exception const&)
+            {
+                JLOG(f.journal().warn()) << "Invalid DB node " << hash;
+            }
+
+            auto const cache = f.getTreeNodeCache(ledgerSeq);
+            auto childID = nodeID;
+            while (node)
+            {
+                if (!cache->canonicalize_replace_client(
+                        node->getHash().as_uint256(), node))
+                    ++loaded;
+
+                if (!node->isInner())
+                    break;
+
+                auto const inner = static_cast<SHAMapInnerNode*>(node.get());
+                auto const branch = selectBranch(childID, id);
+                if (inner->isEmptyBranch(branch))
+                    break;
+
+                auto const& childHash = inner->getChildHash(branch);
+                childID = childID.getChildNodeID(branch);
+                node = cache->fetch(childHash.as_uint256());
+                if (!node)
+                {
+                    prefetchBelow(
+                        f,
+                        ledgerSeq,
+                        childHash,
+                        childID,
+                        id,
+                        loaded,
+                        std::move(done));
+                    return;
+                }
+            }
+            done(loaded);
+        });
+}
+
+void
+SHAMap::prefetch(uint256 const& id, std::function<void(std::size_t)> done)
+    const
+{
+    auto node = root_;
+    SHAMapNodeID nodeID;
+
+    while (backed_ && node->isInner())
+    {
+        auto const inner = std::static_pointer_cast<SHAMapInnerNode>(node);
+        auto const branch = selectBranch(nodeID, id);
+        if (inner->isEmptyBranch(branch))
+            break;
+
+        nodeID = nodeID.getChildNodeID(branch);
+        node = inner->getChild(branch);
+        if (!node)
+        {
+            auto const& hash = inner->getChildHash(branch);
+            node = cacheLookup(hash);
+            if (!node)
+            {
+                prefetchBelow(
+                    f_, ledgerSeq_, hash, nodeID, id, 0, std::move(done));
+                return;
+            }
+            node = inner->canonicalizeChild(branch, std::move(node));
+        }
+    }
+    done(0);
+}
+
 SHAMap::const_iterator
 SHAMap::upper_bound(uint256 const& id) const
 {
@@ -765,7 +863,9 @@ SHAMap::delItem(uint256 const& id)
 }
 
 bool
-SHAMap::addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item)
+SHAMap::addGiveItem(
+    SHAMapNodeType type,
+    boost::intrusive_ptr<SHAMapItem const> item)
 {
     assert(state_ != SHAMapState::Immutable);
     assert(type != SHAMapNodeType::tnINNER);
@@ -803,7 +903,7 @@ SHAMap::addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item)
         // this is a leaf node that has to be made an inner node holding two
         // items
         auto leaf = std::static_pointer_cast<SHAMapLeafNode>(node);
-        std::shared_ptr<SHAMapItem const> otherItem = leaf->peekItem();
+        boost::intrusive_ptr<SHAMapItem const> otherItem = leaf->peekItem();
         assert(otherItem && (tag != otherItem->key()));
 
         node = std::make_shared<SHAMapInnerNode>(node->cowid());
@@ -834,9 +934,11 @@ SHAMap::addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item)
 }
 
 bool
-SHAMap::addItem(SHAMapNodeType type, SHAMapItem&& i)
+SHAMap::addItem(
+    SHAMapNodeType type,
+    boost::intrusive_ptr<SHAMapItem const> item)
 {
-    return addGiveItem(type, std::make_shared<SHAMapItem const>(std::move(i)));
+    return addGiveItem(type, std::move(item));
 }
 
 SHAMapHash
@@ -854,7 +956,7 @@ SHAMap::getHash() const
 bool
 SHAMap::updateGiveItem(
     SHAMapNodeType type,
-    std::shared_ptr<SHAMapItem const> item)
+    boost::intrusive_ptr<SHAMapItem const> item)
 {
     // can't change the tag but can change the hash
     uint256 tag = item->key();
@@ -976,18 +1078,18 @@ int
 SHAMap::unshare()
 {
     // Don't share nodes with parent map
-    return walkSubTree(false, hotUNKNOWN);
+    return walkSubTree(false, hotUNKNOWN, true);
 }
 
 int
-SHAMap::flushDirty(NodeObjectType t)
+SHAMap::flushDirty(NodeObjectType t, bool parallel)
 {
     // We only write back if this map is backed.
-    return walkSubTree(backed_, t);
+    return walkSubTree(backed_, t, parallel);
 }
 
 int
-SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
+SHAMap::walkSubTree(bool doWrite, NodeObjectType t, bool parallel)
 {
     assert(!doWrite || backed_);
 
@@ -1016,13 +1118,97 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
         return 1;
     }
 
+    node = preFlushNode(std::move(node));
+
+    // The root's branches that need flushing. No need to do I/O: if a
+    // node isn't linked, it can't need to be flushed.
+    std::array<std::shared_ptr<SHAMapTreeNode>, branchFactor> children;
+    std::vector<int> branches;
+    if (parallel)
+    {
+        for (int branch = 0; branch < branchFactor; ++branch)
+        {
+            if (node->isEmptyBranch(branch))
+                continue;
+
+            auto child = node->getChild(branch);
+            if (child && child->isInner() && (child->cowid() != 0))
+                branches.push_back(branch);
+            children[branch] = std::move(child);
+        }
+    }
+
+    // With a single dirty subtree there is nothing to run side by side
+    if (branches.size() < 2)
+    {
+        flushed = flushInner(node, doWrite, t);
+        root_ = std::move(node);
+        return flushed;
+    }
+
+    // The subtrees below the root share no node that needs flushing, so
+    // each is hashed and written on its own. Only the root, which links
+    // them, waits for all of them.
+    std::array<int, branchFactor> counts{};
+    WorkerPool::instance().run(branches.size(), [&](std::size_t i) {
+        auto const branch = branches[i];
+        auto child = std::static_pointer_cast<SHAMapInnerNode>(
+            preFlushNode(std::move(children[branch])));
+        counts[branch] = flushInner(child, doWrite, t);
+        children[branch] = std::move(child);
+    });
+
+    for (auto const branch : branches)
+    {
+        assert(node->cowid() == cowid_);
+        node->shareChild(branch, children[branch]);
+        flushed += counts[branch];
+    }
+
+    // Dirty leaves directly below the root are too cheap to hand out
+    for (int branch = 0; branch < branchFactor; ++branch)
+    {
+        auto& child = children[branch];
+        if (!child || !child->isLeaf() || (child->cowid() == 0))
+            continue;
+
+        ++flushed;
+
+        child = preFlushNode(std::move(child));
+        child->updateHash();
+        child->unshare();
+
+        if (doWrite)
+            child = writeNode(t, std::move(child));
+
+        node->shareChild(branch, child);
+    }
+
+    node->updateHashDeep();
+    node->unshare();
+
+    if (doWrite)
+        node = std::static_pointer_cast<SHAMapInnerNode>(
+            writeNode(t, std::move(node)));
+
+    root_ = std::move(node);
+
+    return flushed + 1;
+}
+
+int
+SHAMap::flushInner(
+    std::shared_ptr<SHAMapInnerNode>& node,
+    bool doWrite,
+    NodeObjectType t) const
+{
+    int flushed = 0;
+
     // Stack of {parent,index,child} pointers representing
     // inner nodes we are in the process of flushing
     using StackEntry = std::pair<std::shared_ptr<SHAMapInnerNode>, int>;
     std::stack<StackEntry, std::vector<StackEntry>> stack;
 
-    node = preFlushNode(std::move(node));
-
     int pos = 0;
 
     // We can't flush an inner node until we flush its children
@@ -1105,9 +1291,6 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
         ++pos;
     }
 
-    // Last inner node is the new root_
-    root_ = std::move(node);
-
     return flushed;
 }
 
@@ -37,7 +37,7 @@ namespace ripple {
 bool
 SHAMap::walkBranch(
     SHAMapTreeNode* node,
-    std::shared_ptr<SHAMapItem const> const& otherMapItem,
+    boost::intrusive_ptr<SHAMapItem const> const& otherMapItem,
     bool isFirstMap,
     Delta& differences,
     int& maxCount) const
@@ -72,12 +72,10 @@ SHAMap::walkBranch(
                 // unmatched
                 if (isFirstMap)
                     differences.insert(std::make_pair(
-                        item->key(),
-                        DeltaRef(item, std::shared_ptr<SHAMapItem const>())));
+                        item->key(), DeltaRef(item, nullptr)));
                 else
                     differences.insert(std::make_pair(
-                        item->key(),
-                        DeltaRef(std::shared_ptr<SHAMapItem const>(), item)));
+                        item->key(), DeltaRef(nullptr, item)));
 
                 if (--maxCount <= 0)
                     return false;
@@ -110,12 +108,10 @@ SHAMap::walkBranch(
         // otherMapItem was unmatched, must add
         if (isFirstMap)  // this is first map, so other item is from second
             differences.insert(std::make_pair(
-                otherMapItem->key(),
-                DeltaRef(std::shared_ptr<SHAMapItem const>(), otherMapItem)));
+                otherMapItem->key(), DeltaRef(nullptr, otherMapItem)));
         else
             differences.insert(std::make_pair(
-                otherMapItem->key(),
-                DeltaRef(otherMapItem, std::shared_ptr<SHAMapItem const>())));
+                otherMapItem->key(), DeltaRef(otherMapItem, nullptr)));
 
         if (--maxCount <= 0)
             return false;
@@ -173,17 +169,13 @@ SHAMap::compare(SHAMap const& otherMap, Delta& differences, int maxCount) const
             {
                 differences.insert(std::make_pair(
                     ours->peekItem()->key(),
-                    DeltaRef(
-                        ours->peekItem(),
-                        std::shared_ptr<SHAMapItem const>())));
+                    DeltaRef(ours->peekItem(), nullptr)));
                 if (--maxCount <= 0)
                     return false;
 
                 differences.insert(std::make_pair(
                     other->peekItem()->key(),
-                    DeltaRef(
-                        std::shared_ptr<SHAMapItem const>(),
-                        other->peekItem())));
+                    DeltaRef(nullptr, other->peekItem())));
                 if (--maxCount <= 0)
                     return false;
             }
@@ -217,7 +209,7 @@ SHAMap::compare(SHAMap const& otherMap, Delta& differences, int maxCount) const
                         SHAMapTreeNode* iNode = descendThrow(ours, i);
                         if (!walkBranch(
                                 iNode,
-                                std::shared_ptr<SHAMapItem const>(),
+                                nullptr,
                                 true,
                                 differences,
                                 maxCount))
@@ -229,7 +221,7 @@ SHAMap::compare(SHAMap const& otherMap, Delta& differences, int maxCount) const
                         SHAMapTreeNode* iNode = otherMap.descendThrow(other, i);
                         if (!otherMap.walkBranch(
                                 iNode,
-                                std::shared_ptr<SHAMapItem const>(),
+                                nullptr,
                                 false,
                                 differences,
                                 maxCount))
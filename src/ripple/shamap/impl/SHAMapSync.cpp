@@ -20,12 +20,18 @@
 #include <ripple/basics/random.h>
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/shamap/SHAMapSyncFilter.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace ripple {
 
 void
 SHAMap::visitLeaves(
-    std::function<void(std::shared_ptr<SHAMapItem const> const& item)> const&
+    std::function<
+        void(boost::intrusive_ptr<SHAMapItem const> const& item)> const&
         leafFunction) const
 {
     visitNodes([&leafFunction](SHAMapTreeNode& node) {
@@ -96,6 +102,97 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
     }
 }
 
+void
+SHAMap::visitNodesParallel(
+    std::size_t threads,
+    std::function<bool(std::size_t, SHAMapTreeNode&)> const& function) const
+{
+    if (!root_)
+        return;
+
+    if (!function(0, *root_) || !root_->isInner())
+        return;
+
+    auto const innerRoot = std::static_pointer_cast<SHAMapInnerNode>(root_);
+    std::vector<int> branches;
+    for (int i = 0; i < branchFactor; ++i)
+    {
+        if (!innerRoot->isEmptyBranch(i))
+            branches.push_back(i);
+    }
+
+    if (branches.empty())
+        return;
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> stop{false};
+    std::mutex m;
+    std::exception_ptr error;
+
+    // Claim the subtrees below the root one at a time and walk each
+    // depth first. A false return or an exception stops every walker.
+    auto walk = [&](std::size_t worker) {
+        using StackEntry = std::shared_ptr<SHAMapInnerNode>;
+        std::stack<StackEntry, std::vector<StackEntry>> stack;
+
+        auto visit = [&](std::shared_ptr<SHAMapTreeNode> node) {
+            if (stop)
+                return false;
+            if (!function(worker, *node))
+            {
+                stop = true;
+                return false;
+            }
+            if (node->isInner())
+                stack.push(std::static_pointer_cast<SHAMapInnerNode>(
+                    std::move(node)));
+            return true;
+        };
+
+        try
+        {
+            for (auto i = next++; i < branches.size(); i = next++)
+            {
+                if (!visit(descendNoStore(innerRoot, branches[i])))
+                    return;
+
+                while (!stack.empty())
+                {
+                    auto node = std::move(stack.top());
+                    stack.pop();
+
+                    for (int b = 0; b < branchFactor; ++b)
+                    {
+                        if (!node->isEmptyBranch(b) &&
+                            !visit(descendNoStore(node, b)))
+                            return;
+                    }
+                }
+            }
+        }
+        catch (...)
+        {
+            stop = true;
+            std::lock_guard l(m);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+
+    threads = std::clamp<std::size_t>(threads, 1, branches.size());
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i)
+        workers.emplace_back(walk, i);
+
+    walk(0);
+    for (auto& worker : workers)
+        worker.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
 void
 SHAMap::visitDifferences(
     SHAMap const* have,
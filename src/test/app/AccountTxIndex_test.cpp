@@ -0,0 +1,777 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/main/DBInit.h>
+#include <ripple/app/rdb/AccountTxIndex.h>
+#include <ripple/app/rdb/backend/detail/Node.h>
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/TxMeta.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <tuple>
+
+namespace ripple {
+
+namespace {
+
+using Entry = AccountTxIndex::Entry;
+
+constexpr auto maxSeq = std::numeric_limits<std::uint32_t>::max();
+
+AccountID
+makeAccount(std::uint8_t n)
+{
+    AccountID account;
+    *account.begin() = n;
+    return account;
+}
+
+uint256
+makeTxID(std::uint32_t ledgerSeq, std::uint32_t txnSeq)
+{
+    uint256 id;
+    auto p = id.begin();
+    for (auto v : {ledgerSeq, txnSeq})
+    {
+        *p++ = static_cast<std::uint8_t>(v >> 24);
+        *p++ = static_cast<std::uint8_t>(v >> 16);
+        *p++ = static_cast<std::uint8_t>(v >> 8);
+        *p++ = static_cast<std::uint8_t>(v);
+    }
+    return id;
+}
+
+std::vector<Entry>
+scanAll(
+    AccountTxIndex const& index,
+    AccountID const& account,
+    bool forward,
+    std::uint32_t minLedger = 0,
+    std::uint32_t maxLedger = maxSeq)
+{
+    std::vector<Entry> ret;
+    index.scan(
+        account,
+        {minLedger, 0},
+        {maxLedger, maxSeq},
+        forward,
+        [&](Entry const& entry) {
+            ret.push_back(entry);
+            return true;
+        });
+    return ret;
+}
+
+// Metadata of a transaction at the given place in its ledger which modified
+// the roots of the given accounts
+Blob
+makeMeta(std::uint32_t txnSeq, std::vector<AccountID> const& accounts)
+{
+    TxMeta meta(uint256{}, 0);
+    for (auto const& account : accounts)
+    {
+        auto const key = keylet::account(account).key;
+        meta.setAffectedNode(key, sfModifiedNode, ltACCOUNT_ROOT);
+        STObject fields(sfFinalFields);
+        fields.setAccountID(sfAccount, account);
+        meta.getAffectedNode(key).emplace_back(std::move(fields));
+    }
+    Serializer s;
+    meta.addRaw(s, tesSUCCESS, txnSeq);
+    return std::move(s.modData());
+}
+
+// Fills an index with ledgers of random transactions, each of which also
+// affects account 0, and returns the positions of those.
+std::set<std::pair<std::uint32_t, std::uint32_t>>
+fillIndex(
+    AccountTxIndex& index,
+    std::uint32_t firstLedger,
+    std::uint32_t lastLedger,
+    std::uint64_t seed)
+{
+    std::set<std::pair<std::uint32_t, std::uint32_t>> ret;
+    beast::xor_shift_engine r(seed);
+    for (auto seq = firstLedger; seq <= lastLedger; ++seq)
+    {
+        std::vector<Entry> batch;
+        auto const count = r() % 6;
+        for (std::uint32_t txn = 0; txn < count; ++txn)
+        {
+            auto const id = makeTxID(seq, txn);
+            batch.push_back({makeAccount(1 + r() % 8), seq, txn, id});
+            batch.push_back({makeAccount(0), seq, txn, id});
+            ret.emplace(seq, txn);
+        }
+        index.insert(batch);
+    }
+    return ret;
+}
+
+}  // namespace
+
+class AccountTxIndex_test : public beast::unit_test::suite
+{
+    AccountTxIndex::Setup
+    smallSetup(beast::temp_dir const& dir)
+    {
+        AccountTxIndex::Setup setup;
+        setup.dir = dir.path();
+        setup.memtableEntries = 500;
+        setup.fenceInterval = 7;
+        return setup;
+    }
+
+    // Check that a scan finds exactly the expected positions of account 0
+    // in both directions.
+    void
+    expectEntries(
+        AccountTxIndex const& index,
+        std::set<std::pair<std::uint32_t, std::uint32_t>> const& expected)
+    {
+        auto const forward = scanAll(index, makeAccount(0), true);
+        auto const backward = scanAll(index, makeAccount(0), false);
+        if (!BEAST_EXPECT(forward.size() == expected.size()) ||
+            !BEAST_EXPECT(backward.size() == expected.size()))
+            return;
+
+        bool ok = true;
+        auto e = expected.begin();
+        for (std::size_t i = 0; i < forward.size(); ++i, ++e)
+        {
+            auto const& f = forward[i];
+            auto const& b = backward[backward.size() - i - 1];
+            ok = ok && f.ledgerSeq == e->first && f.txnSeq == e->second &&
+                f.txID == makeTxID(e->first, e->second) &&
+                f.account == makeAccount(0) && b.ledgerSeq == f.ledgerSeq &&
+                b.txnSeq == f.txnSeq && b.txID == f.txID;
+        }
+        BEAST_EXPECT(ok);
+    }
+
+    void
+    testOrdering()
+    {
+        testcase("Ordering");
+        test::SuiteJournal journal("AccountTxIndex_test", *this);
+
+        // Without a directory the index is kept in memory
+        AccountTxIndex index({}, journal);
+        BEAST_EXPECT(!index.minLedgerSeq());
+        BEAST_EXPECT(scanAll(index, makeAccount(0), true).empty());
+
+        // Entries of a batch need not be sorted
+        index.insert(
+            {{makeAccount(1), 7, 2, makeTxID(7, 2)},
+             {makeAccount(1), 7, 0, makeTxID(7, 0)},
+             {makeAccount(2), 5, 1, makeTxID(5, 1)},
+             {makeAccount(1), 3, 4, makeTxID(3, 4)}});
+        index.insert({{makeAccount(1), 9, 0, makeTxID(9, 0)}});
+
+        auto const forward = scanAll(index, makeAccount(1), true);
+        if (BEAST_EXPECT(forward.size() == 4))
+        {
+            BEAST_EXPECT(forward[0].ledgerSeq == 3 && forward[0].txnSeq == 4);
+            BEAST_EXPECT(forward[1].ledgerSeq == 7 && forward[1].txnSeq == 0);
+            BEAST_EXPECT(forward[2].ledgerSeq == 7 && forward[2].txnSeq == 2);
+            BEAST_EXPECT(forward[3].ledgerSeq == 9 && forward[3].txnSeq == 0);
+            BEAST_EXPECT(forward[2].txID == makeTxID(7, 2));
+        }
+        auto const backward = scanAll(index, makeAccount(1), false);
+        BEAST_EXPECT(
+            backward.size() == 4 && backward.front().ledgerSeq == 9 &&
+            backward.back().ledgerSeq == 3);
+
+        // Both positions are inclusive
+        std::vector<Entry> range;
+        index.scan(makeAccount(1), {7, 0}, {7, 2}, true, [&](Entry const& e) {
+            range.push_back(e);
+            return true;
+        });
+        BEAST_EXPECT(range.size() == 2);
+
+        // Scans stop when asked to
+        int visited = 0;
+        index.scan(makeAccount(1), {0, 0}, {maxSeq, maxSeq}, false, [&](auto&) {
+            return ++visited < 2;
+        });
+        BEAST_EXPECT(visited == 2);
+
+        BEAST_EXPECT(index.minLedgerSeq() == 3);
+        BEAST_EXPECT(index.size() == 5);
+        BEAST_EXPECT(scanAll(index, makeAccount(3), true).empty());
+    }
+
+    void
+    testResave()
+    {
+        testcase("Resave");
+        test::SuiteJournal journal("AccountTxIndex_test", *this);
+
+        beast::temp_dir dir;
+        AccountTxIndex index(smallSetup(dir), journal);
+        auto const expected = fillIndex(index, 1, 400, 1);
+
+        // Saving a ledger again, before and after its entries were written
+        // to a run, visits each position once with the newest ID.
+        for (int i = 0; i < 2; ++i)
+        {
+            auto const [seq, txn] = *expected.begin();
+            index.insert({{makeAccount(0), seq, txn, makeTxID(seq, txn)}});
+            expectEntries(index, expected);
+            index.flush();
+        }
+
+        uint256 const replaced{42};
+        auto const [seq, txn] = *expected.rbegin();
+        index.insert({{makeAccount(0), seq, txn, replaced}});
+        auto const newest = scanAll(index, makeAccount(0), false, seq, seq);
+        BEAST_EXPECT(!newest.empty() && newest.front().txID == replaced);
+
+        // Saving a ledger again with one transaction moved to another place
+        // in it, and another no longer affecting an account, leaves entries
+        // of the first save in the index. Queries skip them.
+        DatabaseCon::Setup setup;
+        setup.dataDir = dir.path();
+        DatabaseCon txdb(setup, TxDBName, TxDBPragma, TxDBInit);
+        auto db = txdb.checkoutDb();
+
+        AccountTxIndex resaved({}, journal);
+        auto const alice = makeAccount(10);
+        auto const bob = makeAccount(11);
+        auto const carol = makeAccount(12);
+        auto const moved = makeTxID(500, 3);
+        auto const dropped = makeTxID(500, 4);
+        std::vector<Entry> const first{
+            {alice, 500, 3, moved},
+            {bob, 500, 4, dropped},
+            {carol, 500, 4, dropped}};
+        saveTransactions(*db, first);
+        resaved.insert(first);
+
+        RangeSet<std::uint32_t> ledger;
+        ledger.insert(500);
+        resaved.markResaved(ledger);
+        std::vector<Entry> const second{
+            {alice, 500, 5, moved}, {carol, 500, 4, dropped}};
+        saveTransactions(*db, second);
+        resaved.insert(second);
+
+        BEAST_EXPECT(scanAll(resaved, alice, true).size() == 2);
+        BEAST_EXPECT(scanAll(resaved, bob, true).size() == 1);
+        BEAST_EXPECT(resaved.resaved() == ledger);
+
+        auto const found = [&](AccountID const& account) {
+            RelationalDatabase::AccountTxOptions const options{
+                account, 0, maxSeq, 0, 100, true};
+            std::vector<Blob> ret;
+            for (auto const& tx :
+                 detail::getOldestAccountTxsB(resaved, *db, options))
+                ret.push_back(std::get<0>(tx));
+            return ret;
+        };
+        BEAST_EXPECT(
+            found(alice) ==
+            std::vector<Blob>{Blob(moved.begin(), moved.end())});
+        BEAST_EXPECT(found(bob).empty());
+        BEAST_EXPECT(
+            found(carol) ==
+            std::vector<Blob>{Blob(dropped.begin(), dropped.end())});
+    }
+
+    void
+    testPersistence()
+    {
+        testcase("Persistence");
+        test::SuiteJournal journal("AccountTxIndex_test", *this);
+
+        beast::temp_dir dir;
+        std::set<std::pair<std::uint32_t, std::uint32_t>> expected;
+        {
+            AccountTxIndex index(smallSetup(dir), journal);
+            BEAST_EXPECT(!index.imported());
+            expected = fillIndex(index, 1, 1000, 2);
+            index.markImported();
+            BEAST_EXPECT(index.imported());
+
+            // Runs were merged down to a few
+            BEAST_EXPECT(index.runCount() > 0 && index.runCount() < 8);
+            expectEntries(index, expected);
+
+            // Left only in the log when the index is closed
+            index.insert({{makeAccount(0), 1001, 0, makeTxID(1001, 0)}});
+            expected.emplace(1001, 0);
+        }
+        {
+            AccountTxIndex index(smallSetup(dir), journal);
+            BEAST_EXPECT(index.imported());
+            expectEntries(index, expected);
+            BEAST_EXPECT(index.minLedgerSeq() == expected.begin()->first);
+
+            auto const more = fillIndex(index, 1002, 1200, 3);
+            expected.insert(more.begin(), more.end());
+        }
+
+        // Logs of other sizes are replayed too
+        auto setup = smallSetup(dir);
+        setup.memtableEntries = 100'000;
+        AccountTxIndex index(setup, journal);
+        expectEntries(index, expected);
+    }
+
+    void
+    testDeleteBefore()
+    {
+        testcase("DeleteBefore");
+        test::SuiteJournal journal("AccountTxIndex_test", *this);
+
+        beast::temp_dir dir;
+        std::set<std::pair<std::uint32_t, std::uint32_t>> expected;
+        {
+            AccountTxIndex index(smallSetup(dir), journal);
+            expected = fillIndex(index, 1, 800, 4);
+            RangeSet<std::uint32_t> resaved;
+            resaved.insert(100);
+            resaved.insert(500);
+            index.markResaved(resaved);
+            index.deleteBefore(300);
+            BEAST_EXPECT(index.resaved() == RangeSet<std::uint32_t>(500u));
+            expected.erase(expected.begin(), expected.lower_bound({300, 0}));
+            expectEntries(index, expected);
+            BEAST_EXPECT(index.minLedgerSeq() >= 300);
+
+            // Merges drop what was deleted
+            auto const before = index.size();
+            auto const more = fillIndex(index, 801, 1200, 5);
+            expected.insert(more.begin(), more.end());
+            index.flush();
+            BEAST_EXPECT(index.size() < before + 2 * more.size());
+            expectEntries(index, expected);
+        }
+
+        // The ledgers saved again are noted durably
+        AccountTxIndex index(smallSetup(dir), journal);
+        expectEntries(index, expected);
+        BEAST_EXPECT(index.minLedgerSeq() >= 300);
+        BEAST_EXPECT(index.resaved() == RangeSet<std::uint32_t>(500u));
+    }
+
+    // Fill the Transactions table with the transactions named by the
+    // entries, with metadata affecting the accounts of the entries.
+    static void
+    saveTransactions(
+        soci::session& session,
+        std::vector<Entry> const& entries,
+        std::uint32_t ledgerOffset = 0)
+    {
+        std::map<uint256, std::pair<Entry, std::vector<AccountID>>> txs;
+        for (auto const& entry : entries)
+        {
+            auto& tx = txs[entry.txID];
+            tx.first = entry;
+            tx.second.push_back(entry.account);
+        }
+
+        soci::transaction tr(session);
+        for (auto const& [id, tx] : txs)
+        {
+            auto const& [entry, accounts] = tx;
+            session << "INSERT OR REPLACE INTO Transactions "
+                       "(TransID, LedgerSeq, Status, RawTxn, TxnMeta) "
+                       "VALUES ('" +
+                    to_string(id) + "', " +
+                    std::to_string(entry.ledgerSeq + ledgerOffset) +
+                    ", 'V', X'" + strHex(id) + "', X'" +
+                    strHex(makeMeta(entry.txnSeq, accounts)) + "');";
+        }
+        tr.commit();
+    }
+
+    void
+    testQueries()
+    {
+        testcase("Queries");
+        test::SuiteJournal journal("AccountTxIndex_test", *this);
+
+        beast::temp_dir dir;
+        DatabaseCon::Setup setup;
+        setup.dataDir = dir.path();
+        DatabaseCon txdb(setup, TxDBName, TxDBPragma, TxDBInit);
+        auto db = txdb.checkoutDb();
+
+        AccountTxIndex index({}, journal);
+        auto const account = makeAccount(0);
+        std::vector<Entry> entries;
+        for (std::uint32_t seq = 10; seq < 20; ++seq)
+        {
+            for (std::uint32_t txn = 0; txn < 3; ++txn)
+                entries.push_back({account, seq, txn, makeTxID(seq, txn)});
+        }
+        index.insert(entries);
+        saveTransactions(*db, entries);
+
+        // An entry for a transaction saved again with another ledger
+        std::vector<Entry> stale{{account, 15, 1, makeTxID(15, 1)}};
+        saveTransactions(*db, stale, 100);
+        index.insert({{account, 115, 1, makeTxID(15, 1)}});
+
+        // Page through the transactions, newest first
+        std::vector<std::pair<std::uint32_t, Blob>> found;
+        auto onTransaction = [&](std::uint32_t seq,
+                                 std::string const& status,
+                                 Blob&& rawTxn,
+                                 Blob&&) {
+            BEAST_EXPECT(status == "V");
+            found.emplace_back(seq, std::move(rawTxn));
+        };
+        std::optional<RelationalDatabase::AccountTxMarker> marker;
+        int pages = 0;
+        do
+        {
+            RelationalDatabase::AccountTxPageOptions const options{
+                account, 0, maxSeq, marker, 4, false};
+            auto const [next, total] = detail::newestAccountTxPage(
+                index, *db, [](std::uint32_t) {}, onTransaction, options, 200);
+            BEAST_EXPECT(total == 4 || !next);
+            marker = next;
+        } while (marker && ++pages < 20);
+
+        if (BEAST_EXPECT(found.size() == entries.size()))
+        {
+            BEAST_EXPECT(found.front().first == 115);
+            BEAST_EXPECT(found.back().first == 10);
+            auto const oldestID = makeTxID(10, 0);
+            BEAST_EXPECT(
+                found.back().second ==
+                Blob(oldestID.begin(), oldestID.end()));
+        }
+
+        // Offsets skip transactions
+        RelationalDatabase::AccountTxOptions const options{
+            account, 12, 13, 2, 3, false};
+        auto const oldest = detail::getOldestAccountTxsB(index, *db, options);
+        if (BEAST_EXPECT(oldest.size() == 3))
+        {
+            BEAST_EXPECT(std::get<2>(oldest[0]) == 12);
+            BEAST_EXPECT(std::get<2>(oldest[1]) == 13);
+            BEAST_EXPECT(std::get<2>(oldest[2]) == 13);
+        }
+
+        // Importing reads the AccountTransactions table
+        *db << "INSERT INTO AccountTransactions "
+               "(TransID, Account, LedgerSeq, TxnSeq) VALUES ('" +
+                to_string(makeTxID(30, 1)) + "', '" + toBase58(account) +
+                "', 30, 1);";
+        AccountTxIndex imported({}, journal);
+        BEAST_EXPECT(detail::importAccountTransactions(
+            *db,
+            [&](std::vector<Entry>& batch) {
+                imported.insert(batch);
+                return true;
+            },
+            journal));
+        auto const all = scanAll(imported, account, true);
+        BEAST_EXPECT(
+            all.size() == 1 && all[0].ledgerSeq == 30 && all[0].txnSeq == 1 &&
+            all[0].txID == makeTxID(30, 1));
+    }
+
+    void
+    testGaps()
+    {
+        testcase("Gaps");
+        test::SuiteJournal journal("AccountTxIndex_test", *this);
+
+        beast::temp_dir dir;
+        DatabaseCon::Setup setup;
+        setup.dataDir = dir.path();
+        DatabaseCon txdb(setup, TxDBName, TxDBPragma, TxDBInit);
+        auto db = txdb.checkoutDb();
+
+        using detail::AccountTxStore;
+        for (auto const store : {AccountTxStore::Index, AccountTxStore::Table})
+        {
+            detail::makeAccountTxGaps(*db, store);
+            detail::makeAccountTxGaps(*db, store);
+        }
+        for (LedgerIndex seq : {40, 20, 30, 20})
+            detail::addAccountTxGap(*db, AccountTxStore::Index, seq);
+        detail::addAccountTxGap(*db, AccountTxStore::Table, 50);
+        auto const gaps = detail::getAccountTxGaps(*db, AccountTxStore::Index);
+        BEAST_EXPECT(gaps == std::vector<LedgerIndex>({20, 30, 40}));
+        BEAST_EXPECT(
+            detail::getAccountTxGaps(*db, AccountTxStore::Table) ==
+            std::vector<LedgerIndex>({50}));
+
+        // Only the rows of the ledgers noted are caught up with
+        auto const account = makeAccount(0);
+        for (std::uint32_t seq : {20, 25, 30})
+        {
+            *db << "INSERT INTO AccountTransactions "
+                   "(TransID, Account, LedgerSeq, TxnSeq) VALUES ('" +
+                    to_string(makeTxID(seq, 2)) + "', '" +
+                    toBase58(account) + "', " + std::to_string(seq) + ", 2);";
+        }
+        AccountTxIndex index({}, journal);
+        BEAST_EXPECT(detail::importLedgerAccountTransactions(
+            *db,
+            gaps,
+            [&](std::vector<Entry>& batch) {
+                index.insert(batch);
+                return true;
+            },
+            journal));
+        auto const all = scanAll(index, account, true);
+        BEAST_EXPECT(
+            all.size() == 2 && all[0].ledgerSeq == 20 &&
+            all[0].txID == makeTxID(20, 2) && all[1].ledgerSeq == 30 &&
+            all[1].txnSeq == 2 && all[1].txID == makeTxID(30, 2));
+
+        detail::deleteAccountTxGaps(*db, AccountTxStore::Index, 31);
+        BEAST_EXPECT(
+            detail::getAccountTxGaps(*db, AccountTxStore::Index) ==
+            std::vector<LedgerIndex>({40}));
+        BEAST_EXPECT(
+            detail::getAccountTxGaps(*db, AccountTxStore::Table).size() == 1);
+
+        // The table catches up from the metadata of the transactions. A
+        // row left by an earlier save of a transaction since moved to the
+        // ledger goes.
+        auto const other = makeAccount(1);
+        saveTransactions(
+            *db,
+            {{account, 50, 0, makeTxID(50, 0)},
+             {other, 50, 0, makeTxID(50, 0)},
+             {other, 50, 3, makeTxID(25, 2)}});
+        BEAST_EXPECT(
+            detail::saveLedgerAccountTransactions(*db, 50, journal) == 3);
+
+        std::set<std::tuple<std::string, std::string, std::uint32_t>> rows;
+        {
+            // SOCI requires boost::optional (not std::optional) as
+            // parameters.
+            boost::optional<std::string> transID, acct;
+            boost::optional<std::uint32_t> txnSeq;
+            soci::statement st =
+                (db->prepare << "SELECT TransID, Account, TxnSeq "
+                                "FROM AccountTransactions "
+                                "WHERE LedgerSeq = 50 OR LedgerSeq = 25;",
+                 soci::into(transID),
+                 soci::into(acct),
+                 soci::into(txnSeq));
+            st.execute();
+            while (st.fetch())
+                rows.emplace(
+                    transID.value_or(""),
+                    acct.value_or(""),
+                    txnSeq.value_or(0));
+        }
+        BEAST_EXPECT(
+            rows ==
+            decltype(rows)(
+                {{to_string(makeTxID(50, 0)), toBase58(account), 0},
+                 {to_string(makeTxID(50, 0)), toBase58(other), 0},
+                 {to_string(makeTxID(25, 2)), toBase58(other), 3}}));
+    }
+
+public:
+    void
+    run() override
+    {
+        testOrdering();
+        testResave();
+        testPersistence();
+        testDeleteBefore();
+        testQueries();
+        testGaps();
+    }
+};
+
+// Saves the given number of transactions, 200'000 by default, for one
+// account into both the SQLite transaction database and the account
+// transaction index, along with as many for other accounts, and reports
+// how long it takes to page through them with account_tx's page length.
+class AccountTxIndexTiming_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static constexpr std::uint32_t txnsPerLedger = 50;
+    static constexpr std::uint32_t pageLength = 200;
+
+    struct Timing
+    {
+        std::size_t pages = 0;
+        std::size_t transactions = 0;
+        std::chrono::microseconds total{0};
+        std::chrono::microseconds worst{0};
+    };
+
+    template <class Page>
+    Timing
+    pageThrough(Page const& page)
+    {
+        Timing ret;
+        std::optional<RelationalDatabase::AccountTxMarker> marker;
+        do
+        {
+            auto const start = clock_type::now();
+            auto const [next, total] = page(marker);
+            auto const elapsed =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    clock_type::now() - start);
+            ret.total += elapsed;
+            ret.worst = std::max(ret.worst, elapsed);
+            ret.transactions += total;
+            ++ret.pages;
+            marker = next;
+        } while (marker);
+        return ret;
+    }
+
+    void
+    report(char const* what, Timing const& t)
+    {
+        std::stringstream ss;
+        ss << std::setw(16) << what << std::setw(10) << t.pages
+           << std::setw(14) << t.transactions << std::setw(14)
+           << t.total.count() / std::max<std::size_t>(t.pages, 1)
+           << std::setw(14) << t.worst.count();
+        log << ss.str() << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        test::SuiteJournal journal("AccountTxIndexTiming_test", *this);
+
+        std::uint32_t count = 200'000;
+        if (!arg().empty())
+            count = std::stoul(arg());
+
+        beast::temp_dir dir;
+        DatabaseCon::Setup setup;
+        setup.dataDir = dir.path();
+        DatabaseCon txdb(setup, TxDBName, TxDBPragma, TxDBInit);
+        auto db = txdb.checkoutDb();
+
+        AccountTxIndex::Setup indexSetup;
+        indexSetup.dir = dir.file("account_tx_index");
+        AccountTxIndex index(indexSetup, journal);
+
+        testcase("load");
+        auto const heavy = makeAccount(0);
+        auto const heavyID = toBase58(heavy);
+        beast::xor_shift_engine r(1);
+        std::string const raw(200, 'a');
+        auto const ledgers = (count + txnsPerLedger - 1) / txnsPerLedger;
+        auto const start = clock_type::now();
+        for (std::uint32_t seq = 1; seq <= ledgers; ++seq)
+        {
+            std::vector<Entry> entries;
+            std::string txns =
+                "INSERT INTO Transactions "
+                "(TransID, LedgerSeq, Status, RawTxn, TxnMeta) VALUES ";
+            std::string accts =
+                "INSERT INTO AccountTransactions "
+                "(TransID, Account, LedgerSeq, TxnSeq) VALUES ";
+            for (std::uint32_t txn = 0; txn < txnsPerLedger; ++txn)
+            {
+                auto const id = makeTxID(seq, txn);
+                auto const other = makeAccount(1 + r() % 200);
+                entries.push_back({heavy, seq, txn, id});
+                entries.push_back({other, seq, txn, id});
+
+                auto const sid = "'" + to_string(id) + "'";
+                auto const sseq = std::to_string(seq);
+                auto const stxn = std::to_string(txn);
+                txns += "(" + sid + ", " + sseq + ", 'V', X'" + strHex(raw) +
+                    "', X'" + strHex(makeMeta(txn, {heavy, other})) + "'),";
+                accts += "(" + sid + ", '" + heavyID + "', " + sseq + ", " +
+                    stxn + "),(" + sid + ", '" + toBase58(other) + "', " +
+                    sseq + ", " + stxn + "),";
+            }
+            txns.back() = ';';
+            accts.back() = ';';
+
+            soci::transaction tr(*db);
+            *db << txns;
+            *db << accts;
+            tr.commit();
+            index.insert(entries);
+        }
+        index.flush();
+        log << "saved " << ledgers << " ledgers in "
+            << std::chrono::duration<double>(clock_type::now() - start)
+                   .count()
+            << "s, " << index.runCount() << " index runs" << std::endl;
+
+        testcase("paging");
+        log << std::setw(16) << "newest first" << std::setw(10) << "pages"
+            << std::setw(14) << "transactions" << std::setw(14) << "us/page"
+            << std::setw(14) << "worst us" << std::endl;
+
+        auto onTransaction =
+            [](std::uint32_t, std::string const&, Blob&&, Blob&&) {};
+        auto onUnsavedLedger = [](std::uint32_t) {};
+        auto options = [&](auto const& marker) {
+            return RelationalDatabase::AccountTxPageOptions{
+                heavy, 0, maxSeq, marker, pageLength, false};
+        };
+
+        auto const sqlite = pageThrough([&](auto const& marker) {
+            return detail::newestAccountTxPage(
+                *db,
+                onUnsavedLedger,
+                onTransaction,
+                options(marker),
+                0,
+                pageLength);
+        });
+        report("SQLite", sqlite);
+
+        auto const indexed = pageThrough([&](auto const& marker) {
+            return detail::newestAccountTxPage(
+                index,
+                *db,
+                onUnsavedLedger,
+                onTransaction,
+                options(marker),
+                pageLength);
+        });
+        report("index", indexed);
+
+        BEAST_EXPECT(sqlite.transactions == ledgers * txnsPerLedger);
+        BEAST_EXPECT(indexed.transactions == sqlite.transactions);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AccountTxIndex, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(AccountTxIndexTiming, app, ripple);
+
+}  // namespace ripple
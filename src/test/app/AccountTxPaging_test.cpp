@@ -61,12 +61,17 @@ class AccountTxPaging_test : public beast::unit_test::suite
     }
 
     void
-    testAccountTxPaging()
+    testAccountTxPaging(bool useIndex)
     {
-        testcase("Paging for Single Account");
+        testcase(
+            std::string("Paging for Single Account") +
+            (useIndex ? " with index" : ""));
         using namespace test::jtx;
 
-        Env env(*this);
+        Env env(*this, envconfig([useIndex](std::unique_ptr<Config> cfg) {
+            cfg->setUseAccountTxIndex(useIndex);
+            return cfg;
+        }));
         Account A1{"A1"};
         Account A2{"A2"};
         Account A3{"A3"};
@@ -2159,7 +2164,8 @@ public:
     void
     run() override
     {
-        testAccountTxPaging();
+        testAccountTxPaging(false);
+        testAccountTxPaging(true);
         testAccountTxPagingGrpc();
         testAccountTxParametersGrpc();
         testAccountTxContentsGrpc();
@@ -20,6 +20,11 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/unit_test.h>
+#include <ripple/protocol/digest.h>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+#include <thread>
 
 namespace ripple {
 namespace test {
@@ -242,6 +247,49 @@ class HashRouter_test : public beast::unit_test::suite
         BEAST_EXPECT(router.shouldProcess(key, peer, flags, 1s));
     }
 
+    void
+    testShards()
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 2s, 4);
+
+        // Keys whose leading bytes put them in different shards
+        uint256 key1;
+        uint256 key2;
+        key1.data()[1] = 1;
+        key2.data()[1] = 2;
+
+        // t=0
+        router.setFlags(key1, 11111);
+        router.setFlags(key2, 22222);
+
+        ++stopwatch;
+        ++stopwatch;
+        ++stopwatch;
+
+        // t=3
+        // Adding an entry only expires the entries of its own shard
+        uint256 key3 = key1;
+        key3.data()[31] = 3;
+        router.setFlags(key3, 33333);
+        BEAST_EXPECT(router.getFlags(key1) == 0);
+
+        // key2 has outlived the hold time, but nothing was added to its
+        // shard, so it is still there
+        BEAST_EXPECT(router.getFlags(key2) == 22222);
+
+        // A peer is only recorded once
+        BEAST_EXPECT(router.shouldRelay(key3));
+        for (HashRouter::PeerShortID peer : {7, 3, 7, 9, 3, 0})
+            router.addSuppressionPeer(key3, peer);
+        ++stopwatch;
+        ++stopwatch;
+        auto const peers = router.shouldRelay(key3);
+        BEAST_EXPECT(
+            peers && *peers == std::set<HashRouter::PeerShortID>({3, 7, 9}));
+    }
+
 public:
     void
     run() override
@@ -252,10 +300,91 @@ public:
         testSetFlags();
         testRelay();
         testProcess();
+        testShards();
+    }
+};
+
+/** Measure the throughput of the calls peers make for every message as the
+    number of threads making them grows, with one shard and with the default
+    number of shards.
+    Run manually with --unittest=HashRouterContention
+*/
+class HashRouterContention_test : public beast::unit_test::suite
+{
+    static constexpr std::size_t keyCount = 100000;
+    static constexpr std::size_t opsPerThread = 200000;
+
+    double
+    measure(std::vector<uint256> const& keys, std::size_t n, std::size_t shards)
+    {
+        using namespace std::chrono;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, HashRouter::getDefaultHoldTime(), shards);
+
+        std::atomic<bool> start{false};
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < n; ++t)
+        {
+            threads.emplace_back([&, t] {
+                while (!start)
+                    std::this_thread::yield();
+                // Each thread plays a peer which hears about messages in its
+                // own order, relays some and marks a few as bad.
+                auto const peer = static_cast<HashRouter::PeerShortID>(t + 1);
+                auto i = t * 7919;
+                for (std::size_t op = 0; op < opsPerThread; ++op)
+                {
+                    i = (i + 104729) % keys.size();
+                    if (op % 16 == 0)
+                        router.setFlags(keys[i], SF_BAD);
+                    else if (op % 4 == 0)
+                        router.shouldRelay(keys[i]);
+                    else
+                        router.addSuppressionPeer(keys[i], peer);
+                }
+            });
+        }
+
+        auto const begin = steady_clock::now();
+        start = true;
+        for (auto& t : threads)
+            t.join();
+        auto const elapsed = steady_clock::now() - begin;
+
+        return n * opsPerThread /
+            duration_cast<duration<double>>(elapsed).count();
+    }
+
+public:
+    void
+    run() override
+    {
+        std::vector<uint256> keys;
+        keys.reserve(keyCount);
+        for (std::size_t i = 0; i < keyCount; ++i)
+            keys.push_back(sha512Half(i));
+
+        testcase("contention");
+        log << std::setw(8) << "threads" << std::setw(16) << "1 shard ops/s"
+            << std::setw(16) << "sharded ops/s" << std::setw(10) << "speedup"
+            << std::endl;
+        for (std::size_t n : {1, 2, 4, 8, 16, 32})
+        {
+            auto const one = measure(keys, n, 1);
+            auto const sharded =
+                measure(keys, n, HashRouter::getDefaultShards());
+            BEAST_EXPECT(one > 0 && sharded > 0);
+            std::stringstream ss;
+            ss << std::setw(8) << n << std::fixed << std::setprecision(0)
+               << std::setw(16) << one << std::setw(16) << sharded
+               << std::setprecision(2) << std::setw(10) << sharded / one;
+            log << ss.str() << std::endl;
+        }
     }
 };
 
 BEAST_DEFINE_TESTSUITE(HashRouter, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(HashRouterContention, app, ripple);
 
 }  // namespace test
 }  // namespace ripple
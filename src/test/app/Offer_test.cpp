@@ -17,6 +17,8 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/tx/apply.h>
 #include <ripple/protocol/Feature.h>
 #include <ripple/protocol/Quality.h>
 #include <ripple/protocol/jss.h>
@@ -1120,6 +1122,18 @@ public:
             env(offer(alice, XRP(1000), XRP(1000)), ter(temBAD_OFFER));
             env.require(owners(alice, 0), offers(alice, 0));
 
+            // Such an order has no book, so it can be prefetched before
+            // preflight rejects it
+            for (auto const& same :
+                 {env.jt(offer(alice, XRP(1000), XRP(1000))),
+                  env.jt(offer(alice, USD(1000), USD(1000)))})
+            {
+                if (BEAST_EXPECT(same.stx))
+                    prefetchTransaction(
+                        *env.app().getLedgerMaster().getClosedLedger(),
+                        *same.stx);
+            }
+
             // Alice tries an IOU to IOU order:
             env(trust(alice, USD(1000)), ter(tesSUCCESS));
             env(pay(gw, alice, USD(1000)), ter(tesSUCCESS));
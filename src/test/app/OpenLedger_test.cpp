@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/misc/HashRouter.h>
+#include <ripple/app/tx/apply.h>
+#include <test/jtx.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace ripple {
+namespace test {
+
+/*  Submits many transactions into one open ledger, in small batches as
+    NetworkOPs does, and reports how long each batch takes to apply as the
+    ledger fills. Copying the open ledger for a batch should not grow with
+    the number of transactions already in it.
+
+    Run manually with --unittest=OpenLedgerModify
+*/
+class OpenLedgerModify_test : public beast::unit_test::suite
+{
+    static constexpr std::size_t accountCount = 100;
+    static constexpr std::size_t txPerAccount = 100;
+    static constexpr std::size_t batchSize = 10;
+    static constexpr std::size_t reportEvery = 1000;
+
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+        using namespace std::chrono;
+
+        testcase("modify");
+
+        Env env(*this);
+        auto& app = env.app();
+
+        std::vector<Account> accounts;
+        for (std::size_t i = 0; i < accountCount; ++i)
+        {
+            accounts.emplace_back("account" + std::to_string(i));
+            env.fund(XRP(10000), accounts.back());
+        }
+        env.close();
+
+        // Sign everything up front, taking turns between the accounts so
+        // each account's transactions arrive in sequence.
+        std::vector<std::shared_ptr<STTx const>> txs;
+        txs.reserve(accountCount * txPerAccount);
+        for (std::size_t n = 0; n < txPerAccount; ++n)
+        {
+            for (auto const& account : accounts)
+            {
+                auto const tx =
+                    env.jt(noop(account), seq(env.seq(account) + n), fee(10))
+                        .stx;
+                forceValidity(
+                    app.getHashRouter(), tx->getTransactionID(), Validity::Valid);
+                txs.push_back(tx);
+            }
+        }
+
+        log << std::setw(10) << "txs" << std::setw(16) << "batch mean us"
+            << std::setw(16) << "batch max us" << std::setw(16)
+            << "copy mean us" << std::endl;
+
+        std::size_t applied = 0;
+        double batchTotal = 0;
+        double batchMax = 0;
+        double copyTotal = 0;
+        std::size_t batches = 0;
+        for (std::size_t i = 0; i < txs.size(); i += batchSize)
+        {
+            auto const last = std::min(i + batchSize, txs.size());
+
+            auto const start = steady_clock::now();
+            app.openLedger().modify([&](OpenView& view, beast::Journal j) {
+                for (auto k = i; k < last; ++k)
+                    applied += ripple::apply(app, view, *txs[k], tapNONE, j)
+                                   .second;
+                return true;
+            });
+            auto const batch =
+                duration_cast<duration<double, std::micro>>(
+                    steady_clock::now() - start)
+                    .count();
+
+            // The copy modify makes of the open ledger, on its own.
+            auto const current = app.openLedger().current();
+            auto const copyStart = steady_clock::now();
+            OpenView const copy(*current);
+            auto const copied =
+                duration_cast<duration<double, std::micro>>(
+                    steady_clock::now() - copyStart)
+                    .count();
+
+            batchTotal += batch;
+            batchMax = std::max(batchMax, batch);
+            copyTotal += copied;
+            ++batches;
+
+            if (last % reportEvery == 0 || last == txs.size())
+            {
+                std::stringstream ss;
+                ss << std::setw(10) << copy.txCount() << std::fixed
+                   << std::setprecision(1) << std::setw(16)
+                   << batchTotal / batches << std::setw(16) << batchMax
+                   << std::setw(16) << copyTotal / batches;
+                log << ss.str() << std::endl;
+                batchTotal = batchMax = copyTotal = 0;
+                batches = 0;
+            }
+        }
+
+        BEAST_EXPECT(applied == txs.size());
+        BEAST_EXPECT(app.openLedger().current()->txCount() == txs.size());
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(OpenLedgerModify, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/OrderBookDB.h>
+#include <ripple/core/JobQueue.h>
+#include <test/jtx.h>
+
+namespace ripple {
+namespace test {
+
+class OrderBookDB_test : public beast::unit_test::suite
+{
+    // Closes a ledger and waits for it to be published.
+    static void
+    close(jtx::Env& env)
+    {
+        env.close();
+        env.app().getJobQueue().rendezvous();
+    }
+
+    static bool
+    hasBook(OrderBookDB& db, Issue const& in, Issue const& out)
+    {
+        auto const books = db.getBooksByTakerPays(in);
+        return std::find(books.begin(), books.end(), Book{in, out}) !=
+            books.end();
+    }
+
+    void
+    testValidatedLedgers()
+    {
+        testcase("Books follow validated ledgers");
+
+        using namespace jtx;
+
+        Env env{*this};
+        auto const gw = Account("gw");
+        auto const alice = Account("alice");
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice);
+        close(env);
+        env.trust(USD(1000), alice);
+        close(env);
+        env(pay(gw, alice, USD(500)));
+        close(env);
+
+        auto& db = env.app().getOrderBookDB();
+        BEAST_EXPECT(!hasBook(db, xrpIssue(), USD.issue()));
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+
+        // Two qualities in one book, one in the other
+        auto const first = env.seq(alice);
+        env(offer(alice, XRP(100), USD(10)));
+        auto const second = env.seq(alice);
+        env(offer(alice, XRP(200), USD(10)));
+        auto const third = env.seq(alice);
+        env(offer(alice, USD(10), XRP(100)));
+        close(env);
+
+        BEAST_EXPECT(hasBook(db, xrpIssue(), USD.issue()));
+        BEAST_EXPECT(hasBook(db, USD.issue(), xrpIssue()));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+
+        // The book survives while any of its qualities has an offer
+        env(offer_cancel(alice, first));
+        close(env);
+        BEAST_EXPECT(hasBook(db, xrpIssue(), USD.issue()));
+
+        env(offer_cancel(alice, second));
+        env(offer_cancel(alice, third));
+        close(env);
+        BEAST_EXPECT(!hasBook(db, xrpIssue(), USD.issue()));
+        BEAST_EXPECT(!hasBook(db, USD.issue(), xrpIssue()));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+
+        // A book can come back
+        env(offer(alice, XRP(100), USD(10)));
+        close(env);
+        BEAST_EXPECT(hasBook(db, xrpIssue(), USD.issue()));
+    }
+
+    void
+    testFullUpdate()
+    {
+        testcase("Full update matches tracked books");
+
+        using namespace jtx;
+
+        Env env{*this};
+        auto const gw = Account("gw");
+        auto const alice = Account("alice");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund(XRP(10000), gw, alice);
+        close(env);
+        env.trust(USD(1000), alice);
+        env.trust(EUR(1000), alice);
+        close(env);
+        env(pay(gw, alice, USD(500)));
+        env(pay(gw, alice, EUR(500)));
+        close(env);
+
+        auto const seq = env.seq(alice);
+        env(offer(alice, XRP(100), USD(10)));
+        env(offer(alice, EUR(10), USD(10)));
+        env(offer(alice, USD(10), EUR(20)));
+        close(env);
+        env(offer_cancel(alice, seq));
+        close(env);
+
+        auto& db = env.app().getOrderBookDB();
+        auto snapshot = [&]() {
+            std::vector<std::vector<Book>> v;
+            for (auto const& issue : {xrpIssue(), USD.issue(), EUR.issue()})
+            {
+                v.push_back(db.getBooksByTakerPays(issue));
+                std::sort(v.back().begin(), v.back().end());
+            }
+            return v;
+        };
+
+        auto const tracked = snapshot();
+        BEAST_EXPECT(tracked[0].empty());
+        BEAST_EXPECT(tracked[1].size() == 1);
+        BEAST_EXPECT(tracked[2].size() == 1);
+
+        db.update(env.closed());
+        BEAST_EXPECT(snapshot() == tracked);
+    }
+
+public:
+    void
+    run() override
+    {
+        testValidatedLedgers();
+        testFullUpdate();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookDB, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
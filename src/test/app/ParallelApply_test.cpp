@@ -0,0 +1,351 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/BuildLedger.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerReplay.h>
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/app/tx/apply.h>
+#include <test/jtx.h>
+#include <test/jtx/envconfig.h>
+
+namespace ripple {
+namespace test {
+
+// Passes reads through to a base view, throwing on reading one key
+class ThrowingView : public ReadView
+{
+    ReadView const& base_;
+    uint256 const key_;
+
+    void
+    check(uint256 const& key) const
+    {
+        if (key == key_)
+            Throw<std::runtime_error>("ThrowingView");
+    }
+
+public:
+    ThrowingView(ReadView const& base, uint256 const& key)
+        : base_(base), key_(key)
+    {
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists(Keylet const& k) const override
+    {
+        check(k.key);
+        return base_.exists(k);
+    }
+
+    std::optional<key_type>
+    succ(key_type const& key, std::optional<key_type> const& last)
+        const override
+    {
+        return base_.succ(key, last);
+    }
+
+    std::shared_ptr<SLE const>
+    read(Keylet const& k) const override
+    {
+        check(k.key);
+        return base_.read(k);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound(uint256 const& key) const override
+    {
+        return base_.slesUpperBound(key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists(key_type const& key) const override
+    {
+        return base_.txExists(key);
+    }
+
+    tx_type
+    txRead(key_type const& key) const override
+    {
+        return base_.txRead(key);
+    }
+};
+
+class ParallelApply_test : public beast::unit_test::suite
+{
+    // Close a few ledgers holding transactions of which some touch
+    // independent state and some depend on each other.
+    std::vector<std::shared_ptr<Ledger const>>
+    makeLedgers(jtx::Env& env)
+    {
+        using namespace jtx;
+
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        std::vector<Account> accounts;
+        for (int i = 0; i < 16; ++i)
+            accounts.emplace_back("account" + std::to_string(i));
+
+        std::vector<std::shared_ptr<Ledger const>> ledgers;
+        auto const close = [&]() {
+            env.close();
+            ledgers.push_back(env.app().getLedgerMaster().getClosedLedger());
+        };
+
+        env.fund(XRP(100000), gw);
+        for (auto const& account : accounts)
+            env.fund(XRP(10000), account);
+        close();
+        for (auto const& account : accounts)
+            env(trust(account, USD(100000)));
+        close();
+        for (auto const& account : accounts)
+            env(pay(gw, account, USD(1000)));
+        close();
+
+        for (int round = 0; round < 3; ++round)
+        {
+            for (std::size_t i = 0; i + 1 < accounts.size(); i += 2)
+            {
+                // Pairs of accounts with nothing in common
+                env(pay(accounts[i], accounts[i + 1], XRP(10 + i)));
+                // Rippling through the gateway's trust lines
+                env(pay(
+                    accounts[i + 1],
+                    accounts[(i + 2) % accounts.size()],
+                    USD(1 + round)));
+            }
+
+            // Several transactions from one account
+            for (std::size_t i = 5; i < 9; ++i)
+                env(pay(accounts[0], accounts[i], XRP(1)));
+
+            // Offers, some of which cross
+            env(offer(accounts[1], XRP(100), USD(10)));
+            env(offer(accounts[2], USD(10), XRP(100)));
+            env(offer(accounts[3], XRP(50), USD(6)));
+            env(offer_cancel(accounts[3], env.seq(accounts[3]) - 1));
+            env(noop(accounts[4]));
+
+            // Claims a fee only
+            env(pay(accounts[6], accounts[7], XRP(1000000)),
+                ter(tecUNFUNDED_PAYMENT));
+            close();
+        }
+
+        return ledgers;
+    }
+
+    void
+    testReplay()
+    {
+        testcase("Replay");
+
+        using namespace jtx;
+        Env env(*this);
+        auto const ledgers = makeLedgers(env);
+
+        for (auto const& ledger : ledgers)
+        {
+            auto const parent = env.app().getLedgerMaster().getLedgerByHash(
+                ledger->info().parentHash);
+            if (!BEAST_EXPECT(parent))
+                continue;
+
+            for (bool const parallel : {false, true})
+            {
+                env.app().config().PARALLEL_APPLY = parallel;
+                auto const replayed = buildLedger(
+                    LedgerReplay(parent, ledger),
+                    tapNONE,
+                    env.app(),
+                    env.journal);
+                BEAST_EXPECT(replayed->info().hash == ledger->info().hash);
+            }
+
+            // Applying the ledger's transactions as a consensus set
+            // produces the same ledger either way, including retries.
+            std::vector<std::shared_ptr<Ledger>> built;
+            std::vector<std::set<TxID>> failed;
+            for (bool const parallel : {false, true})
+            {
+                env.app().config().PARALLEL_APPLY = parallel;
+                CanonicalTXSet txns(ledger->info().txHash);
+                for (auto const& item : ledger->txs)
+                    txns.insert(item.first);
+                failed.emplace_back();
+                built.push_back(buildLedger(
+                    parent,
+                    ledger->info().closeTime,
+                    true,
+                    ledger->info().closeTimeResolution,
+                    env.app(),
+                    txns,
+                    failed.back(),
+                    env.journal));
+                BEAST_EXPECT(txns.empty());
+            }
+            BEAST_EXPECT(built[0]->info().hash == built[1]->info().hash);
+            BEAST_EXPECT(failed[0] == failed[1]);
+        }
+        env.app().config().PARALLEL_APPLY = false;
+    }
+
+    void
+    testClose()
+    {
+        testcase("Close");
+
+        // Ledgers closed by a server applying transactions in parallel
+        // match those closed by one applying them serially.
+        using namespace jtx;
+        auto const hashes = [this](bool parallel) {
+            Env env(*this, envconfig([parallel](std::unique_ptr<Config> cfg) {
+                cfg->PARALLEL_APPLY = parallel;
+                return cfg;
+            }));
+            std::vector<uint256> result;
+            for (auto const& ledger : makeLedgers(env))
+                result.push_back(ledger->info().hash);
+            return result;
+        };
+
+        auto const serial = hashes(false);
+        auto const parallel = hashes(true);
+        BEAST_EXPECT(serial.size() == 6);
+        BEAST_EXPECT(parallel == serial);
+    }
+
+    void
+    testThrow()
+    {
+        testcase("Throw");
+
+        // A transaction that throws when executed again, after conflicting
+        // with one committed before it, fails without disturbing the rest.
+        using namespace jtx;
+        Env env(*this);
+        Account const alice("alice");
+        Account const bob("bob");
+        Account const carol("carol");
+        Account const dan("dan");
+        Account const erin("erin");
+        env.fund(XRP(10000), alice, bob, carol, dan, erin);
+        env.close();
+
+        std::vector<std::shared_ptr<STTx const>> const txns{
+            env.jt(pay(alice, bob, XRP(10))).stx,
+            env.jt(pay(bob, carol, XRP(10))).stx,
+            env.jt(pay(dan, erin, XRP(10))).stx};
+
+        for (bool const parallel : {false, true})
+        {
+            ThrowingView throwing(
+                *env.current(), keylet::account(carol.id()).key);
+            OpenView view(&throwing);
+            std::vector<ApplyResult> results;
+
+            if (parallel)
+            {
+                results = applyTransactions(
+                    env.app(), view, txns, false, tapNONE, env.journal);
+            }
+            else
+            {
+                for (auto const& tx : txns)
+                    results.push_back(applyTransaction(
+                        env.app(), view, *tx, false, tapNONE, env.journal));
+            }
+
+            BEAST_EXPECT(
+                results ==
+                std::vector<ApplyResult>(
+                    {ApplyResult::Success,
+                     ApplyResult::Fail,
+                     ApplyResult::Success}));
+            BEAST_EXPECT(view.txCount() == 2);
+            BEAST_EXPECT(view.txExists(txns[0]->getTransactionID()));
+            BEAST_EXPECT(!view.txExists(txns[1]->getTransactionID()));
+            BEAST_EXPECT(view.txExists(txns[2]->getTransactionID()));
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testReplay();
+        testClose();
+        testThrow();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ParallelApply, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
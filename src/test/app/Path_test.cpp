@@ -17,7 +17,9 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/paths/AccountCurrencies.h>
+#include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/basics/contract.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/core/JobQueue.h>
@@ -172,6 +174,7 @@ IPE(Issue const& iss)
 
 class Path_test : public beast::unit_test::suite
 {
+protected:
     jtx::Env
     pathTestEnv()
     {
@@ -1378,6 +1381,81 @@ public:
         }
     }
 
+    void
+    line_cache_advance()
+    {
+        testcase("line cache advance");
+        using namespace jtx;
+        Env env = pathTestEnv();
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        auto const carol = Account("carol");
+        auto const dan = Account("dan");
+        std::vector<Account> const accounts{gw, alice, bob, carol, dan};
+
+        env.fund(XRP(10000), gw, alice, bob, carol, dan);
+        env.trust(USD(1000), alice, bob, carol);
+        env(pay(gw, alice, USD(100)));
+        env(pay(gw, carol, USD(100)));
+        env.close();
+
+        auto& ledgerMaster = env.app().getLedgerMaster();
+        auto const cache = std::make_shared<RippleLineCache>(
+            ledgerMaster.getClosedLedger(), env.journal);
+        for (auto const& account : accounts)
+            cache->getRippleLines(account, LineDirection::outgoing);
+
+        // Change the lines of every account but carol
+        env(pay(alice, bob, USD(10)));
+        env(trust(dan, USD(50)));
+        env.close();
+
+        auto const ledger = ledgerMaster.getClosedLedger();
+        auto const next = cache->advance(ledger);
+        if (!BEAST_EXPECT(next))
+            return;
+        BEAST_EXPECT(next->getLedger() == ledger);
+        BEAST_EXPECT(next->counters().patches == 1);
+
+        // The lines are those read from the ledger, and only those of the
+        // accounts that changed had to be read
+        auto const loads = next->counters().loads.load();
+        auto const fresh =
+            std::make_shared<RippleLineCache>(ledger, env.journal);
+        for (auto const& account : accounts)
+        {
+            auto const lines =
+                next->getRippleLines(account, LineDirection::outgoing);
+            auto const expected =
+                fresh->getRippleLines(account, LineDirection::outgoing);
+            if (!BEAST_EXPECT(!lines == !expected) || !lines)
+                continue;
+            if (!BEAST_EXPECT(lines->size() == expected->size()))
+                continue;
+            for (std::size_t i = 0; i < lines->size(); ++i)
+            {
+                auto const& line = (*lines)[i];
+                auto const& other = (*expected)[i];
+                BEAST_EXPECT(line.key() == other.key());
+                BEAST_EXPECT(line.getBalance() == other.getBalance());
+                BEAST_EXPECT(line.getLimit() == other.getLimit());
+                BEAST_EXPECT(line.getLimitPeer() == other.getLimitPeer());
+                BEAST_EXPECT(line.getNoRipple() == other.getNoRipple());
+            }
+        }
+        BEAST_EXPECT(next->counters().loads - loads == 4);
+        BEAST_EXPECT(
+            next->getRippleLines(carol, LineDirection::outgoing) ==
+            cache->getRippleLines(carol, LineDirection::outgoing));
+
+        // A cache can only be advanced to the ledger following its own
+        env.close();
+        BEAST_EXPECT(!cache->advance(ledgerMaster.getClosedLedger()));
+        BEAST_EXPECT(next->advance(ledgerMaster.getClosedLedger()));
+    }
+
     void
     noripple_combinations()
     {
@@ -1464,6 +1542,7 @@ public:
         trust_auto_clear_trust_auto_clear();
         xrp_to_xrp();
         receive_max();
+        line_cache_advance();
         noripple_combinations();
 
         // The following path_find_NN tests are data driven tests
@@ -1480,7 +1559,82 @@ public:
     }
 };
 
+// Times path finding from XRP to an IOU issued by many gateways, each with
+// an order book, so that path ranking has many candidate paths to evaluate.
+// The number of requests can be passed as the suite argument.
+class PathTiming_test : public Path_test
+{
+    void
+    run() override
+    {
+        using namespace jtx;
+        testcase("path find timing");
+
+        auto const requests = arg().empty() ? 20 : std::stoi(arg());
+        Env env = pathTestEnv();
+
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        std::vector<Account> gateways;
+        std::vector<Account> makers;
+        for (int i = 0; i < 12; ++i)
+        {
+            gateways.emplace_back("gateway" + std::to_string(i));
+            makers.emplace_back("maker" + std::to_string(i));
+        }
+
+        env.fund(XRP(1000000), alice, bob);
+        for (std::size_t i = 0; i < gateways.size(); ++i)
+            env.fund(XRP(1000000), gateways[i], makers[i]);
+        env.close();
+
+        for (auto const& gateway : gateways)
+        {
+            auto const USD = gateway["USD"];
+            env(trust(bob, USD(1000000)));
+            for (auto const& maker : makers)
+                env(trust(maker, USD(1000000)));
+        }
+        env.close();
+
+        // Every maker offers every gateway's USD for XRP, at a spread of
+        // qualities, and holds some of every other gateway's USD.
+        for (std::size_t i = 0; i < gateways.size(); ++i)
+        {
+            auto const USD = gateways[i]["USD"];
+            for (std::size_t j = 0; j < makers.size(); ++j)
+            {
+                env(pay(gateways[i], makers[j], USD(10000)));
+                env(offer(makers[j], XRP(100 + i + j), USD(10)));
+            }
+            env.close();
+        }
+
+        using clock_type = std::chrono::steady_clock;
+        std::size_t alternatives = 0;
+        auto const start = clock_type::now();
+        for (int i = 0; i < requests; ++i)
+        {
+            auto const result = find_paths_request(
+                env,
+                alice,
+                bob,
+                bob["USD"](50 + i),
+                std::nullopt,
+                xrpCurrency());
+            alternatives += result[jss::alternatives].size();
+        }
+        auto const elapsed =
+            std::chrono::duration<double>(clock_type::now() - start).count();
+
+        BEAST_EXPECT(alternatives > 0);
+        log << requests << " requests in " << elapsed << "s, "
+            << elapsed * 1000 / requests << "ms each" << std::endl;
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(Path, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(PathTiming, app, ripple);
 
 }  // namespace test
 }  // namespace ripple
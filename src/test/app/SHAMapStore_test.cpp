@@ -330,6 +330,17 @@ public:
 
         lastRotated = store.getLastRotated();
 
+        {
+            // The rotate copied the state of the ledger it rotated at
+            auto const counts = env.rpc("get_counts")[jss::result];
+            BEAST_EXPECT(counts.isMember(jss::online_delete));
+            auto const& copy = counts[jss::online_delete];
+            BEAST_EXPECT(!copy["copy_running"].asBool());
+            BEAST_EXPECT(copy["copy_ledger"].asUInt() == lastRotated);
+            BEAST_EXPECT(
+                std::stoull(copy["copy_nodes_visited"].asString()) > 0);
+        }
+
         // Close enough ledgers to trigger another rotate
         for (; ledgerSeq < lastRotated + deleteInterval + 1; ++ledgerSeq)
         {
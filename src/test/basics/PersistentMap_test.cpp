@@ -0,0 +1,186 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/PersistentMap.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class PersistentMap_test : public beast::unit_test::suite
+{
+    using Map = PersistentMap<int, std::string>;
+    using Reference = std::map<int, std::string>;
+
+    bool
+    same(Map const& map, Reference const& ref)
+    {
+        if (map.size() != ref.size())
+            return false;
+        auto iter = map.begin();
+        for (auto const& [key, value] : ref)
+        {
+            if (iter == map.end() || iter->first != key ||
+                iter->second != value)
+                return false;
+            ++iter;
+        }
+        return iter == map.end();
+    }
+
+    void
+    testBasics()
+    {
+        testcase("Basics");
+
+        Map map;
+        BEAST_EXPECT(map.empty());
+        BEAST_EXPECT(map.begin() == map.end());
+        BEAST_EXPECT(!map.lookup(1));
+        BEAST_EXPECT(map.erase(1) == 0);
+
+        BEAST_EXPECT(map.insert(2, "two"));
+        BEAST_EXPECT(map.insert(1, "one"));
+        BEAST_EXPECT(map.insert(3, "three"));
+        BEAST_EXPECT(!map.insert(2, "deux"));
+        BEAST_EXPECT(map.size() == 3);
+        BEAST_EXPECT(*map.lookup(2) == "two");
+
+        BEAST_EXPECT(!map.insert_or_assign(2, "deux"));
+        BEAST_EXPECT(map.insert_or_assign(4, "four"));
+        BEAST_EXPECT(*map.lookup(2) == "deux");
+
+        BEAST_EXPECT(map.lower_bound(2)->first == 2);
+        BEAST_EXPECT(map.upper_bound(2)->first == 3);
+        BEAST_EXPECT(map.upper_bound(4) == map.end());
+        BEAST_EXPECT(map.lower_bound(0) == map.begin());
+
+        BEAST_EXPECT(map.erase(2) == 1);
+        BEAST_EXPECT(map.erase(2) == 0);
+        BEAST_EXPECT(same(map, {{1, "one"}, {3, "three"}, {4, "four"}}));
+
+        map.clear();
+        BEAST_EXPECT(map.empty());
+        BEAST_EXPECT(map.begin() == map.end());
+    }
+
+    // Apply the same random changes to a map and a std::map, keeping
+    // copies along the way, and check that every copy still matches.
+    void
+    testRandom()
+    {
+        testcase("Random");
+
+        beast::xor_shift_engine rng(42);
+        std::uniform_int_distribution<int> keys(0, 2000);
+
+        Map map;
+        Reference ref;
+        std::vector<std::pair<Map, Reference>> copies;
+
+        for (int i = 0; i < 50000; ++i)
+        {
+            auto const key = keys(rng);
+            auto const value = std::to_string(i);
+            switch (rng() % 4)
+            {
+                case 0:
+                    BEAST_EXPECT(
+                        map.insert(key, value) == ref.emplace(key, value).second);
+                    break;
+                case 1:
+                case 2:
+                    BEAST_EXPECT(
+                        map.insert_or_assign(key, value) ==
+                        ref.insert_or_assign(key, value).second);
+                    break;
+                default:
+                    BEAST_EXPECT(map.erase(key) == ref.erase(key));
+                    break;
+            }
+
+            if (i % 1000 == 0)
+            {
+                copies.emplace_back(map, ref);
+
+                auto const found = map.lookup(key);
+                auto const iter = ref.find(key);
+                BEAST_EXPECT(!found == (iter == ref.end()));
+                if (found && iter != ref.end())
+                    BEAST_EXPECT(*found == iter->second);
+
+                auto const upper = map.upper_bound(key);
+                auto const refUpper = ref.upper_bound(key);
+                BEAST_EXPECT((upper == map.end()) == (refUpper == ref.end()));
+                if (upper != map.end() && refUpper != ref.end())
+                    BEAST_EXPECT(upper->first == refUpper->first);
+            }
+        }
+
+        BEAST_EXPECT(same(map, ref));
+        for (auto const& [copy, copyRef] : copies)
+            BEAST_EXPECT(same(copy, copyRef));
+    }
+
+    void
+    testIterators()
+    {
+        testcase("Iterators");
+
+        Map map;
+        for (int i = 0; i < 100; ++i)
+            map.insert(i, std::to_string(i));
+
+        // An iterator keeps showing what the map held when it was taken.
+        auto iter = map.lower_bound(50);
+        for (int i = 0; i < 100; i += 2)
+            map.erase(i);
+        map.insert_or_assign(51, "changed");
+
+        int expected = 50;
+        for (; iter != Map::const_iterator{}; ++iter)
+        {
+            BEAST_EXPECT(iter->first == expected);
+            BEAST_EXPECT(iter->second == std::to_string(expected));
+            ++expected;
+        }
+        BEAST_EXPECT(expected == 100);
+
+        BEAST_EXPECT(map.size() == 50);
+        BEAST_EXPECT(*map.lookup(51) == "changed");
+        BEAST_EXPECT(map.begin()->first == 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        testBasics();
+        testRandom();
+        testIterators();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(PersistentMap, basics, ripple);
+
+}  // namespace ripple
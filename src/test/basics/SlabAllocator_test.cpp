@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/SlabAllocator.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class SlabAllocator_test : public beast::unit_test::suite
+{
+    static constexpr std::size_t slabSize = 4096;
+
+    void
+    testBlocks()
+    {
+        testcase("Blocks");
+
+        SlabAllocator a(24, slabSize);
+        BEAST_EXPECT(a.blockSize() >= 24);
+        BEAST_EXPECT(a.blockSize() % alignof(std::max_align_t) == 0);
+
+        // Enough blocks to need several slabs
+        std::vector<void*> blocks;
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto const p = a.allocate();
+            BEAST_EXPECT(
+                reinterpret_cast<std::uintptr_t>(p) %
+                    alignof(std::max_align_t) ==
+                0);
+            std::memset(p, i & 0xff, a.blockSize());
+            blocks.push_back(p);
+        }
+
+        // No two blocks overlap
+        std::vector<std::uintptr_t> sorted;
+        for (auto const p : blocks)
+            sorted.push_back(reinterpret_cast<std::uintptr_t>(p));
+        std::sort(sorted.begin(), sorted.end());
+        bool apart = true;
+        for (std::size_t i = 1; i < sorted.size(); ++i)
+            apart = apart && sorted[i] - sorted[i - 1] >= a.blockSize();
+        BEAST_EXPECT(apart);
+
+        // Writing one block left the others alone
+        bool intact = true;
+        for (std::size_t i = 0; i < blocks.size(); ++i)
+        {
+            auto const bytes = static_cast<std::uint8_t const*>(blocks[i]);
+            auto const expected = static_cast<std::uint8_t>(i & 0xff);
+            intact = intact &&
+                std::all_of(bytes, bytes + a.blockSize(), [=](auto b) {
+                         return b == expected;
+                     });
+        }
+        BEAST_EXPECT(intact);
+
+        auto s = a.stats();
+        BEAST_EXPECT(s.bytesInUse == blocks.size() * a.blockSize());
+        BEAST_EXPECT(s.slabs > 1);
+        BEAST_EXPECT(s.slabBytes == s.slabs * slabSize);
+        BEAST_EXPECT(s.slabsAllocated == s.slabs);
+
+        // A freed block is handed out again before the slab grows
+        auto const reused = blocks.back();
+        a.deallocate(reused);
+        blocks.back() = a.allocate();
+        BEAST_EXPECT(blocks.back() == reused);
+        BEAST_EXPECT(a.stats().slabsAllocated == s.slabsAllocated);
+
+        // Empty slabs go back to the system, but one is kept per arena
+        for (auto const p : blocks)
+            a.deallocate(p);
+        s = a.stats();
+        BEAST_EXPECT(s.bytesInUse == 0);
+        BEAST_EXPECT(s.slabs == 1);
+    }
+
+    void
+    testInvalid()
+    {
+        testcase("Invalid");
+
+        try
+        {
+            SlabAllocator a(16, 3000);
+            fail();
+        }
+        catch (std::invalid_argument const&)
+        {
+            pass();
+        }
+
+        try
+        {
+            SlabAllocator a(slabSize, slabSize);
+            fail();
+        }
+        catch (std::invalid_argument const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testSet()
+    {
+        testcase("Set");
+
+        SlabAllocatorSet set({32, 64, 128}, slabSize);
+
+        std::vector<std::pair<void*, std::size_t>> blocks;
+        for (std::size_t size : {1, 32, 33, 64, 100, 128, 129, 1000})
+        {
+            auto const p = set.allocate(size);
+            std::memset(p, 0xab, size);
+            blocks.emplace_back(p, size);
+        }
+
+        auto s = set.stats();
+        BEAST_EXPECT(s.oversize == 2);
+        BEAST_EXPECT(s.slabs.bytesInUse == 2 * 32 + 2 * 64 + 2 * 128);
+        BEAST_EXPECT(s.slabs.slabs == 3);
+
+        for (auto const& [p, size] : blocks)
+            set.deallocate(p, size);
+        s = set.stats();
+        BEAST_EXPECT(s.oversize == 0);
+        BEAST_EXPECT(s.slabs.bytesInUse == 0);
+    }
+
+    void
+    testThreads()
+    {
+        testcase("Threads");
+
+        SlabAllocator a(48, slabSize);
+
+        // Each thread frees half of what it allocates and hands the rest
+        // to the next thread, so blocks often go back to an arena other
+        // than the one of the thread freeing them.
+        int constexpr threadCount = 8;
+        int constexpr rounds = 20000;
+        std::vector<std::vector<void*>> handoff(threadCount);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&a, &handoff, t] {
+                beast::xor_shift_engine r(t + 1);
+                std::vector<void*> mine;
+                for (int i = 0; i < rounds; ++i)
+                {
+                    auto const p = a.allocate();
+                    *static_cast<int*>(p) = t;
+                    mine.push_back(p);
+                    if (mine.size() > 64 && r() % 2)
+                    {
+                        auto const k = r() % mine.size();
+                        a.deallocate(mine[k]);
+                        mine[k] = mine.back();
+                        mine.pop_back();
+                    }
+                }
+                handoff[t] = std::move(mine);
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        threads.clear();
+
+        auto const before = a.stats();
+        std::size_t held = 0;
+        for (auto const& h : handoff)
+            held += h.size();
+        BEAST_EXPECT(before.bytesInUse == held * a.blockSize());
+
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&a, &handoff, t] {
+                for (auto const p : handoff[(t + 1) % threadCount])
+                    a.deallocate(p);
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+
+        auto const after = a.stats();
+        BEAST_EXPECT(after.bytesInUse == 0);
+        BEAST_EXPECT(after.slabs <= threadCount);
+    }
+
+public:
+    void
+    run() override
+    {
+        testBlocks();
+        testInvalid();
+        testSet();
+        testThreads();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SlabAllocator, basics, ripple);
+
+}  // namespace ripple
@@ -22,8 +22,13 @@
 #include <ripple/beast/clock/manual_clock.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/protocol/Protocol.h>
+#include <ripple/protocol/digest.h>
 #include <test/unit_test/SuiteJournal.h>
 
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
 namespace ripple {
 
 /*
@@ -38,9 +43,9 @@ original object.
 
 class TaggedCache_test : public beast::unit_test::suite
 {
-public:
+    template <class Cache>
     void
-    run() override
+    testBasics()
     {
         using namespace std::chrono_literals;
         using namespace beast::severities;
@@ -49,9 +54,7 @@ public:
         TestStopwatch clock;
         clock.set(0);
 
-        using Key = LedgerIndex;
         using Value = std::string;
-        using Cache = TaggedCache<Key, Value>;
 
         Cache c("test", 1, 1s, clock, journal);
 
@@ -149,8 +152,280 @@ public:
             BEAST_EXPECT(c.getTrackSize() == 0);
         }
     }
+
+    // Many threads canonicalizing the same keys must all end up
+    // sharing one object per key.
+    template <class Cache>
+    void
+    testConcurrentCanonicalize()
+    {
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("TaggedCache_test", *this);
+
+        TestStopwatch clock;
+        clock.set(0);
+
+        Cache c("test", 0, 60s, clock, journal);
+
+        std::size_t const nKeys = 1000;
+        std::size_t const nThreads = 8;
+        std::vector<std::vector<std::shared_ptr<std::string>>> results(
+            nThreads);
+
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < nThreads; ++t)
+        {
+            threads.emplace_back([&, t] {
+                auto& result = results[t];
+                result.reserve(nKeys);
+                for (std::size_t k = 0; k < nKeys; ++k)
+                {
+                    auto p = std::make_shared<std::string>(std::to_string(k));
+                    c.canonicalize_replace_client(k, p);
+                    result.push_back(std::move(p));
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+
+        BEAST_EXPECT(c.getCacheSize() == static_cast<int>(nKeys));
+        BEAST_EXPECT(c.getTrackSize() == nKeys);
+        for (std::size_t k = 0; k < nKeys; ++k)
+        {
+            auto const p = c.fetch(k);
+            for (auto const& result : results)
+                BEAST_EXPECT(result[k].get() == p.get());
+        }
+
+        ++clock;
+        results.clear();
+        c.setTargetAge(0s);
+        c.sweep();
+        BEAST_EXPECT(c.getCacheSize() == 0);
+        BEAST_EXPECT(c.getTrackSize() == 0);
+    }
+
+    // With no time budget every slice stops early, so sweeping a large
+    // cache has to resume many times and must still visit every entry.
+    template <class Cache>
+    void
+    testSlicedSweep()
+    {
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("TaggedCache_test", *this);
+
+        TestStopwatch clock;
+        clock.set(0);
+
+        auto& sweeper = CacheSweeper::instance();
+        auto const budget = sweeper.budget();
+        sweeper.setBudget(0s);
+
+        Cache c("test", 0, 1s, clock, journal);
+
+        std::size_t const nKeys = 10000;
+        std::vector<std::shared_ptr<std::string>> held;
+        for (std::size_t k = 0; k < nKeys; ++k)
+        {
+            auto p = std::make_shared<std::string>(std::to_string(k));
+            c.canonicalize_replace_client(k, p);
+            if (k % 2 == 0)
+                held.push_back(std::move(p));
+        }
+        BEAST_EXPECT(c.getCacheSize() == static_cast<int>(nKeys));
+
+        // Everything leaves the cache, the held half stays tracked
+        ++clock;
+        c.sweep();
+        BEAST_EXPECT(c.getCacheSize() == 0);
+        BEAST_EXPECT(c.getTrackSize() == static_cast<int>(nKeys / 2));
+
+        held.clear();
+        c.sweep();
+        BEAST_EXPECT(c.getTrackSize() == 0);
+
+        sweeper.setBudget(budget);
+    }
+
+    // Inserts between slices grow the partitions and rehash them, which
+    // reorders their entries. The sweep must still examine every entry
+    // that was there when it started.
+    template <class Cache>
+    void
+    testSweepWhileGrowing()
+    {
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("TaggedCache_test", *this);
+
+        TestStopwatch clock;
+        clock.set(0);
+
+        auto& sweeper = CacheSweeper::instance();
+        auto const budget = sweeper.budget();
+        sweeper.setBudget(0s);
+
+        Cache c("test", 0, 1s, clock, journal);
+
+        std::size_t const nKeys = 10000;
+        for (std::size_t k = 0; k < nKeys; ++k)
+        {
+            auto p = std::make_shared<std::string>(std::to_string(k));
+            c.canonicalize_replace_client(k, p);
+        }
+
+        // Only the entries added during the sweep are fresh
+        ++clock;
+        std::thread inserter([&] {
+            for (std::size_t k = nKeys; k < 5 * nKeys; ++k)
+            {
+                auto p = std::make_shared<std::string>(std::to_string(k));
+                c.canonicalize_replace_client(k, p);
+            }
+        });
+        c.sweep();
+        inserter.join();
+
+        BEAST_EXPECT(c.getCacheSize() == static_cast<int>(4 * nKeys));
+        BEAST_EXPECT(c.getTrackSize() == static_cast<int>(4 * nKeys));
+
+        sweeper.setBudget(budget);
+    }
+
+public:
+    void
+    run() override
+    {
+        using Key = LedgerIndex;
+        using Value = std::string;
+
+        testcase("global lock");
+        testBasics<TaggedCache<Key, Value>>();
+        testConcurrentCanonicalize<TaggedCache<Key, Value>>();
+        testSlicedSweep<TaggedCache<Key, Value>>();
+        testSweepWhileGrowing<TaggedCache<Key, Value>>();
+
+        testcase("partition locks");
+        testBasics<PartitionedTaggedCache<Key, Value>>();
+        testConcurrentCanonicalize<PartitionedTaggedCache<Key, Value>>();
+        testSlicedSweep<PartitionedTaggedCache<Key, Value>>();
+        testSweepWhileGrowing<PartitionedTaggedCache<Key, Value>>();
+    }
+};
+
+/** Measure fetch and canonicalize throughput as the number of threads
+    hammering one cache grows, with a global lock and with partition locks.
+    Run manually with --unittest=TaggedCacheContention
+*/
+class TaggedCacheContention_test : public beast::unit_test::suite
+{
+    static std::size_t constexpr keyCount = 1 << 16;
+    static std::size_t constexpr opsPerThread = 1 << 18;
+
+    template <class Cache>
+    std::chrono::nanoseconds
+    runThreads(Cache& c, std::vector<uint256> const& keys, std::size_t n)
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(n);
+        auto const start = std::chrono::steady_clock::now();
+        for (std::size_t t = 0; t < n; ++t)
+        {
+            threads.emplace_back([&, t] {
+                // Mostly hits, with one canonicalize in eight to keep
+                // writers in the mix as the NodeStore cache sees them.
+                auto i = t * 7919;
+                for (std::size_t op = 0; op < opsPerThread; ++op)
+                {
+                    i = (i + 104729) % keys.size();
+                    if (op % 8 == 0)
+                    {
+                        auto p = std::make_shared<int>(static_cast<int>(i));
+                        c.canonicalize_replace_client(keys[i], p);
+                    }
+                    else if (!c.fetch(keys[i]))
+                    {
+                        fail("missing key");
+                        return;
+                    }
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        return std::chrono::steady_clock::now() - start;
+    }
+
+    template <class Cache>
+    double
+    measure(std::vector<uint256> const& keys, std::size_t n, bool sweeping)
+    {
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal("TaggedCacheContention_test", *this);
+        TestStopwatch clock;
+
+        Cache c("bench", 0, 1h, clock, journal);
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            auto p = std::make_shared<int>(static_cast<int>(i));
+            c.canonicalize_replace_client(keys[i], p);
+        }
+
+        // Optionally sweep continuously while the readers run. Nothing
+        // expires, so this only measures how much sweeping stalls them.
+        std::atomic<bool> done{false};
+        std::thread sweeper;
+        if (sweeping)
+            sweeper = std::thread([&] {
+                while (!done)
+                    c.sweep();
+            });
+
+        auto const elapsed = runThreads(c, keys, n);
+
+        done = true;
+        if (sweeper.joinable())
+            sweeper.join();
+
+        using namespace std::chrono;
+        return n * opsPerThread /
+            duration_cast<duration<double>>(elapsed).count();
+    }
+
+public:
+    void
+    run() override
+    {
+        using Global = TaggedCache<uint256, int>;
+        using Partitioned = PartitionedTaggedCache<uint256, int>;
+
+        std::vector<uint256> keys;
+        keys.reserve(keyCount);
+        for (std::size_t i = 0; i < keyCount; ++i)
+            keys.push_back(sha512Half(i));
+
+        for (bool const sweeping : {false, true})
+        {
+            testcase(sweeping ? "contention with sweep" : "contention");
+            log << std::setw(8) << "threads" << std::setw(16) << "global ops/s"
+                << std::setw(16) << "partition ops/s" << std::setw(10)
+                << "speedup" << std::endl;
+            for (std::size_t n : {1, 2, 4, 8, 16, 32})
+            {
+                auto const g = measure<Global>(keys, n, sweeping);
+                auto const p = measure<Partitioned>(keys, n, sweeping);
+                BEAST_EXPECT(g > 0 && p > 0);
+                std::stringstream ss;
+                ss << std::setw(8) << n << std::fixed << std::setprecision(0)
+                   << std::setw(16) << g << std::setw(16) << p
+                   << std::setprecision(2) << std::setw(10) << p / g;
+                log << ss.str() << std::endl;
+            }
+        }
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(TaggedCache, common, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(TaggedCacheContention, common, ripple);
 
 }  // namespace ripple
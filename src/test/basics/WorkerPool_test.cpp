@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/WorkerPool.h>
+#include <ripple/beast/unit_test.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace ripple {
+
+class WorkerPool_test : public beast::unit_test::suite
+{
+    void
+    testRun()
+    {
+        testcase("Run");
+
+        for (std::size_t threads : {0, 1, 4})
+        {
+            WorkerPool pool(threads);
+            BEAST_EXPECT(pool.threads() == threads);
+
+            std::vector<std::atomic<int>> calls(1000);
+            pool.run(calls.size(), [&](std::size_t i) { ++calls[i]; });
+            bool once = true;
+            for (auto const& c : calls)
+                once = once && c == 1;
+            BEAST_EXPECT(once);
+
+            pool.run(0, [&](std::size_t) { fail(); });
+        }
+    }
+
+    void
+    testThrow()
+    {
+        testcase("Throw");
+
+        WorkerPool pool(4);
+
+        // Items throw on the pool's threads and on the calling thread
+        for (std::size_t thrower : {0, 1, 500, 999})
+        {
+            try
+            {
+                pool.run(1000, [&](std::size_t i) {
+                    if (i == thrower)
+                        throw std::runtime_error("item");
+                });
+                fail();
+            }
+            catch (std::runtime_error const& e)
+            {
+                BEAST_EXPECT(e.what() == std::string("item"));
+            }
+        }
+
+        // Every item throwing reports one of them
+        try
+        {
+            pool.run(100, [](std::size_t) { throw std::logic_error("all"); });
+            fail();
+        }
+        catch (std::logic_error const&)
+        {
+            pass();
+        }
+
+        // The pool still works afterwards
+        std::atomic<std::size_t> sum{0};
+        pool.run(100, [&](std::size_t i) { sum += i; });
+        BEAST_EXPECT(sum == 4950);
+    }
+
+public:
+    void
+    run() override
+    {
+        testRun();
+        testThrow();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(WorkerPool, basics, ripple);
+
+}  // namespace ripple
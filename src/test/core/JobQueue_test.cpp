@@ -17,9 +17,14 @@
 */
 //==============================================================================
 
+#include <ripple/beast/insight/NullCollector.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/core/JobQueue.h>
 #include <test/jtx/Env.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace ripple {
 namespace test {
@@ -149,16 +154,205 @@ class JobQueue_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testPriority()
+    {
+        testcase("Priority order");
+
+        jtx::Env env{*this};
+        JobQueue jQueue(
+            1,
+            beast::insight::NullCollector::New(),
+            env.journal,
+            env.app().logs(),
+            env.app().getPerfLog());
+
+        // Hold the only thread until every job is queued
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool open = false;
+        std::atomic<bool> holding{false};
+        jQueue.addJob(jtCLIENT, "gate", [&]() {
+            holding = true;
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [&] { return open; });
+        });
+        while (!holding)
+            std::this_thread::yield();
+
+        std::vector<std::string> order;
+        auto add = [&](JobType type, std::string const& name) {
+            jQueue.addJob(type, name, [&order, name]() {
+                order.push_back(name);
+            });
+        };
+        add(jtCLIENT, "client 1");
+        add(jtTRANSACTION, "transaction 1");
+        add(jtADMIN, "admin");
+        add(jtCLIENT, "client 2");
+        add(jtTRANSACTION, "transaction 2");
+        BEAST_EXPECT(jQueue.getJobCount(jtCLIENT) == 2);
+        BEAST_EXPECT(jQueue.getJobCountGE(jtTRANSACTION) == 3);
+
+        {
+            std::lock_guard lock(mutex);
+            open = true;
+        }
+        cv.notify_all();
+        jQueue.rendezvous();
+
+        std::vector<std::string> const expected{
+            "admin",
+            "transaction 1",
+            "transaction 2",
+            "client 1",
+            "client 2"};
+        BEAST_EXPECT(order == expected);
+        BEAST_EXPECT(jQueue.getJobCountGE(jtPACK) == 0);
+
+        jQueue.stop();
+    }
+
+    void
+    testLimit()
+    {
+        testcase("Job type limits");
+
+        using namespace std::chrono_literals;
+
+        jtx::Env env{*this};
+        JobQueue jQueue(
+            2,
+            beast::insight::NullCollector::New(),
+            env.journal,
+            env.app().logs(),
+            env.app().getPerfLog());
+
+        // jtUPDATE_PF runs one job at a time
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool open = false;
+        std::atomic<bool> firstDone{false};
+        std::atomic<bool> secondRan{false};
+        std::atomic<bool> secondAfterFirst{false};
+        std::atomic<bool> otherRan{false};
+
+        jQueue.addJob(jtUPDATE_PF, "first", [&]() {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [&] { return open; });
+            firstDone = true;
+        });
+        jQueue.addJob(jtUPDATE_PF, "second", [&]() {
+            secondAfterFirst = firstDone.load();
+            secondRan = true;
+        });
+        BEAST_EXPECT(jQueue.getJobCountTotal(jtUPDATE_PF) == 2);
+
+        // The other thread is free for jobs of other types
+        jQueue.addJob(jtCLIENT, "other", [&]() { otherRan = true; });
+        for (int i = 0; i < 1000 && !otherRan; ++i)
+            std::this_thread::sleep_for(1ms);
+        BEAST_EXPECT(otherRan);
+        BEAST_EXPECT(!secondRan);
+
+        {
+            std::lock_guard lock(mutex);
+            open = true;
+        }
+        cv.notify_all();
+        jQueue.rendezvous();
+
+        BEAST_EXPECT(secondRan);
+        BEAST_EXPECT(secondAfterFirst);
+        BEAST_EXPECT(jQueue.getJobCountTotal(jtUPDATE_PF) == 0);
+
+        jQueue.stop();
+    }
+
 public:
     void
     run() override
     {
         testAddJob();
         testPostCoro();
+        testPriority();
+        testLimit();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(JobQueue, core, ripple);
 
+//------------------------------------------------------------------------------
+
+// Measures how quickly jobs pass through the queue when many threads add
+// them. The suite argument, if any, sets the number of jobs per run.
+class JobQueueThroughput_test : public beast::unit_test::suite
+{
+    void
+    measure(jtx::Env& env, int producers, int threads, std::size_t jobs)
+    {
+        using namespace std::chrono;
+
+        JobQueue jQueue(
+            threads,
+            beast::insight::NullCollector::New(),
+            env.journal,
+            env.app().logs(),
+            env.app().getPerfLog());
+
+        std::atomic<std::size_t> done{0};
+        auto const perProducer = jobs / producers;
+
+        auto const start = steady_clock::now();
+        std::vector<std::thread> adders;
+        adders.reserve(producers);
+        for (int p = 0; p < producers; ++p)
+        {
+            adders.emplace_back([&]() {
+                for (std::size_t i = 0; i < perProducer; ++i)
+                {
+                    jQueue.addJob(
+                        i % 2 ? jtTRANSACTION : jtCLIENT,
+                        "throughput",
+                        [&]() { ++done; });
+                }
+            });
+        }
+        for (auto& t : adders)
+            t.join();
+        jQueue.rendezvous();
+        auto const elapsed = steady_clock::now() - start;
+
+        BEAST_EXPECT(done == perProducer * producers);
+
+        auto const us = duration_cast<microseconds>(elapsed).count();
+        log << producers << " producers, " << threads << " threads: " << done
+            << " jobs in " << us << "us, "
+            << (us ? done * 1000000 / us : 0) << " jobs/s" << std::endl;
+
+        jQueue.stop();
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t jobs = 200000;
+        if (!arg().empty())
+            jobs = std::stoul(arg());
+
+        jtx::Env env{*this};
+
+        testcase("Enqueue and dequeue throughput");
+        for (int threads : {1, 4, 16})
+        {
+            for (int producers : {1, 4, 16})
+                measure(env, producers, threads, jobs);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(JobQueueThroughput, core, ripple);
+
 }  // namespace test
 }  // namespace ripple
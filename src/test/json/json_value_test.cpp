@@ -23,8 +23,11 @@
 #include <ripple/json/json_reader.h>
 #include <ripple/json/json_value.h>
 #include <ripple/json/json_writer.h>
+#include <ripple/json/to_string.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <regex>
 
 namespace ripple {
@@ -1372,6 +1375,105 @@ struct json_value_test : beast::unit_test::suite
         }
     }
 
+    void
+    test_storage()
+    {
+        // Callers hold references to members and elements while adding
+        // more, so neither may move once created.
+        {
+            Json::Value obj{Json::objectValue};
+            static Json::StaticString const first("first");
+            Json::Value& ref = obj[first];
+            Json::Value& arr = obj["array"];
+            Json::Value& elem = arr.append(Json::objectValue);
+            for (int i = 0; i < 1000; ++i)
+            {
+                obj["member" + std::to_string(i)] = i;
+                arr.append(i);
+            }
+            ref = "still here";
+            elem["x"] = 1;
+            BEAST_EXPECT(obj[first] == "still here");
+            BEAST_EXPECT(obj["array"][0u]["x"] == 1);
+            BEAST_EXPECT(obj["array"].size() == 1001);
+            BEAST_EXPECT(obj["array"][1000u] == 999);
+        }
+        {
+            // Members are written in name order whether the name is static
+            // or copied, and unset array elements are written as null.
+            Json::Value obj;
+            static Json::StaticString const b("b");
+            obj["c"] = 3;
+            obj[b] = 2;
+            obj[std::string("a")] = 1;
+            obj["d"][2u] = true;
+            obj["d"].append("x");
+            BEAST_EXPECT(
+                Json::FastWriter().write(obj) ==
+                R"({"a":1,"b":2,"c":3,"d":[null,null,true,"x"]})");
+
+            Json::Value parsed;
+            BEAST_EXPECT(
+                Json::Reader().parse(Json::StyledWriter().write(obj), parsed));
+            BEAST_EXPECT(
+                Json::FastWriter().write(parsed) ==
+                Json::FastWriter().write(obj));
+        }
+        {
+            // Objects large enough to index their member names find, remove,
+            // copy and write members just like small ones.
+            Json::Value obj{Json::objectValue};
+            Json::Value& low = obj["m000"];
+            for (int i = 199; i > 0; --i)
+            {
+                char name[8];
+                std::snprintf(name, sizeof(name), "m%03d", i);
+                obj[name] = i;
+            }
+            low = 0;
+            BEAST_EXPECT(obj.size() == 200);
+            BEAST_EXPECT(obj["m000"] == 0);
+            BEAST_EXPECT(obj.isMember("m150"));
+            BEAST_EXPECT(!obj.isMember("m200"));
+
+            Json::Value const& cobj = obj;
+            BEAST_EXPECT(cobj["m150"] == 150);
+            BEAST_EXPECT(cobj["m200"].isNull());
+
+            BEAST_EXPECT(obj.removeMember("m150") == 150);
+            BEAST_EXPECT(!obj.isMember("m150"));
+            BEAST_EXPECT(obj.removeMember("m150").isNull());
+            obj["m150"] = "back";
+            BEAST_EXPECT(obj["m150"] == "back");
+            BEAST_EXPECT(obj.size() == 200);
+
+            Json::Value copy = obj;
+            copy["m001"] = "changed";
+            BEAST_EXPECT(copy["m150"] == "back");
+            BEAST_EXPECT(obj["m001"] == 1);
+            BEAST_EXPECT(copy.removeMember("m002") == 2);
+            BEAST_EXPECT(obj.isMember("m002"));
+
+            int expected = 0;
+            bool ordered = true;
+            for (auto it = obj.begin(); it != obj.end(); ++it, ++expected)
+            {
+                char name[8];
+                std::snprintf(name, sizeof(name), "m%03d", expected);
+                ordered = ordered && it.memberName() == std::string(name);
+            }
+            BEAST_EXPECT(ordered && expected == 200);
+            std::string const written = Json::FastWriter().write(obj);
+            BEAST_EXPECT(written.rfind(R"({"m000":0,"m001":1,)", 0) == 0);
+
+            obj.clear();
+            BEAST_EXPECT(obj.size() == 0);
+            BEAST_EXPECT(!obj.isMember("m001"));
+            obj["m001"] = 1;
+            BEAST_EXPECT(obj["m001"] == 1);
+        }
+    }
+
     void
     run() override
     {
@@ -1391,9 +1493,100 @@ struct json_value_test : beast::unit_test::suite
         test_iterator();
         test_nest_limits();
         test_leak();
+        test_storage();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(json_value, json, ripple);
 
+/** Times building, copying and serializing a large ledger_data response.
+
+    Run manually; the optional argument is the number of state entries.
+*/
+struct json_value_timing_test : beast::unit_test::suite
+{
+    static Json::Value
+    makeEntry(std::uint32_t i)
+    {
+        // Member names are static strings, as the protocol's field names
+        // and the jss:: names are.
+        static Json::StaticString const account("Account");
+        static Json::StaticString const balance("Balance");
+        static Json::StaticString const flags("Flags");
+        static Json::StaticString const entryType("LedgerEntryType");
+        static Json::StaticString const ownerCount("OwnerCount");
+        static Json::StaticString const prevTxnID("PreviousTxnID");
+        static Json::StaticString const prevTxnLgrSeq("PreviousTxnLgrSeq");
+        static Json::StaticString const sequence("Sequence");
+        static Json::StaticString const index("index");
+
+        auto const n = std::to_string(i);
+        Json::Value entry(Json::objectValue);
+        entry[account] = "rAccount" + n + "xxxxxxxxxxxxxxxxxxxxx";
+        entry[balance] = std::to_string(1000000000ull + i);
+        entry[flags] = 0u;
+        entry[entryType] = "AccountRoot";
+        entry[ownerCount] = i % 16;
+        entry[prevTxnID] = std::string(64 - n.size(), 'A') + n;
+        entry[prevTxnLgrSeq] = 70000000u + i;
+        entry[sequence] = i;
+        entry[index] = std::string(64 - n.size(), 'B') + n;
+        return entry;
+    }
+
+    void
+    run() override
+    {
+        using namespace std::chrono;
+
+        std::uint32_t count = 100000;
+        if (!arg().empty())
+            count = std::stoul(arg());
+
+        testcase("ledger_data with " + std::to_string(count) + " entries");
+
+        auto report = [&](std::string const& what, auto elapsed) {
+            log << what << ": "
+                << duration_cast<microseconds>(elapsed).count() << "us"
+                << std::endl;
+        };
+
+        auto start = steady_clock::now();
+        auto result = std::make_unique<Json::Value>(Json::objectValue);
+        (*result)["ledger_hash"] = std::string(64, 'C');
+        (*result)["ledger_index"] = 70000000u;
+        Json::Value& nodes = (*result)["state"];
+        nodes = Json::arrayValue;
+        for (std::uint32_t i = 0; i < count; ++i)
+            nodes.append(makeEntry(i));
+        report("build", steady_clock::now() - start);
+
+        start = steady_clock::now();
+        auto copy = std::make_unique<Json::Value>(*result);
+        report("copy", steady_clock::now() - start);
+
+        start = steady_clock::now();
+        auto const compact = to_string(*result);
+        report("serialize", steady_clock::now() - start);
+
+        start = steady_clock::now();
+        Json::Value parsed;
+        BEAST_EXPECT(Json::Reader().parse(compact, parsed));
+        report("parse", steady_clock::now() - start);
+
+        start = steady_clock::now();
+        bool const same = *copy == *result && parsed == *result;
+        report("compare", steady_clock::now() - start);
+        BEAST_EXPECT(same);
+        BEAST_EXPECT(parsed["state"].size() == count);
+
+        start = steady_clock::now();
+        result.reset();
+        copy.reset();
+        report("destroy", steady_clock::now() - start);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(json_value_timing, json, ripple);
+
 }  // namespace ripple
@@ -88,6 +88,32 @@ public:
                 params, megabytes(4), scheduler, journal);
             backend->open();
 
+            {
+                // Read it back with one batched fetch, along with keys
+                // that were never stored
+                auto const missing = createPredictableBatch(100, rng());
+
+                std::vector<uint256 const*> hashes;
+                for (auto const& obj : batch)
+                    hashes.push_back(&obj->getHash());
+                for (auto const& obj : missing)
+                    hashes.push_back(&obj->getHash());
+
+                auto const [results, status] = backend->fetchBatch(hashes);
+                BEAST_EXPECT(status == ok);
+
+                if (BEAST_EXPECT(results.size() == hashes.size()))
+                {
+                    Batch copy(results.begin(), results.begin() + batch.size());
+                    BEAST_EXPECT(areBatchesEqual(batch, copy));
+
+                    BEAST_EXPECT(std::all_of(
+                        results.begin() + batch.size(),
+                        results.end(),
+                        [](auto const& obj) { return !obj; }));
+                }
+            }
+
             // Read it back in
             Batch copy;
             fetchCopyOfBatch(*backend, &copy, batch);
@@ -98,6 +124,45 @@ public:
         }
     }
 
+    void
+    testReadQueueDepth()
+    {
+        DummyScheduler scheduler;
+
+        testcase("NuDB read_queue_depth");
+
+        test::SuiteJournal journal("Backend_test", *this);
+        beast::temp_dir tempDir;
+
+        auto const make = [&](std::string const& depth) {
+            Section params;
+            params.set("type", "nudb");
+            params.set("path", tempDir.path());
+            params.set("read_queue_depth", depth);
+            return Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal);
+        };
+
+        BEAST_EXPECT(make("1"));
+        BEAST_EXPECT(make("8"));
+
+        BEAST_EXPECT(make("256"));
+
+        for (auto const& depth :
+             std::vector<std::string>{"0", "-1", "8x", "many", "257"})
+        {
+            try
+            {
+                make(depth);
+                fail("read_queue_depth=" + depth + " accepted");
+            }
+            catch (std::runtime_error const&)
+            {
+                pass();
+            }
+        }
+    }
+
     //--------------------------------------------------------------------------
 
     void
@@ -106,6 +171,7 @@ public:
         std::uint64_t const seedValue = 50;
 
         testBackend("nudb", seedValue);
+        testReadQueueDepth();
 
 #if RIPPLE_ROCKSDB_AVAILABLE
         testBackend("rocksdb", seedValue);
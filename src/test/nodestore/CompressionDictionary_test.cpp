@@ -0,0 +1,652 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Buffer.h>
+#include <ripple/basics/ByteUtilities.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/CompressionDictionary.h>
+#include <ripple/nodestore/impl/DecodedBlob.h>
+#include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/nodestore/impl/codec.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/LedgerFormats.h>
+#include <ripple/protocol/Serializer.h>
+#include <test/nodestore/TestBase.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <fstream>
+#include <nudb/nudb.hpp>
+#include <thread>
+
+#include <ripple/unity/rocksdb.h>
+
+namespace ripple {
+namespace NodeStore {
+
+// Objects shaped like account root leaves: the same fields in the same
+// order, with accounts drawn from a small set and varying amounts.
+static Batch
+createLeafBatch(int numObjects, std::uint64_t seed)
+{
+    beast::xor_shift_engine rng(seed);
+
+    std::vector<uint160> accounts(256);
+    for (auto& a : accounts)
+        beast::rngfill(a.begin(), a.size(), rng);
+
+    Batch batch;
+    batch.reserve(numObjects);
+    for (int i = 0; i < numObjects; ++i)
+    {
+        uint256 txnID;
+        beast::rngfill(txnID.begin(), txnID.size(), rng);
+        uint256 key;
+        beast::rngfill(key.begin(), key.size(), rng);
+
+        Serializer s;
+        s.add32(HashPrefix::leafNode);
+        s.add8(0x11);  // LedgerEntryType
+        s.add16(ltACCOUNT_ROOT);
+        s.add8(0x22);  // Flags
+        s.add32(0);
+        s.add8(0x24);  // Sequence
+        s.add32(rand_int(rng, 1, 1000000));
+        s.add8(0x25);  // PreviousTxnLgrSeq
+        s.add32(70000000 + i);
+        s.add8(0x2D);  // OwnerCount
+        s.add32(rand_int(rng, 0, 16));
+        s.add8(0x55);  // PreviousTxnID
+        s.addBitString(txnID);
+        s.add8(0x62);  // Balance
+        s.add64(
+            0x4000000000000000ull |
+            rand_int(rng, std::uint64_t{1}, std::uint64_t{100000000000}));
+        s.add8(0x81);  // Account
+        s.addVL(accounts[rand_int(rng, accounts.size() - 1)].data(), 20);
+        s.addBitString(key);
+
+        batch.push_back(NodeObject::createObject(
+            hotACCOUNT_NODE, Blob(s.begin(), s.end()), s.getSHA512Half()));
+    }
+    return batch;
+}
+
+static std::vector<Blob>
+encode(Batch const& batch)
+{
+    std::vector<Blob> blobs;
+    blobs.reserve(batch.size());
+    EncodedBlob e;
+    for (auto const& obj : batch)
+    {
+        e.prepare(obj);
+        auto const p = static_cast<std::uint8_t const*>(e.getData());
+        blobs.emplace_back(p, p + e.getSize());
+    }
+    return blobs;
+}
+
+class CompressionDictionary_test : public TestBase
+{
+public:
+    void
+    testCodec()
+    {
+        testcase("codec");
+
+        auto const blobs = encode(createLeafBatch(4000, 71));
+        std::vector<Blob> const samples(blobs.begin(), blobs.begin() + 2000);
+
+        auto const dictionary = CompressionDictionary::train(samples);
+        if (!BEAST_EXPECT(dictionary))
+            return;
+        BEAST_EXPECT(!dictionary->content().empty());
+        BEAST_EXPECT(
+            dictionary->content().size() <= CompressionDictionary::maxSize);
+
+        CompressionDictionaries dictionaries;
+        dictionaries.insert(dictionary);
+        BEAST_EXPECT(dictionaries.current() == dictionary);
+        BEAST_EXPECT(dictionaries.find(dictionary->id()) == dictionary);
+        BEAST_EXPECT(!dictionaries.find(dictionary->id() + 1));
+
+        // Objects the dictionary was not trained on
+        std::size_t plainBytes = 0;
+        std::size_t dictionaryBytes = 0;
+        bool same = true;
+        for (auto i = samples.size(); i < blobs.size(); ++i)
+        {
+            auto const& b = blobs[i];
+
+            Buffer plain;
+            plainBytes += nodeobject_compress(b.data(), b.size(), plain).second;
+
+            Buffer compressed;
+            auto const out = nodeobject_compress(
+                b.data(), b.size(), compressed, dictionary.get());
+            dictionaryBytes += out.second;
+            BEAST_EXPECT(*static_cast<std::uint8_t const*>(out.first) == 4);
+
+            Buffer decompressed;
+            auto const in = nodeobject_decompress(
+                out.first, out.second, decompressed, &dictionaries);
+            same = same && in.second == b.size() &&
+                std::memcmp(in.first, b.data(), b.size()) == 0;
+        }
+        BEAST_EXPECT(same);
+        BEAST_EXPECT(dictionaryBytes < plainBytes);
+
+        {
+            // Without the dictionary the object can't be read
+            auto const& b = blobs.back();
+            Buffer compressed;
+            auto const out = nodeobject_compress(
+                b.data(), b.size(), compressed, dictionary.get());
+
+            Buffer decompressed;
+            CompressionDictionaries none;
+            try
+            {
+                nodeobject_decompress(
+                    out.first, out.second, decompressed, &none);
+                fail();
+            }
+            catch (std::runtime_error const&)
+            {
+                pass();
+            }
+            try
+            {
+                nodeobject_decompress(out.first, out.second, decompressed);
+                fail();
+            }
+            catch (std::runtime_error const&)
+            {
+                pass();
+            }
+        }
+
+        {
+            // Inner nodes keep their own encoding
+            Serializer s;
+            s.add32(0);
+            s.add32(0);
+            s.add8(hotUNKNOWN);
+            s.add32(HashPrefix::innerNode);
+            for (int i = 0; i < 16; ++i)
+                s.addBitString(i % 3 ? uint256() : uint256(i + 1));
+            BEAST_EXPECT(s.size() == 525);
+
+            Buffer compressed;
+            auto const out = nodeobject_compress(
+                s.data(), s.size(), compressed, dictionary.get());
+            BEAST_EXPECT(*static_cast<std::uint8_t const*>(out.first) == 2);
+        }
+
+        // Nothing in common, nothing to train
+        BEAST_EXPECT(!CompressionDictionary::train({}));
+        BEAST_EXPECT(!CompressionDictionary::train({Blob{1, 2, 3}}));
+    }
+
+    void
+    testFile()
+    {
+        testcase("file");
+
+        auto const dictionary =
+            CompressionDictionary::train(encode(createLeafBatch(2000, 72)));
+        if (!BEAST_EXPECT(dictionary))
+            return;
+
+        beast::temp_dir tempDir;
+        auto const path =
+            (boost::filesystem::path(tempDir.path()) / dictionary->fileName())
+                .string();
+        dictionary->save(path);
+
+        auto const loaded = CompressionDictionary::load(path);
+        BEAST_EXPECT(loaded->id() == dictionary->id());
+        BEAST_EXPECT(loaded->created() == dictionary->created());
+        BEAST_EXPECT(loaded->content() == dictionary->content());
+        BEAST_EXPECT(loaded->fileName() == dictionary->fileName());
+
+        // Dictionaries are never overwritten
+        try
+        {
+            dictionary->save(path);
+            fail();
+        }
+        catch (std::exception const&)
+        {
+            pass();
+        }
+
+        // A damaged dictionary is detected
+        {
+            std::fstream f(
+                path, std::ios::in | std::ios::out | std::ios::binary);
+            f.seekp(-1, std::ios::end);
+            f.put(static_cast<char>(dictionary->content().back() ^ 0xFF));
+        }
+        try
+        {
+            CompressionDictionary::load(path);
+            fail();
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testBackend()
+    {
+        testcase("NuDB backend");
+
+        DummyScheduler scheduler;
+        test::SuiteJournal journal("CompressionDictionary_test", *this);
+
+        beast::temp_dir tempDir;
+        Section params;
+        params.set("type", "NuDB");
+        params.set("path", tempDir.path());
+        params.set("compression_dictionary", "1");
+
+        // Enough objects to train a dictionary and then use it
+        auto const batch = createLeafBatch(12000, 73);
+
+        {
+            auto backend = Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal);
+            backend->open();
+            storeBatch(*backend, batch);
+
+            Batch copy;
+            fetchCopyOfBatch(*backend, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+        }
+
+        int dictionaries = 0;
+        for (auto const& entry :
+             boost::filesystem::directory_iterator(tempDir.path()))
+        {
+            if (entry.path().extension() == ".dict")
+                ++dictionaries;
+        }
+        BEAST_EXPECT(dictionaries == 1);
+
+        {
+            // Reopened without the option, it still reads every object
+            params.set("compression_dictionary", "0");
+            auto backend = Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal);
+            backend->open();
+
+            Batch copy;
+            fetchCopyOfBatch(*backend, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+        }
+    }
+
+    void
+    testBackground()
+    {
+        testcase("Background training");
+
+        // Holds tasks until the test runs them
+        struct DeferredScheduler : DummyScheduler
+        {
+            std::vector<Task*> tasks;
+
+            bool
+            scheduleTask(Task& task) override
+            {
+                tasks.push_back(&task);
+                return true;
+            }
+        };
+
+        DeferredScheduler scheduler;
+        test::SuiteJournal journal("CompressionDictionary_test", *this);
+
+        beast::temp_dir tempDir;
+        Section params;
+        params.set("type", "NuDB");
+        params.set("path", tempDir.path());
+        params.set("compression_dictionary", "1");
+
+        auto const countDictionaries = [&] {
+            int n = 0;
+            for (auto const& entry :
+                 boost::filesystem::directory_iterator(tempDir.path()))
+            {
+                if (entry.path().extension() == ".dict")
+                    ++n;
+            }
+            return n;
+        };
+
+        auto const batch = createLeafBatch(12000, 79);
+        std::thread trainer;
+        {
+            auto backend = Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal);
+            backend->open();
+            storeBatch(*backend, batch);
+
+            // Writing went on without waiting for the dictionary
+            BEAST_EXPECT(scheduler.tasks.size() == 1);
+            BEAST_EXPECT(countDictionaries() == 0);
+
+            Batch copy;
+            fetchCopyOfBatch(*backend, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+
+            // Closing the backend waits for training to finish
+            trainer = std::thread([task = scheduler.tasks.front()] {
+                task->performScheduledTask();
+            });
+        }
+        trainer.join();
+        BEAST_EXPECT(countDictionaries() == 1);
+
+        {
+            auto backend = Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal);
+            backend->open();
+
+            Batch copy;
+            fetchCopyOfBatch(*backend, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+        }
+    }
+
+    void
+    testStoppedScheduler()
+    {
+        testcase("Stopped scheduler");
+
+        // Refuses every task, as the job queue does once it has stopped
+        struct StoppedScheduler : DummyScheduler
+        {
+            int refused = 0;
+
+            bool
+            scheduleTask(Task&) override
+            {
+                ++refused;
+                return false;
+            }
+        };
+
+        StoppedScheduler scheduler;
+        test::SuiteJournal journal("CompressionDictionary_test", *this);
+
+        beast::temp_dir tempDir;
+        Section params;
+        params.set("type", "NuDB");
+        params.set("path", tempDir.path());
+        params.set("compression_dictionary", "1");
+
+        auto const batch = createLeafBatch(12000, 83);
+        {
+            // Sampling past the threshold trains on the writing thread,
+            // and closing the backend doesn't wait for a task
+            auto backend = Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal);
+            backend->open();
+            storeBatch(*backend, batch);
+            BEAST_EXPECT(scheduler.refused == 1);
+            backend->close();
+        }
+
+        int dictionaries = 0;
+        for (auto const& entry :
+             boost::filesystem::directory_iterator(tempDir.path()))
+        {
+            if (entry.path().extension() == ".dict")
+                ++dictionaries;
+        }
+        BEAST_EXPECT(dictionaries == 1);
+    }
+
+    void
+    run() override
+    {
+        testCodec();
+        testFile();
+        testBackend();
+        testBackground();
+        testStoppedScheduler();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(CompressionDictionary, NodeStore, ripple);
+
+//------------------------------------------------------------------------------
+
+/*  Reports what a compression dictionary would save on an existing
+    database, and how fast objects decode with and without one.
+
+    --unittest-arg=type=<NuDB|RocksDB>,path=<path>[,count=<count>]
+
+    Reads the first `count` objects of the database, default 1000000,
+    trains a dictionary from the first megabyte of leaves among them and
+    compresses all of them both ways.
+*/
+class CompressionDictionaryReport_test : public beast::unit_test::suite
+{
+    static std::map<std::string, std::string>
+    parseArgs(std::string const& s)
+    {
+        std::map<std::string, std::string> args;
+        std::istringstream is(s);
+        std::string kv;
+        while (std::getline(is, kv, ','))
+        {
+            if (auto const eq = kv.find('='); eq != std::string::npos)
+                args[kv.substr(0, eq)] = kv.substr(eq + 1);
+        }
+        return args;
+    }
+
+    // Read objects, decoded as the codec sees them, from a NuDB database.
+    std::vector<Blob>
+    readNuDB(std::string const& path, std::size_t count)
+    {
+        CompressionDictionaries dictionaries;
+        for (auto const& entry : boost::filesystem::directory_iterator(path))
+        {
+            if (entry.path().extension() == ".dict")
+                dictionaries.insert(
+                    CompressionDictionary::load(entry.path().string()));
+        }
+
+        std::vector<Blob> blobs;
+        nudb::error_code ec;
+        nudb::visit(
+            (boost::filesystem::path(path) / "nudb.dat").string(),
+            [&](void const*,
+                std::size_t,
+                void const* data,
+                std::size_t size,
+                nudb::error_code& error) {
+                Buffer bf;
+                auto const result =
+                    nodeobject_decompress(data, size, bf, &dictionaries);
+                auto const p = static_cast<std::uint8_t const*>(result.first);
+                blobs.emplace_back(p, p + result.second);
+                if (blobs.size() >= count)
+                    error = boost::system::errc::make_error_code(
+                        boost::system::errc::operation_canceled);
+            },
+            nudb::no_progress{},
+            ec);
+        if (ec && ec != boost::system::errc::operation_canceled)
+            Throw<nudb::system_error>(ec);
+        return blobs;
+    }
+
+#if RIPPLE_ROCKSDB_AVAILABLE
+    // RocksDB stores objects uncompressed, leaving it to its own block
+    // compression.
+    std::vector<Blob>
+    readRocksDB(std::string const& path, std::size_t count)
+    {
+        rocksdb::Options options;
+        options.create_if_missing = false;
+        rocksdb::DB* pdb = nullptr;
+        auto const status =
+            rocksdb::DB::OpenForReadOnly(options, path, &pdb);
+        if (!status.ok() || !pdb)
+            Throw<std::runtime_error>(
+                "Can't open '" + path + "': " + status.ToString());
+        std::unique_ptr<rocksdb::DB> db(pdb);
+
+        rocksdb::ReadOptions readOptions;
+        readOptions.fill_cache = false;
+        std::unique_ptr<rocksdb::Iterator> it(db->NewIterator(readOptions));
+
+        std::vector<Blob> blobs;
+        for (it->SeekToFirst(); it->Valid() && blobs.size() < count;
+             it->Next())
+        {
+            auto const p =
+                reinterpret_cast<std::uint8_t const*>(it->value().data());
+            blobs.emplace_back(p, p + it->value().size());
+        }
+        return blobs;
+    }
+#endif
+
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono;
+
+        auto const args = parseArgs(arg());
+        if (args.count("type") == 0 || args.count("path") == 0)
+        {
+            log << "Usage:\n"
+                << "--unittest-arg=type=<type>,path=<path>[,count=<count>]\n"
+                << "type:  NuDB or RocksDB\n"
+                << "path:  Database directory\n"
+                << "count: Number of objects to read, default 1000000";
+            return;
+        }
+
+        std::size_t const count =
+            args.count("count") ? std::stoull(args.at("count")) : 1000000;
+        auto const& type = args.at("type");
+        auto const& path = args.at("path");
+
+        std::vector<Blob> blobs;
+        if (boost::iequals(type, "NuDB"))
+            blobs = readNuDB(path, count);
+#if RIPPLE_ROCKSDB_AVAILABLE
+        else if (boost::iequals(type, "RocksDB"))
+            blobs = readRocksDB(path, count);
+#endif
+        else
+        {
+            fail("unsupported type " + type);
+            return;
+        }
+
+        std::vector<Blob> samples;
+        std::size_t sampledBytes = 0;
+        std::size_t rawBytes = 0;
+        for (auto const& b : blobs)
+        {
+            rawBytes += b.size();
+
+            Buffer bf;
+            auto const out = nodeobject_compress(b.data(), b.size(), bf);
+            if (sampledBytes < 1024 * 1024 &&
+                *static_cast<std::uint8_t const*>(out.first) == 1)
+            {
+                samples.push_back(b);
+                sampledBytes += b.size();
+            }
+        }
+
+        auto const dictionary = CompressionDictionary::train(samples);
+        if (!dictionary)
+        {
+            fail("no dictionary could be trained");
+            return;
+        }
+        CompressionDictionaries dictionaries;
+        dictionaries.insert(dictionary);
+
+        auto measure = [&](std::string const& what,
+                           CompressionDictionary const* d) {
+            std::vector<Blob> compressed;
+            compressed.reserve(blobs.size());
+            std::size_t bytes = 0;
+            for (auto const& b : blobs)
+            {
+                Buffer bf;
+                auto const out = nodeobject_compress(b.data(), b.size(), bf, d);
+                auto const p = static_cast<std::uint8_t const*>(out.first);
+                compressed.emplace_back(p, p + out.second);
+                bytes += out.second;
+            }
+
+            auto const start = steady_clock::now();
+            for (auto const& c : compressed)
+            {
+                Buffer bf;
+                nodeobject_decompress(c.data(), c.size(), bf, &dictionaries);
+            }
+            auto const us = std::max<std::int64_t>(
+                1, duration_cast<microseconds>(steady_clock::now() - start)
+                       .count());
+
+            log << what << ": " << bytes << " bytes, "
+                << (100 * bytes / std::max<std::size_t>(rawBytes, 1))
+                << "% of raw, decoded at " << rawBytes / us << " MB/s"
+                << std::endl;
+            return bytes;
+        };
+
+        log << blobs.size() << " objects, " << rawBytes << " bytes raw, "
+            << "dictionary of " << dictionary->content().size()
+            << " bytes from " << samples.size() << " objects" << std::endl;
+        auto const plain = measure("lz4", nullptr);
+        auto const withDictionary =
+            measure("lz4 with dictionary", dictionary.get());
+        log << "saved "
+            << static_cast<std::int64_t>(plain) -
+                static_cast<std::int64_t>(withDictionary)
+            << " bytes" << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(CompressionDictionaryReport, NodeStore, ripple);
+
+}  // namespace NodeStore
+}  // namespace ripple
@@ -554,6 +554,59 @@ public:
             std::unique_ptr<Database> db = Manager::instance().make_Database(
                 megabytes(4), scheduler, 2, nodeParams, journal_);
 
+            {
+                // Nothing is cached yet, so this goes through the read
+                // threads, which fetch their requests in bundles. Keys that
+                // were never stored come back empty.
+                auto const missing = createPredictableBatch(100, rng());
+
+                std::mutex mutex;
+                std::condition_variable cv;
+                std::size_t pending = batch.size() + missing.size();
+                Batch copy;
+
+                auto request = [&](Batch const& b) {
+                    for (auto const& obj : b)
+                    {
+                        db->asyncFetch(
+                            obj->getHash(),
+                            0,
+                            [&](std::shared_ptr<NodeObject> const& result) {
+                                std::lock_guard lock(mutex);
+                                if (result)
+                                    copy.push_back(result);
+                                if (--pending == 0)
+                                    cv.notify_all();
+                            });
+                    }
+                };
+                request(batch);
+                request(missing);
+
+                std::unique_lock lock(mutex);
+                BEAST_EXPECT(cv.wait_for(
+                    lock, std::chrono::seconds(30), [&] { return !pending; }));
+
+                auto sorted = batch;
+                std::sort(sorted.begin(), sorted.end(), LessThan{});
+                std::sort(copy.begin(), copy.end(), LessThan{});
+                BEAST_EXPECT(areBatchesEqual(sorted, copy));
+
+                // The misses were cached, so asking for them again is
+                // answered at once instead of going back to the backend
+                for (auto const& obj : missing)
+                {
+                    auto answered = std::make_shared<std::atomic<bool>>(false);
+                    db->asyncFetch(
+                        obj->getHash(),
+                        0,
+                        [answered](std::shared_ptr<NodeObject> const& result) {
+                            *answered = !result;
+                        });
+                    BEAST_EXPECT(*answered);
+                }
+            }
+
             // Read it back in
             Batch copy;
             fetchCopyOfBatch(*db, &copy, batch);
@@ -28,6 +28,7 @@
 #include <ripple/nodestore/Manager.h>
 #include <ripple/unity/rocksdb.h>
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <iterator>
@@ -733,6 +734,82 @@ public:
         }
     }
 
+    // Fetch random existing keys in batches, as ledger acquisition does,
+    // with the backend keeping up to the given number of reads in flight.
+    void
+    do_batch_fetch(
+        Section const& config,
+        std::size_t depth,
+        beast::Journal journal)
+    {
+        std::size_t const batchSize = 128;
+
+        Section section = config;
+        section.set("read_queue_depth", std::to_string(depth));
+        DummyScheduler scheduler;
+        auto backend = make_Backend(section, scheduler, journal);
+        BEAST_EXPECT(backend != nullptr);
+        backend->open();
+
+        Sequence seq(1);
+        beast::xor_shift_engine gen(depth);
+        std::uniform_int_distribution<std::size_t> dist(0, default_items - 1);
+        std::vector<uint256> keys;
+        keys.reserve(default_items);
+        for (std::size_t i = 0; i < default_items; ++i)
+            keys.push_back(seq.obj(dist(gen))->getHash());
+
+        std::vector<uint256 const*> batch;
+        batch.reserve(batchSize);
+        std::size_t found = 0;
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < keys.size(); i += batchSize)
+        {
+            batch.clear();
+            for (auto j = i; j < std::min(i + batchSize, keys.size()); ++j)
+                batch.push_back(&keys[j]);
+            auto const [objs, status] = backend->fetchBatch(batch);
+            BEAST_EXPECT(status == ok);
+            for (auto const& obj : objs)
+                found += obj != nullptr;
+        }
+        auto const elapsed = std::chrono::duration_cast<duration_type>(
+            clock_type::now() - start);
+        backend->close();
+        BEAST_EXPECT(found == keys.size());
+
+        std::stringstream ss;
+        ss << std::left << std::setw(10) << get(config, "type", std::string())
+           << std::right << std::setw(6) << depth << std::setw(10)
+           << to_string(elapsed) << std::setw(12)
+           << (keys.size() * 1000 / std::max<std::size_t>(elapsed.count(), 1))
+           << "/s";
+        log << ss.str() << std::endl;
+    }
+
+    void
+    do_batch_tests(std::vector<std::string> const& config_strings)
+    {
+        // For figures which reflect the device rather than the page cache,
+        // use a database larger than memory or drop the cache between runs.
+        log << "Batched random reads, " << default_items << " Objects"
+            << std::endl;
+        log << std::left << std::setw(10) << "Backend" << std::right
+            << std::setw(6) << "Depth" << std::setw(10) << "Time"
+            << std::setw(14) << "Throughput" << std::endl;
+
+        test::SuiteJournal journal("Timing_test", *this);
+        for (auto const& config_string : config_strings)
+        {
+            beast::temp_dir tempDir;
+            Section config = parse(config_string);
+            config.set("path", tempDir.path());
+            do_insert(config, Params{default_items, 8}, journal);
+            for (std::size_t depth : {1, 8, 32, 128})
+                do_batch_fetch(config, depth, journal);
+        }
+    }
+
     void
     run() override
     {
@@ -775,6 +852,8 @@ public:
         do_tests(4, tests, config_strings);
         do_tests(8, tests, config_strings);
         // do_tests (16, tests, config_strings);
+
+        do_batch_tests(config_strings);
     }
 };
 
@@ -27,6 +27,7 @@
 #include <ripple/overlay/Message.h>
 #include <ripple/overlay/impl/Handshake.h>
 #include <ripple/overlay/impl/ProtocolMessage.h>
+#include <ripple/overlay/impl/TrafficCount.h>
 #include <ripple/overlay/impl/ZeroCopyStream.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/PublicKey.h>
@@ -87,11 +88,28 @@ public:
         uint16_t nbuffers,
         std::string msg)
     {
-        testcase("Compress/Decompress: " + msg);
+        for (auto const algorithm : {Algorithm::LZ4, Algorithm::ZSTD})
+            doTest(proto, mt, nbuffers, msg, algorithm);
+    }
+
+    template <typename T>
+    void
+    doTest(
+        std::shared_ptr<T> proto,
+        protocol::MessageType mt,
+        uint16_t nbuffers,
+        std::string msg,
+        Algorithm algorithm)
+    {
+        testcase(
+            "Compress/Decompress: " + msg + " " +
+            compression::algorithmName(algorithm));
 
         Message m(*proto, mt);
 
-        auto& buffer = m.getBuffer(Compressed::On);
+        auto& buffer = m.getBuffer(Compressed::On, algorithm);
+        log << msg << " " << compression::algorithmName(algorithm) << ": "
+            << m.getBufferSize() << " -> " << buffer.size() << std::endl;
 
         boost::beast::multi_buffer buffers;
 
@@ -116,6 +134,8 @@ public:
         if (!header || header->algorithm == Algorithm::None)
             return;
 
+        BEAST_EXPECT(header->algorithm == algorithm);
+
         std::vector<std::uint8_t> decompressed;
         decompressed.resize(header->uncompressed_size);
 
@@ -129,7 +149,8 @@ public:
             stream,
             header->payload_wire_size,
             decompressed.data(),
-            header->uncompressed_size);
+            header->uncompressed_size,
+            header->algorithm);
         BEAST_EXPECT(decompressedSize == header->uncompressed_size);
         auto const proto1 = std::make_shared<T>();
 
@@ -495,13 +516,15 @@ public:
             http_request.version(request.version());
             http_request.base() = request.base();
             // feature enabled on the peer's connection only if both sides are
-            // enabled
-            auto const peerEnabled = inboundEnable && outboundEnable;
+            // enabled, and then with the preferred algorithm
+            auto const expected = inboundEnable && outboundEnable
+                ? Algorithm::ZSTD
+                : Algorithm::None;
             // inbound is enabled if the request's header has the feature
             // enabled and the peer's configuration is enabled
-            auto const inboundEnabled = peerFeatureEnabled(
-                http_request, FEATURE_COMPR, "lz4", inboundEnable);
-            BEAST_EXPECT(!(peerEnabled ^ inboundEnabled));
+            BEAST_EXPECT(
+                peerCompressionAlgorithm(http_request, inboundEnable) ==
+                expected);
 
             env.reset();
             env = getEnv(inboundEnable);
@@ -516,9 +539,9 @@ public:
                 env->app());
             // outbound is enabled if the response's header has the feature
             // enabled and the peer's configuration is enabled
-            auto const outboundEnabled = peerFeatureEnabled(
-                http_resp, FEATURE_COMPR, "lz4", outboundEnable);
-            BEAST_EXPECT(!(peerEnabled ^ outboundEnabled));
+            BEAST_EXPECT(
+                peerCompressionAlgorithm(http_resp, outboundEnable) ==
+                expected);
         };
         handshake(1, 1);
         handshake(1, 0);
@@ -534,7 +557,171 @@ public:
     }
 };
 
+// The parts of compression which must hold in every build, as opposed to
+// the sizes compression_test reports.
+class compression_zstd_test : public compression_test
+{
+    using Compressed = compression::Compressed;
+    using Algorithm = compression::Algorithm;
+
+    void
+    testDictionary()
+    {
+        testcase("Dictionary");
+
+        // The dictionary is part of the protocol. Peers with another
+        // dictionary can't read each other's messages.
+        auto const content = compression::zstdDictionaryContent();
+        BEAST_EXPECT(content.size() == 1973);
+        BEAST_EXPECT(
+            to_string(sha512Half(content)) ==
+            "63FF47AEB9462076A546EA39CBDCC698ECEA67D03DA9E188B76E590FE1D24BF2");
+    }
+
+    void
+    testNegotiation()
+    {
+        testcase("Negotiation");
+
+        auto request = [](std::string const& features) {
+            http_request_type r;
+            r.insert("X-Protocol-Ctl", features);
+            return r;
+        };
+
+        // Both ends support zstd
+        auto const current =
+            request(makeFeaturesRequestHeader(true, false, false, false));
+        BEAST_EXPECT(
+            peerCompressionAlgorithm(current, true) == Algorithm::ZSTD);
+        BEAST_EXPECT(
+            peerCompressionAlgorithm(current, false) == Algorithm::None);
+        BEAST_EXPECT(
+            makeFeaturesResponseHeader(current, true, false, false, false) ==
+            "compr=zstd1;");
+        BEAST_EXPECT(
+            makeFeaturesResponseHeader(current, false, false, false, false)
+                .empty());
+
+        // A peer which only supports lz4 finds lz4 in our request, and we
+        // answer its request with lz4
+        BEAST_EXPECT(isFeatureValue(current, FEATURE_COMPR, "lz4"));
+        auto const legacy = request("compr=lz4");
+        BEAST_EXPECT(peerCompressionAlgorithm(legacy, true) == Algorithm::LZ4);
+        BEAST_EXPECT(
+            makeFeaturesResponseHeader(legacy, true, false, false, false) ==
+            "compr=lz4;");
+    }
+
+    void
+    testMessage()
+    {
+        testcase("Message");
+
+        protocol::TMEndpoints endpoints;
+        for (int i = 0; i < 100; i++)
+        {
+            auto ep = endpoints.add_endpoints_v2();
+            ep->set_endpoint("10.0.1." + std::to_string(i) + ":51235");
+            ep->set_hops(i % 3);
+        }
+        endpoints.set_version(2);
+
+        TrafficCount traffic;
+        Message m(endpoints, protocol::mtENDPOINTS);
+
+        // Compressed once with each algorithm, and counted once
+        auto const& buffer =
+            m.getBuffer(Compressed::On, Algorithm::ZSTD, &traffic);
+        BEAST_EXPECT(
+            &m.getBuffer(Compressed::On, Algorithm::ZSTD, &traffic) ==
+            &buffer);
+        BEAST_EXPECT(
+            &m.getBuffer(Compressed::On, Algorithm::LZ4, &traffic) != &buffer);
+        BEAST_EXPECT(&m.getBuffer(Compressed::Off) != &buffer);
+
+        auto const& zstd =
+            traffic.getCompressionStats()[compression::algorithmIndex(
+                Algorithm::ZSTD)][protocol::mtENDPOINTS];
+        BEAST_EXPECT(zstd.messagesOut == 1);
+        BEAST_EXPECT(
+            zstd.bytesOutBefore ==
+            m.getBufferSize() - compression::headerBytes);
+        BEAST_EXPECT(
+            zstd.bytesOutAfter ==
+            buffer.size() - compression::headerBytesCompressed);
+        BEAST_EXPECT(zstd.bytesOutAfter < zstd.bytesOutBefore);
+        BEAST_EXPECT(zstd.messagesIn == 0);
+        BEAST_EXPECT(
+            traffic
+                .getCompressionStats()[compression::algorithmIndex(
+                    Algorithm::LZ4)][protocol::mtENDPOINTS]
+                .messagesOut == 1);
+
+        boost::beast::multi_buffer buffers;
+        buffers.commit(boost::asio::buffer_copy(
+            buffers.prepare(buffer.size()), boost::asio::buffer(buffer)));
+
+        boost::system::error_code ec;
+        auto const header = ripple::detail::parseMessageHeader(
+            ec, buffers.data(), buffer.size());
+        if (!BEAST_EXPECT(header && header->algorithm == Algorithm::ZSTD))
+            return;
+
+        std::chrono::nanoseconds elapsed{-1};
+        auto const parsed =
+            ripple::detail::parseMessageContent<protocol::TMEndpoints>(
+                *header, buffers.data(), &elapsed);
+        BEAST_EXPECT(
+            parsed &&
+            parsed->SerializeAsString() == endpoints.SerializeAsString());
+        BEAST_EXPECT(elapsed.count() >= 0);
+    }
+
+    void
+    testSizes()
+    {
+        testcase("Sizes");
+
+        // The dictionary must make zstd worth preferring over lz4 for the
+        // messages it was built for
+        Logs logs(beast::severities::kInfo);
+        auto const smaller = [this](auto const& proto,
+                                    protocol::MessageType mt,
+                                    std::string const& name) {
+            Message m(*proto, mt);
+            auto const zstd =
+                m.getBuffer(Compressed::On, Algorithm::ZSTD).size();
+            auto const lz4 = m.getBuffer(Compressed::On, Algorithm::LZ4).size();
+            log << name << ": " << m.getBufferSize() << " -> zstd " << zstd
+                << ", lz4 " << lz4 << std::endl;
+            return zstd < lz4;
+        };
+        BEAST_EXPECT(smaller(
+            buildTransaction(logs), protocol::mtTRANSACTION, "TMTransaction"));
+        BEAST_EXPECT(smaller(
+            buildLedgerData(500, logs),
+            protocol::mtLEDGER_DATA,
+            "TMLedgerData500"));
+        BEAST_EXPECT(smaller(
+            buildLedgerData(10000, logs),
+            protocol::mtLEDGER_DATA,
+            "TMLedgerData10000"));
+    }
+
+public:
+    void
+    run() override
+    {
+        testDictionary();
+        testNegotiation();
+        testMessage();
+        testSizes();
+    }
+};
+
 BEAST_DEFINE_TESTSUITE_MANUAL(compression, ripple_data, ripple);
+BEAST_DEFINE_TESTSUITE(compression_zstd, ripple_data, ripple);
 
 }  // namespace test
 }  // namespace ripple
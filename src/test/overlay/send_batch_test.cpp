@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/overlay/impl/PeerImp.h>
+#include <ripple/overlay/impl/Tuning.h>
+
+namespace ripple {
+
+namespace test {
+
+class send_batch_test : public beast::unit_test::suite
+{
+    using Compressed = compression::Compressed;
+    using Algorithm = compression::Algorithm;
+
+    // A transaction message whose packed size is about `bytes`
+    static std::shared_ptr<Message>
+    makeMessage(std::size_t bytes)
+    {
+        protocol::TMTransaction tx;
+        tx.set_rawtransaction(std::string(bytes, 'x'));
+        tx.set_status(protocol::tsNEW);
+        return std::make_shared<Message>(tx, protocol::mtTRANSACTION);
+    }
+
+    // The number of messages in the first batch of `queue`, checking
+    // that they are its first messages in order
+    std::size_t
+    firstBatch(std::deque<std::shared_ptr<Message>> const& queue)
+    {
+        auto const buffers = sendBatch(queue, Compressed::Off, Algorithm::LZ4);
+        for (std::size_t i = 0; i < buffers.size(); ++i)
+        {
+            auto const& buffer = queue[i]->getBuffer(Compressed::Off);
+            BEAST_EXPECT(buffers[i].data() == buffer.data());
+            BEAST_EXPECT(buffers[i].size() == buffer.size());
+        }
+        return buffers.size();
+    }
+
+public:
+    void
+    testMessageLimit()
+    {
+        testcase("Message limit");
+
+        std::deque<std::shared_ptr<Message>> queue;
+        for (std::size_t i = 0; i < Tuning::sendBatchMessages + 10; ++i)
+            queue.push_back(makeMessage(100));
+
+        BEAST_EXPECT(firstBatch(queue) == Tuning::sendBatchMessages);
+
+        queue.erase(queue.begin(), queue.begin() + Tuning::sendBatchMessages);
+        BEAST_EXPECT(firstBatch(queue) == 10);
+    }
+
+    void
+    testByteLimit()
+    {
+        testcase("Byte limit");
+
+        // Three of these do not fit in one batch
+        std::size_t const third = Tuning::sendBatchBytes / 3;
+        std::deque<std::shared_ptr<Message>> queue;
+        for (int i = 0; i < 5; ++i)
+            queue.push_back(makeMessage(third));
+
+        BEAST_EXPECT(firstBatch(queue) == 2);
+
+        // A message larger than a batch goes on its own
+        queue.push_front(makeMessage(2 * Tuning::sendBatchBytes));
+        BEAST_EXPECT(firstBatch(queue) == 1);
+
+        // and so does the message after it
+        std::deque<std::shared_ptr<Message>> small{
+            makeMessage(100), makeMessage(2 * Tuning::sendBatchBytes)};
+        BEAST_EXPECT(firstBatch(small) == 1);
+    }
+
+    void
+    run() override
+    {
+        testMessageLimit();
+        testByteLimit();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(send_batch, overlay, ripple);
+
+}  // namespace test
+
+}  // namespace ripple
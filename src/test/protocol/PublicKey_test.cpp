@@ -20,6 +20,8 @@
 #include <ripple/beast/unit_test.h>
 #include <ripple/protocol/PublicKey.h>
 #include <ripple/protocol/SecretKey.h>
+#include <chrono>
+#include <string>
 #include <vector>
 
 namespace ripple {
@@ -453,15 +455,172 @@ public:
         BEAST_EXPECT(pk1 == pk3);
     }
 
+    void
+    testVerifyBatch()
+    {
+        testcase("Batch verification");
+
+        struct Signed
+        {
+            PublicKey pk;
+            std::string message;
+            Buffer sig;
+        };
+
+        auto make = [](KeyType type, std::size_t n) {
+            std::vector<Signed> v;
+            v.reserve(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                auto const [pk, sk] = randomKeyPair(type);
+                auto message = "message " + std::to_string(i);
+                auto sig = sign(pk, sk, makeSlice(message));
+                v.push_back({pk, std::move(message), std::move(sig)});
+            }
+            return v;
+        };
+
+        auto checks = [](std::vector<Signed> const& v) {
+            std::vector<SignatureCheck> c;
+            c.reserve(v.size());
+            for (auto const& s : v)
+                c.push_back({&s.pk, makeSlice(s.message), s.sig});
+            return c;
+        };
+
+        BEAST_EXPECT(verifyBatch({}).empty());
+
+        // Sizes below, at and past the library's internal batch limit
+        for (std::size_t n : {1, 3, 4, 64, 65, 150})
+        {
+            auto const v = make(KeyType::ed25519, n);
+            auto c = checks(v);
+            auto r = verifyBatch(c);
+            BEAST_EXPECT(r.size() == n);
+            BEAST_EXPECT(std::all_of(r.begin(), r.end(), [](bool b) {
+                return b;
+            }));
+
+            // A signature over a different message fails on its own and
+            // does not take the rest of its group with it.
+            std::string const other = "not the message";
+            c[n / 2].message = makeSlice(other);
+            r = verifyBatch(c);
+            for (std::size_t i = 0; i < n; ++i)
+                BEAST_EXPECT(r[i] == (i != n / 2));
+        }
+
+        // Mixed key types, matching verify() entry by entry
+        {
+            auto v = make(KeyType::ed25519, 10);
+            for (auto& s : make(KeyType::secp256k1, 10))
+                v.push_back(std::move(s));
+
+            // Not canonical: S is not less than the group order
+            Buffer big(v[1].sig.data(), v[1].sig.size());
+            std::fill(big.data() + 32, big.data() + 64, 0xFF);
+            std::string const other = "not the message";
+
+            auto c = checks(v);
+            c[1].signature = big;
+            c[12].message = makeSlice(other);
+            c[3].publicKey = &v[4].pk;
+
+            auto const r = verifyBatch(c);
+            BEAST_EXPECT(r.size() == c.size());
+            for (std::size_t i = 0; i < c.size(); ++i)
+            {
+                BEAST_EXPECT(
+                    r[i] ==
+                    verify(*c[i].publicKey, c[i].message, c[i].signature));
+                BEAST_EXPECT(r[i] == (i != 1 && i != 3 && i != 12));
+            }
+        }
+    }
+
     void
     run() override
     {
         testBase58();
         testCanonical();
         testMiscOperations();
+        testVerifyBatch();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(PublicKey, protocol, ripple);
 
+// Measures Ed25519 verification throughput on one core, one signature at a
+// time and in batches of various sizes. The suite argument, if any, sets
+// the number of signatures checked for each size.
+class VerifyBatchTiming_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono;
+
+        std::size_t count = 4096;
+        if (!arg().empty())
+            count = std::stoul(arg());
+
+        testcase("Ed25519 verification throughput");
+
+        std::vector<PublicKey> keys;
+        std::vector<std::string> messages;
+        std::vector<Buffer> sigs;
+        keys.reserve(count);
+        messages.reserve(count);
+        sigs.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto const [pk, sk] = randomKeyPair(KeyType::ed25519);
+            messages.push_back("message " + std::to_string(i));
+            sigs.push_back(sign(pk, sk, makeSlice(messages.back())));
+            keys.push_back(pk);
+        }
+
+        auto report = [&](std::string const& what, auto elapsed) {
+            auto const us = duration_cast<microseconds>(elapsed).count();
+            log << what << ": " << count << " signatures in " << us
+                << "us, " << (us ? count * 1000000 / us : 0)
+                << " signatures/s" << std::endl;
+        };
+
+        {
+            bool ok = true;
+            auto const start = steady_clock::now();
+            for (std::size_t i = 0; i < count; ++i)
+                ok &= verify(keys[i], makeSlice(messages[i]), sigs[i]);
+            report("verify", steady_clock::now() - start);
+            BEAST_EXPECT(ok);
+        }
+
+        for (std::size_t batch : {1, 2, 4, 8, 16, 32, 64})
+        {
+            std::vector<SignatureCheck> checks;
+            checks.reserve(batch);
+
+            bool ok = true;
+            auto const start = steady_clock::now();
+            for (std::size_t i = 0; i < count; i += batch)
+            {
+                checks.clear();
+                for (auto j = i; j < std::min(i + batch, count); ++j)
+                    checks.push_back(
+                        {&keys[j], makeSlice(messages[j]), sigs[j]});
+                for (bool b : verifyBatch(checks))
+                    ok &= b;
+            }
+            report(
+                "verifyBatch, batch size " + std::to_string(batch),
+                steady_clock::now() - start);
+            BEAST_EXPECT(ok);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(VerifyBatchTiming, protocol, ripple);
+
 }  // namespace ripple
@@ -20,6 +20,13 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/protocol/jss.h>
 #include <test/jtx.h>
+#include <test/jtx/WSClient.h>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http.hpp>
+#include <array>
+#include <fstream>
+#include <limits>
 
 namespace ripple {
 
@@ -487,6 +494,65 @@ public:
         }
     }
 
+    void
+    testStreamed()
+    {
+        // A JSON-RPC client speaking HTTP/1.1 and a WebSocket client get
+        // their result streamed, the command line client gets it whole.
+        using namespace test::jtx;
+        Env env{*this};
+        Account const gw{"gateway"};
+        auto const USD = gw["USD"];
+        env.fund(XRP(100000), gw);
+
+        for (auto i = 0; i < 40; i++)
+        {
+            Account const bob{std::string("bob") + std::to_string(i)};
+            env.fund(XRP(1000), bob);
+            env.trust(USD(1000), bob);
+        }
+        env.close();
+
+        auto const ws = test::makeWSClient(env.app().config());
+        for (auto const binary : {false, true})
+        {
+            Json::Value jvParams;
+            jvParams[jss::ledger_index] = "validated";
+            jvParams[jss::binary] = binary;
+            jvParams[jss::limit] = 25;
+            for (;;)
+            {
+                auto const jrr = env.rpc(
+                    "json",
+                    "ledger_data",
+                    boost::lexical_cast<std::string>(jvParams))[jss::result];
+                for (auto const& jrs :
+                     {env.client().invoke("ledger_data", jvParams),
+                      ws->invoke("ledger_data", jvParams)})
+                {
+                    auto const& streamed = jrs[jss::result];
+                    BEAST_EXPECT(streamed[jss::status] == "success");
+                    BEAST_EXPECT(streamed[jss::state] == jrr[jss::state]);
+                    BEAST_EXPECT(streamed[jss::marker] == jrr[jss::marker]);
+                    BEAST_EXPECT(streamed[jss::ledger] == jrr[jss::ledger]);
+                    BEAST_EXPECT(
+                        streamed[jss::ledger_hash] == jrr[jss::ledger_hash]);
+                }
+                if (!jrr.isMember(jss::marker))
+                    break;
+                jvParams[jss::marker] = jrr[jss::marker];
+            }
+        }
+
+        // Errors are never streamed
+        Json::Value jvParams;
+        jvParams[jss::marker] = "NOT_A_MARKER";
+        auto const jrr =
+            env.client().invoke("ledger_data", jvParams)[jss::result];
+        BEAST_EXPECT(jrr[jss::error] == "invalidParams");
+        BEAST_EXPECT(jrr[jss::error_message] == "Invalid field 'marker'.");
+    }
+
     void
     run() override
     {
@@ -497,9 +563,143 @@ public:
         testMarkerFollow();
         testLedgerHeader();
         testLedgerType();
+        testStreamed();
     }
 };
 
 BEAST_DEFINE_TESTSUITE_PRIO(LedgerData, app, ripple, 1);
 
+// Requests a large ledger_data page and a full ledger over HTTP/1.0, which
+// gets the whole reply built before it is sent, and over HTTP/1.1, which
+// gets it streamed. Reports the time to the first byte, the total time and
+// how far the resident memory of the process rose while the reply was made.
+class LedgerDataStream_test : public beast::unit_test::suite
+{
+    // Resident memory of this process in kB, the current or the peak.
+    static std::size_t
+    residentKB(std::string const& field)
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            if (line.compare(0, field.size(), field) == 0)
+                return std::stoull(line.substr(field.size() + 1));
+        }
+        return 0;
+    }
+
+    void
+    measure(
+        test::jtx::Env& env,
+        std::string const& method,
+        Json::Value const& params,
+        unsigned version)
+    {
+        using namespace std::chrono;
+        namespace http = boost::beast::http;
+        using boost::asio::ip::tcp;
+
+        auto const& section = env.app().config()["port_rpc"];
+        tcp::endpoint const ep{
+            boost::asio::ip::make_address(*section.get<std::string>("ip")),
+            *section.get<std::uint16_t>("port")};
+        boost::asio::io_service ios;
+        tcp::socket stream{ios};
+        stream.connect(ep);
+
+        http::request<http::string_body> req{http::verb::post, "/", version};
+        req.set(http::field::host, ep.address().to_string());
+        req.set(http::field::content_type, "application/json; charset=UTF-8");
+        {
+            Json::Value jr;
+            jr[jss::method] = method;
+            jr[jss::params].append(params);
+            req.body() = to_string(jr);
+        }
+        req.prepare_payload();
+
+        // Start counting the peak from the memory in use now
+        std::ofstream("/proc/self/clear_refs") << "5";
+        auto const baseKB = residentKB("VmRSS:");
+
+        auto const start = steady_clock::now();
+        http::write(stream, req);
+        boost::beast::flat_buffer buffer;
+        buffer.commit(stream.read_some(buffer.prepare(4096)));
+        auto const firstByte = steady_clock::now();
+
+        // Count the body without keeping it
+        http::response_parser<http::buffer_body> parser;
+        parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+        http::read_header(stream, buffer, parser);
+        std::size_t bytes = 0;
+        std::array<char, 65536> chunk;
+        while (!parser.is_done())
+        {
+            parser.get().body().data = chunk.data();
+            parser.get().body().size = chunk.size();
+            boost::system::error_code ec;
+            http::read(stream, buffer, parser, ec);
+            if (ec && ec != http::error::need_buffer)
+            {
+                fail(ec.message());
+                return;
+            }
+            bytes += chunk.size() - parser.get().body().size;
+        }
+        auto const done = steady_clock::now();
+        auto const peakKB = residentKB("VmHWM:");
+
+        BEAST_EXPECT(parser.get().result() == http::status::ok);
+        log << method << (params[jss::binary].asBool() ? " binary" : "")
+            << ", HTTP/1." << version % 10 << ": " << bytes << " bytes, "
+            << "first byte "
+            << duration_cast<milliseconds>(firstByte - start).count()
+            << "ms, total "
+            << duration_cast<milliseconds>(done - start).count()
+            << "ms, peak RSS +" << (peakKB > baseKB ? peakKB - baseKB : 0)
+            << "kB" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace test::jtx;
+        Env env{*this};
+        Account const gw{"gateway"};
+        auto const USD = gw["USD"];
+        env.fund(XRP(100000), gw);
+        for (auto i = 0; i < 20000; i++)
+        {
+            Account const bob{std::string("bob") + std::to_string(i)};
+            env.fund(XRP(1000), bob);
+            env.trust(USD(1000), bob);
+            if (i % 500 == 0)
+                env.close();
+        }
+        env.close();
+
+        for (auto const binary : {false, true})
+        {
+            Json::Value params;
+            params[jss::ledger_index] = "validated";
+            params[jss::binary] = binary;
+            params[jss::limit] = 1000000;
+            for (auto const version : {10u, 11u})
+                measure(env, "ledger_data", params, version);
+        }
+
+        Json::Value params;
+        params[jss::ledger_index] = "validated";
+        params[jss::full] = true;
+        params[jss::expand] = true;
+        for (auto const version : {10u, 11u})
+            measure(env, "ledger", params, version);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(LedgerDataStream, app, ripple, 1);
+
 }  // namespace ripple
@@ -240,6 +240,42 @@ class LedgerRPC_test : public beast::unit_test::suite
         BEAST_EXPECT(jrr[jss::ledger][jss::accountState].size() == 2u);
     }
 
+    void
+    testLedgerFullStreamed()
+    {
+        testcase("Ledger Request, Full Option Streamed");
+        using namespace test::jtx;
+
+        Env env{*this};
+        Account const gw{"gateway"};
+        auto const USD = gw["USD"];
+        env.fund(XRP(100000), gw);
+        for (auto i = 0; i < 20; i++)
+        {
+            Account const bob{std::string("bob") + std::to_string(i)};
+            env.fund(XRP(1000), bob);
+            env.trust(USD(1000), bob);
+        }
+        env.close();
+
+        Json::Value jvParams;
+        jvParams[jss::ledger_index] = "validated";
+        jvParams[jss::full] = true;
+        jvParams[jss::expand] = true;
+        auto const jrr =
+            env.rpc("json", "ledger", to_string(jvParams))[jss::result];
+        BEAST_EXPECT(jrr[jss::ledger][jss::accountState].size() > 40u);
+        BEAST_EXPECT(jrr[jss::ledger][jss::transactions].size() > 40u);
+
+        // An HTTP/1.1 client is sent the same result, a piece at a time
+        auto const streamed =
+            env.client().invoke("ledger", jvParams)[jss::result];
+        BEAST_EXPECT(streamed[jss::status] == "success");
+        BEAST_EXPECT(streamed[jss::ledger] == jrr[jss::ledger]);
+        BEAST_EXPECT(streamed[jss::ledger_hash] == jrr[jss::ledger_hash]);
+        BEAST_EXPECT(streamed[jss::validated] == jrr[jss::validated]);
+    }
+
     void
     testLedgerFullNonAdmin()
     {
@@ -1723,6 +1759,7 @@ public:
         testLedgerCurrent();
         testMissingLedgerEntryLedgerHash();
         testLedgerFull();
+        testLedgerFullStreamed();
         testLedgerFullNonAdmin();
         testLedgerAccounts();
         testLedgerEntryAccountRoot();
@@ -24,10 +24,15 @@
 #include <ripple/rpc/impl/Tuning.h>
 
 #include <test/jtx.h>
+#include <test/jtx/CaptureLogs.h>
 #include <test/jtx/Env.h>
 #include <test/jtx/envconfig.h>
 #include <test/rpc/GRPCTestClientBase.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 namespace ripple {
 namespace test {
 
@@ -596,6 +601,82 @@ class ReportingETL_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testConcurrentGetLedgerData()
+    {
+        testcase("GetLedgerData on several completion queues");
+        using namespace test::jtx;
+        std::unique_ptr<Config> config = envconfig(addGrpcConfig);
+        (*config)["port_grpc"].set("threads", "3");
+        std::string grpcPort = *(*config)["port_grpc"].get<std::string>("port");
+        Env env(*this, std::move(config));
+
+        int const num_accounts = 20;
+        for (auto i = 0; i < num_accounts; i++)
+        {
+            Account const bob{std::string("bob") + std::to_string(i)};
+            env.fund(XRP(1000), bob);
+        }
+        env.close();
+
+        auto const seq = env.closed()->seq();
+        int const num_clients = 8;
+        std::vector<grpc::StatusCode> codes(num_clients);
+        std::vector<int> sizes(num_clients);
+        std::vector<std::thread> clients;
+        for (int i = 0; i < num_clients; ++i)
+        {
+            clients.emplace_back([&, i]() {
+                for (int j = 0; j < 5; ++j)
+                {
+                    GrpcLedgerDataClient grpcClient{grpcPort};
+                    grpcClient.request.mutable_ledger()->set_sequence(seq);
+                    grpcClient.GetLedgerData();
+                    codes[i] = grpcClient.status.error_code();
+                    sizes[i] = grpcClient.reply.ledger_objects().objects_size();
+                    if (!grpcClient.status.ok())
+                        return;
+                }
+            });
+        }
+        for (auto& client : clients)
+            client.join();
+
+        for (int i = 0; i < num_clients; ++i)
+        {
+            BEAST_EXPECT(codes[i] == grpc::StatusCode::OK);
+            BEAST_EXPECT(sizes[i] == num_accounts + 2);
+        }
+    }
+
+    void
+    testBadThreads()
+    {
+        testcase("Invalid threads in port_grpc");
+        using namespace test::jtx;
+
+        auto const tooMany = std::to_string(
+            4 * std::max(1u, std::thread::hardware_concurrency()) + 1);
+        for (auto const& threads :
+             std::vector<std::string>{"0", "-1", "two", "3x", tooMany})
+        {
+            std::string messages;
+            except([&] {
+                Env env{
+                    *this,
+                    envconfig([&](std::unique_ptr<Config> cfg) {
+                        cfg = addGrpcConfig(std::move(cfg));
+                        (*cfg)["port_grpc"].set("threads", threads);
+                        return cfg;
+                    }),
+                    std::make_unique<CaptureLogs>(&messages)};
+            });
+            BEAST_EXPECT(
+                messages.find("Invalid threads for grpc server") !=
+                std::string::npos);
+        }
+    }
+
     // gRPC stuff
     class GrpcLedgerDiffClient : public GRPCTestClientBase
     {
@@ -1155,6 +1236,10 @@ public:
 
         testGetLedgerData();
 
+        testConcurrentGetLedgerData();
+
+        testBadThreads();
+
         testGetLedgerDiff();
 
         testGetLedgerEntry();
@@ -1167,5 +1252,91 @@ public:
 
 BEAST_DEFINE_TESTSUITE_PRIO(ReportingETL, app, ripple, 2);
 
+// Drives many concurrent GetLedgerData calls, as a reporting node downloading
+// the initial ledger does, against servers polling a different number of
+// completion queues, and reports the throughput of each.
+class ReportingETLLoad_test : public beast::unit_test::suite
+{
+    struct GrpcLedgerDataClient : public GRPCTestClientBase
+    {
+        org::xrpl::rpc::v1::GetLedgerDataRequest request;
+        org::xrpl::rpc::v1::GetLedgerDataResponse reply;
+
+        explicit GrpcLedgerDataClient(std::string const& port)
+            : GRPCTestClientBase(port)
+        {
+        }
+    };
+
+    void
+    testLoad(std::size_t queues)
+    {
+        testcase("GetLedgerData load, " + std::to_string(queues) + " queues");
+        using namespace test::jtx;
+        using namespace std::chrono;
+        std::unique_ptr<Config> config = envconfig(addGrpcConfig);
+        (*config)["port_grpc"].set("threads", std::to_string(queues));
+        std::string grpcPort = *(*config)["port_grpc"].get<std::string>("port");
+        Env env(*this, std::move(config));
+
+        for (auto i = 0; i < 5000; i++)
+        {
+            Account const cat{std::string("cat") + std::to_string(i)};
+            env.fund(XRP(1000), cat);
+            if (i % 500 == 0)
+                env.close();
+        }
+        env.close();
+
+        auto const seq = env.closed()->seq();
+        int const num_clients = 32;
+        int const num_calls = 20;
+        std::atomic<int> failed = 0;
+        std::vector<std::thread> clients;
+        auto const start = steady_clock::now();
+        for (int i = 0; i < num_clients; ++i)
+        {
+            clients.emplace_back([&]() {
+                // Each client walks the whole ledger, page by page, over
+                // and over
+                std::string marker;
+                for (int j = 0; j < num_calls; ++j)
+                {
+                    GrpcLedgerDataClient client{grpcPort};
+                    client.request.mutable_ledger()->set_sequence(seq);
+                    client.request.set_marker(marker);
+                    client.status = client.stub_->GetLedgerData(
+                        &client.context, client.request, &client.reply);
+                    if (!client.status.ok())
+                        ++failed;
+                    marker = client.reply.marker();
+                }
+            });
+        }
+        for (auto& client : clients)
+            client.join();
+        auto const elapsed =
+            duration_cast<milliseconds>(steady_clock::now() - start);
+
+        BEAST_EXPECT(failed == 0);
+        log << queues << " queues: " << num_clients * num_calls
+            << " calls in " << elapsed.count() << "ms, "
+            << num_clients * num_calls * 1000 /
+                std::max<std::int64_t>(elapsed.count(), 1)
+            << " calls/s" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        testLoad(1);
+        testLoad(2);
+        testLoad(std::max(4u, std::thread::hardware_concurrency()));
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(ReportingETLLoad, app, ripple, 2);
+
 }  // namespace test
 }  // namespace ripple
@@ -1137,6 +1137,46 @@ public:
         }
     }
 
+    void
+    testSharedFanOut()
+    {
+        using namespace std::chrono_literals;
+        using namespace jtx;
+        Env env(*this);
+        auto wsc1 = makeWSClient(env.app().config());
+        auto wsc2 = makeWSClient(env.app().config());
+
+        Json::Value stream;
+        stream[jss::streams] = Json::arrayValue;
+        stream[jss::streams].append("ledger");
+        for (auto* wsc : {wsc1.get(), wsc2.get()})
+        {
+            auto jv = wsc->invoke("subscribe", stream);
+            BEAST_EXPECT(jv[jss::result][jss::ledger_index] == 2);
+        }
+
+        env.close();
+
+        // Both sessions receive the same ledgerClosed message
+        for (auto* wsc : {wsc1.get(), wsc2.get()})
+        {
+            BEAST_EXPECT(wsc->findMsg(5s, [&](auto const& jv) {
+                return jv[jss::type] == "ledgerClosed" &&
+                    jv[jss::ledger_index] == 3;
+            }));
+        }
+
+        // which was serialized once and delivered twice
+        auto const counts = env.rpc("get_counts")[jss::result];
+        BEAST_EXPECT(counts.isMember(jss::streams));
+        auto const& ledger = counts[jss::streams][jss::ledger];
+        BEAST_EXPECT(ledger[jss::messages] == "1");
+        BEAST_EXPECT(ledger[jss::deliveries] == "2");
+
+        for (auto* wsc : {wsc1.get(), wsc2.get()})
+            wsc->invoke("unsubscribe", stream);
+    }
+
     void
     run() override
     {
@@ -1149,6 +1189,7 @@ public:
         testSubErrors(false);
         testSubByUrl();
         testHistoryTxStream();
+        testSharedFanOut();
     }
 };
 
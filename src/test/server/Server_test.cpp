@@ -34,6 +34,7 @@
 #include <boost/beast/ssl/ssl_stream.hpp>
 #include <boost/utility/in_place_factory.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <optional>
 #include <stdexcept>
@@ -306,6 +307,37 @@ public:
         pass();
     }
 
+    void
+    connectionContextTests()
+    {
+        testcase("Connections on their own io_services");
+        TestSink sink{*this};
+        TestThread thread;
+        TestThread shards[2];
+        beast::Journal journal{sink};
+        TestHandler handler;
+        std::atomic<std::size_t> chosen{0};
+        auto s = make_Server(
+            handler,
+            thread.get_io_service(),
+            journal,
+            [&]() -> boost::asio::io_context& {
+                return shards[chosen++ % 2].get_io_service();
+            });
+        std::vector<Port> serverPort(1);
+        serverPort.back().ip =
+            beast::IP::Address::from_string(getEnvLocalhostAddr()),
+        serverPort.back().port = 0;
+        serverPort.back().protocol.insert("http");
+        auto eps = s->ports(serverPort);
+        test_request(eps[0]);
+        test_keepalive(eps[0]);
+        s = nullptr;
+
+        // The door chooses for the next connection before accepting it
+        BEAST_EXPECT(chosen >= 2);
+    }
+
     void
     stressTest()
     {
@@ -507,6 +539,7 @@ public:
     run() override
     {
         basicTests();
+        connectionContextTests();
         stressTest();
         testBadConfig();
     }
@@ -0,0 +1,248 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2022 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/WorkerPool.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/shamap/SHAMap.h>
+#include <ripple/shamap/SHAMapItem.h>
+#include <test/shamap/common.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace ripple {
+namespace tests {
+
+// Items whose key depends only on their index, so that maps built from
+// the same indexes hold the same keys whatever the version of the data.
+class SHAMapFlushBase : public beast::unit_test::suite
+{
+protected:
+    static boost::intrusive_ptr<SHAMapItem const>
+    makeItem(std::uint64_t i, std::uint32_t version)
+    {
+        auto const key = sha512Half(i);
+        Serializer s;
+        s.addBitString(key);
+        s.add64(i);
+        s.add32(version);
+        return make_shamapitem(key, s.slice());
+    }
+
+    static void
+    fill(SHAMap& map, std::uint64_t count)
+    {
+        for (std::uint64_t i = 0; i < count; ++i)
+            map.addItem(SHAMapNodeType::tnACCOUNT_STATE, makeItem(i, 0));
+    }
+
+    // Give every stride'th item of the first count a new version
+    static void
+    update(
+        SHAMap& map,
+        std::uint64_t count,
+        std::uint64_t stride,
+        std::uint32_t version)
+    {
+        for (std::uint64_t i = 0; i < count; i += stride)
+            map.updateGiveItem(
+                SHAMapNodeType::tnACCOUNT_STATE, makeItem(i, version));
+    }
+};
+
+class SHAMapFlush_test : public SHAMapFlushBase
+{
+    void
+    testFlush(bool backed, beast::Journal const& journal)
+    {
+        testcase(backed ? "flush backed" : "flush unbacked");
+
+        TestNodeFamily f(journal);
+        std::uint64_t const count = 20000;
+
+        SHAMap serial(SHAMapType::STATE, f);
+        SHAMap parallel(SHAMapType::STATE, f);
+        if (!backed)
+        {
+            serial.setUnbacked();
+            parallel.setUnbacked();
+        }
+        fill(serial, count);
+        fill(parallel, count);
+
+        auto const flushed = serial.flushDirty(hotACCOUNT_NODE, false);
+        BEAST_EXPECT(parallel.flushDirty(hotACCOUNT_NODE, true) == flushed);
+        BEAST_EXPECT(flushed > count);
+        BEAST_EXPECT(parallel.getHash() == serial.getHash());
+        parallel.invariants();
+
+        // Every node was flushed, and written if the map is backed
+        int nodes = 0;
+        parallel.visitNodes([&](SHAMapTreeNode& node) {
+            ++nodes;
+            BEAST_EXPECT(node.cowid() == 0);
+            if (backed)
+                BEAST_EXPECT(
+                    f.db().fetchNodeObject(node.getHash().as_uint256(), 0));
+            return true;
+        });
+        BEAST_EXPECT(nodes == flushed);
+
+        // Nothing is left to flush
+        BEAST_EXPECT(parallel.flushDirty(hotACCOUNT_NODE, true) == 0);
+    }
+
+    // A mutable snapshot of a map that was never flushed is unshared from
+    // it, cloning rather than modifying the dirty nodes they had in common.
+    void
+    testSnapshot(beast::Journal const& journal)
+    {
+        testcase("flush snapshot");
+
+        TestNodeFamily f(journal);
+        std::uint64_t const count = 20000;
+
+        SHAMap base(SHAMapType::STATE, f);
+        fill(base, count);
+        auto const baseHash = base.getHash();
+
+        auto snap = base.snapShot(true);
+        update(*snap, count, 7, 1);
+        auto const snapHash = snap->getHash();
+        BEAST_EXPECT(snapHash != baseHash);
+
+        snap->flushDirty(hotACCOUNT_NODE, true);
+        BEAST_EXPECT(snap->getHash() == snapHash);
+        snap->invariants();
+
+        // The original map still holds, and flushes, its own data
+        BEAST_EXPECT(base.getHash() == baseHash);
+        base.flushDirty(hotACCOUNT_NODE, false);
+        BEAST_EXPECT(base.getHash() == baseHash);
+        base.invariants();
+
+        // The same change applied serially ends in the same map
+        update(base, count, 7, 1);
+        base.flushDirty(hotACCOUNT_NODE, false);
+        BEAST_EXPECT(base.getHash() == snapHash);
+    }
+
+public:
+    void
+    run() override
+    {
+        test::SuiteJournal journal("SHAMapFlush_test", *this);
+
+        testFlush(true, journal);
+        testFlush(false, journal);
+        testSnapshot(journal);
+    }
+};
+
+// Compares serial and parallel flushes of a large state map, both of the
+// whole map and of a ledger's worth of changes to an already flushed map.
+// The item count can be passed as the suite argument.
+class SHAMapFlushTiming_test : public SHAMapFlushBase
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    static double
+    seconds(F&& f)
+    {
+        auto const start = clock_type::now();
+        f();
+        return std::chrono::duration<double>(clock_type::now() - start)
+            .count();
+    }
+
+    void
+    report(char const* what, double serial, double parallel)
+    {
+        std::stringstream ss;
+        ss << std::setw(24) << what << std::fixed << std::setprecision(3)
+           << std::setw(12) << serial << std::setw(12) << parallel
+           << std::setprecision(2) << std::setw(10) << serial / parallel;
+        log << ss.str() << std::endl;
+    }
+
+    void
+    measure(bool backed, std::uint64_t count, beast::Journal const& journal)
+    {
+        testcase(backed ? "flush backed" : "flush unbacked");
+        log << "worker pool threads: " << WorkerPool::instance().threads()
+            << std::endl;
+        log << std::setw(24) << "items " + std::to_string(count)
+            << std::setw(12) << "serial s" << std::setw(12) << "parallel s"
+            << std::setw(10) << "speedup" << std::endl;
+
+        std::uint64_t const changes = std::max<std::uint64_t>(count / 100, 1);
+
+        // Each run gets a family of its own, so neither finds the nodes
+        // of the other already cached or stored.
+        double full[2];
+        double delta[2];
+        SHAMapHash hash[2];
+        for (bool const parallel : {false, true})
+        {
+            TestNodeFamily f(journal);
+            SHAMap map(SHAMapType::STATE, f);
+            if (!backed)
+                map.setUnbacked();
+            fill(map, count);
+            full[parallel] =
+                seconds([&] { map.flushDirty(hotACCOUNT_NODE, parallel); });
+
+            auto snap = map.snapShot(true);
+            update(*snap, count, count / changes, 1);
+            delta[parallel] =
+                seconds([&] { snap->flushDirty(hotACCOUNT_NODE, parallel); });
+            hash[parallel] = snap->getHash();
+        }
+        BEAST_EXPECT(hash[0] == hash[1]);
+
+        report("full map", full[0], full[1]);
+        report(
+            (std::to_string(changes) + " changes").c_str(), delta[0], delta[1]);
+        BEAST_EXPECT(full[0] > 0 && full[1] > 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        test::SuiteJournal journal("SHAMapFlushTiming_test", *this);
+
+        std::uint64_t count = 2'000'000;
+        if (!arg().empty())
+            count = std::stoull(arg());
+
+        measure(false, count, journal);
+        measure(true, count, journal);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SHAMapFlush, ripple_app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapFlushTiming, ripple_app, ripple);
+
+}  // namespace tests
+}  // namespace ripple
@@ -0,0 +1,329 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2023 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Buffer.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/shamap/SHAMap.h>
+#include <ripple/shamap/SHAMapItem.h>
+#include <boost/algorithm/string.hpp>
+#include <test/shamap/common.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace tests {
+
+class SHAMapItem_test : public beast::unit_test::suite
+{
+    void
+    testPayload()
+    {
+        testcase("Payload");
+
+        std::vector<std::uint8_t> data(300);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<std::uint8_t>(i);
+
+        for (std::size_t size : {0, 1, 31, 32, 200, 300})
+        {
+            auto const key = sha512Half(size);
+            auto const item = make_shamapitem(key, Slice(data.data(), size));
+            BEAST_EXPECT(item->key() == key);
+            BEAST_EXPECT(item->size() == size);
+            BEAST_EXPECT(item->slice() == Slice(data.data(), size));
+        }
+    }
+
+    void
+    testSharing()
+    {
+        testcase("Sharing");
+
+        auto const before = detail::shamapItemAllocator().stats();
+
+        std::uint8_t const payload[] = {1, 2, 3, 4};
+        auto item = make_shamapitem(uint256(1), Slice(payload, 4));
+        {
+            // Copies of the pointer share the item, a copy of the item
+            // is a new one
+            auto const shared = item;
+            auto const copy = make_shamapitem(*item);
+            BEAST_EXPECT(shared.get() == item.get());
+            BEAST_EXPECT(copy.get() != item.get());
+            BEAST_EXPECT(copy->key() == item->key());
+            BEAST_EXPECT(copy->slice() == item->slice());
+
+            // So does a pointer made from a reference to the item
+            boost::intrusive_ptr<SHAMapItem const> const fromRef(&*item);
+            BEAST_EXPECT(fromRef.get() == item.get());
+        }
+        BEAST_EXPECT(item->slice() == Slice(payload, 4));
+
+        // Releasing the last reference gives the block back
+        BEAST_EXPECT(
+            detail::shamapItemAllocator().stats().slabs.bytesInUse >
+            before.slabs.bytesInUse);
+        item.reset();
+        BEAST_EXPECT(
+            detail::shamapItemAllocator().stats().slabs.bytesInUse ==
+            before.slabs.bytesInUse);
+
+        // Payloads too large for any slab still work
+        std::vector<std::uint8_t> const large(4096, 0x5a);
+        auto big = make_shamapitem(uint256(2), makeSlice(large));
+        BEAST_EXPECT(big->slice() == makeSlice(large));
+        BEAST_EXPECT(
+            detail::shamapItemAllocator().stats().oversize ==
+            before.oversize + 1);
+        big.reset();
+        BEAST_EXPECT(
+            detail::shamapItemAllocator().stats().oversize == before.oversize);
+    }
+
+public:
+    void
+    run() override
+    {
+        testPayload();
+        testSharing();
+    }
+};
+
+// Reports the memory taken by as many items as a mainnet state map holds,
+// kept in one of three layouts:
+//
+//   legacy  the way items used to be kept: a shared_ptr to an object
+//           owning a separately allocated Buffer, two allocations each
+//   slab    intrusively counted items with their payload inline
+//   map     slab items in a state map, with all its inner nodes
+//
+// The argument names the layout and, optionally, a count of items other
+// than mainnet's, as in --unittest-arg=slab or --unittest-arg=legacy,100000.
+// Memory freed by one layout is reused by the next, so each should be
+// measured in a process of its own. Without a layout all of them run in
+// turn, slab first and legacy last, which only gives rough figures.
+class SHAMapItemMemory_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // The old layout of an item
+    struct LegacyItem
+    {
+        uint256 tag;
+        Buffer data;
+
+        LegacyItem(uint256 const& t, Slice s) : tag(t), data(s)
+        {
+        }
+    };
+
+    static std::uint64_t
+    residentKB()
+    {
+        std::string const field = "VmRSS:";
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            if (line.compare(0, field.size(), field) == 0)
+                return std::stoull(line.substr(field.size() + 1));
+        }
+        return 0;
+    }
+
+    // Sizes of common ledger entries: account roots, offers, trust lines
+    // and directories, in roughly the proportions a mainnet state map
+    // holds them.
+    static std::size_t
+    payloadSize(beast::xor_shift_engine& r)
+    {
+        auto const pick = r() % 100;
+        if (pick < 45)
+            return 110 + r() % 24;
+        if (pick < 60)
+            return 140 + r() % 40;
+        if (pick < 90)
+            return 200 + r() % 48;
+        return 90 + r() % 400;
+    }
+
+    void
+    report(char const* what, std::uint64_t kb, std::uint64_t count)
+    {
+        std::stringstream ss;
+        ss << std::setw(28) << what << std::setw(12) << kb / 1024
+           << std::fixed << std::setprecision(1) << std::setw(16)
+           << kb * 1024.0 / count;
+        log << ss.str() << std::endl;
+    }
+
+    // Roughly the number of entries in the state map of a mainnet ledger
+    static constexpr std::uint64_t mainnetItems = 20'000'000;
+
+    void
+    testLegacy(std::uint64_t count)
+    {
+        std::vector<std::uint8_t> payload(1024);
+        beast::xor_shift_engine r(1);
+        std::vector<std::shared_ptr<LegacyItem const>> items;
+        items.reserve(count);
+        auto const base = residentKB();
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            items.push_back(std::make_shared<LegacyItem const>(
+                sha512Half(i), Slice(payload.data(), payloadSize(r))));
+        }
+        report(
+            "shared_ptr + Buffer",
+            residentKB() - base - count * sizeof(items[0]) / 1024,
+            count);
+    }
+
+    void
+    testSlab(std::uint64_t count)
+    {
+        std::vector<std::uint8_t> payload(1024);
+        auto const before = detail::shamapItemAllocator().stats();
+        {
+            beast::xor_shift_engine r(1);
+            std::vector<boost::intrusive_ptr<SHAMapItem const>> items;
+            items.reserve(count);
+            std::uint64_t payloadBytes = 0;
+            auto const base = residentKB();
+            for (std::uint64_t i = 0; i < count; ++i)
+            {
+                auto const size = payloadSize(r);
+                payloadBytes += size;
+                items.push_back(make_shamapitem(
+                    sha512Half(i), Slice(payload.data(), size)));
+            }
+            report(
+                "slab, payload inline",
+                residentKB() - base - count * sizeof(items[0]) / 1024,
+                count);
+
+            auto const s = detail::shamapItemAllocator().stats();
+            report(
+                "  slabs held",
+                (s.slabs.slabBytes - before.slabs.slabBytes) / 1024,
+                count);
+            report(
+                "  blocks in use",
+                (s.slabs.bytesInUse - before.slabs.bytesInUse) / 1024,
+                count);
+            auto const oversize = s.oversize - before.oversize;
+            log << "  payload bytes/item " << payloadBytes / count
+                << ", items too large for a slab " << oversize << std::endl;
+            log << "  allocations "
+                << s.slabs.slabsAllocated - before.slabs.slabsAllocated +
+                    oversize
+                << ", " << 2 * count << " before" << std::endl;
+        }
+
+        // Every item went back to its slab
+        BEAST_EXPECT(
+            detail::shamapItemAllocator().stats().slabs.bytesInUse ==
+            before.slabs.bytesInUse);
+    }
+
+    void
+    testMap(std::uint64_t count)
+    {
+        test::SuiteJournal journal("SHAMapItemMemory_test", *this);
+
+        std::vector<std::uint8_t> payload(1024);
+        auto const before = detail::shamapItemAllocator().stats();
+        beast::xor_shift_engine r(1);
+        TestNodeFamily f(journal);
+        auto const base = residentKB();
+        auto const start = clock_type::now();
+        {
+            SHAMap map(SHAMapType::STATE, f);
+            map.setUnbacked();
+            for (std::uint64_t i = 0; i < count; ++i)
+            {
+                map.addItem(
+                    SHAMapNodeType::tnACCOUNT_STATE,
+                    make_shamapitem(
+                        sha512Half(i), Slice(payload.data(), payloadSize(r))));
+            }
+            BEAST_EXPECT(map.getHash().isNonZero());
+            report("state map, all nodes", residentKB() - base, count);
+        }
+        log << "  load and hash "
+            << std::chrono::duration<double>(clock_type::now() - start).count()
+            << "s" << std::endl;
+
+        BEAST_EXPECT(
+            detail::shamapItemAllocator().stats().slabs.bytesInUse ==
+            before.slabs.bytesInUse);
+    }
+
+public:
+    void
+    run() override
+    {
+        std::uint64_t count = mainnetItems;
+        std::string layout;
+        std::vector<std::string> args;
+        boost::split(args, arg(), boost::algorithm::is_any_of(","));
+        for (auto const& a : args)
+        {
+            if (a.empty())
+                continue;
+            if (std::isdigit(static_cast<unsigned char>(a.front())))
+                count = std::stoull(a);
+            else
+                layout = a;
+        }
+
+        testcase("memory");
+        if (!layout.empty() && layout != "slab" && layout != "map" &&
+            layout != "legacy")
+        {
+            fail("unknown layout " + layout);
+            return;
+        }
+
+        log << std::setw(28) << "items " + std::to_string(count)
+            << std::setw(12) << "RSS MB" << std::setw(16) << "bytes/item"
+            << std::endl;
+
+        if (layout.empty() || layout == "slab")
+            testSlab(count);
+        if (layout.empty() || layout == "map")
+            testMap(count);
+        if (layout.empty() || layout == "legacy")
+            testLegacy(count);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SHAMapItem, ripple_app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapItemMemory, ripple_app, ripple);
+
+}  // namespace tests
+}  // namespace ripple
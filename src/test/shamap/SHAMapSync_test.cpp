@@ -25,6 +25,10 @@
 #include <ripple/shamap/SHAMapItem.h>
 #include <test/shamap/common.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <mutex>
 
 namespace ripple {
 namespace tests {
@@ -34,14 +38,14 @@ class SHAMapSync_test : public beast::unit_test::suite
 public:
     beast::xor_shift_engine eng_;
 
-    std::shared_ptr<SHAMapItem>
+    boost::intrusive_ptr<SHAMapItem const>
     makeRandomAS()
     {
         Serializer s;
 
         for (int d = 0; d < 3; ++d)
             s.add32(rand_int<std::uint32_t>(eng_));
-        return std::make_shared<SHAMapItem>(s.getSHA512Half(), s.slice());
+        return make_shamapitem(s.getSHA512Half(), s.slice());
     }
 
     bool
@@ -55,10 +59,10 @@ public:
 
         for (int i = 0; i < count; ++i)
         {
-            std::shared_ptr<SHAMapItem> item = makeRandomAS();
+            boost::intrusive_ptr<SHAMapItem const> item = makeRandomAS();
             items.push_back(item->key());
 
-            if (!map.addItem(SHAMapNodeType::tnACCOUNT_STATE, std::move(*item)))
+            if (!map.addItem(SHAMapNodeType::tnACCOUNT_STATE, std::move(item)))
             {
                 log << "Unable to add item to map\n";
                 return false;
@@ -84,6 +88,55 @@ public:
         return true;
     }
 
+    void
+    testPrefetch(beast::Journal const& journal)
+    {
+        testcase("prefetch");
+
+        TestNodeFamily f(journal);
+        std::vector<uint256> keys;
+        SHAMapHash hash;
+        {
+            SHAMap source(SHAMapType::FREE, f);
+            for (int i = 0; i < 10000; ++i)
+            {
+                auto item = makeRandomAS();
+                keys.push_back(item->key());
+                source.addItem(
+                    SHAMapNodeType::tnACCOUNT_STATE, std::move(item));
+            }
+            source.flushDirty(hotACCOUNT_NODE);
+            hash = source.getHash();
+        }
+
+        // Only the node store holds the nodes below the root
+        f.reset();
+        SHAMap map(SHAMapType::FREE, f);
+        BEAST_EXPECT(map.fetchRoot(hash, nullptr));
+
+        auto const prefetch = [&map](uint256 const& key) {
+            std::promise<std::size_t> loaded;
+            map.prefetch(key, [&loaded](std::size_t n) {
+                loaded.set_value(n);
+            });
+            return loaded.get_future().get();
+        };
+
+        // The whole path, down to and including the leaf, is loaded once
+        BEAST_EXPECT(prefetch(keys[0]) >= 2);
+        BEAST_EXPECT(prefetch(keys[0]) == 0);
+
+        // and is then found without reading the node store
+        auto const reads = f.db().getFetchTotalCount();
+        BEAST_EXPECT(map.hasItem(keys[0]));
+        BEAST_EXPECT(f.db().getFetchTotalCount() == reads);
+
+        // A key not in the map is prefetched as far as its path goes
+        prefetch(~keys[1]);
+        BEAST_EXPECT(!map.hasItem(~keys[1]));
+        BEAST_EXPECT(f.db().getFetchTotalCount() == reads);
+    }
+
     void
     run() override
     {
@@ -97,8 +150,7 @@ public:
         int items = 10000;
         for (int i = 0; i < items; ++i)
         {
-            source.addItem(
-                SHAMapNodeType::tnACCOUNT_STATE, std::move(*makeRandomAS()));
+            source.addItem(SHAMapNodeType::tnACCOUNT_STATE, makeRandomAS());
             if (i % 100 == 0)
                 source.invariants();
         }
@@ -113,6 +165,38 @@ public:
         source.visitLeaves([&count](auto const& item) { ++count; });
         BEAST_EXPECT(count == items);
 
+        {
+            // A parallel visit sees the same nodes, each once
+            std::vector<uint256> serial;
+            source.visitNodes([&serial](SHAMapTreeNode& node) {
+                serial.push_back(node.getHash().as_uint256());
+                return true;
+            });
+
+            std::size_t const threads = 4;
+            std::mutex m;
+            std::vector<uint256> parallel;
+            source.visitNodesParallel(
+                threads, [&](std::size_t worker, SHAMapTreeNode& node) {
+                    BEAST_EXPECT(worker < threads);
+                    std::lock_guard l(m);
+                    parallel.push_back(node.getHash().as_uint256());
+                    return true;
+                });
+
+            std::sort(serial.begin(), serial.end());
+            std::sort(parallel.begin(), parallel.end());
+            BEAST_EXPECT(parallel == serial);
+
+            // Returning false stops every thread
+            std::atomic<std::size_t> visited{0};
+            source.visitNodesParallel(
+                threads, [&visited](std::size_t, SHAMapTreeNode&) {
+                    return ++visited < 100;
+                });
+            BEAST_EXPECT(visited >= 100 && visited < 100 + threads);
+        }
+
         std::vector<SHAMapMissingNode> missingNodes;
         source.walkMap(missingNodes, 2048);
         BEAST_EXPECT(missingNodes.empty());
@@ -185,6 +269,8 @@ public:
         BEAST_EXPECT(source.deepCompare(destination));
 
         destination.invariants();
+
+        testPrefetch(journal);
     }
 };
 